@@ -0,0 +1,376 @@
+#include "bench_executor.h"
+
+#include "grebe/histogram.h"
+#include "grebe/runtime.h"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <ctime>
+#endif
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+constexpr uint32_t kSamplesPerFrame = 1024;
+
+uint64_t now_ns() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        Clock::now().time_since_epoch()).count());
+}
+
+double process_cpu_seconds() {
+#ifndef _WIN32
+    struct timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return static_cast<double>(ts.tv_sec) + static_cast<double>(ts.tv_nsec) * 1e-9;
+#else
+    return -1.0;
+#endif
+}
+
+/// Emits pooled 1-channel frames: unthrottled, or one per period.
+class BenchSource : public grebe::IStage {
+public:
+    explicit BenchSource(std::chrono::nanoseconds period) : period_(period) {}
+
+    grebe::StageResult process(grebe::BatchView&, grebe::BatchWriter& out,
+                               grebe::ExecContext&) override {
+        if (period_.count() > 0) {
+            auto now = Clock::now();
+            if (now < next_) return grebe::StageResult::NoData;
+            next_ = std::max(next_ + period_, now);
+        }
+        auto f = grebe::Frame::make_pooled(1, kSamplesPerFrame);
+        std::memset(f.mutable_data(), 0, f.data_count() * sizeof(int16_t));
+        f.sequence = seq_++;
+        f.producer_ts_ns = now_ns();
+        out.push(std::move(f));
+        return grebe::StageResult::Ok;
+    }
+
+    std::string name() const override { return "BenchSource"; }
+
+private:
+    std::chrono::nanoseconds period_;
+    Clock::time_point next_{};
+    uint64_t seq_ = 0;
+};
+
+/// Copies each frame into a pooled buffer with a light per-sample transform.
+class RelayStage : public grebe::IStage {
+public:
+    grebe::StageResult process(grebe::BatchView& in, grebe::BatchWriter& out,
+                               grebe::ExecContext&) override {
+        for (const auto& f : in) {
+            auto o = grebe::Frame::make_pooled(f.channel_count, f.samples_per_channel);
+            const int16_t* src = f.data();
+            int16_t* dst = o.mutable_data();
+            for (size_t i = 0; i < f.data_count(); ++i) {
+                dst[i] = static_cast<int16_t>(src[i] ^ 0x5a5a);
+            }
+            o.sequence = f.sequence;
+            o.producer_ts_ns = f.producer_ts_ns;
+            out.push(std::move(o));
+        }
+        return grebe::StageResult::Ok;
+    }
+
+    std::string name() const override { return "Relay"; }
+};
+
+/// Terminal stage: counts frames and records source→sink latency of each.
+class BenchSink : public grebe::IStage {
+public:
+    grebe::StageResult process(grebe::BatchView& in, grebe::BatchWriter&,
+                               grebe::ExecContext&) override {
+        const uint64_t t = now_ns();
+        for (const auto& f : in) latency.record(t - f.producer_ts_ns);
+        frames.fetch_add(in.size(), std::memory_order_relaxed);
+        return grebe::StageResult::Ok;
+    }
+
+    std::string name() const override { return "BenchSink"; }
+
+    std::atomic<uint64_t> frames{0};
+    grebe::HdrHistogram latency;  // ns; reset() after warm-up
+};
+
+struct ExecutorBenchResult {
+    std::string label;
+    std::string executor;
+    std::string mode;
+    size_t   stages          = 0;
+    size_t   threads         = 0;
+    double   duration_s      = 0.0;
+    uint64_t frames          = 0;
+    double   frames_per_sec  = 0.0;
+    double   latency_p50_us  = 0.0;
+    double   latency_p99_us  = 0.0;
+    double   cpu_pct         = 0.0;  // process CPU time / wall time (-1 = unavailable)
+    // live mode only
+    uint32_t toggles         = 0;    // attach/detach cycles of the analysis branch
+    double   attach_max_ms   = 0.0;
+    double   detach_max_ms   = 0.0;
+    // saturated / paced: stage heap activity after warm-up (alloc_accounting)
+    uint64_t steady_heap_allocs  = 0;
+    uint64_t steady_heap_bytes   = 0;
+    uint64_t steady_minor_faults = 0;
+    std::string steady_alloc_stage;  // stage with the most steady-state allocations
+};
+
+/// Sum per-stage heap activity between two telemetry snapshots of one graph.
+void add_steady_allocs(ExecutorBenchResult& r, const std::vector<grebe::StageTelemetry>& warm,
+                       const std::vector<grebe::StageTelemetry>& end) {
+    uint64_t worst = 0;
+    for (size_t i = 0; i < warm.size() && i < end.size(); ++i) {
+        const uint64_t allocs = end[i].heap_allocations - warm[i].heap_allocations;
+        r.steady_heap_allocs  += allocs;
+        r.steady_heap_bytes   += end[i].heap_bytes - warm[i].heap_bytes;
+        r.steady_minor_faults += end[i].minor_faults - warm[i].minor_faults;
+        if (allocs > worst) {
+            worst = allocs;
+            r.steady_alloc_stage = end[i].name;
+        }
+    }
+}
+
+ExecutorBenchResult bench_executor_scenario(grebe::ExecutorKind kind, size_t stages,
+                                            bool paced, size_t worker_threads,
+                                            int duration_s) {
+    ExecutorBenchResult result;
+    result.executor = (kind == grebe::ExecutorKind::WorkStealing) ? "work_stealing"
+                                                                  : "thread_per_stage";
+    result.mode = paced ? "paced" : "saturated";
+    result.stages = stages;
+    result.label = result.executor + "_" + result.mode + "_" + std::to_string(stages);
+
+    grebe::RuntimeOptions ro;
+    ro.executor = kind;
+    ro.worker_threads = worker_threads;
+    ro.alloc_accounting = true;
+    grebe::StageGraph graph(ro);
+
+    grebe::StageOptions opts;
+    opts.queue_kind = grebe::QueueKind::Spsc;
+    opts.policy = paced ? grebe::BackpressurePolicy::DropOldest
+                        : grebe::BackpressurePolicy::Block;
+    opts.queue_capacity = 64;
+    opts.idle_policy = grebe::IdlePolicy::Park;
+
+    const auto period = paced ? std::chrono::nanoseconds(std::chrono::milliseconds(1))
+                              : std::chrono::nanoseconds(0);
+    auto prev = graph.add_stage(std::make_unique<BenchSource>(period), opts);
+    for (size_t i = 0; i + 2 < stages; ++i) {
+        auto id = graph.add_stage(std::make_unique<RelayStage>(), opts);
+        graph.connect(prev, id);
+        prev = id;
+    }
+    auto sink_owned = std::make_unique<BenchSink>();
+    auto* sink = sink_owned.get();
+    graph.connect(prev, graph.add_stage(std::move(sink_owned), opts));
+
+    const double c0 = process_cpu_seconds();
+    const auto t0 = Clock::now();
+    graph.start();
+    result.threads = graph.thread_count();
+    // Fill the pool once with every buffer the graph can hold at once
+    // (start() sized its cache for it): how close a run gets to that peak
+    // depends on scheduling, so a late new peak would otherwise show up as
+    // steady-state allocation. Anything else a stage allocates still counts
+    {
+        const size_t in_flight = (stages - 1) * opts.queue_capacity +
+                                 stages * 2 * opts.max_batch_frames;
+        std::vector<grebe::Frame> lease;
+        lease.reserve(in_flight);
+        for (size_t i = 0; i < in_flight; ++i) {
+            lease.push_back(grebe::Frame::make_pooled(1, kSamplesPerFrame));
+        }
+    }
+    // Allocations once the frame pool and queues have warmed up are steady
+    // state: a fixed warm-up (1 s or a quarter of the run), then every
+    // allocation until the end of the run counts
+    const auto warmup = std::chrono::milliseconds(std::min(1000, duration_s * 250));
+    std::this_thread::sleep_until(t0 + warmup);
+    const auto warm = graph.telemetry();
+    sink->latency.reset();  // latency percentiles cover the same steady window
+    std::this_thread::sleep_until(t0 + std::chrono::seconds(duration_s));
+    const uint64_t frames = sink->frames.load(std::memory_order_relaxed);
+    const auto t1 = Clock::now();
+    const double c1 = process_cpu_seconds();
+    add_steady_allocs(result, warm, graph.telemetry());
+    graph.stop();
+
+    const double wall = std::chrono::duration<double>(t1 - t0).count();
+    result.duration_s = wall;
+    result.frames = frames;
+    result.frames_per_sec = static_cast<double>(frames) / wall;
+    result.cpu_pct = (c0 >= 0.0) ? (c1 - c0) / wall * 100.0 : -1.0;
+
+    const auto lat = sink->latency.percentiles(1e-3);
+    result.latency_p50_us = lat.p50;
+    result.latency_p99_us = lat.p99;
+    return result;
+}
+
+/// Paced Source → Relay → Sink while a Relay → BenchSink analysis branch
+/// is attached to the source and detached again every @p period, without
+/// stopping the runtime. The main sink's rate and latency show what the
+/// toggling costs the display path.
+ExecutorBenchResult bench_live_attach_scenario(grebe::ExecutorKind kind, size_t worker_threads,
+                                               int duration_s,
+                                               std::chrono::milliseconds period) {
+    ExecutorBenchResult result;
+    result.executor = (kind == grebe::ExecutorKind::WorkStealing) ? "work_stealing"
+                                                                  : "thread_per_stage";
+    result.mode = "live";
+    result.stages = 3;
+    result.label = result.executor + "_live_3";
+
+    grebe::RuntimeOptions ro;
+    ro.executor = kind;
+    ro.worker_threads = worker_threads;
+    grebe::LinearRuntime rt(ro);
+
+    grebe::StageOptions opts;
+    opts.queue_kind = grebe::QueueKind::Spsc;
+    opts.policy = grebe::BackpressurePolicy::DropOldest;
+    opts.queue_capacity = 64;
+    opts.idle_policy = grebe::IdlePolicy::Park;
+
+    rt.add_stage(std::make_unique<BenchSource>(std::chrono::milliseconds(1)), opts);
+    rt.add_stage(std::make_unique<RelayStage>(), opts);
+    auto sink_owned = std::make_unique<BenchSink>();
+    auto* sink = sink_owned.get();
+    rt.add_stage(std::move(sink_owned), opts);
+
+    const double c0 = process_cpu_seconds();
+    const auto t0 = Clock::now();
+    const auto end = t0 + std::chrono::seconds(duration_s);
+    rt.start();
+    result.threads = rt.thread_count();
+
+    grebe::StageId branch = grebe::kInvalidStageId;
+    while (Clock::now() < end) {
+        const auto ta = Clock::now();
+        if (branch == grebe::kInvalidStageId) {
+            branch = rt.attach(0, std::make_unique<RelayStage>(), opts);
+            if (branch != grebe::kInvalidStageId) {
+                rt.attach(branch, std::make_unique<BenchSink>(), opts);
+            }
+            result.attach_max_ms = std::max(result.attach_max_ms,
+                std::chrono::duration<double, std::milli>(Clock::now() - ta).count());
+        } else {
+            rt.detach(branch);
+            branch = grebe::kInvalidStageId;
+            result.detach_max_ms = std::max(result.detach_max_ms,
+                std::chrono::duration<double, std::milli>(Clock::now() - ta).count());
+            ++result.toggles;
+        }
+        std::this_thread::sleep_for(period);
+    }
+    const uint64_t frames = sink->frames.load(std::memory_order_relaxed);
+    const auto t1 = Clock::now();
+    const double c1 = process_cpu_seconds();
+    rt.stop();
+
+    const double wall = std::chrono::duration<double>(t1 - t0).count();
+    result.duration_s = wall;
+    result.frames = frames;
+    result.frames_per_sec = static_cast<double>(frames) / wall;
+    result.cpu_pct = (c0 >= 0.0) ? (c1 - c0) / wall * 100.0 : -1.0;
+
+    const auto lat = sink->latency.percentiles(1e-3);
+    result.latency_p50_us = lat.p50;
+    result.latency_p99_us = lat.p99;
+    return result;
+}
+
+nlohmann::json result_to_json(const ExecutorBenchResult& r) {
+    nlohmann::json j;
+    j["label"]          = r.label;
+    j["executor"]       = r.executor;
+    j["mode"]           = r.mode;
+    j["stages"]         = r.stages;
+    j["threads"]        = r.threads;
+    j["duration_s"]     = r.duration_s;
+    j["frames"]         = r.frames;
+    j["frames_per_sec"] = r.frames_per_sec;
+    j["latency_p50_us"] = r.latency_p50_us;
+    j["latency_p99_us"] = r.latency_p99_us;
+    j["cpu_pct"]        = r.cpu_pct;
+    if (r.mode == "live") {
+        j["toggles"]       = r.toggles;
+        j["attach_max_ms"] = r.attach_max_ms;
+        j["detach_max_ms"] = r.detach_max_ms;
+    } else {
+        j["steady_heap_allocs"]  = r.steady_heap_allocs;
+        j["steady_heap_bytes"]   = r.steady_heap_bytes;
+        j["steady_minor_faults"] = r.steady_minor_faults;
+        if (r.steady_heap_allocs > 0) {
+            j["steady_alloc_stage"] = r.steady_alloc_stage;
+        }
+    }
+    return j;
+}
+
+} // namespace
+
+nlohmann::json run_bench_executor(int duration_seconds, size_t worker_threads) {
+    spdlog::info("=== BM-J: Executor Scaling (pool threads={}) ===",
+                 worker_threads ? std::to_string(worker_threads) : std::string("auto"));
+
+    nlohmann::json results = nlohmann::json::array();
+
+    const grebe::ExecutorKind kinds[] = {
+        grebe::ExecutorKind::ThreadPerStage,
+        grebe::ExecutorKind::WorkStealing,
+    };
+    const size_t depths[] = {3, 10, 30};
+
+    for (bool paced : {false, true}) {
+        for (size_t stages : depths) {
+            for (auto kind : kinds) {
+                auto r = bench_executor_scenario(kind, stages, paced, worker_threads,
+                                                 duration_seconds);
+                spdlog::info("  {:<32} threads {:>2}: {:>9.0f} frames/s, "
+                             "latency p50 {:.1f} us, p99 {:.1f} us, CPU {:.1f}%",
+                             r.label, r.threads, r.frames_per_sec,
+                             r.latency_p50_us, r.latency_p99_us, r.cpu_pct);
+                if (r.steady_heap_allocs > 0 || r.steady_minor_faults > 0) {
+                    spdlog::info("  {:<32} steady state: {} heap allocs ({} B, most in {}), "
+                                 "{} minor faults", "", r.steady_heap_allocs,
+                                 r.steady_heap_bytes,
+                                 r.steady_alloc_stage.empty() ? "-" : r.steady_alloc_stage,
+                                 r.steady_minor_faults);
+                }
+                results.push_back(result_to_json(r));
+            }
+        }
+    }
+
+    // Live attach/detach: the main path should stay at the paced 1000 frames/s
+    for (auto kind : kinds) {
+        auto r = bench_live_attach_scenario(kind, worker_threads, duration_seconds,
+                                            std::chrono::milliseconds(100));
+        spdlog::info("  {:<32} threads {:>2}: {:>9.0f} frames/s, "
+                     "latency p50 {:.1f} us, p99 {:.1f} us, CPU {:.1f}%",
+                     r.label, r.threads, r.frames_per_sec,
+                     r.latency_p50_us, r.latency_p99_us, r.cpu_pct);
+        spdlog::info("  {:<32} {} toggles: attach max {:.3f} ms, detach max {:.3f} ms",
+                     "", r.toggles, r.attach_max_ms, r.detach_max_ms);
+        results.push_back(result_to_json(r));
+    }
+
+    return results;
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <nlohmann/json.hpp>
+
+#include <cstddef>
+
+// BM-J: Executor scaling benchmark.
+// Runs Source → (N-2) relay stages → Sink pipelines of 3, 10 and 30 stages
+// under ThreadPerStage and WorkStealing executors.
+//   saturated: source produces as fast as possible over Block edges;
+//              measures delivered frames/s and process CPU.
+//   paced:     source emits one frame per millisecond over DropOldest edges;
+//              measures source→sink latency percentiles and process CPU.
+//   live:      paced 3-stage pipeline while a 2-stage analysis branch is
+//              attached / detached every 100 ms without stopping the runtime;
+//              measures main-path rate and latency, and attach/detach time.
+// saturated and paced results include the stages' heap allocations and minor
+// page faults after warm-up (steady_heap_allocs etc., zero when allocation-free).
+// worker_threads: WorkStealing pool size (0 = hardware concurrency).
+// Returns JSON array of per-scenario results.
+nlohmann::json run_bench_executor(int duration_seconds, size_t worker_threads = 0);
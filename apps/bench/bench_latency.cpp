@@ -0,0 +1,346 @@
+#include "bench_latency.h"
+#include "ipc/contracts.h"
+#include "ipc/pipe_transport.h"
+#include "ipc/udp_transport.h"
+#include "stages/transport_rx_stage.h"
+#include "stages/async_transport_rx_stage.h"
+#include "stages/decimation_stage.h"
+#include "stages/visualization_stage.h"
+
+#include "grebe/async.h"
+#include "grebe/histogram.h"
+#include "grebe/runtime.h"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+constexpr uint16_t BENCH_PORT       = 19877;
+constexpr uint32_t kSamplesPerFrame = 512;  // fits one 1400-byte UDP datagram
+constexpr double   kSampleRateHz    = 2e6;  // one frame every 256 us
+constexpr uint32_t kDecimateTarget  = 128;
+constexpr auto     kDisplayPoll     = std::chrono::microseconds(200);
+
+/// Paced sender: calls send(header, payload) once per frame period.
+template <typename Send>
+void run_paced_producer(std::atomic<bool>& stop, Send&& send) {
+    std::vector<int16_t> payload(kSamplesPerFrame);
+    for (size_t i = 0; i < payload.size(); ++i) {
+        payload[i] = static_cast<int16_t>((i * 37) & 0x7FFF);
+    }
+    const auto period = std::chrono::nanoseconds(
+        static_cast<int64_t>(1e9 * kSamplesPerFrame / kSampleRateHz));
+
+    uint64_t seq = 0;
+    auto next = Clock::now();
+    while (!stop.load(std::memory_order_relaxed)) {
+        std::this_thread::sleep_until(next);
+        next += period;
+
+        FrameHeaderV2 hdr{};
+        hdr.sequence = seq;
+        hdr.producer_ts_ns = grebe::steady_now_ns();
+        hdr.channel_count = 1;
+        hdr.block_length_samples = kSamplesPerFrame;
+        hdr.payload_bytes = kSamplesPerFrame * sizeof(int16_t);
+        hdr.sample_rate_hz = kSampleRateHz;
+        hdr.first_sample_index = seq * kSamplesPerFrame;
+        if (!send(hdr, payload.data())) break;
+        ++seq;
+    }
+}
+
+/// In-process producer: the same paced frames as a runtime source stage.
+class PacedSourceStage : public grebe::IStage {
+public:
+    grebe::StageResult process(grebe::BatchView&, grebe::BatchWriter& out,
+                               grebe::ExecContext&) override {
+        const auto now = Clock::now();
+        if (now < next_) {
+            std::this_thread::sleep_until(next_);
+        }
+        next_ = std::max(next_ + period_, now);
+
+        auto f = grebe::Frame::make_pooled(1, kSamplesPerFrame);
+        int16_t* dst = f.mutable_data();
+        for (uint32_t i = 0; i < kSamplesPerFrame; ++i) {
+            dst[i] = static_cast<int16_t>((i * 37) & 0x7FFF);
+        }
+        f.sequence = seq_;
+        f.producer_ts_ns = grebe::steady_now_ns();
+        f.sample_rate_hz = kSampleRateHz;
+        f.first_sample_index = seq_ * kSamplesPerFrame;
+        ++seq_;
+        out.push(std::move(f));
+        return grebe::StageResult::Ok;
+    }
+
+    std::string name() const override { return "PacedSource"; }
+
+private:
+    std::chrono::nanoseconds period_{
+        static_cast<int64_t>(1e9 * kSamplesPerFrame / kSampleRateHz)};
+    Clock::time_point next_{};
+    uint64_t seq_ = 0;
+};
+
+struct LatencyBenchResult {
+    std::string transport;
+    double   duration_s       = 0.0;
+    uint64_t frames_displayed = 0;
+    grebe::Percentiles e2e_ms{};
+    std::vector<std::pair<std::string, double>> hop_p50_ms;  // trace order
+    size_t   threads          = 0;    // runtime threads (+ reactor for async)
+    double   stop_ms          = 0.0;  // transport close + LinearRuntime::stop()
+};
+
+std::string trace_point_name(uint8_t point, const std::vector<std::string>& stage_names) {
+    switch (static_cast<grebe::TracePoint>(point)) {
+    case grebe::TracePoint::Receive:   return "receive";
+    case grebe::TracePoint::Visualize: return "visualize";
+    case grebe::TracePoint::Upload:    return "upload";
+    }
+    if (point < stage_names.size()) return stage_names[point];
+    return "stage" + std::to_string(point);
+}
+
+/// Runs @p source → DecimationStage → VisualizationStage for @p duration_s.
+/// @p producer runs on its own thread until its flag is set (empty for
+/// inproc); @p stop_transport then unblocks a blocking Rx stage so the
+/// runtime can stop (async Rx stages need none). @p extra_threads counts
+/// threads outside the runtime that the source relies on (the reactor).
+LatencyBenchResult bench_latency_scenario(const std::string& transport,
+                                          std::unique_ptr<grebe::IStage> source,
+                                          const std::function<void(std::atomic<bool>&)>& producer,
+                                          const std::function<void()>& stop_transport,
+                                          int duration_s, size_t extra_threads = 0) {
+    LatencyBenchResult result;
+    result.transport = transport;
+
+    grebe::LinearRuntime rt;
+    grebe::StageOptions opts;
+    opts.queue_capacity = 64;
+    opts.policy = grebe::BackpressurePolicy::DropOldest;
+    opts.idle_policy = grebe::IdlePolicy::Park;
+    std::vector<std::string> stage_names{source->name(), "DecimationStage"};
+    rt.add_stage(std::move(source), opts);
+    rt.add_stage(std::make_unique<grebe::DecimationStage>(DecimationMode::MinMax,
+                                                          kDecimateTarget), opts);
+
+    grebe::VisualizationStage viz(kDecimateTarget);
+    grebe::HdrHistogram e2e;
+    std::map<uint8_t, std::unique_ptr<grebe::HdrHistogram>> hops;
+    std::vector<uint8_t> hop_order;
+
+    std::atomic<bool> stop{false};
+    rt.start();
+    std::thread producer_thread;
+    if (producer) {
+        producer_thread = std::thread([&] { producer(stop); });
+    }
+
+    // Display loop: drain runtime output into the visualization stage, as
+    // the viewer does once per frame (without waiting for vsync)
+    const auto t0 = Clock::now();
+    const auto deadline = t0 + std::chrono::seconds(duration_s);
+    std::vector<grebe::Frame> input;
+    while (Clock::now() < deadline) {
+        input.clear();
+        while (auto f = rt.poll_output()) {
+            input.push_back(std::move(*f));
+        }
+        if (!input.empty()) {
+            grebe::BatchView view(std::move(input));
+            grebe::BatchWriter writer;
+            grebe::ExecContext ctx{};
+            viz.process(view, writer, ctx);
+            for (auto& d : writer.take()) {
+                if (d.producer_ts_ns == 0) continue;
+                const int64_t vis = d.trace.offset_of(
+                    static_cast<uint8_t>(grebe::TracePoint::Visualize));
+                if (vis < 0) continue;
+                e2e.record(static_cast<uint64_t>(vis));
+                for (uint8_t i = 0; i < d.trace.count; ++i) {
+                    auto& h = hops[d.trace.point[i]];
+                    if (!h) {
+                        h = std::make_unique<grebe::HdrHistogram>();
+                        hop_order.push_back(d.trace.point[i]);
+                    }
+                    h->record(d.trace.offset_ns[i]);
+                }
+                ++result.frames_displayed;
+            }
+        }
+        std::this_thread::sleep_for(kDisplayPoll);
+    }
+    const auto t1 = Clock::now();
+    result.threads = rt.thread_count() + extra_threads;
+
+    stop.store(true, std::memory_order_relaxed);
+    if (producer_thread.joinable()) producer_thread.join();
+    const auto stop_t0 = Clock::now();
+    if (stop_transport) stop_transport();
+    rt.stop();
+    result.stop_ms = std::chrono::duration<double, std::milli>(Clock::now() - stop_t0).count();
+
+    result.duration_s = std::chrono::duration<double>(t1 - t0).count();
+    result.e2e_ms = e2e.percentiles(1e-6);
+    for (uint8_t p : hop_order) {
+        result.hop_p50_ms.emplace_back(trace_point_name(p, stage_names),
+                                       hops[p]->percentiles(1e-6).p50);
+    }
+    return result;
+}
+
+nlohmann::json result_to_json(const LatencyBenchResult& r) {
+    nlohmann::json j;
+    j["transport"]        = r.transport;
+    j["duration_s"]       = r.duration_s;
+    j["frames_displayed"] = r.frames_displayed;
+    j["e2e_p50_ms"]       = r.e2e_ms.p50;
+    j["e2e_p90_ms"]       = r.e2e_ms.p90;
+    j["e2e_p99_ms"]       = r.e2e_ms.p99;
+    j["e2e_max_ms"]       = r.e2e_ms.max;
+    j["threads"]          = r.threads;
+    j["stop_ms"]          = r.stop_ms;
+    nlohmann::json hops = nlohmann::json::array();
+    for (const auto& [name, p50] : r.hop_p50_ms) {
+        hops.push_back({{"point", name}, {"p50_ms", p50}});
+    }
+    j["hops"] = hops;
+    return j;
+}
+
+void log_result(const LatencyBenchResult& r) {
+    std::string hops;
+    for (const auto& [name, p50] : r.hop_p50_ms) {
+        if (!hops.empty()) hops += ", ";
+        hops += fmt::format("{} {:.3f}", name, p50);
+    }
+    spdlog::info("  {:<10} {:>6} frames: e2e p50 {:.3f} ms, p99 {:.3f} ms, max {:.3f} ms",
+                 r.transport, r.frames_displayed, r.e2e_ms.p50, r.e2e_ms.p99, r.e2e_ms.max);
+    spdlog::info("             threads {}, stop {:.3f} ms", r.threads, r.stop_ms);
+    spdlog::info("             hop p50 (ms since producer): {}", hops);
+}
+
+} // namespace
+
+nlohmann::json run_bench_latency(int duration_seconds) {
+    spdlog::info("=== BM-K: End-to-End Latency (1ch x {} samples @ {:.0f} MSPS) ===",
+                 kSamplesPerFrame, kSampleRateHz / 1e6);
+
+    nlohmann::json results = nlohmann::json::array();
+
+    // --- inproc: producer is the runtime's source stage ---
+    {
+        auto r = bench_latency_scenario("inproc", std::make_unique<PacedSourceStage>(),
+                                        {}, {}, duration_seconds);
+        log_result(r);
+        results.push_back(result_to_json(r));
+    }
+
+#ifndef _WIN32
+    // --- pipe: in-process pipe() pair, same framing as grebe-sg stdout ---
+    {
+        int data_fds[2];
+        int cmd_fds[2];
+        if (::pipe(data_fds) == 0 && ::pipe(cmd_fds) == 0) {
+            PipeConsumer consumer(data_fds[0], cmd_fds[1]);  // owns these fds
+            PipeProducer producer(data_fds[1], cmd_fds[0]);
+            auto r = bench_latency_scenario(
+                "pipe", std::make_unique<TransportRxStage>(consumer),
+                [&](std::atomic<bool>& stop) {
+                    run_paced_producer(stop, [&](const FrameHeaderV2& h, const void* p) {
+                        return producer.send_frame(h, p);
+                    });
+                },
+                [&] {
+                    // EOF on the data pipe ends the Rx stage
+                    ::close(data_fds[1]);
+                    ::close(cmd_fds[0]);
+                },
+                duration_seconds);
+            log_result(r);
+            results.push_back(result_to_json(r));
+        } else {
+            spdlog::warn("  pipe: pipe() failed, skipping");
+        }
+    }
+#endif
+
+    // --- udp: loopback datagrams ---
+    {
+        UdpConsumer consumer(BENCH_PORT);
+        UdpProducer producer("127.0.0.1", BENCH_PORT);
+        auto r = bench_latency_scenario(
+            "udp", std::make_unique<TransportRxStage>(consumer),
+            [&](std::atomic<bool>& stop) {
+                run_paced_producer(stop, [&](const FrameHeaderV2& h, const void* p) {
+                    return producer.send_frame(h, p);
+                });
+            },
+            [&] { consumer.close(); },
+            duration_seconds);
+        log_result(r);
+        results.push_back(result_to_json(r));
+    }
+
+#ifndef _WIN32
+    // --- async: the same transports as coroutine Rx stages on one reactor ---
+    // Nothing closes the transports before stop(): stop latency no longer
+    // depends on EOF or the UDP receive timeout
+    if (grebe::Reactor::supported()) {
+        grebe::Reactor reactor;
+
+        int data_fds[2];
+        int cmd_fds[2];
+        if (::pipe(data_fds) == 0 && ::pipe(cmd_fds) == 0) {
+            PipeConsumer consumer(data_fds[0], cmd_fds[1]);
+            PipeProducer producer(data_fds[1], cmd_fds[0]);
+            auto r = bench_latency_scenario(
+                "pipe-async", std::make_unique<AsyncTransportRxStage>(reactor, consumer),
+                [&](std::atomic<bool>& stop) {
+                    run_paced_producer(stop, [&](const FrameHeaderV2& h, const void* p) {
+                        return producer.send_frame(h, p);
+                    });
+                },
+                {}, duration_seconds, 1);
+            ::close(data_fds[1]);
+            ::close(cmd_fds[0]);
+            log_result(r);
+            results.push_back(result_to_json(r));
+        }
+
+        UdpConsumer consumer(BENCH_PORT);
+        UdpProducer producer("127.0.0.1", BENCH_PORT);
+        auto r = bench_latency_scenario(
+            "udp-async", std::make_unique<AsyncTransportRxStage>(reactor, consumer),
+            [&](std::atomic<bool>& stop) {
+                run_paced_producer(stop, [&](const FrameHeaderV2& h, const void* p) {
+                    return producer.send_frame(h, p);
+                });
+            },
+            {}, duration_seconds, 1);
+        log_result(r);
+        results.push_back(result_to_json(r));
+    }
+#endif
+
+    return results;
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <nlohmann/json.hpp>
+
+// BM-K: End-to-end sample latency benchmark (NFR-02 / NFR-12).
+// A paced producer feeds Rx → DecimationStage (LinearRuntime) → VisualizationStage
+// for each transport (inproc source stage, pipe, UDP loopback), then pipe and
+// UDP again as coroutine Rx stages on a shared Reactor (pipe-async, udp-async).
+// Measures producer timestamp → display frame latency (glass-to-glass minus
+// GPU, swap and vsync) as p50/p99, plus per-hop medians from Frame::trace,
+// thread count and stop latency (transport close + LinearRuntime::stop()).
+// Returns JSON array of per-transport results.
+nlohmann::json run_bench_latency(int duration_seconds);
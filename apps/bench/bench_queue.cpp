@@ -0,0 +1,311 @@
+#include "bench_queue.h"
+#include "core/in_process_queue.h"
+#include "core/lock_free_queue.h"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <ctime>
+#endif
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+// Enqueue latency is sampled (1 in N calls) to keep timer overhead and
+// sample storage bounded for multi-second runs.
+constexpr uint64_t LATENCY_SAMPLE_INTERVAL = 16;
+constexpr size_t   LATENCY_SAMPLE_MAX      = 1 << 20;
+
+struct QueueBenchResult {
+    std::string label;
+    std::string kind;
+    std::string policy;
+    size_t   capacity        = 0;
+    double   duration_s      = 0.0;
+    uint64_t frames_enqueued = 0;
+    uint64_t frames_dequeued = 0;
+    uint64_t frames_dropped  = 0;
+    double   frames_per_sec  = 0.0;
+    double   enqueue_p50_ns  = 0.0;
+    double   enqueue_p99_ns  = 0.0;
+    double   enqueue_max_ns  = 0.0;
+};
+
+const char* kind_name(grebe::QueueKind kind) {
+    switch (kind) {
+    case grebe::QueueKind::Mutex: return "mutex";
+    case grebe::QueueKind::Spsc:  return "spsc";
+    case grebe::QueueKind::Mpmc:  return "mpmc";
+    }
+    return "unknown";
+}
+
+const char* policy_name(grebe::BackpressurePolicy policy) {
+    switch (policy) {
+    case grebe::BackpressurePolicy::DropLatest: return "drop_latest";
+    case grebe::BackpressurePolicy::DropOldest: return "drop_oldest";
+    case grebe::BackpressurePolicy::Block:      return "block";
+    case grebe::BackpressurePolicy::Credit:     return "credit";
+    }
+    return "unknown";
+}
+
+std::unique_ptr<grebe::IQueue<grebe::Frame>> make_queue(grebe::QueueKind kind,
+                                                        size_t capacity,
+                                                        grebe::BackpressurePolicy policy) {
+    switch (kind) {
+    case grebe::QueueKind::Spsc:
+        return std::make_unique<grebe::LockFreeQueue>(capacity, policy, false);
+    case grebe::QueueKind::Mpmc:
+        return std::make_unique<grebe::LockFreeQueue>(capacity, policy, true);
+    case grebe::QueueKind::Mutex:
+        break;
+    }
+    return std::make_unique<grebe::InProcessQueue>(capacity, policy);
+}
+
+double percentile(std::vector<uint64_t>& sorted, double p) {
+    if (sorted.empty()) return 0.0;
+    size_t idx = static_cast<size_t>(p * static_cast<double>(sorted.size() - 1));
+    return static_cast<double>(sorted[idx]);
+}
+
+QueueBenchResult bench_queue_scenario(grebe::QueueKind kind,
+                                      grebe::BackpressurePolicy policy,
+                                      size_t capacity,
+                                      int duration_s) {
+    QueueBenchResult result;
+    result.kind = kind_name(kind);
+    result.policy = policy_name(policy);
+    result.label = result.kind + "_" + result.policy;
+
+    auto queue = make_queue(kind, capacity, policy);
+    result.capacity = queue->capacity();
+
+    // Borrowed frames over a static payload: no per-frame allocation, so the
+    // measurement isolates the queue itself.
+    static const int16_t payload[64] = {};
+
+    std::atomic<bool> producer_done{false};
+    std::atomic<uint64_t> dequeued{0};
+
+    std::thread consumer([&] {
+        uint64_t n = 0;
+        for (;;) {
+            if (auto f = queue->dequeue()) {
+                ++n;
+                continue;
+            }
+            if (producer_done.load(std::memory_order_acquire)) {
+                while (queue->dequeue()) ++n;
+                break;
+            }
+        }
+        dequeued.store(n, std::memory_order_relaxed);
+    });
+
+    std::vector<uint64_t> latencies;
+    latencies.reserve(LATENCY_SAMPLE_MAX);
+
+    uint64_t seq = 0;
+    auto t0 = Clock::now();
+    auto deadline = t0 + std::chrono::seconds(duration_s);
+
+    while (Clock::now() < deadline) {
+        // Check the deadline once per 1024 frames to keep clock reads off the hot path
+        for (int i = 0; i < 1024; ++i) {
+            auto f = grebe::Frame::make_borrowed(payload, 64, nullptr);
+            f.sequence = seq;
+            if (seq % LATENCY_SAMPLE_INTERVAL == 0 && latencies.size() < LATENCY_SAMPLE_MAX) {
+                auto e0 = Clock::now();
+                queue->enqueue(std::move(f));
+                auto e1 = Clock::now();
+                latencies.push_back(static_cast<uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(e1 - e0).count()));
+            } else {
+                queue->enqueue(std::move(f));
+            }
+            ++seq;
+        }
+    }
+
+    producer_done.store(true, std::memory_order_release);
+    consumer.join();
+    auto t1 = Clock::now();
+
+    double elapsed = std::chrono::duration<double>(t1 - t0).count();
+    result.duration_s = elapsed;
+    result.frames_enqueued = queue->total_enqueued();
+    result.frames_dequeued = dequeued.load();
+    result.frames_dropped = queue->total_dropped();
+    result.frames_per_sec = static_cast<double>(result.frames_dequeued) / elapsed;
+
+    std::sort(latencies.begin(), latencies.end());
+    result.enqueue_p50_ns = percentile(latencies, 0.50);
+    result.enqueue_p99_ns = percentile(latencies, 0.99);
+    result.enqueue_max_ns = latencies.empty() ? 0.0 : static_cast<double>(latencies.back());
+
+    return result;
+}
+
+struct WakeupBenchResult {
+    std::string label;
+    std::string kind;
+    std::string wait;
+    uint64_t frames          = 0;
+    double   wake_p50_us     = 0.0;
+    double   wake_p99_us     = 0.0;
+    double   wake_max_us     = 0.0;
+    double   consumer_cpu_pct = 0.0;  // consumer thread CPU time / wall time (-1 = unavailable)
+};
+
+double thread_cpu_seconds() {
+#ifndef _WIN32
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<double>(ts.tv_sec) + static_cast<double>(ts.tv_nsec) * 1e-9;
+#else
+    return -1.0;
+#endif
+}
+
+WakeupBenchResult bench_wakeup_scenario(grebe::QueueKind kind, bool park, int duration_s) {
+    WakeupBenchResult result;
+    result.kind = kind_name(kind);
+    result.wait = park ? "park" : "yield";
+    result.label = "wakeup_" + result.kind + "_" + result.wait;
+
+    auto queue = make_queue(kind, 64, grebe::BackpressurePolicy::DropOldest);
+    static const int16_t payload[64] = {};
+
+    std::atomic<bool> producer_done{false};
+    std::vector<uint64_t> latencies;
+    latencies.reserve(static_cast<size_t>(duration_s) * 1000 + 16);
+    double cpu_s = 0.0;
+    double wall_s = 0.0;
+
+    std::thread consumer([&] {
+        double c0 = thread_cpu_seconds();
+        auto w0 = Clock::now();
+        while (!producer_done.load(std::memory_order_acquire)) {
+            std::optional<grebe::Frame> f;
+            if (park) {
+                f = queue->dequeue_wait(std::chrono::milliseconds(10));
+            } else {
+                f = queue->dequeue();
+                if (!f) std::this_thread::yield();
+            }
+            if (!f) continue;
+            auto now_ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                Clock::now().time_since_epoch()).count());
+            latencies.push_back(now_ns - f->producer_ts_ns);
+        }
+        cpu_s = thread_cpu_seconds() - c0;
+        wall_s = std::chrono::duration<double>(Clock::now() - w0).count();
+    });
+
+    auto deadline = Clock::now() + std::chrono::seconds(duration_s);
+    uint64_t seq = 0;
+    while (Clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        auto f = grebe::Frame::make_borrowed(payload, 64, nullptr);
+        f.sequence = seq++;
+        f.producer_ts_ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            Clock::now().time_since_epoch()).count());
+        queue->enqueue(std::move(f));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    producer_done.store(true, std::memory_order_release);
+    queue->shutdown();
+    consumer.join();
+
+    result.frames = latencies.size();
+    std::sort(latencies.begin(), latencies.end());
+    result.wake_p50_us = percentile(latencies, 0.50) / 1e3;
+    result.wake_p99_us = percentile(latencies, 0.99) / 1e3;
+    result.wake_max_us = latencies.empty() ? 0.0 : static_cast<double>(latencies.back()) / 1e3;
+    result.consumer_cpu_pct = (cpu_s >= 0.0 && wall_s > 0.0) ? cpu_s / wall_s * 100.0 : -1.0;
+    return result;
+}
+
+nlohmann::json wakeup_to_json(const WakeupBenchResult& r) {
+    nlohmann::json j;
+    j["label"]            = r.label;
+    j["kind"]             = r.kind;
+    j["wait"]             = r.wait;
+    j["frames"]           = r.frames;
+    j["wake_p50_us"]      = r.wake_p50_us;
+    j["wake_p99_us"]      = r.wake_p99_us;
+    j["wake_max_us"]      = r.wake_max_us;
+    j["consumer_cpu_pct"] = r.consumer_cpu_pct;
+    return j;
+}
+
+nlohmann::json result_to_json(const QueueBenchResult& r) {
+    nlohmann::json j;
+    j["label"]           = r.label;
+    j["kind"]            = r.kind;
+    j["policy"]          = r.policy;
+    j["capacity"]        = r.capacity;
+    j["duration_s"]      = r.duration_s;
+    j["frames_enqueued"] = r.frames_enqueued;
+    j["frames_dequeued"] = r.frames_dequeued;
+    j["frames_dropped"]  = r.frames_dropped;
+    j["frames_per_sec"]  = r.frames_per_sec;
+    j["enqueue_p50_ns"]  = r.enqueue_p50_ns;
+    j["enqueue_p99_ns"]  = r.enqueue_p99_ns;
+    j["enqueue_max_ns"]  = r.enqueue_max_ns;
+    return j;
+}
+
+} // namespace
+
+nlohmann::json run_bench_queue(int duration_seconds, size_t capacity) {
+    spdlog::info("=== BM-I: Queue Throughput (capacity={}) ===", capacity);
+
+    nlohmann::json results = nlohmann::json::array();
+
+    const grebe::QueueKind kinds[] = {
+        grebe::QueueKind::Mutex,
+        grebe::QueueKind::Spsc,
+        grebe::QueueKind::Mpmc,
+    };
+    const grebe::BackpressurePolicy policies[] = {
+        grebe::BackpressurePolicy::DropLatest,
+        grebe::BackpressurePolicy::DropOldest,
+        grebe::BackpressurePolicy::Block,
+    };
+
+    for (auto policy : policies) {
+        for (auto kind : kinds) {
+            spdlog::info("  Running: {}_{}...", kind_name(kind), policy_name(policy));
+            auto r = bench_queue_scenario(kind, policy, capacity, duration_seconds);
+            spdlog::info("    => {:.2f} M frames/s, enqueue p50 {:.0f} ns, p99 {:.0f} ns, dropped {}",
+                         r.frames_per_sec / 1e6, r.enqueue_p50_ns, r.enqueue_p99_ns,
+                         r.frames_dropped);
+            results.push_back(result_to_json(r));
+        }
+    }
+
+    spdlog::info("--- Wakeup (1 frame/ms, yield-poll vs park) ---");
+    for (auto kind : kinds) {
+        for (bool park : {false, true}) {
+            spdlog::info("  Running: wakeup_{}_{}...", kind_name(kind), park ? "park" : "yield");
+            auto r = bench_wakeup_scenario(kind, park, duration_seconds);
+            spdlog::info("    => wake p50 {:.1f} us, p99 {:.1f} us, consumer CPU {:.1f}%",
+                         r.wake_p50_us, r.wake_p99_us, r.consumer_cpu_pct);
+            results.push_back(wakeup_to_json(r));
+        }
+    }
+
+    return results;
+}
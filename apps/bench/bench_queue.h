@@ -0,0 +1,15 @@
+#pragma once
+
+#include <nlohmann/json.hpp>
+
+#include <cstddef>
+
+// BM-I: Inter-stage queue throughput benchmark.
+// Compares InProcessQueue (mutex) against LockFreeQueue (SPSC / MPMC) with
+// one producer and one consumer thread for each BackpressurePolicy.
+// Measures frames/s through the queue and enqueue latency percentiles.
+// Wakeup scenarios send one frame per millisecond and compare a yield-polling
+// consumer with a parked consumer (dequeue_wait): wake latency and consumer CPU.
+// capacity: queue capacity in frames.
+// Returns JSON array of per-scenario results.
+nlohmann::json run_bench_queue(int duration_seconds, size_t capacity = 64);
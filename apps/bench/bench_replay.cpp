@@ -0,0 +1,139 @@
+#include "bench_replay.h"
+#include "synthetic_source.h"
+#include "stages/data_source_adapter.h"
+#include "stages/decimation_stage.h"
+#include "stages/visualization_stage.h"
+
+#include "grebe/runtime.h"
+
+#include <spdlog/spdlog.h>
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+constexpr double   kNominalRateHz  = 1e9;   // simulated timeline; high-rate block size
+constexpr uint32_t kDecimateTarget = 3840;  // viewer default display width
+constexpr size_t   kQueueCapacity  = 64;
+
+struct ReplayBenchResult {
+    std::string mode;
+    uint32_t channels          = 0;
+    double   duration_s        = 0.0;   // wall time between first and last display frame
+    double   simulated_s       = 0.0;   // simulated time covered in that interval
+    uint64_t samples           = 0;     // raw samples per channel displayed
+    uint64_t frames_displayed  = 0;
+    double   samples_per_sec   = 0.0;   // sustainable raw rate per channel
+    double   realtime_factor   = 0.0;   // simulated_s / duration_s
+};
+
+ReplayBenchResult bench_replay_scenario(DecimationMode mode, const std::string& label,
+                                        uint32_t channels, int duration_s) {
+    ReplayBenchResult result;
+    result.mode = label;
+    result.channels = channels;
+
+    SyntheticSource source(channels, kNominalRateHz, WaveformType::Sine);
+    source.set_virtual_clock(true);
+    source.start();
+
+    grebe::LinearRuntime rt;
+    grebe::StageOptions opts;
+    opts.queue_capacity = kQueueCapacity;
+    opts.policy = grebe::BackpressurePolicy::Credit;
+    opts.queue_kind = grebe::QueueKind::Spsc;
+    rt.add_stage(std::make_unique<grebe::DataSourceAdapter>(source));
+    rt.add_stage(std::make_unique<grebe::DecimationStage>(mode, kDecimateTarget), opts);
+    rt.set_output_options({kQueueCapacity, grebe::BackpressurePolicy::Credit,
+                           grebe::QueueKind::Spsc});
+
+    grebe::VisualizationStage viz(kDecimateTarget);
+    rt.start();
+
+    // Display loop: drain and visualize as fast as possible (no vsync)
+    const auto deadline = Clock::now() + std::chrono::seconds(duration_s);
+    Clock::time_point first_t{}, last_t{};
+    uint64_t first_ts = 0, last_ts = 0;
+    uint64_t first_index = 0, last_index = 0;
+    std::vector<grebe::Frame> input;
+    while (Clock::now() < deadline) {
+        input.clear();
+        while (auto f = rt.poll_output()) {
+            input.push_back(std::move(*f));
+        }
+        if (input.empty()) {
+            std::this_thread::yield();
+            continue;
+        }
+        const auto now = Clock::now();
+        const auto& newest = input.back();
+        if (result.frames_displayed == 0) {
+            first_t = now;
+            first_ts = input.front().producer_ts_ns;
+            first_index = input.front().first_sample_index;
+        }
+        last_t = now;
+        last_ts = newest.producer_ts_ns;
+        last_index = newest.first_sample_index;
+
+        grebe::BatchView view(std::move(input));
+        grebe::BatchWriter writer;
+        grebe::ExecContext ctx{};
+        viz.process(view, writer, ctx);
+        result.frames_displayed += writer.take().size();
+    }
+
+    rt.stop();
+    source.stop();
+
+    result.duration_s = std::chrono::duration<double>(last_t - first_t).count();
+    result.simulated_s = static_cast<double>(last_ts - first_ts) * 1e-9;
+    result.samples = last_index - first_index;
+    if (result.duration_s > 0.0) {
+        result.samples_per_sec = static_cast<double>(result.samples) / result.duration_s;
+        result.realtime_factor = result.simulated_s / result.duration_s;
+    }
+    return result;
+}
+
+nlohmann::json result_to_json(const ReplayBenchResult& r) {
+    nlohmann::json j;
+    j["mode"]             = r.mode;
+    j["channels"]         = r.channels;
+    j["duration_s"]       = r.duration_s;
+    j["simulated_s"]      = r.simulated_s;
+    j["samples"]          = r.samples;
+    j["frames_displayed"] = r.frames_displayed;
+    j["samples_per_sec"]  = r.samples_per_sec;
+    j["msps"]             = r.samples_per_sec / 1e6;
+    j["realtime_factor"]  = r.realtime_factor;
+    return j;
+}
+
+} // namespace
+
+nlohmann::json run_bench_replay(int duration_seconds, uint32_t channels) {
+    spdlog::info("=== BM-L: Sustainable Rate, Virtual Clock ({}ch, display {} pts) ===",
+                 channels, kDecimateTarget);
+
+    nlohmann::json results = nlohmann::json::array();
+    const std::pair<DecimationMode, const char*> modes[] = {
+        {DecimationMode::MinMax, "minmax"},
+        {DecimationMode::LTTB,   "lttb"},
+    };
+    for (const auto& [mode, label] : modes) {
+        auto r = bench_replay_scenario(mode, label, channels, duration_seconds);
+        spdlog::info("  {:<8} {:>10.1f} MSPS/ch ({:.2f}x real time at {:.0f} MSPS), "
+                     "{} display frames",
+                     r.mode, r.samples_per_sec / 1e6, r.realtime_factor,
+                     kNominalRateHz / 1e6, r.frames_displayed);
+        results.push_back(result_to_json(r));
+    }
+    return results;
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <nlohmann/json.hpp>
+
+#include <cstdint>
+
+// BM-L: Maximum sustainable sample rate (virtual-clock replay).
+// SyntheticSource runs with a virtual clock (no pacing, simulated producer
+// timestamps) → DataSourceAdapter → DecimationStage → VisualizationStage,
+// with credit flow on every edge, so the pipeline's slowest stage sets the
+// rate. Reports raw samples/s per channel through to the display stage and
+// the speed-up over real time, per decimation mode.
+// Returns JSON array of per-mode results.
+nlohmann::json run_bench_replay(int duration_seconds, uint32_t channels);
@@ -0,0 +1,355 @@
+#include "bench_shm.h"
+#include "ipc/contracts.h"
+#include "ipc/pipe_transport.h"
+#include "ipc/shm_transport.h"
+#include "stages/transport_rx_stage.h"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <ctime>
+#include <unistd.h>
+#endif
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+constexpr uint32_t kBlockSamples = 16384;  // grebe-sg default block size
+constexpr uint32_t kShmSlots     = 32;     // grebe-sg default --shm-slots
+
+struct ShmBenchResult {
+    std::string transport;
+    uint32_t channels          = 0;
+    double   duration_s        = 0.0;
+    uint64_t frames            = 0;
+    double   throughput_msps   = 0.0;  // all channels
+    double   producer_ns_per_sample = 0.0;  // thread CPU time
+    double   consumer_ns_per_sample = 0.0;
+    double   cpu_ns_per_sample = 0.0;      // producer + consumer
+    double   transport_ns_per_sample = 0.0;  // cpu minus the source copy baseline
+};
+
+#ifndef _WIN32
+double thread_cpu_seconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<double>(ts.tv_sec) + static_cast<double>(ts.tv_nsec) * 1e-9;
+}
+
+/// Runs @p produce until the deadline and @p consume until it returns
+/// false, each on its own thread, then @p close_producer to end the stream.
+/// produce / consume return the samples moved per call (0 = closed).
+ShmBenchResult bench_transport_scenario(const std::string& transport, uint32_t channels,
+                                        int duration_s,
+                                        const std::function<uint64_t()>& produce,
+                                        const std::function<uint64_t()>& consume,
+                                        const std::function<void()>& close_producer) {
+    ShmBenchResult result;
+    result.transport = transport;
+    result.channels = channels;
+
+    std::atomic<bool> stop{false};
+    uint64_t samples = 0;
+    double producer_cpu_s = 0.0;
+    double consumer_cpu_s = 0.0;
+
+    std::thread consumer([&] {
+        const double c0 = thread_cpu_seconds();
+        while (const uint64_t n = consume()) {
+            samples += n;
+            ++result.frames;
+        }
+        consumer_cpu_s = thread_cpu_seconds() - c0;
+    });
+
+    const auto t0 = Clock::now();
+    std::thread producer([&] {
+        const double c0 = thread_cpu_seconds();
+        while (!stop.load(std::memory_order_relaxed)) {
+            if (produce() == 0) break;
+        }
+        producer_cpu_s = thread_cpu_seconds() - c0;
+        close_producer();
+    });
+
+    std::this_thread::sleep_for(std::chrono::seconds(duration_s));
+    stop.store(true, std::memory_order_relaxed);
+    producer.join();
+    consumer.join();
+    result.duration_s = std::chrono::duration<double>(Clock::now() - t0).count();
+
+    if (samples > 0 && result.duration_s > 0.0) {
+        const auto n = static_cast<double>(samples);
+        result.throughput_msps        = n / result.duration_s / 1e6;
+        result.producer_ns_per_sample = producer_cpu_s * 1e9 / n;
+        result.consumer_ns_per_sample = consumer_cpu_s * 1e9 / n;
+        result.cpu_ns_per_sample      = result.producer_ns_per_sample +
+                                        result.consumer_ns_per_sample;
+    }
+    return result;
+}
+
+/// CPU time per sample of the producer's source copy alone (no transport).
+double source_copy_ns_per_sample(const std::vector<int16_t>& source) {
+    std::vector<int16_t> dst(source.size());
+    uint64_t samples = 0;
+    const double c0 = thread_cpu_seconds();
+    const auto deadline = Clock::now() + std::chrono::milliseconds(200);
+    while (Clock::now() < deadline) {
+        std::memcpy(dst.data(), source.data(), source.size() * sizeof(int16_t));
+        samples += source.size();
+    }
+    const double cpu_s = thread_cpu_seconds() - c0;
+    return samples > 0 ? cpu_s * 1e9 / static_cast<double>(samples) : 0.0;
+}
+
+FrameHeaderV2 make_header(uint64_t seq, uint32_t channels) {
+    FrameHeaderV2 h{};
+    h.sequence = seq;
+    h.producer_ts_ns = grebe::steady_now_ns();
+    h.channel_count = channels;
+    h.block_length_samples = kBlockSamples;
+    h.payload_bytes = channels * kBlockSamples * static_cast<uint32_t>(sizeof(int16_t));
+    h.sample_rate_hz = 1e9;
+    h.first_sample_index = seq * kBlockSamples;
+    return h;
+}
+
+/// Fan-out: one producer, @p consumers readers on the same queue. Reader 0
+/// keeps up (Block); the others are lossy (DropOldest, depth 4), the last
+/// of them slow (holds each frame 1 ms). The payload is written once, so the
+/// producer's CPU per sample should not grow with the number of readers.
+nlohmann::json bench_fanout(const std::vector<int16_t>& source, uint32_t channels,
+                            uint32_t consumers, int duration_s) {
+    const std::string name = "/grebe-bench-fanout-" + std::to_string(getpid());
+    grebe::ShmQueueConfig config;
+    config.slot_count = kShmSlots;
+    config.slot_samples = source.size();
+    config.policy = grebe::BackpressurePolicy::Block;
+    config.max_consumers = consumers;
+    ShmProducer producer(name, config, -1);
+
+    std::vector<std::unique_ptr<ShmConsumer>> readers;
+    for (uint32_t i = 0; i < consumers; ++i) {
+        grebe::ShmConsumerOptions options;
+        if (i > 0) {
+            options.policy = grebe::BackpressurePolicy::DropOldest;
+            options.depth = 4;
+        }
+        readers.push_back(std::make_unique<ShmConsumer>(name, -1, std::chrono::milliseconds(1000),
+                                                        options));
+    }
+
+    std::vector<uint64_t> received(consumers, 0);
+    std::vector<std::thread> threads;
+    for (uint32_t i = 0; i < consumers; ++i) {
+        const bool slow = i > 0 && i + 1 == consumers;
+        threads.emplace_back([&, i, slow] {
+            for (;;) {
+                if (auto f = readers[i]->receive(std::chrono::milliseconds(100))) {
+                    ++received[i];
+                    if (slow) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                    continue;
+                }
+                if (readers[i]->closed()) return;
+            }
+        });
+    }
+
+    std::atomic<bool> stop{false};
+    uint64_t samples = 0;
+    double producer_cpu_s = 0.0;
+    const auto t0 = Clock::now();
+    std::thread writer([&] {
+        const double c0 = thread_cpu_seconds();
+        uint64_t seq = 0;
+        while (!stop.load(std::memory_order_relaxed)) {
+            int16_t* dst = producer.acquire_payload(source.size());
+            if (!dst) break;
+            std::memcpy(dst, source.data(), source.size() * sizeof(int16_t));
+            if (!producer.commit_frame(make_header(seq++, channels))) break;
+            samples += source.size();
+        }
+        producer_cpu_s = thread_cpu_seconds() - c0;
+        producer.close();
+    });
+    std::this_thread::sleep_for(std::chrono::seconds(duration_s));
+    stop.store(true, std::memory_order_relaxed);
+    writer.join();
+    for (auto& t : threads) t.join();
+    const double elapsed_s = std::chrono::duration<double>(Clock::now() - t0).count();
+
+    const double producer_ns = samples > 0 ? producer_cpu_s * 1e9 / static_cast<double>(samples)
+                                           : 0.0;
+    const uint64_t lossy_drops = consumers > 1 ? producer.queue()->total_dropped() : 0;
+    spdlog::info("  fan-out x{}: {:>8.1f} MSPS, producer {:.3f} ns/sample, "
+                 "frames {} (slow lossy reader: {})",
+                 consumers, static_cast<double>(samples) / elapsed_s / 1e6, producer_ns,
+                 received.front(), consumers > 1 ? std::to_string(received.back()) : "-");
+
+    nlohmann::json j;
+    j["transport"]              = "shm-fanout";
+    j["channels"]               = channels;
+    j["block_samples"]          = kBlockSamples;
+    j["consumers"]              = consumers;
+    j["duration_s"]             = elapsed_s;
+    j["frames"]                 = received.front();
+    j["throughput_msps"]        = static_cast<double>(samples) / elapsed_s / 1e6;
+    j["producer_ns_per_sample"] = producer_ns;
+    j["frames_per_consumer"]    = received;
+    j["lossy_drops"]            = lossy_drops;
+    return j;
+}
+#endif
+
+nlohmann::json result_to_json(const ShmBenchResult& r) {
+    nlohmann::json j;
+    j["transport"]              = r.transport;
+    j["channels"]               = r.channels;
+    j["block_samples"]          = kBlockSamples;
+    j["duration_s"]             = r.duration_s;
+    j["frames"]                 = r.frames;
+    j["throughput_msps"]        = r.throughput_msps;
+    j["producer_ns_per_sample"] = r.producer_ns_per_sample;
+    j["consumer_ns_per_sample"] = r.consumer_ns_per_sample;
+    j["cpu_ns_per_sample"]      = r.cpu_ns_per_sample;
+    j["transport_ns_per_sample"] = r.transport_ns_per_sample;
+    return j;
+}
+
+void log_result(const ShmBenchResult& r) {
+    spdlog::info("  {:<5} {:>8.1f} MSPS, CPU/sample: producer {:.3f} ns, consumer {:.3f} ns, "
+                 "total {:.3f} ns (transport {:.3f} ns)",
+                 r.transport, r.throughput_msps, r.producer_ns_per_sample,
+                 r.consumer_ns_per_sample, r.cpu_ns_per_sample, r.transport_ns_per_sample);
+}
+
+} // namespace
+
+nlohmann::json run_bench_shm(int duration_seconds, uint32_t channels) {
+    nlohmann::json results = nlohmann::json::array();
+#ifdef _WIN32
+    (void)duration_seconds;
+    (void)channels;
+    spdlog::warn("BM-M: not supported on Windows, skipping");
+#else
+    spdlog::info("=== BM-M: Transport CPU Cost, pipe vs shm ({}ch x {} samples) ===",
+                 channels, kBlockSamples);
+
+    // Stand-in for grebe-sg's source rings: the producer copies a block out
+    // of it per frame in both scenarios
+    const size_t frame_samples = static_cast<size_t>(channels) * kBlockSamples;
+    std::vector<int16_t> source(frame_samples);
+    for (size_t i = 0; i < source.size(); ++i) {
+        source[i] = static_cast<int16_t>((i * 37) & 0x7FFF);
+    }
+
+    // The source copy is the same for both transports: subtract it to
+    // compare what the transports themselves cost
+    const double copy_ns = source_copy_ns_per_sample(source);
+    spdlog::info("  source copy baseline: {:.3f} ns/sample", copy_ns);
+    auto finish = [copy_ns](ShmBenchResult& r) {
+        r.transport_ns_per_sample = std::max(0.0, r.cpu_ns_per_sample - copy_ns);
+    };
+
+    double pipe_transport = 0.0;
+
+    // --- pipe: staging copy + writev, read into a pooled frame ---
+    {
+        int data_fds[2];
+        int cmd_fds[2];
+        if (::pipe(data_fds) == 0 && ::pipe(cmd_fds) == 0) {
+            PipeConsumer consumer(data_fds[0], cmd_fds[1]);  // owns these fds
+            PipeProducer producer(data_fds[1], cmd_fds[0]);
+            std::vector<int16_t> staging(frame_samples);
+            std::vector<int16_t> rx_payload;
+            uint64_t seq = 0;
+            auto r = bench_transport_scenario(
+                "pipe", channels, duration_seconds,
+                [&]() -> uint64_t {
+                    std::memcpy(staging.data(), source.data(), frame_samples * sizeof(int16_t));
+                    if (!producer.send_frame(make_header(seq++, channels), staging.data())) return 0;
+                    return frame_samples;
+                },
+                [&]() -> uint64_t {
+                    FrameHeaderV2 h{};
+                    if (!consumer.receive_frame(h, rx_payload)) return 0;
+                    grebe::Frame f = make_rx_frame(h, rx_payload);
+                    return f.data_count();
+                },
+                [&] {
+                    ::close(data_fds[1]);
+                    ::close(cmd_fds[0]);
+                });
+            finish(r);
+            log_result(r);
+            pipe_transport = r.transport_ns_per_sample;
+            results.push_back(result_to_json(r));
+        } else {
+            spdlog::warn("  pipe: pipe() failed, skipping");
+        }
+    }
+
+    // --- shm: copy straight into the slot, Borrowed frame on the consumer ---
+    try {
+        const std::string name = "/grebe-bench-shm-" + std::to_string(getpid());
+        grebe::ShmQueueConfig config;
+        config.slot_count = kShmSlots;
+        config.slot_samples = frame_samples;
+        config.policy = grebe::BackpressurePolicy::Block;
+        ShmProducer producer(name, config, -1);
+        ShmConsumer consumer(name, -1);
+        uint64_t seq = 0;
+        auto r = bench_transport_scenario(
+            "shm", channels, duration_seconds,
+            [&]() -> uint64_t {
+                int16_t* dst = producer.acquire_payload(frame_samples);
+                if (!dst) return 0;
+                std::memcpy(dst, source.data(), frame_samples * sizeof(int16_t));
+                if (!producer.commit_frame(make_header(seq++, channels))) return 0;
+                return frame_samples;
+            },
+            [&]() -> uint64_t {
+                for (;;) {
+                    if (auto f = consumer.receive(std::chrono::milliseconds(100))) {
+                        return f->data_count();
+                    }
+                    if (consumer.closed()) return 0;
+                }
+            },
+            [&] { producer.close(); });
+        finish(r);
+        log_result(r);
+        auto j = result_to_json(r);
+        if (pipe_transport > 0.0 && r.transport_ns_per_sample > 0.0) {
+            j["transport_vs_pipe"] = pipe_transport / r.transport_ns_per_sample;
+            spdlog::info("  shm transport uses {:.1f}x less CPU per sample than pipe",
+                         pipe_transport / r.transport_ns_per_sample);
+        }
+        results.push_back(j);
+    } catch (const std::exception& e) {
+        spdlog::warn("  shm: {}, skipping", e.what());
+    }
+
+    // --- shm fan-out: one payload write for 1..3 readers ---
+    try {
+        for (uint32_t n = 1; n <= 3; ++n) {
+            results.push_back(bench_fanout(source, channels, n, duration_seconds));
+        }
+    } catch (const std::exception& e) {
+        spdlog::warn("  shm fan-out: {}, skipping", e.what());
+    }
+#endif
+    return results;
+}
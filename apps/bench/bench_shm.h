@@ -0,0 +1,17 @@
+#pragma once
+
+#include <nlohmann/json.hpp>
+
+#include <cstdint>
+
+// BM-M: Transport CPU cost, pipe vs shared memory.
+// A producer thread sends 16384-sample blocks as fast as the consumer takes
+// them, the way grebe-sg's sender does (copy out of the source ring, then
+// transport); a consumer thread receives them as grebe-viewer's source stage
+// does (pipe: read + pooled frame; shm: Borrowed frame, no copy).
+// Reports throughput and CPU time per sample on each side, and the transport
+// share of it (minus a copy-only baseline of the producer's source copy).
+// Fan-out: the shm producer's CPU per sample with 1, 2 and 3 readers
+// attached (one of them slow and lossy), which should stay flat.
+// Returns JSON array of per-transport results (empty on Windows).
+nlohmann::json run_bench_shm(int duration_seconds, uint32_t channels);
@@ -1,6 +1,8 @@
 #include "bench_udp.h"
 #include "ipc/udp_transport.h"
 #include "ipc/contracts.h"
+#include "stages/transport_rx_stage.h"
+#include "grebe/alloc_tracker.h"
 
 #include <spdlog/spdlog.h>
 
@@ -30,6 +32,11 @@ struct UdpBenchResult {
     double throughput_msps  = 0.0;
     double throughput_mbps  = 0.0;
     double drop_rate        = 0.0;
+    uint64_t reassembly_drops = 0;  // fragmented frames that never completed
+    uint64_t copied_frames    = 0;  // unfragmented frames not received in place
+    uint64_t lost_frames      = 0;  // sequences the reorder window gave up on
+    uint64_t reordered_frames = 0;
+    double rx_allocs_per_frame = 0.0;  // receiver heap allocations per frame
 };
 
 uint32_t max_block_size(uint32_t channels, size_t max_datagram) {
@@ -82,16 +89,22 @@ UdpBenchResult bench_udp_scenario(const std::string& label,
     std::atomic<uint64_t> recv_frames{0};
     std::atomic<uint64_t> recv_bytes{0};
     std::atomic<bool> sender_done{false};
+    uint64_t rx_allocs = 0;
 
     // Receiver thread: receive_frame() blocks internally (loops on timeout),
     // only returns false when consumer.close() sets the closed_ flag.
+    // Builds a pooled Frame per datagram frame, as TransportRxStage does.
     std::thread receiver([&] {
         FrameHeaderV2 hdr;
         std::vector<int16_t> buf;
+        const uint64_t allocs0 = grebe::thread_heap_counters().allocations;
         while (consumer.receive_frame(hdr, buf)) {
+            grebe::Frame frame = make_rx_frame(hdr, buf);
             recv_frames.fetch_add(1, std::memory_order_relaxed);
-            recv_bytes.fetch_add(sizeof(hdr) + hdr.payload_bytes, std::memory_order_relaxed);
+            recv_bytes.fetch_add(sizeof(hdr) + frame.data_count() * sizeof(int16_t),
+                                 std::memory_order_relaxed);
         }
+        rx_allocs = grebe::thread_heap_counters().allocations - allocs0;
     });
 
     // Sender: runs on main thread for duration_s seconds
@@ -148,6 +161,11 @@ UdpBenchResult bench_udp_scenario(const std::string& label,
     result.throughput_msps = (received * block_size) / elapsed / 1e6;
     result.throughput_mbps = (received * payload_bytes) / elapsed / (1024.0 * 1024.0);
     result.drop_rate = sent > 0 ? static_cast<double>(sent - received) / sent : 0.0;
+    result.reassembly_drops = consumer.reassembly_drops();
+    result.copied_frames = consumer.copied_frames();
+    result.lost_frames = consumer.lost_frames();
+    result.reordered_frames = consumer.reordered_frames();
+    result.rx_allocs_per_frame = received > 0 ? static_cast<double>(rx_allocs) / received : 0.0;
 
     return result;
 }
@@ -167,6 +185,11 @@ nlohmann::json result_to_json(const UdpBenchResult& r) {
     j["throughput_msps"] = r.throughput_msps;
     j["throughput_mbps"] = r.throughput_mbps;
     j["drop_rate"]       = r.drop_rate;
+    j["reassembly_drops"] = r.reassembly_drops;
+    j["copied_frames"]   = r.copied_frames;
+    j["lost_frames"]     = r.lost_frames;
+    j["reordered_frames"] = r.reordered_frames;
+    j["rx_allocs_per_frame"] = r.rx_allocs_per_frame;
     return j;
 }
 
@@ -190,6 +213,7 @@ nlohmann::json run_bench_udp(int duration_seconds, uint32_t channels,
     if (channels == 1) {
         block_scenarios = {
             {"1ch_max",  1, 0},
+            {"1ch_16384", 1, 16384},  // grebe-sg default block, fragmented
             {"1ch_256",  1, 256},
             {"1ch_64",   1, 64},
             {"2ch_max",  2, 0},
@@ -200,6 +224,7 @@ nlohmann::json run_bench_udp(int duration_seconds, uint32_t channels,
         std::string prefix = std::to_string(channels) + "ch";
         block_scenarios = {
             {prefix + "_max",  channels, 0},
+            {prefix + "_16384", channels, 16384},
             {prefix + "_256",  channels, 256},
             {prefix + "_64",   channels, 64},
         };
@@ -208,17 +233,15 @@ nlohmann::json run_bench_udp(int duration_seconds, uint32_t channels,
     spdlog::info("--- Block size variation (unlimited rate, burst={}) ---", burst_size);
     for (auto& s : block_scenarios) {
         uint32_t bs = s.block_size > 0 ? s.block_size : max_block_size(s.channels, max_datagram_size);
-        // Skip scenarios where the fixed block_size exceeds datagram capacity
-        if (s.block_size > 0 && s.block_size > max_block_size(s.channels, max_datagram_size)) {
-            spdlog::info("  Skipping: {} ({}ch x {} samples > datagram limit {})",
-                         s.label, s.channels, s.block_size, max_block_size(s.channels, max_datagram_size));
-            continue;
-        }
-        spdlog::info("  Running: {} ({}ch x {} samples, unlimited)...", s.label, s.channels, bs);
+        // Blocks over the datagram limit go out as fragments
+        const bool fragmented = bs > max_block_size(s.channels, max_datagram_size);
+        spdlog::info("  Running: {} ({}ch x {} samples, unlimited{})...", s.label, s.channels, bs,
+                     fragmented ? ", fragmented" : "");
         auto r = bench_udp_scenario(s.label, s.channels, bs, 0.0, duration_seconds,
                                     BENCH_PORT, max_datagram_size, burst_size);
-        spdlog::info("    => {:.1f} MSPS, {:.0f} frames/s, drop {:.2f}%",
-                      r.throughput_msps, r.frames_per_sec, r.drop_rate * 100);
+        spdlog::info("    => {:.1f} MSPS, {:.0f} frames/s, drop {:.2f}%, copied {}, rx allocs/frame {:.3f}",
+                      r.throughput_msps, r.frames_per_sec, r.drop_rate * 100,
+                      r.copied_frames, r.rx_allocs_per_frame);
         results.push_back(result_to_json(r));
     }
 
@@ -5,7 +5,10 @@
 // BM-H: UDP loopback throughput benchmark.
 // Measures UdpProducer → UdpConsumer throughput on 127.0.0.1.
 // channels: number of channels for rate scenarios (1-8).
-// max_datagram_size: max bytes per UDP datagram (default 1400 for WSL2 safety).
+// max_datagram_size: max bytes per UDP datagram (default 1400 for WSL2 safety);
+// larger blocks are fragmented and reassembled.
+// The receiver builds pooled Frames (make_rx_frame) and reports heap
+// allocations per frame and frames not received in place.
 // burst_size: sendmmsg/recvmmsg batch size (1 = no batching, Linux only).
 // Returns JSON array of per-scenario results.
 nlohmann::json run_bench_udp(int duration_seconds, uint32_t channels = 1,
@@ -1,11 +1,20 @@
 // grebe-bench: Performance benchmark suite
-// Usage: grebe-bench [--udp] [--duration=N] [--help]
+// Usage: grebe-bench [--udp] [--queue] [--executor] [--latency] [--replay] [--shm] [--duration=N]
+//                    [--fail-on-alloc] [--help]
 
 #include "bench_udp.h"
+#include "bench_queue.h"
+#include "bench_executor.h"
+#include "bench_latency.h"
+#include "bench_replay.h"
+#include "bench_shm.h"
+
+#include "grebe/alloc_tracker.h"
 
 #include <nlohmann/json.hpp>
 #include <spdlog/spdlog.h>
 
+#include <algorithm>
 #include <chrono>
 #include <ctime>
 #include <filesystem>
@@ -19,11 +28,19 @@ namespace {
 
 struct BenchOptions {
     bool run_udp      = false;
+    bool run_queue    = false;
+    bool run_executor = false;
+    bool run_latency  = false;
+    bool run_replay   = false;
+    bool run_shm      = false;
     bool run_all      = false;
     int  duration     = 5;
     uint32_t channels = 1;        // channel count for rate scenarios
     size_t datagram_size = 1400;  // max UDP datagram bytes
     uint32_t burst_size = 1;     // sendmmsg/recvmmsg batch size (1 = no batching)
+    size_t queue_capacity = 64;  // queue capacity for BM-I
+    size_t pool_threads = 0;     // WorkStealing pool size for BM-J (0 = auto)
+    bool fail_on_alloc = false;  // exit 1 if any steady-state heap allocation
     std::string json_path;  // empty = auto-generate
 };
 
@@ -34,10 +51,19 @@ void print_help(const char* argv0) {
         "Options:\n"
         "  --all          Run all benchmarks (default if no category specified)\n"
         "  --udp          UDP loopback throughput (BM-H)\n"
+        "  --queue        Inter-stage queue throughput, mutex vs lock-free (BM-I)\n"
+        "  --executor     Runtime executor scaling, thread-per-stage vs work-stealing (BM-J)\n"
+        "  --latency      End-to-end producer-to-display latency per transport (BM-K)\n"
+        "  --replay       Sustainable pipeline rate with a virtual-clock source (BM-L)\n"
+        "  --shm          Transport CPU cost per sample, pipe vs shared memory (BM-M)\n"
         "  --channels=N       Channel count for rate scenarios (default: 1, max: 8)\n"
         "  --duration=N       Duration in seconds for transport benchmarks (default: 5)\n"
         "  --datagram-size=N  Max UDP datagram bytes (default: 1400, max: 65000)\n"
         "  --udp-burst=N      sendmmsg/recvmmsg batch size (default: 1 = no batching, Linux only)\n"
+        "  --queue-capacity=N Queue capacity in frames for BM-I (default: 64)\n"
+        "  --pool-threads=N   Work-stealing pool size for BM-J (default: 0 = hardware concurrency)\n"
+        "  --fail-on-alloc    Exit with status 1 if a runtime stage allocates heap memory\n"
+        "                     after warm-up (BM-J saturated/paced)\n"
         "  --json=PATH        Output JSON path (default: ./tmp/bench_<ts>.json)\n"
         "  --help             Show this help\n",
         argv0);
@@ -51,6 +77,16 @@ BenchOptions parse_args(int argc, char* argv[]) {
             opts.run_all = true;
         } else if (arg == "--udp") {
             opts.run_udp = true;
+        } else if (arg == "--queue") {
+            opts.run_queue = true;
+        } else if (arg == "--executor") {
+            opts.run_executor = true;
+        } else if (arg == "--latency") {
+            opts.run_latency = true;
+        } else if (arg == "--replay") {
+            opts.run_replay = true;
+        } else if (arg == "--shm") {
+            opts.run_shm = true;
         } else if (arg.rfind("--channels=", 0) == 0) {
             opts.channels = static_cast<uint32_t>(std::stoi(arg.substr(11)));
             if (opts.channels < 1) opts.channels = 1;
@@ -65,6 +101,13 @@ BenchOptions parse_args(int argc, char* argv[]) {
             opts.burst_size = static_cast<uint32_t>(std::stoi(arg.substr(12)));
             if (opts.burst_size < 1) opts.burst_size = 1;
             if (opts.burst_size > 256) opts.burst_size = 256;
+        } else if (arg.rfind("--queue-capacity=", 0) == 0) {
+            opts.queue_capacity = static_cast<size_t>(std::stoi(arg.substr(17)));
+            if (opts.queue_capacity < 1) opts.queue_capacity = 1;
+        } else if (arg.rfind("--pool-threads=", 0) == 0) {
+            opts.pool_threads = static_cast<size_t>(std::max(0, std::stoi(arg.substr(15))));
+        } else if (arg == "--fail-on-alloc") {
+            opts.fail_on_alloc = true;
         } else if (arg.rfind("--json=", 0) == 0) {
             opts.json_path = arg.substr(7);
         } else if (arg == "--help" || arg == "-h") {
@@ -75,12 +118,31 @@ BenchOptions parse_args(int argc, char* argv[]) {
         }
     }
     // Default: run all if no category specified
-    if (!opts.run_udp) {
+    if (!opts.run_udp && !opts.run_queue && !opts.run_executor && !opts.run_latency &&
+        !opts.run_replay && !opts.run_shm) {
         opts.run_all = true;
     }
     return opts;
 }
 
+/// Results reporting steady-state heap allocations (steady_heap_allocs > 0).
+size_t count_steady_alloc_failures(const nlohmann::json& report) {
+    size_t failures = 0;
+    for (const auto& [bench, results] : report.items()) {
+        if (!results.is_array()) continue;
+        for (const auto& r : results) {
+            if (r.is_object() && r.value("steady_heap_allocs", uint64_t{0}) > 0) {
+                spdlog::error("{}: {} allocates in steady state ({} allocs, most in {})",
+                              bench, r.value("label", std::string("?")),
+                              r["steady_heap_allocs"].get<uint64_t>(),
+                              r.value("steady_alloc_stage", std::string("?")));
+                ++failures;
+            }
+        }
+    }
+    return failures;
+}
+
 std::string make_timestamp() {
     auto now = std::chrono::system_clock::now();
     auto t = std::chrono::system_clock::to_time_t(now);
@@ -124,6 +186,7 @@ int main(int argc, char* argv[]) {
 #else
     report["platform"] = "linux";
 #endif
+    report["alloc_hooks"] = grebe::alloc_hooks_installed();
 
     // --- BM-H: UDP loopback ---
     if (opts.run_udp || opts.run_all) {
@@ -131,6 +194,31 @@ int main(int argc, char* argv[]) {
                                                      opts.datagram_size, opts.burst_size);
     }
 
+    // --- BM-I: Queue throughput ---
+    if (opts.run_queue || opts.run_all) {
+        report["bm_i_queue"] = run_bench_queue(opts.duration, opts.queue_capacity);
+    }
+
+    // --- BM-J: Executor scaling ---
+    if (opts.run_executor || opts.run_all) {
+        report["bm_j_executor"] = run_bench_executor(opts.duration, opts.pool_threads);
+    }
+
+    // --- BM-K: End-to-end latency ---
+    if (opts.run_latency || opts.run_all) {
+        report["bm_k_latency"] = run_bench_latency(opts.duration);
+    }
+
+    // --- BM-L: Sustainable rate (virtual clock) ---
+    if (opts.run_replay || opts.run_all) {
+        report["bm_l_replay"] = run_bench_replay(opts.duration, opts.channels);
+    }
+
+    // --- BM-M: Transport CPU cost (pipe vs shm) ---
+    if (opts.run_shm || opts.run_all) {
+        report["bm_m_shm"] = run_bench_shm(opts.duration, opts.channels);
+    }
+
     // --- Write JSON report ---
     std::string json_path = opts.json_path;
     if (json_path.empty()) {
@@ -150,5 +238,16 @@ int main(int argc, char* argv[]) {
     // --- Summary ---
     spdlog::info("=== grebe-bench complete ===");
 
+    if (opts.fail_on_alloc) {
+        if (!grebe::alloc_hooks_installed()) {
+            spdlog::error("--fail-on-alloc: built without allocation hooks");
+            return 1;
+        }
+        if (size_t failures = count_steady_alloc_failures(report)) {
+            spdlog::error("--fail-on-alloc: {} scenario(s) allocate in steady state", failures);
+            return 1;
+        }
+    }
+
     return 0;
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <cstdint>
 
 // =========================================================================
@@ -8,6 +9,9 @@
 // Sent by grebe-sg (producer) for each block of sample data.
 // Layout: [FrameHeaderV2][ch0 int16_t[block_length_samples]][ch1 ...][...]
 // Payload is channel-major: all samples for ch0, then ch1, etc.
+// header_bytes identifies the layout revision: receivers drop frames whose
+// header_bytes differs from sizeof(FrameHeaderV2) (a grebe-sg from another
+// build) instead of misparsing the stream.
 
 constexpr uint32_t FRAME_HEADER_MAGIC = 0x32484647;  // 'GFH2' little-endian
 
@@ -23,6 +27,28 @@ struct FrameHeaderV2 {
     double   sample_rate_hz     = 0.0;  // current sample rate (grebe-sg authoritative)
     uint64_t sg_drops_total     = 0;    // cumulative SG-side ring buffer drops
     uint64_t first_sample_index = 0;    // absolute sample index of first sample (per channel)
+    uint32_t flags              = 0;    // grebe::Frame::flags bits (kFrameVirtualClock); since 72-byte header
+    uint32_t reserved           = 0;
+};
+static_assert(sizeof(FrameHeaderV2) == 72, "wire layout: receivers check header_bytes");
+
+// =========================================================================
+// UDP Fragment Header
+// =========================================================================
+// A frame larger than the UDP datagram limit is split into fragments; each
+// datagram carries [UdpFragmentHeader][bytes of (FrameHeaderV2 + payload)
+// starting at fragment_offset]. Frames that fit in one datagram are sent
+// unfragmented, FrameHeaderV2 first; the magic tells the two apart.
+
+constexpr uint32_t UDP_FRAGMENT_MAGIC = 0x31465547;  // 'GUF1' little-endian
+
+struct UdpFragmentHeader {
+    uint32_t magic           = UDP_FRAGMENT_MAGIC;
+    uint16_t fragment_index  = 0;
+    uint16_t fragment_count  = 0;
+    uint64_t sequence        = 0;  // FrameHeaderV2::sequence of the whole frame
+    uint32_t frame_bytes     = 0;  // sizeof(FrameHeaderV2) + payload_bytes
+    uint32_t fragment_offset = 0;  // byte offset of this fragment within the frame
 };
 
 // =========================================================================
@@ -37,9 +63,18 @@ struct IpcCommand {
         SET_SAMPLE_RATE = 1,
         TOGGLE_PAUSED   = 2,
         QUIT            = 3,
+        SET_BLOCK_SIZE  = 4,  // flow control: samples/channel per frame (0 = sender default)
     };
 
     uint32_t magic  = IPC_COMMAND_MAGIC;
     uint32_t type   = 0;
-    double   value  = 0.0;  // used by SET_SAMPLE_RATE; 0 otherwise
+    double   value  = 0.0;  // used by SET_SAMPLE_RATE / SET_BLOCK_SIZE; 0 otherwise
 };
+
+/// Block size for a SET_BLOCK_SIZE @p value: clamped to [64, max_block], or
+/// the producer's configured @p default_block for 0 (flow control restarting).
+inline uint32_t block_size_for_request(double value, uint32_t default_block,
+                                       uint32_t max_block) {
+    if (!(value > 0.0)) return default_block;
+    return static_cast<uint32_t>(std::clamp(value, 64.0, static_cast<double>(max_block)));
+}
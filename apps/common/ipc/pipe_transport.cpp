@@ -10,6 +10,7 @@
 #else
 #include <cerrno>
 #include <cstring>
+#include <fcntl.h>
 #include <poll.h>
 #include <sys/uio.h>
 #include <unistd.h>
@@ -72,6 +73,12 @@ PipeProducer::PipeProducer()
 }
 #endif
 
+PipeProducer::PipeProducer(int write_fd, int read_fd)
+    : write_fd_(write_fd)
+    , read_fd_(read_fd)
+{
+}
+
 bool PipeProducer::send_frame(const FrameHeaderV2& header, const void* payload) {
 #ifndef _WIN32
     // Use writev to send header+payload in a single syscall
@@ -178,6 +185,11 @@ bool PipeConsumer::receive_frame(FrameHeaderV2& header, std::vector<int16_t>& pa
         spdlog::warn("PipeConsumer: invalid frame magic 0x{:08x}", header.magic);
         return false;
     }
+    if (header.header_bytes != sizeof(FrameHeaderV2)) {
+        spdlog::warn("PipeConsumer: {}-byte frame header, expected {} (grebe-sg from another build?)",
+                     header.header_bytes, sizeof(FrameHeaderV2));
+        return false;
+    }
 
     if (header.payload_bytes > 0) {
         payload.resize(header.payload_bytes / sizeof(int16_t));
@@ -191,3 +203,75 @@ bool PipeConsumer::receive_frame(FrameHeaderV2& header, std::vector<int16_t>& pa
 bool PipeConsumer::send_command(const IpcCommand& cmd) {
     return write_all(write_fd_, &cmd, sizeof(cmd));
 }
+
+#ifndef _WIN32
+ITransportConsumer::RecvStatus PipeConsumer::try_receive_frame(FrameHeaderV2& header,
+                                                               std::vector<int16_t>& payload) {
+    if (!nonblocking_) {
+        const int flags = fcntl(read_fd_, F_GETFL);
+        if (flags < 0 || fcntl(read_fd_, F_SETFL, flags | O_NONBLOCK) < 0) {
+            spdlog::warn("PipeConsumer: cannot set O_NONBLOCK: {}", std::strerror(errno));
+            return RecvStatus::Closed;
+        }
+        nonblocking_ = true;
+    }
+
+    for (;;) {
+        // Header first, then the payload it announces
+        char* dst;
+        size_t want;
+        if (rx_bytes_ < sizeof(rx_header_)) {
+            dst = reinterpret_cast<char*>(&rx_header_) + rx_bytes_;
+            want = sizeof(rx_header_) - rx_bytes_;
+        } else {
+            const size_t got = rx_bytes_ - sizeof(rx_header_);
+            if (got == rx_header_.payload_bytes) {
+                header = rx_header_;
+                rx_bytes_ = 0;
+                return RecvStatus::Frame;
+            }
+            dst = reinterpret_cast<char*>(payload.data()) + got;
+            want = rx_header_.payload_bytes - got;
+        }
+
+        const ssize_t n = ::read(read_fd_, dst, want);
+        if (n == 0) return RecvStatus::Closed;
+        if (n < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) return RecvStatus::WouldBlock;
+            if (errno == EINTR) continue;
+            return RecvStatus::Closed;
+        }
+        rx_bytes_ += static_cast<size_t>(n);
+
+        if (rx_bytes_ == sizeof(rx_header_)) {
+            if (rx_header_.magic != FRAME_HEADER_MAGIC) {
+                spdlog::warn("PipeConsumer: invalid frame magic 0x{:08x}", rx_header_.magic);
+                return RecvStatus::Closed;
+            }
+            if (rx_header_.header_bytes != sizeof(FrameHeaderV2)) {
+                spdlog::warn("PipeConsumer: {}-byte frame header, expected {} (grebe-sg from another build?)",
+                             rx_header_.header_bytes, sizeof(FrameHeaderV2));
+                return RecvStatus::Closed;
+            }
+            if (rx_header_.payload_bytes % sizeof(int16_t) != 0) {
+                spdlog::warn("PipeConsumer: odd payload size {}", rx_header_.payload_bytes);
+                return RecvStatus::Closed;
+            }
+            payload.resize(rx_header_.payload_bytes / sizeof(int16_t));
+        }
+    }
+}
+
+int PipeConsumer::poll_fd() const {
+    return read_fd_;
+}
+#else
+ITransportConsumer::RecvStatus PipeConsumer::try_receive_frame(FrameHeaderV2& /*header*/,
+                                                               std::vector<int16_t>& /*payload*/) {
+    return RecvStatus::Closed;  // anonymous pipes have no readiness wait on Windows
+}
+
+int PipeConsumer::poll_fd() const {
+    return -1;
+}
+#endif
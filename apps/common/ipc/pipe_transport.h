@@ -2,19 +2,23 @@
 
 #include "transport.h"
 
+#include <cstddef>
+
 // Pipe-based transport producer (used by grebe-sg).
 // Writes frames to stdout (fd 1), reads commands from stdin (fd 0).
 class PipeProducer : public ITransportProducer {
 public:
     PipeProducer();
+    // Explicit fds (not owned), e.g. an in-process pipe() pair for benchmarks.
+    PipeProducer(int write_fd, int read_fd);
     ~PipeProducer() override = default;
 
     bool send_frame(const FrameHeaderV2& header, const void* payload) override;
     bool receive_command(IpcCommand& cmd) override;
 
 private:
-    int write_fd_;  // stdout
-    int read_fd_;   // stdin
+    int write_fd_;  // stdout by default
+    int read_fd_;   // stdin by default
 };
 
 // Pipe-based transport consumer (used by grebe).
@@ -28,7 +32,16 @@ public:
     bool receive_frame(FrameHeaderV2& header, std::vector<int16_t>& payload) override;
     bool send_command(const IpcCommand& cmd) override;
 
+    // Switches read_fd to O_NONBLOCK on first use (POSIX only).
+    RecvStatus try_receive_frame(FrameHeaderV2& header, std::vector<int16_t>& payload) override;
+    int poll_fd() const override;
+
 private:
     int read_fd_;
     int write_fd_;
+
+    // try_receive_frame(): frame being assembled from partial reads
+    FrameHeaderV2 rx_header_{};
+    size_t rx_bytes_ = 0;  // header + payload bytes read so far
+    bool nonblocking_ = false;
 };
@@ -0,0 +1,296 @@
+#include "shm_transport.h"
+
+#include "grebe/frame.h"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr auto kOpenRetryInterval = std::chrono::milliseconds(20);
+constexpr auto kReceivePoll       = std::chrono::milliseconds(100);
+
+FrameHeaderV2 header_from_frame(const grebe::Frame& f) {
+    FrameHeaderV2 h{};
+    h.sequence             = f.sequence;
+    h.producer_ts_ns       = f.producer_ts_ns;
+    h.channel_count        = f.channel_count;
+    h.block_length_samples = f.samples_per_channel;
+    h.payload_bytes        = static_cast<uint32_t>(f.data_count() * sizeof(int16_t));
+    h.sample_rate_hz       = f.sample_rate_hz;
+    h.first_sample_index   = f.first_sample_index;
+    h.flags                = f.flags;
+    return h;
+}
+
+void close_command_fd(int fd) {
+    if (fd < 0) return;
+#ifdef _WIN32
+    _close(fd);
+#else
+    ::close(fd);
+#endif
+}
+
+} // namespace
+
+// =========================================================================
+// ShmProducer (grebe-sg side)
+// =========================================================================
+
+ShmProducer::ShmProducer(const std::string& name, const grebe::ShmQueueConfig& config)
+    : queue_(grebe::ShmQueue::create(name, config)) {}
+
+ShmProducer::ShmProducer(const std::string& name, const grebe::ShmQueueConfig& config,
+                         int cmd_read_fd)
+    : queue_(grebe::ShmQueue::create(name, config))
+    , commands_(-1, cmd_read_fd) {}
+
+ShmProducer::ShmProducer(const std::string& socket_path, const grebe::ShmSessionLimits& limits,
+                         int cmd_read_fd)
+    : commands_(-1, cmd_read_fd)
+    , sessions_(std::make_unique<grebe::ShmSessionServer>(socket_path, limits)) {}
+
+ShmProducer::~ShmProducer() {
+    if (slot_) queue_->cancel(slot_);
+}
+
+bool ShmProducer::keep_sending() const {
+    if (closed_.load(std::memory_order_acquire)) return false;
+    // Session mode outlives any one session; a named queue ends with its shutdown
+    return sessions_ || (queue_ && !queue_->is_shutdown());
+}
+
+bool ShmProducer::send_frame(const FrameHeaderV2& header, const void* payload) {
+    const size_t samples = header.payload_bytes / sizeof(int16_t);
+    int16_t* dst = acquire_payload(samples);
+    // No slot: dropped (no session yet, too large, DropLatest) unless closed
+    if (!dst) return keep_sending();
+    if (samples > 0 && payload) {
+        std::memcpy(dst, payload, header.payload_bytes);
+    }
+    return publish(header);
+}
+
+bool ShmProducer::receive_command(IpcCommand& cmd) {
+    poll_sessions();
+    {
+        // Polled even while no frames flow: keeps the producer heartbeat moving
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (queue_) queue_->heartbeat();
+    }
+    return commands_.receive_command(cmd);
+}
+
+void ShmProducer::poll_sessions(std::chrono::milliseconds timeout) {
+    if (!sessions_ || closed_.load(std::memory_order_acquire)) return;
+    // Held across the handshake: the session in progress (the newest one)
+    // must not be swapped out while a consumer is told to join it
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto queue = sessions_->accept(timeout, pending_ ? pending_.get() : queue_.get());
+    if (!queue) return;
+
+    if (pending_) pending_->shutdown();
+    pending_ = std::move(queue);
+    has_pending_.store(true, std::memory_order_release);
+    // The old session has no consumer left: release a sender waiting on it
+    if (queue_) queue_->shutdown();
+}
+
+void ShmProducer::adopt_pending_session() {
+    std::unique_ptr<grebe::ShmQueue> old;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        old = std::move(queue_);
+        queue_ = std::move(pending_);
+        has_pending_.store(false, std::memory_order_relaxed);
+    }
+    if (queue_) {
+        spdlog::info("ShmProducer: session started ({} slots x {} samples)",
+                     queue_->slot_count(), queue_->slot_samples());
+    }
+}
+
+int16_t* ShmProducer::acquire_payload(size_t samples) {
+    if (slot_) queue_->cancel(slot_);
+    slot_ = {};
+    if (has_pending_.load(std::memory_order_acquire)) adopt_pending_session();
+    if (!queue_) return nullptr;
+    slot_ = queue_->reserve(samples);
+    return slot_.data;
+}
+
+bool ShmProducer::commit_frame(const FrameHeaderV2& header) {
+    if (!slot_) return false;
+    return publish(header);
+}
+
+bool ShmProducer::publish(const FrameHeaderV2& header) {
+    grebe::Frame meta = grebe::Frame::make_borrowed(slot_.data, 0);
+    meta.sequence            = header.sequence;
+    meta.producer_ts_ns      = header.producer_ts_ns;
+    meta.channel_count       = header.channel_count;
+    meta.samples_per_channel = header.block_length_samples;
+    meta.sample_rate_hz      = header.sample_rate_hz;
+    meta.first_sample_index  = header.first_sample_index;
+    meta.flags               = header.flags;
+
+    queue_->set_source_drops(header.sg_drops_total);
+    const grebe::ShmSlot slot = slot_;
+    slot_ = {};
+    // A frame too large for the slot is counted as a queue drop, not an error
+    return queue_->publish(slot, meta) || keep_sending();
+}
+
+void ShmProducer::close() {
+    closed_.store(true, std::memory_order_release);
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (queue_) queue_->shutdown();
+    if (pending_) pending_->shutdown();
+}
+
+// =========================================================================
+// ShmConsumer (grebe-viewer side)
+// =========================================================================
+
+ShmConsumer::ShmConsumer(const std::string& name, int cmd_write_fd,
+                         std::chrono::milliseconds timeout,
+                         const grebe::ShmConsumerOptions& options)
+    : cmd_fd_(cmd_write_fd) {
+    // The producer creates the queue after it starts: retry until it is there
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    for (;;) {
+        try {
+            queue_ = grebe::ShmQueue::open(name, options);
+            break;
+        } catch (const std::exception& e) {
+            if (std::chrono::steady_clock::now() >= deadline) {
+                close_command_fd(cmd_fd_);
+                throw std::runtime_error(std::string("ShmConsumer: ") + e.what());
+            }
+            std::this_thread::sleep_for(kOpenRetryInterval);
+        }
+    }
+    spdlog::info("ShmConsumer: attached to {} ({} slots x {} samples)",
+                 queue_->region().name(), queue_->slot_count(), queue_->slot_samples());
+}
+
+ShmConsumer::ShmConsumer(const Session& session, int cmd_write_fd,
+                         std::chrono::milliseconds timeout)
+    : cmd_fd_(cmd_write_fd)
+    , session_(session) {
+    try {
+        queue_ = connect_session(timeout);
+    } catch (...) {
+        close_command_fd(cmd_fd_);
+        throw;
+    }
+    spdlog::info("ShmConsumer: session on {} ({} ch, {} slots x {} samples)",
+                 session.socket_path, granted_.channels, granted_.slot_count,
+                 granted_.slot_samples);
+}
+
+ShmConsumer::~ShmConsumer() {
+    close_command_fd(cmd_fd_);
+    cmd_fd_ = -1;
+}
+
+std::unique_ptr<grebe::ShmQueue> ShmConsumer::connect_session(std::chrono::milliseconds timeout) {
+    // The producer may still be starting, or busy detaching a dead consumer
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    for (;;) {
+        try {
+            return grebe::shm_session_connect(session_->socket_path, session_->geometry,
+                                              &granted_, session_->options);
+        } catch (const std::exception& e) {
+            if (std::chrono::steady_clock::now() >= deadline) {
+                throw std::runtime_error(std::string("ShmConsumer: ") + e.what());
+            }
+            std::this_thread::sleep_for(kOpenRetryInterval);
+        }
+    }
+}
+
+bool ShmConsumer::reconnect(std::chrono::milliseconds timeout) {
+    if (!session_) return false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (closed_locally_) return false;
+    }
+    std::unique_ptr<grebe::ShmQueue> queue;
+    try {
+        queue = connect_session(timeout);
+    } catch (const std::exception& e) {
+        spdlog::info("{}", e.what());
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (closed_locally_) return false;
+    // Frames of the old session may still be in the pipeline: keep its
+    // mapping until they are gone
+    retired_.push_back(std::move(queue_));
+    queue_ = std::move(queue);
+    retired_.erase(std::remove_if(retired_.begin(), retired_.end(),
+                                  [](const auto& q) { return q->slots_borrowed() == 0; }),
+                   retired_.end());
+    spdlog::info("ShmConsumer: new session on {} ({} slots x {} samples)",
+                 session_->socket_path, granted_.slot_count, granted_.slot_samples);
+    return true;
+}
+
+std::optional<grebe::Frame> ShmConsumer::receive(std::chrono::nanoseconds timeout) {
+    auto f = queue_->dequeue_wait(timeout);
+    if (f) sg_drops_.store(queue_->source_drops(), std::memory_order_relaxed);
+    return f;
+}
+
+bool ShmConsumer::closed() const {
+    return queue_->is_shutdown() && queue_->empty();
+}
+
+void ShmConsumer::close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    closed_locally_ = true;
+    queue_->shutdown();
+}
+
+bool ShmConsumer::receive_frame(FrameHeaderV2& header, std::vector<int16_t>& payload) {
+    for (;;) {
+        if (auto f = queue_->dequeue_wait(kReceivePoll)) {
+            header = header_from_frame(*f);
+            header.sg_drops_total = queue_->source_drops();
+            sg_drops_.store(header.sg_drops_total, std::memory_order_relaxed);
+            payload.assign(f->data(), f->data() + f->data_count());
+            return true;
+        }
+        if (closed()) return false;
+    }
+}
+
+bool ShmConsumer::send_command(const IpcCommand& cmd) {
+    if (cmd_fd_ < 0) return false;
+    const char* p = reinterpret_cast<const char*>(&cmd);
+    size_t len = sizeof(cmd);
+    while (len > 0) {
+#ifdef _WIN32
+        int n = _write(cmd_fd_, p, static_cast<unsigned int>(len));
+#else
+        ssize_t n = ::write(cmd_fd_, p, len);
+#endif
+        if (n <= 0) return false;
+        p += n;
+        len -= static_cast<size_t>(n);
+    }
+    return true;
+}
@@ -0,0 +1,144 @@
+#pragma once
+
+#include "transport.h"
+#include "pipe_transport.h"
+#include "shm/shm_queue.h"
+#include "shm/shm_session.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+// Shared-memory transport producer (used by grebe-sg, --transport=shm).
+// Frames go through a grebe::ShmQueue created by the producer; commands
+// still arrive on a pipe (stdin by default), as in pipe mode.
+// acquire_payload() / commit_frame() hand out a shared payload slot, so the
+// sender writes samples straight into memory the consumer reads.
+//
+// Session mode (POSIX): no named object; each consumer connects to a Unix
+// socket and receives its own sealed memfd queue (grebe::ShmSessionServer).
+// Sessions are accepted from receive_command() (the command thread) and
+// picked up by the sender at its next frame; a new session replaces one
+// whose consumers are all gone. While a session is in progress, further
+// consumers join it, up to limits.defaults.max_consumers (fan-out: every
+// frame is written once and read by all of them). Until the first session,
+// frames are discarded.
+class ShmProducer : public ITransportProducer {
+public:
+    // Create queue @p name (replaces a stale one). Throws std::runtime_error.
+    ShmProducer(const std::string& name, const grebe::ShmQueueConfig& config);
+    // Explicit command fd (not owned), e.g. an in-process pipe() for benchmarks.
+    ShmProducer(const std::string& name, const grebe::ShmQueueConfig& config, int cmd_read_fd);
+    // Session mode: listen on @p socket_path ('@name' = Linux abstract socket).
+    ShmProducer(const std::string& socket_path, const grebe::ShmSessionLimits& limits,
+                int cmd_read_fd = 0);
+    ~ShmProducer() override;
+
+    // Copies the payload into a slot (one copy; prefer acquire/commit).
+    bool send_frame(const FrameHeaderV2& header, const void* payload) override;
+    bool receive_command(IpcCommand& cmd) override;
+
+    // Reserves a slot (waits for the consumer under Block/Credit).
+    int16_t* acquire_payload(size_t samples) override;
+    bool commit_frame(const FrameHeaderV2& header) override;
+
+    // Shut the queue down: the consumer sees end of stream, and a sender
+    // waiting in acquire_payload() / send_frame() returns.
+    void close();
+
+    // Session mode: serve a consumer waiting to connect, if any. Called by
+    // receive_command(); @p timeout 0 = just poll.
+    void poll_sessions(std::chrono::milliseconds timeout = std::chrono::milliseconds(0));
+
+    // Current queue (sender thread only; null in session mode before the
+    // first session).
+    grebe::ShmQueue* queue() { return queue_.get(); }
+
+private:
+    bool publish(const FrameHeaderV2& header);
+    bool keep_sending() const;
+    void adopt_pending_session();
+
+    std::unique_ptr<grebe::ShmQueue> queue_;  // replaced only by the sender, under mutex_
+    PipeProducer commands_;  // read side only
+    grebe::ShmSlot slot_;    // acquired, not yet committed
+
+    std::unique_ptr<grebe::ShmSessionServer> sessions_;
+    std::mutex mutex_;                           // queue_ swap vs. other threads
+    std::unique_ptr<grebe::ShmQueue> pending_;   // accepted, not yet used (mutex_)
+    std::atomic<bool> has_pending_{false};
+    std::atomic<bool> closed_{false};
+};
+
+// Shared-memory transport consumer (used by grebe-viewer, --shm).
+// receive() returns Borrowed frames that point into the shared slot (no
+// copy); receive_frame() copies for ITransportConsumer callers. Commands go
+// to the producer over a pipe.
+class ShmConsumer : public ITransportConsumer {
+public:
+    // Session mode: producer socket and proposed geometry.
+    struct Session {
+        std::string socket_path;
+        grebe::ShmSessionGeometry geometry;
+        grebe::ShmConsumerOptions options;  // this consumer's policy / depth
+    };
+
+    // Map queue @p name, retrying until the producer has created it or
+    // @p timeout expires (then throws std::runtime_error).
+    // cmd_write_fd: owned; -1 = no command channel.
+    ShmConsumer(const std::string& name, int cmd_write_fd,
+                std::chrono::milliseconds timeout = std::chrono::milliseconds(5000),
+                const grebe::ShmConsumerOptions& options = {});
+    // Session mode: handshake with the producer on @p session.socket_path,
+    // retrying until it listens and grants a session or @p timeout expires.
+    ShmConsumer(const Session& session, int cmd_write_fd,
+                std::chrono::milliseconds timeout = std::chrono::milliseconds(5000));
+    ~ShmConsumer() override;
+
+    bool receive_frame(FrameHeaderV2& header, std::vector<int16_t>& payload) override;
+    bool send_command(const IpcCommand& cmd) override;
+
+    // Zero-copy receive: next frame, or nullopt after @p timeout or at end
+    // of stream (see closed()). The frame keeps its slot until destroyed.
+    std::optional<grebe::Frame> receive(std::chrono::nanoseconds timeout);
+
+    // The producer shut the queue down and every queued frame was received.
+    bool closed() const;
+
+    // Stop receiving: the producer no longer delivers to (or waits for)
+    // this consumer; other consumers are not affected.
+    void close();
+
+    // Session mode, after the stream ended (closed()): start a new session
+    // with the producer (same or restarted process), trying for up to
+    // @p timeout. False if it does not listen, in named mode, or after close().
+    // Call from the receiving thread; frames from the old session stay valid.
+    bool reconnect(std::chrono::milliseconds timeout);
+
+    // Producer-side source drops (grebe-sg ring overruns), as of the last
+    // received frame; safe from any thread.
+    uint64_t sg_drops_total() const { return sg_drops_.load(std::memory_order_relaxed); }
+
+    // Granted geometry (session mode; zeros in named mode).
+    const grebe::ShmSessionGeometry& geometry() const { return granted_; }
+
+    grebe::ShmQueue& queue() { return *queue_; }
+
+private:
+    std::unique_ptr<grebe::ShmQueue> connect_session(std::chrono::milliseconds timeout);
+
+    std::unique_ptr<grebe::ShmQueue> queue_;  // replaced only by reconnect(), under mutex_
+    int cmd_fd_;
+
+    std::optional<Session> session_;
+    grebe::ShmSessionGeometry granted_;
+    std::mutex mutex_;                                   // queue_ swap vs. close()
+    bool closed_locally_ = false;                        // mutex_
+    std::vector<std::unique_ptr<grebe::ShmQueue>> retired_;  // frames still borrowed
+    std::atomic<uint64_t> sg_drops_{0};
+};
@@ -2,6 +2,9 @@
 
 #include "contracts.h"
 
+#include <atomic>
+#include <chrono>
+#include <cstddef>
 #include <cstdint>
 #include <vector>
 
@@ -16,6 +19,15 @@ public:
 
     // Non-blocking: check for and receive a command. Returns true if a command was read.
     virtual bool receive_command(IpcCommand& cmd) = 0;
+
+    // Zero-copy send (optional): buffer for the next frame's payload of
+    // @p samples int16_t (channel-major), written in place and sent by
+    // commit_frame(). nullptr = not supported or closed: use send_frame().
+    virtual int16_t* acquire_payload(size_t /*samples*/) { return nullptr; }
+
+    // Send the frame whose payload was written into acquire_payload()'s
+    // buffer. Returns false on close/error.
+    virtual bool commit_frame(const FrameHeaderV2& /*header*/) { return false; }
 };
 
 // Abstract transport consumer (used by grebe).
@@ -27,6 +39,64 @@ public:
     // Blocking: read the next frame. Returns false on pipe close/error.
     virtual bool receive_frame(FrameHeaderV2& header, std::vector<int16_t>& payload) = 0;
 
+    // Outcome of a non-blocking receive.
+    enum class RecvStatus {
+        Frame,       // header/payload hold the next frame
+        WouldBlock,  // nothing complete yet: wait for poll_fd() to become readable
+        Closed,      // pipe close/error
+    };
+
+    // Non-blocking: read the next frame if it can be completed without
+    // waiting. A partially read frame is kept across calls, so pass the same
+    // payload vector until Frame is returned. Once used, do not mix with
+    // receive_frame(). Default: unsupported (Closed).
+    virtual RecvStatus try_receive_frame(FrameHeaderV2& /*header*/,
+                                         std::vector<int16_t>& /*payload*/) {
+        return RecvStatus::Closed;
+    }
+
+    // Fd that becomes readable when try_receive_frame() can make progress
+    // (for a reactor). -1 = non-blocking receive not supported.
+    virtual int poll_fd() const { return -1; }
+
+    // When try_receive_frame() can also make progress without poll_fd()
+    // becoming readable (a frame held back times out); max() = never. A
+    // reactor waits for whichever comes first.
+    virtual std::chrono::steady_clock::time_point receive_deadline() const {
+        return std::chrono::steady_clock::time_point::max();
+    }
+
     // Send a command to the producer. Returns false on pipe close/error.
     virtual bool send_command(const IpcCommand& cmd) = 0;
 };
+
+// Continuity of one received stream: detects the first frame after a gap in
+// sequence or first_sample_index (frames lost or dropped on the way, producer
+// restart), for the receiving stage to flag grebe::kFrameDiscontinuity.
+class RxContinuity {
+public:
+    // True if the frame does not continue the previous one. A zero
+    // first_sample_index (producer without sample indices) is not checked.
+    bool gap(uint64_t sequence, uint64_t first_sample_index, uint32_t samples_per_channel) {
+        const bool gap = started_ &&
+            (sequence != next_sequence_ ||
+             (first_sample_index != 0 && first_sample_index != next_sample_));
+        started_ = true;
+        next_sequence_ = sequence + 1;
+        next_sample_ = first_sample_index + samples_per_channel;
+        if (gap) gaps_.store(gaps_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        return gap;
+    }
+    bool gap(const FrameHeaderV2& header) {
+        return gap(header.sequence, header.first_sample_index, header.block_length_samples);
+    }
+
+    // Discontinuities seen so far; safe from any thread.
+    uint64_t gaps() const { return gaps_.load(std::memory_order_relaxed); }
+
+private:
+    bool started_ = false;
+    uint64_t next_sequence_ = 0;
+    uint64_t next_sample_ = 0;
+    std::atomic<uint64_t> gaps_{0};
+};
@@ -2,6 +2,7 @@
 
 #include <spdlog/spdlog.h>
 
+#include <algorithm>
 #include <cstring>
 
 #ifdef _WIN32
@@ -33,6 +34,36 @@ static void close_socket(int s) {
 }
 #endif
 
+namespace {
+
+/// Bytes [offset, offset + len) of a serialized frame (header, then payload)
+/// as up to two pieces pointing into the caller's buffers.
+struct FrameSlice {
+    const void* ptr[2];
+    size_t len[2];
+    int count = 0;
+};
+
+FrameSlice slice_frame(const FrameHeaderV2& header, const void* payload,
+                       size_t offset, size_t len) {
+    FrameSlice s;
+    const size_t end = offset + len;
+    if (offset < sizeof(header)) {
+        s.ptr[s.count] = reinterpret_cast<const uint8_t*>(&header) + offset;
+        s.len[s.count] = std::min(end, sizeof(header)) - offset;
+        ++s.count;
+    }
+    if (end > sizeof(header)) {
+        const size_t from = std::max(offset, sizeof(header)) - sizeof(header);
+        s.ptr[s.count] = static_cast<const uint8_t*>(payload) + from;
+        s.len[s.count] = end - sizeof(header) - from;
+        ++s.count;
+    }
+    return s;
+}
+
+} // namespace
+
 // =========================================================================
 // UdpProducer (grebe-sg side)
 // =========================================================================
@@ -109,9 +140,7 @@ bool UdpProducer::send_frame(const FrameHeaderV2& header, const void* payload) {
 
     size_t total = sizeof(header) + header.payload_bytes;
     if (total > max_datagram_size_) {
-        spdlog::warn("UdpProducer: datagram too large ({} bytes, max {}), dropping",
-                     total, max_datagram_size_);
-        return false;
+        return send_fragmented(header, payload);
     }
 
 #ifdef _WIN32
@@ -240,6 +269,98 @@ void UdpProducer::flush_internal() {
 }
 #endif
 
+bool UdpProducer::send_fragmented(const FrameHeaderV2& header, const void* payload) {
+    const size_t frame_bytes = sizeof(header) + header.payload_bytes;
+    if (max_datagram_size_ <= sizeof(UdpFragmentHeader) || (header.payload_bytes > 0 && !payload)) {
+        return false;
+    }
+    const size_t chunk = max_datagram_size_ - sizeof(UdpFragmentHeader);
+    const size_t count = (frame_bytes + chunk - 1) / chunk;
+    if (count > UINT16_MAX) {
+        spdlog::warn("UdpProducer: frame too large ({} bytes, {} fragments), dropping",
+                     frame_bytes, count);
+        return false;
+    }
+
+    auto fragment_header = [&](size_t i) {
+        UdpFragmentHeader fh;
+        fh.fragment_index  = static_cast<uint16_t>(i);
+        fh.fragment_count  = static_cast<uint16_t>(count);
+        fh.sequence        = header.sequence;
+        fh.frame_bytes     = static_cast<uint32_t>(frame_bytes);
+        fh.fragment_offset = static_cast<uint32_t>(i * chunk);
+        return fh;
+    };
+
+#ifdef _WIN32
+    for (size_t i = 0; i < count; ++i) {
+        const UdpFragmentHeader fh = fragment_header(i);
+        const FrameSlice slice = slice_frame(header, payload, i * chunk,
+                                             std::min(chunk, frame_bytes - i * chunk));
+        WSABUF bufs[3];
+        bufs[0].buf = reinterpret_cast<char*>(const_cast<UdpFragmentHeader*>(&fh));
+        bufs[0].len = static_cast<ULONG>(sizeof(fh));
+        for (int k = 0; k < slice.count; ++k) {
+            bufs[k + 1].buf = reinterpret_cast<char*>(const_cast<void*>(slice.ptr[k]));
+            bufs[k + 1].len = static_cast<ULONG>(slice.len[k]);
+        }
+        DWORD sent_bytes = 0;
+        if (WSASendTo(sock_, bufs, static_cast<DWORD>(slice.count + 1), &sent_bytes, 0,
+                      reinterpret_cast<const struct sockaddr*>(&dest_addr_),
+                      sizeof(dest_addr_), nullptr, nullptr) == SOCKET_ERROR) {
+            spdlog::warn("UdpProducer: WSASendTo failed: {}", WSAGetLastError());
+            return false;
+        }
+    }
+#else
+    // Batched whole frames go first to keep the frame order
+    flush_internal();
+
+    // Fragment datagrams point into header / payload: no copy
+    frag_headers_.resize(count);
+    frag_iovecs_.resize(count * 3);
+    frag_mmsg_.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        frag_headers_[i] = fragment_header(i);
+        const FrameSlice slice = slice_frame(header, payload, i * chunk,
+                                             std::min(chunk, frame_bytes - i * chunk));
+        struct iovec* iov = &frag_iovecs_[i * 3];
+        iov[0].iov_base = &frag_headers_[i];
+        iov[0].iov_len = sizeof(UdpFragmentHeader);
+        for (int k = 0; k < slice.count; ++k) {
+            iov[k + 1].iov_base = const_cast<void*>(slice.ptr[k]);
+            iov[k + 1].iov_len = slice.len[k];
+        }
+        std::memset(&frag_mmsg_[i], 0, sizeof(struct mmsghdr));
+        frag_mmsg_[i].msg_hdr.msg_name = &dest_addr_;
+        frag_mmsg_[i].msg_hdr.msg_namelen = sizeof(dest_addr_);
+        frag_mmsg_[i].msg_hdr.msg_iov = iov;
+        frag_mmsg_[i].msg_hdr.msg_iovlen = static_cast<size_t>(slice.count + 1);
+    }
+
+    size_t offset = 0;
+    while (offset < count) {
+        int sent = sendmmsg(sock_, &frag_mmsg_[offset],
+                            static_cast<unsigned int>(count - offset), 0);
+        if (sent < 0) {
+            if (errno == EINTR) continue;
+            spdlog::warn("UdpProducer: sendmmsg failed: {}", std::strerror(errno));
+            return false;
+        }
+        offset += static_cast<size_t>(sent);
+    }
+#endif
+
+    ++send_count_;
+    ++fragmented_count_;
+    if (fragmented_count_ == 1) {
+        spdlog::info("UdpProducer: first fragmented frame sent (seq={}, {} bytes in {} "
+                     "fragments of <= {} bytes)",
+                     header.sequence, frame_bytes, count, max_datagram_size_);
+    }
+    return true;
+}
+
 bool UdpProducer::receive_command(IpcCommand& /*cmd*/) {
     // No reverse command channel for UDP transport
     return false;
@@ -305,8 +426,12 @@ UdpConsumer::UdpConsumer(uint16_t port) {
         return;
     }
 
+#ifdef _WIN32
     // Pre-allocate receive buffer (max UDP datagram)
     recv_buf_.resize(65536);
+#else
+    set_burst_size(burst_size_);  // receive slots
+#endif
 
     spdlog::info("UdpConsumer: listening on port {}", port);
 }
@@ -330,35 +455,273 @@ void UdpConsumer::close() {
 #endif
 }
 
+void UdpConsumer::Datagram::copy(size_t offset, size_t n, void* dst) const {
+    auto* out = static_cast<uint8_t*>(dst);
+    for (size_t p = 0; p < 3 && n > 0; ++p) {
+        if (offset >= length[p]) {
+            offset -= length[p];
+            continue;
+        }
+        const size_t k = std::min(n, length[p] - offset);
+        std::memcpy(out, piece[p] + offset, k);
+        out += k;
+        n -= k;
+        offset = 0;
+    }
+}
+
+bool UdpConsumer::accept_datagram(const Datagram& d, FrameHeaderV2& header,
+                                  std::vector<int16_t>& payload) {
+    uint32_t magic = 0;
+    if (d.size < sizeof(magic)) return false;
+    d.copy(0, sizeof(magic), &magic);
+    if (magic == UDP_FRAGMENT_MAGIC) {
+        return accept_fragment(d, header, payload);
+    }
+    if (d.size < sizeof(FrameHeaderV2)) {
+        return false;  // too small, skip
+    }
+
+    // Extract header
+    d.copy(0, sizeof(header), &header);
+
+    if (header.magic != FRAME_HEADER_MAGIC) {
+        spdlog::warn("UdpConsumer: invalid frame magic 0x{:08x}", header.magic);
+        return false;  // bad frame, skip
+    }
+    if (header.header_bytes != sizeof(FrameHeaderV2)) {
+        spdlog::warn("UdpConsumer: {}-byte frame header, expected {} (grebe-sg from another build?)",
+                     header.header_bytes, sizeof(FrameHeaderV2));
+        return false;  // other header layout, skip
+    }
+
+    // Extract payload: take the buffer it landed in when that holds exactly
+    // the payload, otherwise copy it out
+    size_t payload_available = d.size - sizeof(FrameHeaderV2);
+
+    if (header.payload_bytes > 0 && payload_available >= header.payload_bytes) {
+        size_t num_samples = header.payload_bytes / sizeof(int16_t);
+        if (d.samples && d.samples->size() == num_samples &&
+            d.length[1] >= num_samples * sizeof(int16_t)) {
+            payload.swap(*d.samples);
+        } else {
+            payload.resize(num_samples);
+            d.copy(sizeof(FrameHeaderV2), num_samples * sizeof(int16_t), payload.data());
+            copied_.fetch_add(1, std::memory_order_relaxed);
+        }
+        frame_samples_ = num_samples;
+    } else {
+        payload.clear();
+    }
+    return true;
+}
+
+bool UdpConsumer::accept_fragment(const Datagram& d, FrameHeaderV2& header,
+                                  std::vector<int16_t>& payload) {
+    if (d.size <= sizeof(UdpFragmentHeader)) return false;
+    UdpFragmentHeader fh;
+    d.copy(0, sizeof(fh), &fh);
+    const size_t len = d.size - sizeof(fh);
+    if (fh.fragment_count == 0 || fh.fragment_index >= fh.fragment_count ||
+        fh.frame_bytes < sizeof(FrameHeaderV2) || fh.frame_bytes > kMaxReassemblyBytes ||
+        (fh.frame_bytes - sizeof(FrameHeaderV2)) % sizeof(int16_t) != 0 ||
+        fh.fragment_offset >= fh.frame_bytes || len > fh.frame_bytes - fh.fragment_offset) {
+        return false;  // malformed, skip
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+    if (reassembly_.empty()) reassembly_.resize(kReassemblySlots);
+    expire_reassembly(now);
+
+    // Frame already in progress, else a free entry, else the oldest one
+    Reassembly* entry = nullptr;
+    Reassembly* free_entry = nullptr;
+    Reassembly* oldest = nullptr;
+    for (auto& r : reassembly_) {
+        if (!r.active) {
+            if (!free_entry) free_entry = &r;
+        } else if (r.sequence == fh.sequence) {
+            entry = &r;
+            break;
+        } else if (!oldest || r.started < oldest->started) {
+            oldest = &r;
+        }
+    }
+    if (entry && (entry->frame_bytes != fh.frame_bytes ||
+                  entry->fragment_count != fh.fragment_count)) {
+        // Same sequence, different frame (producer restarted): start over
+        reassembly_drops_.fetch_add(1, std::memory_order_relaxed);
+        entry->active = false;
+    }
+    if (!entry) entry = free_entry ? free_entry : oldest;
+    if (!entry->active || entry->sequence != fh.sequence) {
+        if (entry->active) reassembly_drops_.fetch_add(1, std::memory_order_relaxed);
+        entry->active = true;
+        entry->sequence = fh.sequence;
+        entry->frame_bytes = fh.frame_bytes;
+        entry->fragment_count = fh.fragment_count;
+        entry->received = 0;
+        entry->started = now;
+        entry->payload.resize((fh.frame_bytes - sizeof(FrameHeaderV2)) / sizeof(int16_t));
+        entry->have.assign(fh.fragment_count, 0);
+    }
+
+    if (entry->have[fh.fragment_index]) return false;  // duplicate fragment
+    entry->have[fh.fragment_index] = 1;
+
+    // Header bytes to the entry's header, samples straight into the buffer
+    // that becomes the frame's payload
+    size_t offset = fh.fragment_offset;
+    size_t src = sizeof(fh);
+    size_t left = len;
+    if (offset < sizeof(FrameHeaderV2)) {
+        const size_t n = std::min(left, sizeof(FrameHeaderV2) - offset);
+        d.copy(src, n, reinterpret_cast<uint8_t*>(&entry->header) + offset);
+        offset += n;
+        src += n;
+        left -= n;
+    }
+    if (left > 0) {
+        d.copy(src, left, reinterpret_cast<uint8_t*>(entry->payload.data()) +
+                              (offset - sizeof(FrameHeaderV2)));
+    }
+    if (++entry->received < entry->fragment_count) return false;
+
+    // Complete: same checks as an unfragmented frame
+    entry->active = false;
+    header = entry->header;
+    if (header.magic != FRAME_HEADER_MAGIC ||
+        header.header_bytes != sizeof(FrameHeaderV2) ||
+        header.payload_bytes != entry->frame_bytes - sizeof(FrameHeaderV2)) {
+        spdlog::warn("UdpConsumer: reassembled frame seq={} is invalid, dropping", fh.sequence);
+        reassembly_drops_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    // The entry keeps the caller's old buffer for its next frame
+    payload.swap(entry->payload);
+    reassembled_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+void UdpConsumer::expire_reassembly(std::chrono::steady_clock::time_point now) {
+    for (auto& r : reassembly_) {
+        if (r.active && now - r.started > kReassemblyTimeout) {
+            r.active = false;
+            reassembly_drops_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
+
+bool UdpConsumer::order_frame(FrameHeaderV2& header, std::vector<int16_t>& payload) {
+    const uint64_t seq = header.sequence;
+    if (!sequenced_ || seq == next_sequence_) {
+        sequenced_ = true;
+        next_sequence_ = seq + 1;
+        return true;
+    }
+    if (seq < next_sequence_) {
+        if (next_sequence_ - seq <= 4 * kReorderWindow) {
+            duplicates_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        // Far behind: the producer restarted. Frames held from before are
+        // ahead of a gap that will never fill
+        for (auto& h : held_) {
+            if (h.used) lost_.fetch_add(1, std::memory_order_relaxed);
+            h.used = false;
+        }
+        held_count_ = 0;
+        next_sequence_ = seq + 1;
+        return true;
+    }
+
+    // Ahead of a missing frame: hold it. release_held() runs before every
+    // datagram and empties a full window, so there is a free entry
+    if (held_.empty()) held_.resize(kReorderWindow);
+    HeldFrame* entry = nullptr;
+    for (auto& h : held_) {
+        if (h.used && h.header.sequence == seq) {
+            duplicates_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        if (!h.used && !entry) entry = &h;
+    }
+    if (!entry) {
+        lost_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    entry->used = true;
+    entry->header = header;
+    entry->payload.swap(payload);
+    entry->arrived = std::chrono::steady_clock::now();
+    ++held_count_;
+    return false;
+}
+
+std::chrono::steady_clock::time_point UdpConsumer::receive_deadline() const {
+    auto earliest = std::chrono::steady_clock::time_point::max();
+    if (held_count_ == 0) return earliest;
+    for (const auto& h : held_) {
+        if (h.used) earliest = std::min(earliest, h.arrived);
+    }
+    return earliest + kReorderTimeout;
+}
+
+bool UdpConsumer::release_held(FrameHeaderV2& header, std::vector<int16_t>& payload,
+                               bool timeouts) {
+    if (held_count_ == 0) return false;
+    HeldFrame* first = nullptr;
+    auto earliest = std::chrono::steady_clock::time_point::max();
+    for (auto& h : held_) {
+        if (!h.used) continue;
+        if (!first || h.header.sequence < first->header.sequence) first = &h;
+        earliest = std::min(earliest, h.arrived);
+    }
+    if (first->header.sequence != next_sequence_) {
+        // Wait for the missing frames while the window has room
+        if (held_count_ < kReorderWindow &&
+            (!timeouts || std::chrono::steady_clock::now() - earliest < kReorderTimeout)) {
+            return false;
+        }
+        lost_.fetch_add(first->header.sequence - next_sequence_, std::memory_order_relaxed);
+    }
+    reordered_.fetch_add(1, std::memory_order_relaxed);
+    header = first->header;
+    payload.swap(first->payload);
+    first->used = false;
+    --held_count_;
+    next_sequence_ = header.sequence + 1;
+    return true;
+}
+
 void UdpConsumer::set_burst_size(size_t n) {
     if (n < 1) n = 1;
     burst_size_ = n;
 #ifndef _WIN32
-    if (burst_size_ > 1) {
-        recv_bufs_.resize(burst_size_);
-        recv_iovecs_.resize(burst_size_);
-        recv_mmsg_.resize(burst_size_);
-        for (size_t i = 0; i < burst_size_; ++i) {
-            recv_bufs_[i].resize(65536);
-            recv_iovecs_[i].iov_base = recv_bufs_[i].data();
-            recv_iovecs_[i].iov_len = recv_bufs_[i].size();
-            std::memset(&recv_mmsg_[i], 0, sizeof(struct mmsghdr));
-            recv_mmsg_[i].msg_hdr.msg_iov = &recv_iovecs_[i];
-            recv_mmsg_[i].msg_hdr.msg_iovlen = 1;
-        }
+    recv_slots_.resize(burst_size_);
+    recv_mmsg_.resize(burst_size_);
+    for (auto& slot : recv_slots_) {
+        slot.spill.resize(65536);  // max UDP datagram
     }
+    batch_received_ = 0;
+    batch_next_ = 0;
 #endif
 }
 
 bool UdpConsumer::receive_frame(FrameHeaderV2& header, std::vector<int16_t>& payload) {
 #ifndef _WIN32
-    if (burst_size_ > 1) {
-        return receive_batch(header, payload);
+    while (!closed_.load(std::memory_order_acquire)) {
+        const RecvStatus status = (burst_size_ > 1) ? receive_batch(header, payload, 0)
+                                                    : receive_single(header, payload, 0);
+        if (status == RecvStatus::Frame) return true;
+        if (status == RecvStatus::Closed) return false;
+        // WouldBlock: SO_RCVTIMEO expired, re-check closed_
     }
-    return receive_single(header, payload);
+    return false;  // closed
 #else
     // Windows: single recvfrom (same as original)
     while (!closed_.load(std::memory_order_acquire)) {
+        if (release_held(header, payload, true)) return true;
         if (sock_ == INVALID_SOCKET) return false;
 
         int received = recvfrom(sock_,
@@ -372,37 +735,21 @@ bool UdpConsumer::receive_frame(FrameHeaderV2& header, std::vector<int16_t>& pay
             spdlog::warn("UdpConsumer: recvfrom error: {}", err);
             return false;
         }
-        if (received < static_cast<int>(sizeof(FrameHeaderV2))) {
-            continue;  // too small, skip
-        }
         size_t nbytes = static_cast<size_t>(received);
-
-        // Extract header
-        std::memcpy(&header, recv_buf_.data(), sizeof(header));
-
-        if (header.magic != FRAME_HEADER_MAGIC) {
-            spdlog::warn("UdpConsumer: invalid frame magic 0x{:08x}", header.magic);
-            continue;  // bad frame, skip
-        }
-
-        // Extract payload
-        size_t payload_offset = sizeof(FrameHeaderV2);
-        size_t payload_available = nbytes - payload_offset;
-
-        if (header.payload_bytes > 0 && payload_available >= header.payload_bytes) {
-            size_t num_samples = header.payload_bytes / sizeof(int16_t);
-            payload.resize(num_samples);
-            std::memcpy(payload.data(), recv_buf_.data() + payload_offset,
-                        header.payload_bytes);
-        } else {
-            payload.clear();
+        Datagram d;
+        d.piece[0] = recv_buf_.data();
+        d.length[0] = nbytes;
+        d.size = nbytes;
+        if (!accept_datagram(d, header, payload) || !order_frame(header, payload)) {
+            continue;  // fragment of an incomplete frame, invalid, held or duplicate
         }
 
         ++recv_count_;
         if (recv_count_ == 1) {
             spdlog::info("UdpConsumer: first frame received (seq={}, {}ch, {} samples/ch, {} bytes)",
                          header.sequence, header.channel_count,
-                         header.block_length_samples, nbytes);
+                         header.block_length_samples,
+                         sizeof(FrameHeaderV2) + header.payload_bytes);
         }
         return true;
     }
@@ -411,116 +758,140 @@ bool UdpConsumer::receive_frame(FrameHeaderV2& header, std::vector<int16_t>& pay
 }
 
 #ifndef _WIN32
-bool UdpConsumer::receive_single(FrameHeaderV2& header, std::vector<int16_t>& payload) {
-    while (!closed_.load(std::memory_order_acquire)) {
-        if (sock_ < 0) return false;
+ITransportConsumer::RecvStatus UdpConsumer::try_receive_frame(FrameHeaderV2& header,
+                                                              std::vector<int16_t>& payload) {
+    if (closed_.load(std::memory_order_acquire)) return RecvStatus::Closed;
+    return (burst_size_ > 1) ? receive_batch(header, payload, MSG_DONTWAIT)
+                             : receive_single(header, payload, MSG_DONTWAIT);
+}
 
-        ssize_t received = recvfrom(sock_, recv_buf_.data(), recv_buf_.size(), 0,
-                                    nullptr, nullptr);
-        if (received < 0) {
-            if (errno == EAGAIN || errno == EWOULDBLOCK) continue;  // timeout, retry
-            if (closed_.load(std::memory_order_relaxed)) return false;
-            spdlog::warn("UdpConsumer: recvfrom error: {}", std::strerror(errno));
-            return false;
-        }
-        if (received < static_cast<ssize_t>(sizeof(FrameHeaderV2))) {
-            continue;  // too small, skip
-        }
-        size_t nbytes = static_cast<size_t>(received);
+int UdpConsumer::poll_fd() const {
+    return sock_;
+}
 
-        // Extract header
-        std::memcpy(&header, recv_buf_.data(), sizeof(header));
+void UdpConsumer::arm_slot(size_t i) {
+    RecvSlot& slot = recv_slots_[i];
+    // Sized for the current frames: the buffer the caller handed back has
+    // that size already, so this allocates only when the frame size changes
+    slot.samples.resize(frame_samples_);
+    slot.iov[0].iov_base = &slot.header;
+    slot.iov[0].iov_len = sizeof(slot.header);
+    slot.iov[1].iov_base = slot.samples.data();
+    slot.iov[1].iov_len = slot.samples.size() * sizeof(int16_t);
+    slot.iov[2].iov_base = slot.spill.data();
+    slot.iov[2].iov_len = slot.spill.size();
+    std::memset(&recv_mmsg_[i], 0, sizeof(struct mmsghdr));
+    recv_mmsg_[i].msg_hdr.msg_iov = slot.iov;
+    recv_mmsg_[i].msg_hdr.msg_iovlen = 3;
+}
 
-        if (header.magic != FRAME_HEADER_MAGIC) {
-            spdlog::warn("UdpConsumer: invalid frame magic 0x{:08x}", header.magic);
-            continue;  // bad frame, skip
-        }
+UdpConsumer::Datagram UdpConsumer::slot_datagram(size_t i) {
+    RecvSlot& slot = recv_slots_[i];
+    Datagram d;
+    d.size = recv_mmsg_[i].msg_len;
+    size_t left = d.size;
+    for (size_t p = 0; p < 3; ++p) {
+        d.piece[p] = static_cast<const uint8_t*>(slot.iov[p].iov_base);
+        d.length[p] = std::min(left, slot.iov[p].iov_len);
+        left -= d.length[p];
+    }
+    d.samples = &slot.samples;
+    return d;
+}
 
-        // Extract payload
-        size_t payload_offset = sizeof(FrameHeaderV2);
-        size_t payload_available = nbytes - payload_offset;
+ITransportConsumer::RecvStatus UdpConsumer::receive_single(FrameHeaderV2& header,
+                                                           std::vector<int16_t>& payload,
+                                                           int flags) {
+    while (!closed_.load(std::memory_order_acquire)) {
+        if (release_held(header, payload, true)) return RecvStatus::Frame;
+        if (sock_ < 0) return RecvStatus::Closed;
 
-        if (header.payload_bytes > 0 && payload_available >= header.payload_bytes) {
-            size_t num_samples = header.payload_bytes / sizeof(int16_t);
-            payload.resize(num_samples);
-            std::memcpy(payload.data(), recv_buf_.data() + payload_offset,
-                        header.payload_bytes);
-        } else {
-            payload.clear();
+        arm_slot(0);
+        ssize_t received = recvmsg(sock_, &recv_mmsg_[0].msg_hdr, flags);
+        if (received < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) return RecvStatus::WouldBlock;
+            if (errno == EINTR) continue;
+            if (closed_.load(std::memory_order_relaxed)) return RecvStatus::Closed;
+            spdlog::warn("UdpConsumer: recvmsg error: {}", std::strerror(errno));
+            return RecvStatus::Closed;
+        }
+        size_t nbytes = static_cast<size_t>(received);
+        recv_mmsg_[0].msg_len = static_cast<unsigned int>(nbytes);
+        if (!accept_datagram(slot_datagram(0), header, payload) ||
+            !order_frame(header, payload)) {
+            continue;  // fragment of an incomplete frame, invalid, held or duplicate
         }
 
         ++recv_count_;
         if (recv_count_ == 1) {
             spdlog::info("UdpConsumer: first frame received (seq={}, {}ch, {} samples/ch, {} bytes)",
                          header.sequence, header.channel_count,
-                         header.block_length_samples, nbytes);
+                         header.block_length_samples,
+                         sizeof(FrameHeaderV2) + header.payload_bytes);
         }
-        return true;
+        return RecvStatus::Frame;
     }
-    return false;  // closed
+    return RecvStatus::Closed;
 }
 
-bool UdpConsumer::receive_batch(FrameHeaderV2& header, std::vector<int16_t>& payload) {
+ITransportConsumer::RecvStatus UdpConsumer::receive_batch(FrameHeaderV2& header,
+                                                          std::vector<int16_t>& payload,
+                                                          int flags) {
     while (!closed_.load(std::memory_order_acquire)) {
-        // Return from internal queue first
-        if (!recv_queue_.empty()) {
-            auto& front = recv_queue_.front();
-            header = front.first;
-            payload = std::move(front.second);
-            recv_queue_.pop_front();
-            return true;
+        // Datagrams already received may still fill the gap: no timeout yet
+        if (release_held(header, payload, batch_next_ == batch_received_)) {
+            return RecvStatus::Frame;
         }
 
-        if (sock_ < 0) return false;
-
-        // Bulk receive with recvmmsg (MSG_WAITFORONE: block for first, non-blocking for rest)
-        int n = recvmmsg(sock_, recv_mmsg_.data(),
-                         static_cast<unsigned int>(burst_size_),
-                         MSG_WAITFORONE, nullptr);
-        if (n < 0) {
-            if (errno == EAGAIN || errno == EWOULDBLOCK) continue;  // timeout, retry
-            if (closed_.load(std::memory_order_relaxed)) return false;
-            spdlog::warn("UdpConsumer: recvmmsg error: {}", std::strerror(errno));
-            return false;
-        }
-
-        // Parse received datagrams into queue
-        for (int i = 0; i < n; ++i) {
-            size_t nbytes = recv_mmsg_[i].msg_len;
-            if (nbytes < sizeof(FrameHeaderV2)) continue;
-
-            FrameHeaderV2 hdr;
-            std::memcpy(&hdr, recv_bufs_[i].data(), sizeof(hdr));
-
-            if (hdr.magic != FRAME_HEADER_MAGIC) continue;
-
-            std::vector<int16_t> pl;
-            size_t payload_offset = sizeof(FrameHeaderV2);
-            size_t payload_available = nbytes - payload_offset;
-
-            if (hdr.payload_bytes > 0 && payload_available >= hdr.payload_bytes) {
-                size_t num_samples = hdr.payload_bytes / sizeof(int16_t);
-                pl.resize(num_samples);
-                std::memcpy(pl.data(), recv_bufs_[i].data() + payload_offset,
-                            hdr.payload_bytes);
+        // Parse what the last recvmmsg left in the slots first
+        if (batch_next_ < batch_received_) {
+            const size_t i = batch_next_++;
+            if (!accept_datagram(slot_datagram(i), header, payload) ||
+                !order_frame(header, payload)) {
+                continue;  // fragment of an incomplete frame, invalid, held or duplicate
             }
 
             ++recv_count_;
             if (recv_count_ == 1) {
                 spdlog::info("UdpConsumer: first frame received (seq={}, {}ch, {} samples/ch, {} bytes, batch={})",
-                             hdr.sequence, hdr.channel_count,
-                             hdr.block_length_samples, nbytes, burst_size_);
+                             header.sequence, header.channel_count,
+                             header.block_length_samples,
+                             sizeof(FrameHeaderV2) + header.payload_bytes, burst_size_);
             }
-
-            recv_queue_.emplace_back(hdr, std::move(pl));
+            return RecvStatus::Frame;
         }
 
-        // Re-initialize mmsghdr for next batch (msg_len is written by kernel)
+        if (sock_ < 0) return RecvStatus::Closed;
+
+        // Bulk receive with recvmmsg (MSG_WAITFORONE: block for first, non-blocking for rest)
         for (size_t i = 0; i < burst_size_; ++i) {
-            recv_mmsg_[i].msg_len = 0;
+            arm_slot(i);
         }
+        int n = recvmmsg(sock_, recv_mmsg_.data(),
+                         static_cast<unsigned int>(burst_size_),
+                         MSG_WAITFORONE | flags, nullptr);
+        if (n < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) return RecvStatus::WouldBlock;
+            if (errno == EINTR) continue;
+            if (closed_.load(std::memory_order_relaxed)) return RecvStatus::Closed;
+            spdlog::warn("UdpConsumer: recvmmsg error: {}", std::strerror(errno));
+            return RecvStatus::Closed;
+        }
+        batch_received_ = static_cast<size_t>(n);
+        batch_next_ = 0;
     }
-    return false;  // closed
+    return RecvStatus::Closed;
+}
+#endif
+
+#ifdef _WIN32
+ITransportConsumer::RecvStatus UdpConsumer::try_receive_frame(FrameHeaderV2& /*header*/,
+                                                              std::vector<int16_t>& /*payload*/) {
+    return RecvStatus::Closed;  // no reactor on Windows
+}
+
+int UdpConsumer::poll_fd() const {
+    return -1;
 }
 #endif
 
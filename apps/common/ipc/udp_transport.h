@@ -3,10 +3,9 @@
 #include "transport.h"
 
 #include <atomic>
+#include <chrono>
 #include <cstdint>
-#include <deque>
 #include <string>
-#include <utility>
 #include <vector>
 
 #ifdef _WIN32
@@ -20,7 +19,9 @@
 #endif
 
 /// UDP transport producer (used by grebe-sg).
-/// Sends frames as single UDP datagrams to a target host:port.
+/// Sends frames as single UDP datagrams to a target host:port; a frame larger
+/// than the datagram limit is split into fragments (UdpFragmentHeader), so the
+/// block size does not depend on the MTU.
 /// Supports scatter-gather I/O (sendmsg/WSASendTo) and optional sendmmsg batching (Linux).
 /// No reverse command channel — receive_command() always returns false.
 class UdpProducer : public ITransportProducer {
@@ -32,7 +33,7 @@ public:
     bool receive_command(IpcCommand& cmd) override;
 
     /// Override the maximum datagram size (default: 1400 for WSL2 safety).
-    /// Set to 65000 on Windows native or real Linux for larger payloads.
+    /// Set to 65000 on Windows native or real Linux for fewer fragments.
     void set_max_datagram_size(size_t size) { max_datagram_size_ = size; }
     size_t max_datagram_size() const { return max_datagram_size_; }
 
@@ -65,12 +66,36 @@ private:
 
     bool send_scatter_gather(const FrameHeaderV2& header, const void* payload);
     void flush_internal();
+
+    // --- fragment state (reused across frames) ---
+    std::vector<UdpFragmentHeader> frag_headers_;
+    std::vector<struct iovec> frag_iovecs_;        // 3 per fragment
+    std::vector<struct mmsghdr> frag_mmsg_;
 #endif
+    uint64_t fragmented_count_ = 0;
+
+    bool send_fragmented(const FrameHeaderV2& header, const void* payload);
 };
 
 /// UDP transport consumer (used by grebe-viewer).
-/// Binds to a port and receives frames as UDP datagrams.
+/// Binds to a port and receives frames as UDP datagrams. Fragmented frames
+/// are reassembled in a small table (kReassemblySlots frames in flight); a
+/// frame still incomplete after kReassemblyTimeout, or pushed out by newer
+/// ones, is discarded and counted.
 /// Supports recvmmsg batching (Linux) for reduced syscall overhead.
+/// Zero-copy receive (Linux): each datagram is scattered into a receive slot
+/// (header struct, frame-sized sample buffer, spill area), and the sample
+/// buffer is swapped into the caller's payload vector, which becomes the
+/// slot's next buffer. Pass the vector back each call, as make_rx_frame()
+/// leaves it, so buffers circulate without allocation or copies. Frames of
+/// a new size, and fragments, are copied once.
+/// Frames are delivered in sequence order: one that arrives ahead of a
+/// missing sequence is held in a reorder window (kReorderWindow frames). The
+/// gap is given up (counted lost) when the window is full or the oldest held
+/// frame waited kReorderTimeout (checked at each receive call; a blocking
+/// receive wakes up at least every 500 ms, and a reactor waiting on
+/// poll_fd() also wakes at receive_deadline()); duplicates and stragglers
+/// are dropped. A backwards jump far past the window is a producer restart.
 /// No reverse command channel — send_command() always returns false.
 class UdpConsumer : public ITransportConsumer {
 public:
@@ -80,6 +105,13 @@ public:
     bool receive_frame(FrameHeaderV2& header, std::vector<int16_t>& payload) override;
     bool send_command(const IpcCommand& cmd) override;
 
+    /// Non-blocking receive (MSG_DONTWAIT) for a reactor; Linux only.
+    RecvStatus try_receive_frame(FrameHeaderV2& header, std::vector<int16_t>& payload) override;
+    int poll_fd() const override;
+    /// The oldest held frame's kReorderTimeout, so a quiet stream does not
+    /// keep frames waiting behind a gap.
+    std::chrono::steady_clock::time_point receive_deadline() const override;
+
     /// Close the socket to unblock a blocking receive_frame() call.
     void close();
 
@@ -87,7 +119,78 @@ public:
     /// Must be called before first receive_frame().
     void set_burst_size(size_t n);
 
+    /// Unfragmented frames whose samples had to be copied out of the receive
+    /// buffers (first frame or size change; always on Windows). The others
+    /// were handed over in place; reassembled frames are copied once, as
+    /// their fragments arrive.
+    uint64_t copied_frames() const { return copied_.load(std::memory_order_relaxed); }
+    /// Sequences given up on (lost in transit, or discarded at a restart).
+    uint64_t lost_frames() const { return lost_.load(std::memory_order_relaxed); }
+    /// Frames that arrived ahead of a missing one and were held back.
+    uint64_t reordered_frames() const { return reordered_.load(std::memory_order_relaxed); }
+    /// Frames dropped as already delivered or held, or arriving after their
+    /// sequence was given up.
+    uint64_t duplicate_frames() const { return duplicates_.load(std::memory_order_relaxed); }
+    /// Frames rebuilt from fragments.
+    uint64_t reassembled_frames() const { return reassembled_.load(std::memory_order_relaxed); }
+    /// Fragmented frames given up (fragments lost, timed out or evicted).
+    uint64_t reassembly_drops() const { return reassembly_drops_.load(std::memory_order_relaxed); }
+
+    static constexpr size_t kReassemblySlots = 8;
+    static constexpr auto   kReassemblyTimeout = std::chrono::milliseconds(200);
+    /// Largest fragmented frame accepted (header + payload).
+    static constexpr uint32_t kMaxReassemblyBytes = 64u << 20;
+    static constexpr size_t kReorderWindow = 8;
+    static constexpr auto   kReorderTimeout = std::chrono::milliseconds(20);
+
 private:
+    struct Reassembly {
+        bool     active = false;
+        uint64_t sequence = 0;
+        uint32_t frame_bytes = 0;
+        uint16_t fragment_count = 0;
+        uint16_t received = 0;
+        std::chrono::steady_clock::time_point started;
+        FrameHeaderV2 header{};
+        std::vector<int16_t> payload;   // swapped out as the frame's samples
+        std::vector<uint8_t> have;      // per fragment
+    };
+
+    /// One received datagram: up to three consecutive pieces (header area,
+    /// sample buffer, spill area). A contiguous buffer is piece 0 alone.
+    struct Datagram {
+        const uint8_t* piece[3] = {};
+        size_t length[3] = {};
+        size_t size = 0;
+        /// Holds piece 1 and may be swapped out when it is exactly the payload.
+        std::vector<int16_t>* samples = nullptr;
+
+        void copy(size_t offset, size_t n, void* dst) const;
+    };
+
+    /// Frame held back in the reorder window.
+    struct HeldFrame {
+        bool used = false;
+        FrameHeaderV2 header{};
+        std::vector<int16_t> payload;   // swapped in and out, like slot buffers
+        std::chrono::steady_clock::time_point arrived;
+    };
+
+    // Put a complete frame in sequence order. True if @p header / @p payload
+    // is to be delivered now; false if it was held or dropped.
+    bool order_frame(FrameHeaderV2& header, std::vector<int16_t>& payload);
+    // Deliver the oldest held frame if it is next, or its gap is given up
+    // (window full; or timed out, if @p timeouts: no datagram is pending).
+    bool release_held(FrameHeaderV2& header, std::vector<int16_t>& payload, bool timeouts);
+
+    // Parse one datagram (whole frame or fragment). True when it completes
+    // a frame, written to @p header / @p payload.
+    bool accept_datagram(const Datagram& d, FrameHeaderV2& header,
+                         std::vector<int16_t>& payload);
+    bool accept_fragment(const Datagram& d, FrameHeaderV2& header,
+                         std::vector<int16_t>& payload);
+    void expire_reassembly(std::chrono::steady_clock::time_point now);
+
 #ifdef _WIN32
     SOCKET sock_ = INVALID_SOCKET;
 #else
@@ -95,17 +198,44 @@ private:
 #endif
     std::atomic<bool> closed_{false};
     uint64_t recv_count_ = 0;
-    std::vector<uint8_t> recv_buf_;
 
-    // --- recvmmsg batch state (Linux only) ---
+    std::vector<Reassembly> reassembly_;  // kReassemblySlots once fragments arrive
+    std::atomic<uint64_t> reassembled_{0};
+    std::atomic<uint64_t> reassembly_drops_{0};
+    std::atomic<uint64_t> copied_{0};
+
+    std::vector<HeldFrame> held_;  // kReorderWindow once a frame is held
+    size_t held_count_ = 0;
+    bool sequenced_ = false;       // next_sequence_ is valid
+    uint64_t next_sequence_ = 0;
+    std::atomic<uint64_t> lost_{0};
+    std::atomic<uint64_t> reordered_{0};
+    std::atomic<uint64_t> duplicates_{0};
+    size_t frame_samples_ = 0;  // payload of the last unfragmented frame (slot buffer size)
+
+    // --- receive buffers / recvmmsg batch state ---
     size_t burst_size_ = 1;
-#ifndef _WIN32
-    std::deque<std::pair<FrameHeaderV2, std::vector<int16_t>>> recv_queue_;
-    std::vector<std::vector<uint8_t>> recv_bufs_;
-    std::vector<struct iovec> recv_iovecs_;
+#ifdef _WIN32
+    std::vector<uint8_t> recv_buf_;
+#else
+    /// Scatter target of one datagram; burst_size_ of them.
+    struct RecvSlot {
+        FrameHeaderV2 header{};
+        std::vector<int16_t> samples;   // frame_samples_ long when armed
+        std::vector<uint8_t> spill;     // rest of a larger datagram
+        struct iovec iov[3]{};
+    };
+
+    std::vector<RecvSlot> recv_slots_;
     std::vector<struct mmsghdr> recv_mmsg_;
+    size_t batch_received_ = 0;  // datagrams in the slots from the last recvmmsg
+    size_t batch_next_ = 0;      // next one to parse
+
+    void arm_slot(size_t i);
+    Datagram slot_datagram(size_t i);
 
-    bool receive_single(FrameHeaderV2& header, std::vector<int16_t>& payload);
-    bool receive_batch(FrameHeaderV2& header, std::vector<int16_t>& payload);
+    // One receive attempt; @p flags adds MSG_DONTWAIT for try_receive_frame()
+    RecvStatus receive_single(FrameHeaderV2& header, std::vector<int16_t>& payload, int flags);
+    RecvStatus receive_batch(FrameHeaderV2& header, std::vector<int16_t>& payload, int flags);
 #endif
 };
@@ -0,0 +1,78 @@
+#include "stages/async_transport_rx_stage.h"
+#include "stages/transport_rx_stage.h"
+#include "ipc/contracts.h"
+
+#include <spdlog/spdlog.h>
+
+#include <utility>
+
+namespace {
+
+// Frames received back-to-back before yielding the reactor to other stages
+constexpr uint32_t kFramesPerYield = 64;
+
+} // namespace
+
+AsyncTransportRxStage::AsyncTransportRxStage(grebe::Reactor& reactor,
+                                             ITransportConsumer& consumer)
+    : AsyncSourceStage(reactor)
+    , consumer_(consumer)
+    , block_size_("AsyncTransportRxStage", [&consumer](uint32_t n) {
+          // Forwarded to grebe-sg; fails where there is no command channel (UDP)
+          IpcCommand cmd{};
+          cmd.type = IpcCommand::SET_BLOCK_SIZE;
+          cmd.value = static_cast<double>(n);
+          return consumer.send_command(cmd);
+      }) {}
+
+void AsyncTransportRxStage::delivered(const grebe::BatchWriter& out, size_t first,
+                                      const grebe::ExecContext& ctx) {
+    if (ctx.credit_window == 0) return;
+    // ctx.credits is the credit before the whole batch: give each frame the
+    // credit left once the frames ahead of it are queued
+    grebe::ExecContext frame_ctx = ctx;
+    for (size_t i = first; i < out.size(); ++i) {
+        const size_t ahead = i - first;
+        frame_ctx.credits = ctx.credits > ahead ? static_cast<uint32_t>(ctx.credits - ahead) : 0;
+        block_size_.update(out[i].samples_per_channel, out[i].sample_rate_hz, frame_ctx);
+    }
+}
+
+void AsyncTransportRxStage::set_header_observer(
+    std::function<void(const FrameHeaderV2&)> observer) {
+    observer_ = std::move(observer);
+}
+
+grebe::AsyncTask AsyncTransportRxStage::run() {
+    const int fd = consumer_.poll_fd();
+    if (fd < 0) {
+        spdlog::error("AsyncTransportRxStage: transport has no pollable fd");
+        co_return;
+    }
+
+    FrameHeaderV2 header{};
+    uint32_t burst = 0;
+    for (;;) {
+        switch (consumer_.try_receive_frame(header, payload_)) {
+        case ITransportConsumer::RecvStatus::Frame: {
+            if (observer_) observer_(header);
+            grebe::Frame frame = make_rx_frame(header, payload_);
+            if (continuity_.gap(header)) frame.flags |= grebe::kFrameDiscontinuity;
+            if (!co_await emit(std::move(frame))) co_return;
+            if (++burst >= kFramesPerYield) {
+                burst = 0;
+                if (!co_await reschedule()) co_return;
+            }
+            break;
+        }
+        case ITransportConsumer::RecvStatus::WouldBlock:
+            burst = 0;
+            // Held UDP frames time out even when no datagram arrives
+            if (!co_await readable(fd, consumer_.receive_deadline())) co_return;
+            break;
+        case ITransportConsumer::RecvStatus::Closed:
+            spdlog::info("AsyncTransportRxStage: connection closed");
+            co_return;
+        }
+    }
+}
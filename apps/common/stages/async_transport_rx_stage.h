@@ -0,0 +1,46 @@
+#pragma once
+
+// AsyncTransportRxStage — ITransportConsumer → AsyncSourceStage
+// Coroutine Rx: suspends on the consumer's fd instead of blocking a worker
+// in receive_frame(), so many receivers share one Reactor thread.
+// Frames after a gap in sequence / first_sample_index carry kFrameDiscontinuity.
+// On a Credit output edge, adapts grebe-sg's block size to downstream credit.
+
+#include "grebe/async.h"
+#include "ipc/transport.h"
+#include "stages/block_size_controller.h"
+
+#include <functional>
+#include <string>
+#include <vector>
+
+class AsyncTransportRxStage final : public grebe::AsyncSourceStage {
+public:
+    /// @p consumer must support try_receive_frame() (poll_fd() >= 0) and
+    /// outlive the stage.
+    AsyncTransportRxStage(grebe::Reactor& reactor, ITransportConsumer& consumer);
+
+    /// Called on the reactor thread with every received header, e.g. to
+    /// track producer-side telemetry. Set before the runtime starts.
+    void set_header_observer(std::function<void(const FrameHeaderV2&)> observer);
+
+    std::string name() const override { return "AsyncTransportRxStage"; }
+
+    /// Frames flagged kFrameDiscontinuity so far; safe from any thread.
+    uint64_t discontinuities() const { return continuity_.gaps(); }
+
+    /// Block size last requested from grebe-sg by flow control
+    /// (0 = none, the producer's default is in effect).
+    uint32_t requested_block_size() const { return block_size_.requested(); }
+
+private:
+    grebe::AsyncTask run() override;
+    void delivered(const grebe::BatchWriter& out, size_t first,
+                   const grebe::ExecContext& ctx) override;
+
+    ITransportConsumer& consumer_;
+    std::vector<int16_t> payload_;  // reusable buffer (partial frames persist)
+    std::function<void(const FrameHeaderV2&)> observer_;
+    RxContinuity continuity_;
+    grebe::BlockSizeController block_size_;  // Credit edge, executor thread
+};
@@ -0,0 +1,26 @@
+#include "stages/shm_reader_stage.h"
+
+ShmReaderStage::ShmReaderStage(ShmConsumer& consumer)
+    : consumer_(consumer) {}
+
+grebe::StageResult ShmReaderStage::process(grebe::BatchView& /*in*/,
+                                           grebe::BatchWriter& out,
+                                           grebe::ExecContext& /*ctx*/) {
+    auto frame = consumer_.receive(kPollTimeout);
+    if (!frame) {
+        if (!consumer_.closed()) return grebe::StageResult::NoData;
+        // Session mode: follow the producer to a new session if it serves one
+        return consumer_.reconnect(std::chrono::milliseconds(0)) ? grebe::StageResult::NoData
+                                                                 : grebe::StageResult::EOS;
+    }
+
+    if (!(frame->flags & grebe::kFrameVirtualClock)) {
+        frame->trace.mark(grebe::TracePoint::Receive, frame->producer_ts_ns, grebe::steady_now_ns());
+    }
+    // Frames dropped for this consumer (DropOldest/DropLatest lanes) leave a gap
+    if (continuity_.gap(frame->sequence, frame->first_sample_index, frame->samples_per_channel)) {
+        frame->flags |= grebe::kFrameDiscontinuity;
+    }
+    out.push(std::move(*frame));
+    return grebe::StageResult::Ok;
+}
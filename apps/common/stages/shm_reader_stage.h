@@ -0,0 +1,34 @@
+#pragma once
+
+// ShmReaderStage — ShmConsumer → SourceStage (zero-copy)
+// Emits Borrowed frames that point into the shared-memory slots; a slot is
+// returned to the producer when the last downstream stage drops its frame.
+// At end of stream a session-mode consumer first tries one reconnect.
+// Frames after a gap (lane drops, new session) carry kFrameDiscontinuity.
+
+#include "grebe/stage.h"
+#include "ipc/shm_transport.h"
+
+#include <chrono>
+
+class ShmReaderStage final : public grebe::IStage {
+public:
+    /// @p consumer must outlive the stage and every frame it emitted.
+    explicit ShmReaderStage(ShmConsumer& consumer);
+
+    grebe::StageResult process(grebe::BatchView& in, grebe::BatchWriter& out,
+                               grebe::ExecContext& ctx) override;
+
+    std::string name() const override { return "ShmReaderStage"; }
+
+    /// Frames flagged kFrameDiscontinuity so far; safe from any thread.
+    uint64_t discontinuities() const { return continuity_.gaps(); }
+
+private:
+    /// Wait per call while the queue is empty; bounds LinearRuntime::stop()
+    /// latency (no transport close needed to unblock the stage).
+    static constexpr std::chrono::milliseconds kPollTimeout{10};
+
+    ShmConsumer& consumer_;
+    RxContinuity continuity_;
+};
@@ -6,19 +6,26 @@
 TransportRxStage::TransportRxStage(ITransportConsumer& consumer)
     : consumer_(consumer) {}
 
-grebe::StageResult TransportRxStage::process(const grebe::BatchView& /*in*/,
-                                              grebe::BatchWriter& out,
-                                              grebe::ExecContext& /*ctx*/) {
+grebe::StageResult TransportRxStage::process(grebe::BatchView& /*in*/,
+                                             grebe::BatchWriter& out,
+                                             grebe::ExecContext& /*ctx*/) {
     FrameHeaderV2 header{};
 
     if (!consumer_.receive_frame(header, payload_)) {
         return grebe::StageResult::EOS;
     }
 
-    // Build Frame from wire format
+    grebe::Frame frame = make_rx_frame(header, payload_);
+    if (continuity_.gap(header)) frame.flags |= grebe::kFrameDiscontinuity;
+    out.push(std::move(frame));
+    return grebe::StageResult::Ok;
+}
+
+grebe::Frame make_rx_frame(const FrameHeaderV2& header, std::vector<int16_t>& payload) {
+    // Build Frame from wire format (pooled buffer, recycled downstream)
     const uint32_t ch = header.channel_count;
     const uint32_t spc = header.block_length_samples;
-    grebe::Frame frame = grebe::Frame::make_owned(ch, spc);
+    grebe::Frame frame = grebe::Frame::make_pooled(ch, spc);
 
     // Copy metadata (superset: includes fields not in FrameBuffer)
     frame.sequence           = header.sequence;
@@ -27,14 +34,21 @@ grebe::StageResult TransportRxStage::process(const grebe::BatchView& /*in*/,
     frame.samples_per_channel = spc;
     frame.sample_rate_hz     = header.sample_rate_hz;
     frame.first_sample_index = header.first_sample_index;
+    frame.flags              = header.flags;
+    if (!(header.flags & grebe::kFrameVirtualClock)) {
+        frame.trace.mark(grebe::TracePoint::Receive, header.producer_ts_ns, grebe::steady_now_ns());
+    }
 
-    // Copy payload
+    // Take the payload without copying when sizes match: the frame gets the
+    // received buffer and payload keeps the pooled one for the next receive
     const size_t count = static_cast<size_t>(ch) * spc;
-    if (count > 0 && payload_.size() >= count) {
-        std::memcpy(frame.mutable_data(), payload_.data(),
+    if (payload.size() == count) {
+        frame.swap_storage(payload);
+    } else if (count > 0 && payload.size() > count) {
+        std::memcpy(frame.mutable_data(), payload.data(),
                     count * sizeof(int16_t));
+    } else if (count > 0) {
+        std::memset(frame.mutable_data(), 0, count * sizeof(int16_t));
     }
-
-    out.push(std::move(frame));
-    return grebe::StageResult::Ok;
+    return frame;
 }
@@ -2,20 +2,30 @@
 
 // TransportRxStage — ITransportConsumer → IStage wrapper (Phase 12)
 // Wraps Pipe/UDP consumer as a SourceStage.
+// Frames after a gap in sequence / first_sample_index carry kFrameDiscontinuity.
 
 #include "grebe/stage.h"
 #include "ipc/transport.h"
 
+/// Build a pooled Frame from a received wire frame, marking the Receive
+/// trace point. Takes @p payload's storage when its size matches (leaving
+/// the pooled buffer in @p payload for the next receive), otherwise copies.
+grebe::Frame make_rx_frame(const FrameHeaderV2& header, std::vector<int16_t>& payload);
+
 class TransportRxStage final : public grebe::IStage {
 public:
     explicit TransportRxStage(ITransportConsumer& consumer);
 
-    grebe::StageResult process(const grebe::BatchView& in, grebe::BatchWriter& out,
+    grebe::StageResult process(grebe::BatchView& in, grebe::BatchWriter& out,
                                grebe::ExecContext& ctx) override;
 
     std::string name() const override { return "TransportRxStage"; }
 
+    /// Frames flagged kFrameDiscontinuity so far; safe from any thread.
+    uint64_t discontinuities() const { return continuity_.gaps(); }
+
 private:
     ITransportConsumer& consumer_;
     std::vector<int16_t> payload_;  // reusable buffer
+    RxContinuity continuity_;
 };
@@ -4,9 +4,9 @@
 TransportTxStage::TransportTxStage(ITransportProducer& producer)
     : producer_(producer) {}
 
-grebe::StageResult TransportTxStage::process(const grebe::BatchView& in,
-                                              grebe::BatchWriter& /*out*/,
-                                              grebe::ExecContext& /*ctx*/) {
+grebe::StageResult TransportTxStage::process(grebe::BatchView& in,
+                                             grebe::BatchWriter& /*out*/,
+                                             grebe::ExecContext& /*ctx*/) {
     if (in.empty()) return grebe::StageResult::NoData;
 
     for (size_t i = 0; i < in.size(); ++i) {
@@ -22,6 +22,7 @@ grebe::StageResult TransportTxStage::process(const grebe::BatchView& in,
             frame.data_count() * sizeof(int16_t));
         header.sample_rate_hz        = frame.sample_rate_hz;
         header.first_sample_index    = frame.first_sample_index;
+        header.flags                 = frame.flags;
 
         if (!producer_.send_frame(header, frame.data())) {
             return grebe::StageResult::Error;
@@ -10,7 +10,7 @@ class TransportTxStage final : public grebe::IStage {
 public:
     explicit TransportTxStage(ITransportProducer& producer);
 
-    grebe::StageResult process(const grebe::BatchView& in, grebe::BatchWriter& out,
+    grebe::StageResult process(grebe::BatchView& in, grebe::BatchWriter& out,
                                grebe::ExecContext& ctx) override;
 
     std::string name() const override { return "TransportTxStage"; }
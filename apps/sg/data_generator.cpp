@@ -1,5 +1,6 @@
 #include "data_generator.h"
 #include "drop_counter.h"
+#include "grebe/alloc_tracker.h"
 #include "waveform_utils.h"
 
 #ifdef _MSC_VER
@@ -204,6 +205,9 @@ void DataGenerator::rebuild_period_buffer(double sample_rate, double frequency)
 }
 
 void DataGenerator::thread_func() {
+    grebe::register_alloc_thread("sg-generator");
+    effective_placement_.set(grebe::to_string(grebe::apply_thread_placement(placement_, "sg-generator")));
+
     using Clock = std::chrono::steady_clock;
 
     // Batch sizes: larger batches at higher rates to reduce overhead
@@ -1,11 +1,14 @@
 #pragma once
 
 #include "ring_buffer.h"
+#include "grebe/thread_placement.h"
+#include "placement_report.h"
 #include "waveform_type.h"
 
 #include <array>
 #include <cstdint>
 #include <vector>
+#include <string>
 #include <thread>
 #include <atomic>
 
@@ -31,6 +34,11 @@ public:
     void start(std::vector<RingBuffer<int16_t>*> ring_buffers, double sample_rate, WaveformType type);
     void stop();
 
+    /// Generator thread placement, applied on the next start().
+    void set_placement(const grebe::ThreadPlacement& placement) { placement_ = placement; }
+    /// Effective placement of the generator thread (empty until started).
+    std::string effective_placement() const { return effective_placement_.get(); }
+
     void set_sample_rate(double rate);
     void set_frequency(double hz);                  // periodic waveform base frequency (Hz)
     void set_waveform_type(WaveformType type);           // sets all channels
@@ -81,6 +89,8 @@ private:
 
     std::vector<RingBuffer<int16_t>*> ring_buffers_;
     std::vector<DropCounter*> drop_counters_;
+    grebe::ThreadPlacement placement_;
+    PlacementReport effective_placement_;
     std::thread thread_;
     std::atomic<bool> running_{false};
     std::atomic<bool> stop_requested_{false};
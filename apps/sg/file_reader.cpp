@@ -1,5 +1,6 @@
 #include "file_reader.h"
 #include "drop_counter.h"
+#include "grebe/alloc_tracker.h"
 
 #include <spdlog/spdlog.h>
 
@@ -178,6 +179,9 @@ void FileReader::set_paused(bool paused) {
 }
 
 void FileReader::thread_func() {
+    grebe::register_alloc_thread("sg-file-reader");
+    effective_placement_.set(grebe::to_string(grebe::apply_thread_placement(placement_, "sg-file-reader")));
+
     using Clock = std::chrono::steady_clock;
 
     constexpr size_t BATCH_SIZE_LOW  = 4096;
@@ -228,11 +232,21 @@ void FileReader::thread_func() {
         }
 
         size_t this_batch = std::min(batch_size, remaining_in_file);
+        const bool virtual_clock = virtual_clock_.load(std::memory_order_relaxed);
 
         // Push samples from mmap to ring buffers per channel
         for (uint32_t ch = 0; ch < num_ch && ch < rings_.size(); ch++) {
             const int16_t* src = ch_base[ch] + read_pos;
             size_t pushed = rings_[ch]->push_bulk(src, this_batch);
+            // Virtual clock: wait for the sender instead of dropping. The
+            // ring stays full for as long as the sender is slower (the normal
+            // state when unpaced), so park like the backpressure delay below
+            // rather than spinning a core the sender may need.
+            while (virtual_clock && pushed < this_batch &&
+                   !stop_requested_.load(std::memory_order_relaxed)) {
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+                pushed += rings_[ch]->push_bulk(src + pushed, this_batch - pushed);
+            }
             if (ch < drop_counters_.size() && drop_counters_[ch]) {
                 drop_counters_[ch]->record_push(this_batch, pushed);
             }
@@ -253,6 +267,11 @@ void FileReader::thread_func() {
             rate_sample_count = 0;
         }
 
+        if (virtual_clock) {
+            next_wake = now;
+            continue;
+        }
+
         // Backpressure: extra delay when ring nearly full
         bool any_full = false;
         for (auto* rb : rings_) {
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "ring_buffer.h"
+#include "grebe/thread_placement.h"
+#include "placement_report.h"
 
 #include <atomic>
 #include <chrono>
@@ -40,6 +42,11 @@ public:
                std::vector<DropCounter*> drop_counters);
     void stop();
 
+    /// Reader thread placement, applied on the next start().
+    void set_placement(const grebe::ThreadPlacement& placement) { placement_ = placement; }
+    /// Effective placement of the reader thread (empty until started).
+    std::string effective_placement() const { return effective_placement_.get(); }
+
     void set_paused(bool paused);
     bool is_paused() const { return paused_.load(std::memory_order_relaxed); }
 
@@ -50,6 +57,11 @@ public:
     uint64_t total_file_samples() const { return header_.total_samples; }
     const std::string& path() const { return path_; }
 
+    /// Virtual-clock replay: no rate pacing, and full rings are waited on
+    /// instead of dropping samples, so the consumer sets the playback rate.
+    void set_virtual_clock(bool enabled) { virtual_clock_.store(enabled, std::memory_order_relaxed); }
+    bool is_virtual_clock() const { return virtual_clock_.load(std::memory_order_relaxed); }
+
     void set_looping(bool loop) { looping_.store(loop, std::memory_order_relaxed); }
     bool is_looping() const { return looping_.load(std::memory_order_relaxed); }
 
@@ -76,11 +88,14 @@ private:
     std::vector<DropCounter*> drop_counters_;
 
     // Thread state
+    grebe::ThreadPlacement placement_;
+    PlacementReport effective_placement_;
     std::thread thread_;
     std::atomic<bool> running_{false};
     std::atomic<bool> stop_requested_{false};
     std::atomic<bool> paused_{false};
     std::atomic<bool> looping_{true};
+    std::atomic<bool> virtual_clock_{false};
 
     // Telemetry
     std::atomic<double> actual_rate_{0.0};
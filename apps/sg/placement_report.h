@@ -0,0 +1,20 @@
+#pragma once
+
+#include <mutex>
+#include <string>
+#include <utility>
+
+/// Effective thread placement written once by a worker thread, read by the UI.
+struct PlacementReport {
+    mutable std::mutex mutex;
+    std::string text;
+
+    void set(std::string s) {
+        std::lock_guard<std::mutex> lock(mutex);
+        text = std::move(s);
+    }
+    std::string get() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return text;
+    }
+};
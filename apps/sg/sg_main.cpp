@@ -1,11 +1,16 @@
 #include "data_generator.h"
 #include "file_reader.h"
+#include "placement_report.h"
 #include "drop_counter.h"
 #include "ring_buffer.h"
 #include "ipc/transport.h"
 #include "ipc/pipe_transport.h"
 #include "ipc/udp_transport.h"
+#include "ipc/shm_transport.h"
 #include "ipc/contracts.h"
+#include "grebe/alloc_tracker.h"
+#include "grebe/frame.h"
+#include "grebe/thread_placement.h"
 
 #include <GLFW/glfw3.h>
 #include <imgui.h>
@@ -37,10 +42,17 @@ struct SgOptions {
     size_t   ring_size    = 67'108'864;  // 64M samples
     uint32_t block_size   = 16384;       // IPC block size (samples/channel/frame)
     std::string file_path;               // --file=PATH: binary file playback
-    std::string transport  = "pipe";     // --transport=pipe|udp
+    bool     virtual_clock = false;      // --virtual-clock: unpaced file replay, simulated timestamps
+    std::string transport  = "pipe";     // --transport=pipe|udp|shm
     std::string udp_host   = "127.0.0.1";
     uint16_t    udp_port   = 5000;
     size_t      datagram_size = 1400;    // max UDP datagram bytes
+    std::string shm_name   = "/grebe-sg"; // --shm-name=NAME: shared-memory queue
+    uint32_t    shm_slots  = 32;         // --shm-slots=N: payload slots
+    uint32_t    shm_consumers = 1;       // --shm-consumers=N: fan-out readers
+    std::string shm_socket;              // --shm-socket=PATH: memfd sessions (no named queue)
+    grebe::ThreadPlacement sender_placement;  // --sender-placement=SPEC
+    grebe::ThreadPlacement source_placement;  // --source-placement=SPEC (generator / file reader)
 };
 
 static void print_sg_help() {
@@ -50,13 +62,22 @@ static void print_sg_help() {
         "Usage: grebe-sg [OPTIONS]\n"
         "\n"
         "Transport:\n"
-        "  --transport=MODE   Transport mode: pipe (default) or udp\n"
+        "  --transport=MODE   Transport mode: pipe (default), udp or shm\n"
         "  --udp-target=H:P   UDP target host:port (default: 127.0.0.1:5000)\n"
+        "  --shm-name=NAME    Shared-memory queue name (default: /grebe-sg); frames\n"
+        "                     go through shared memory, commands still use stdin\n"
+        "  --shm-slots=N      Shared-memory payload slots (default: 32)\n"
+        "  --shm-consumers=N  Readers that may attach at once, each getting every\n"
+        "                     frame from the same slots (default: 1, max: 16)\n"
+        "  --shm-socket=PATH  Serve anonymous memfd sessions on a Unix socket instead\n"
+        "                     of a named queue ('@name' = abstract, Linux)\n"
         "\n"
         "Source:\n"
         "  --sample-rate=RATE Initial sample rate in Hz (default: 1000000)\n"
         "  --frequency=HZ    Waveform frequency in Hz (default: 1000)\n"
         "  --file=PATH        Binary file playback (.grb format)\n"
+        "  --virtual-clock    Replay --file as fast as the receiver accepts, with\n"
+        "                     simulated producer timestamps (no pacing, no drops)\n"
         "\n"
         "Options:\n"
         "  --channels=N       Number of channels, 1-8 (default: 1)\n"
@@ -64,6 +85,10 @@ static void print_sg_help() {
         "  --block-size=N     Samples per channel per frame (default: 16384)\n"
         "  --datagram-size=N  Max UDP datagram bytes (default: 1400, max: 65000)\n"
         "  --help             Show this help and exit\n"
+        "\n"
+        "Thread placement (SPEC = CPUS[:fifo=PRIO][:numa=NODE], e.g. 2-3:fifo=50:numa=0):\n"
+        "  --sender-placement=SPEC  Transport sender thread\n"
+        "  --source-placement=SPEC  Generator / file reader thread\n"
     );
 }
 
@@ -96,16 +121,40 @@ static int parse_sg_cli(int argc, char* argv[], SgOptions& opts) {
             opts.block_size = static_cast<uint32_t>(std::stoul(arg.substr(13)));
         } else if (arg.rfind("--file=", 0) == 0) {
             opts.file_path = arg.substr(7);
+        } else if (arg == "--virtual-clock") {
+            opts.virtual_clock = true;
         } else if (arg.rfind("--transport=", 0) == 0) {
             opts.transport = arg.substr(12);
-            if (opts.transport != "pipe" && opts.transport != "udp") {
-                spdlog::error("--transport must be 'pipe' or 'udp'");
+            if (opts.transport != "pipe" && opts.transport != "udp" &&
+                opts.transport != "shm") {
+                spdlog::error("--transport must be 'pipe', 'udp' or 'shm'");
                 return 1;
             }
+        } else if (arg.rfind("--shm-name=", 0) == 0) {
+            opts.shm_name = arg.substr(11);
+        } else if (arg.rfind("--shm-socket=", 0) == 0) {
+            opts.shm_socket = arg.substr(13);
+        } else if (arg.rfind("--shm-slots=", 0) == 0) {
+            opts.shm_slots = static_cast<uint32_t>(std::stoul(arg.substr(12)));
+            if (opts.shm_slots < 2) opts.shm_slots = 2;
+        } else if (arg.rfind("--shm-consumers=", 0) == 0) {
+            opts.shm_consumers = std::clamp<uint32_t>(
+                static_cast<uint32_t>(std::stoul(arg.substr(16))), 1,
+                grebe::ShmQueue::kMaxConsumers);
         } else if (arg.rfind("--datagram-size=", 0) == 0) {
             opts.datagram_size = std::stoull(arg.substr(16));
             if (opts.datagram_size > 65000) opts.datagram_size = 65000;
             if (opts.datagram_size < 128) opts.datagram_size = 128;
+        } else if (arg.rfind("--sender-placement=", 0) == 0) {
+            if (!grebe::parse_thread_placement(arg.substr(19), opts.sender_placement)) {
+                spdlog::error("Invalid --sender-placement: '{}'", arg.substr(19));
+                return 1;
+            }
+        } else if (arg.rfind("--source-placement=", 0) == 0) {
+            if (!grebe::parse_thread_placement(arg.substr(19), opts.source_placement)) {
+                spdlog::error("Invalid --source-placement: '{}'", arg.substr(19));
+                return 1;
+            }
         } else if (arg.rfind("--udp-target=", 0) == 0) {
             std::string val = arg.substr(13);
             auto colon = val.rfind(':');
@@ -121,24 +170,41 @@ static int parse_sg_cli(int argc, char* argv[], SgOptions& opts) {
 }
 
 // =========================================================================
-// Sender thread: drains ring buffers → sends frames via pipe
+// Sender thread: drains ring buffers → sends frames via pipe / UDP / shm
 // Decoupled from data source: uses atomic<double> for sample rate.
+// Transports with a zero-copy path (shm) get the samples popped straight
+// into their payload buffer.
 // =========================================================================
 
+/// Largest shm frame (samples per channel): the viewer's largest flow-control
+/// request (BlockSizeController::kMaxBlockScale x the default 16384). Sizes
+/// the shared slots; untouched slot pages cost no memory.
+constexpr uint32_t SG_SHM_MAX_BLOCK = 262144;
+
 static void sender_thread_func(
+    const grebe::ThreadPlacement& placement,
+    PlacementReport& placement_report,
     std::vector<RingBuffer<int16_t>*>& rings,
     ITransportProducer& producer,
     std::atomic<double>& sample_rate_ref,
     std::vector<DropCounter*>& drop_ptrs,
     uint32_t num_channels,
     std::atomic<uint32_t>& block_size_ref,
+    bool virtual_clock,
     std::atomic<bool>& stop_requested)
 {
-    constexpr uint32_t MAX_BLOCK = 65536;
-    std::vector<int16_t> payload(MAX_BLOCK * num_channels);
-    std::vector<int16_t> channel_buf(MAX_BLOCK);
+    grebe::register_alloc_thread("sg-sender");
+    placement_report.set(grebe::to_string(grebe::apply_thread_placement(placement, "sg-sender")));
+
+    // Staging buffer for copying transports; grows with flow-control blocks
+    std::vector<int16_t> payload(size_t{65536} * num_channels);
     uint64_t sequence = 0;
     uint64_t total_samples_sent = 0;
+    // Virtual clock: timestamps follow the sample position, not send time
+    const uint64_t virtual_epoch_ns = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    double virtual_elapsed_s = 0.0;
 
     while (!stop_requested.load(std::memory_order_relaxed)) {
         uint32_t block_size = block_size_ref.load(std::memory_order_relaxed);
@@ -157,11 +223,17 @@ static void sender_thread_func(
             continue;
         }
 
-        // Drain block_size from each channel and pack channel-major
+        // Drain block_size from each channel and pack channel-major, into
+        // the transport's own buffer when it has one
+        const size_t frame_samples = static_cast<size_t>(num_channels) * block_size;
+        int16_t* dst = producer.acquire_payload(frame_samples);
+        const bool zero_copy = (dst != nullptr);
+        if (!zero_copy) {
+            if (payload.size() < frame_samples) payload.resize(frame_samples);
+            dst = payload.data();
+        }
         for (uint32_t ch = 0; ch < num_channels; ch++) {
-            size_t popped = rings[ch]->pop_bulk(channel_buf.data(), block_size);
-            size_t offset = static_cast<size_t>(ch) * block_size;
-            std::memcpy(payload.data() + offset, channel_buf.data(), popped * sizeof(int16_t));
+            rings[ch]->pop_bulk(dst + static_cast<size_t>(ch) * block_size, block_size);
         }
 
         // Build frame header
@@ -176,6 +248,11 @@ static void sender_thread_func(
         header.block_length_samples = block_size;
         header.payload_bytes = num_channels * block_size * sizeof(int16_t);
         header.sample_rate_hz = sample_rate_ref.load(std::memory_order_relaxed);
+        if (virtual_clock && header.sample_rate_hz > 0.0) {
+            header.producer_ts_ns = virtual_epoch_ns + static_cast<uint64_t>(virtual_elapsed_s * 1e9);
+            header.flags = grebe::kFrameVirtualClock;
+            virtual_elapsed_s += static_cast<double>(block_size) / header.sample_rate_hz;
+        }
 
         // Accumulate SG-side drops from all channels
         uint64_t sg_drops = 0;
@@ -186,7 +263,9 @@ static void sender_thread_func(
         header.first_sample_index = total_samples_sent;
         total_samples_sent += block_size;
 
-        if (!producer.send_frame(header, payload.data())) {
+        const bool sent = zero_copy ? producer.commit_frame(header)
+                                    : producer.send_frame(header, payload.data());
+        if (!sent) {
             spdlog::info("grebe-sg: transport closed, stopping sender");
             stop_requested.store(true, std::memory_order_relaxed);
             break;
@@ -208,6 +287,9 @@ static void command_reader_func(
     ITransportProducer& producer,
     std::atomic<double>& cmd_sample_rate,
     std::atomic<bool>& cmd_toggle_paused,
+    std::atomic<uint32_t>& block_size,
+    uint32_t default_block_size,
+    uint32_t max_block_size,
     std::atomic<bool>& stop_requested)
 {
     while (!stop_requested.load(std::memory_order_relaxed)) {
@@ -221,6 +303,16 @@ static void command_reader_func(
             case IpcCommand::TOGGLE_PAUSED:
                 cmd_toggle_paused.store(true, std::memory_order_relaxed);
                 break;
+            case IpcCommand::SET_BLOCK_SIZE: {
+                // Viewer flow control: larger blocks when its pipeline runs short of
+                // credit; 0 restores the configured --block-size (e.g. after a rate change)
+                const uint32_t n = block_size_for_request(cmd.value, default_block_size,
+                                                          max_block_size);
+                if (n != block_size.exchange(n, std::memory_order_relaxed)) {
+                    spdlog::info("grebe-sg: block size -> {} (flow control)", n);
+                }
+                break;
+            }
             case IpcCommand::QUIT:
                 spdlog::info("grebe-sg: quit command received");
                 stop_requested.store(true, std::memory_order_relaxed);
@@ -258,9 +350,16 @@ int main(int argc, char* argv[]) {
     std::unique_ptr<FileReader> file_reader;
     SourceMode source_mode = SourceMode::Synthetic;
 
+    if (opts.virtual_clock && opts.file_path.empty()) {
+        spdlog::error("--virtual-clock requires --file");
+        return 1;
+    }
+
     if (!opts.file_path.empty()) {
         try {
             file_reader = std::make_unique<FileReader>(opts.file_path);
+            file_reader->set_placement(opts.source_placement);
+            file_reader->set_virtual_clock(opts.virtual_clock);
             if (file_reader->channel_count() != opts.num_channels) {
                 spdlog::warn("File has {}ch, overriding --channels={}",
                              file_reader->channel_count(), opts.num_channels);
@@ -276,7 +375,8 @@ int main(int argc, char* argv[]) {
     spdlog::info("Starting: {}ch, {:.0f} SPS, {:.2f} Hz, ring={}, block={}, source={}",
                  opts.num_channels, opts.sample_rate, opts.frequency_hz,
                  opts.ring_size, opts.block_size,
-                 source_mode == SourceMode::File ? "file" : "synthetic");
+                 source_mode == SourceMode::File
+                     ? (opts.virtual_clock ? "file (virtual clock)" : "file") : "synthetic");
 
     // Init GLFW + OpenGL (optional — headless if window creation fails)
     bool has_window = false;
@@ -334,6 +434,7 @@ int main(int argc, char* argv[]) {
     DataGenerator data_gen;
     data_gen.set_drop_counters(drop_ptrs);
     data_gen.set_frequency(opts.frequency_hz);
+    data_gen.set_placement(opts.source_placement);
 
     if (source_mode == SourceMode::Synthetic) {
         data_gen.start(ring_ptrs, opts.sample_rate, WaveformType::Sine);
@@ -346,21 +447,55 @@ int main(int argc, char* argv[]) {
     // Transport producer
     std::unique_ptr<ITransportProducer> transport;
     if (opts.transport == "udp") {
-        // UDP block size cap: each datagram must fit within the configured limit.
-        // Default 1400 bytes (safe for WSL2 loopback where >1472 is dropped).
-        // Use --datagram-size=65000 on Windows native for higher throughput.
-        uint32_t max_block = static_cast<uint32_t>(
-            (opts.datagram_size - sizeof(FrameHeaderV2)) / (opts.num_channels * sizeof(int16_t)));
-        if (opts.block_size > max_block) {
-            spdlog::info("UDP block_size {} -> {} (datagram_size={}, {}ch)",
-                         opts.block_size, max_block, opts.datagram_size, opts.num_channels);
-            opts.block_size = max_block;
+        // Frames larger than a datagram are fragmented, so block_size stays as
+        // configured. Default 1400 bytes (safe for WSL2 loopback where >1472
+        // is dropped); --datagram-size=65000 means fewer fragments per frame.
+        const size_t frame_bytes = sizeof(FrameHeaderV2) +
+            static_cast<size_t>(opts.num_channels) * opts.block_size * sizeof(int16_t);
+        if (frame_bytes > opts.datagram_size) {
+            const size_t chunk = opts.datagram_size - sizeof(UdpFragmentHeader);
+            spdlog::info("UDP frames of {} bytes sent as {} fragments (datagram_size={})",
+                         frame_bytes, (frame_bytes + chunk - 1) / chunk, opts.datagram_size);
         }
         auto udp = std::make_unique<UdpProducer>(opts.udp_host, opts.udp_port);
         udp->set_max_datagram_size(opts.datagram_size);
         transport = std::move(udp);
         spdlog::info("Transport: UDP -> {}:{} (datagram_size={})",
                      opts.udp_host, opts.udp_port, opts.datagram_size);
+    } else if (opts.transport == "shm") {
+        if (opts.block_size > SG_SHM_MAX_BLOCK) {
+            spdlog::info("shm block_size {} -> {}", opts.block_size, SG_SHM_MAX_BLOCK);
+            opts.block_size = SG_SHM_MAX_BLOCK;
+        }
+        // Block: a full queue stalls the sender and the rings absorb (and
+        // count) the overrun, as a full pipe does
+        grebe::ShmQueueConfig shm_config;
+        shm_config.slot_count = opts.shm_slots;
+        shm_config.slot_samples = static_cast<size_t>(opts.num_channels) * SG_SHM_MAX_BLOCK;
+        shm_config.policy = grebe::BackpressurePolicy::Block;
+        shm_config.max_consumers = opts.shm_consumers;
+        try {
+            if (!opts.shm_socket.empty()) {
+                // The viewer proposes channels / slot count per session; the
+                // slot size stays large enough for any flow-control block
+                grebe::ShmSessionLimits limits;
+                limits.channels = opts.num_channels;
+                limits.defaults = shm_config;
+                limits.min_slot_samples = shm_config.slot_samples;
+                limits.max_slot_samples = shm_config.slot_samples;
+                transport = std::make_unique<ShmProducer>(opts.shm_socket, limits);
+            } else {
+                transport = std::make_unique<ShmProducer>(opts.shm_name, shm_config);
+            }
+        } catch (const std::exception& e) {
+            spdlog::error("Failed to create shared-memory queue: {}", e.what());
+            data_gen.stop();
+            if (file_reader) file_reader->stop();
+            return 1;
+        }
+        spdlog::info("Transport: shm {} ({} slots, {} consumer(s), commands on stdin)",
+                     opts.shm_socket.empty() ? opts.shm_name : "sessions on " + opts.shm_socket,
+                     opts.shm_slots, opts.shm_consumers);
     } else {
         transport = std::make_unique<PipeProducer>();
         spdlog::info("Transport: pipe (stdout/stdin)");
@@ -369,21 +504,33 @@ int main(int argc, char* argv[]) {
     // Start threads
     std::atomic<bool> stop_requested{false};
     std::atomic<uint32_t> block_size{opts.block_size};
+    // SET_BLOCK_SIZE requests must leave room in the ring for the next block
+    auto max_block_size = static_cast<uint32_t>(
+        std::min<size_t>(size_t{1} << 20, opts.ring_size / 2));
+    if (opts.transport == "shm") {
+        // ... and fit a shared payload slot
+        max_block_size = std::min(max_block_size, SG_SHM_MAX_BLOCK);
+    }
 
     // Command atomics (decoupled from data source)
     std::atomic<double> cmd_sample_rate{0.0};  // 0 = no pending command
     std::atomic<bool> cmd_toggle_paused{false};
 
+    PlacementReport sender_placement;
     std::thread sender(sender_thread_func,
+                       std::cref(opts.sender_placement), std::ref(sender_placement),
                        std::ref(ring_ptrs), std::ref(*transport),
                        std::ref(current_sample_rate), std::ref(drop_ptrs),
                        opts.num_channels, std::ref(block_size),
-                       std::ref(stop_requested));
+                       opts.virtual_clock, std::ref(stop_requested));
 
     std::thread cmd_reader(command_reader_func,
                            std::ref(*transport),
                            std::ref(cmd_sample_rate),
                            std::ref(cmd_toggle_paused),
+                           std::ref(block_size),
+                           opts.block_size,
+                           max_block_size,
                            std::ref(stop_requested));
 
     // UI state
@@ -469,6 +616,9 @@ int main(int argc, char* argv[]) {
             if (opts.transport == "udp") {
                 ImGui::TextDisabled("Transport: UDP -> %s:%u",
                     opts.udp_host.c_str(), opts.udp_port);
+            } else if (opts.transport == "shm") {
+                ImGui::TextDisabled("Transport: shm %s", opts.shm_socket.empty()
+                    ? opts.shm_name.c_str() : opts.shm_socket.c_str());
             } else {
                 ImGui::TextDisabled("Transport: pipe");
             }
@@ -519,7 +669,12 @@ int main(int argc, char* argv[]) {
                 ImGui::Spacing();
 
                 // --- Block Length ---
-                ImGui::Text("Block Length");
+                // Follow viewer flow-control changes (SET_BLOCK_SIZE)
+                const uint32_t cur_block = block_size.load(std::memory_order_relaxed);
+                for (int i = 0; i < 6; i++) {
+                    if (block_options[i] == cur_block) { block_sel = i; break; }
+                }
+                ImGui::Text("Block Length: %u", cur_block);
                 if (ImGui::Combo("##block", &block_sel, block_labels, 6)) {
                     block_size.store(block_options[block_sel], std::memory_order_relaxed);
                     spdlog::info("Block size -> {}", block_options[block_sel]);
@@ -656,6 +811,8 @@ int main(int argc, char* argv[]) {
                         file_error_msg.clear();
                         try {
                             auto new_reader = std::make_unique<FileReader>(new_path);
+                            new_reader->set_placement(opts.source_placement);
+                            new_reader->set_virtual_clock(opts.virtual_clock);
                             if (new_reader->channel_count() != opts.num_channels) {
                                 file_error_msg = "Channel mismatch: file has " +
                                     std::to_string(new_reader->channel_count()) +
@@ -704,6 +861,12 @@ int main(int argc, char* argv[]) {
                 ImGui::Text("Drops: 0");
             }
 
+            // --- Effective thread placement ---
+            ImGui::TextDisabled("Sender thread: %s", sender_placement.get().c_str());
+            const std::string source_placement = (source_mode == SourceMode::File && file_reader)
+                ? file_reader->effective_placement() : data_gen.effective_placement();
+            ImGui::TextDisabled("Source thread: %s", source_placement.c_str());
+
             ImGui::End();
             ImGui::Render();
 
@@ -743,6 +906,10 @@ int main(int argc, char* argv[]) {
         file_reader->stop();
     }
 
+    // A shm sender may be waiting for a free slot: closing the queue releases it
+    if (auto* shm = dynamic_cast<ShmProducer*>(transport.get())) {
+        shm->close();
+    }
     if (sender.joinable()) sender.join();
     if (cmd_reader.joinable()) cmd_reader.join();
 
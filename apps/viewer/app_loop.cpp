@@ -11,6 +11,8 @@
 #include "hud.h"
 #include "profiler.h"
 #include "ipc/transport.h"
+#include "ipc/shm_transport.h"
+#include "ipc/udp_transport.h"
 #include "ipc/contracts.h"
 
 #include <GLFW/glfw3.h>
@@ -271,6 +273,17 @@ void run_main_loop(AppComponents& app) {
                 t0 = Benchmark::now();
                 app.render_backend->upload_vertices(display_frame.data(), display_frame.data_count());
                 app.benchmark->set_upload_time(Benchmark::elapsed_ms(t0));
+
+                // Glass-to-glass minus GPU: newest displayed sample's age at upload
+                if (display_frame.producer_ts_ns != 0 &&
+                    !(display_frame.flags & grebe::kFrameVirtualClock)) {
+                    const uint64_t now_ns = grebe::steady_now_ns();
+                    display_frame.trace.mark(grebe::TracePoint::Upload,
+                                             display_frame.producer_ts_ns, now_ns);
+                    if (now_ns >= display_frame.producer_ts_ns) {
+                        app.benchmark->record_display_latency(now_ns - display_frame.producer_ts_ns);
+                    }
+                }
             } else {
                 app.benchmark->set_upload_time(0.0);
             }
@@ -281,12 +294,19 @@ void run_main_loop(AppComponents& app) {
         // Get telemetry from runtime
         auto telem = app.runtime->telemetry();
         double dec_time_ms = 0.0;
+        grebe::Percentiles dec_pct, dec_queue_pct;
         uint64_t queue_drops = 0;
+        uint64_t credit_stalls = 0;
+        double credit_stall_ms = 0.0;
         for (auto& st : telem) {
             if (st.name == "DecimationStage") {
                 dec_time_ms = st.avg_process_time_ms;
+                dec_pct = st.process_time_ms;
+                dec_queue_pct = st.queue_time_ms;
             }
             queue_drops += st.queue_dropped;
+            credit_stalls += st.credit_stalls;
+            credit_stall_ms += st.credit_stall_ms;
         }
 
         // Effective algorithm
@@ -302,6 +322,8 @@ void run_main_loop(AppComponents& app) {
         }
 
         app.benchmark->set_decimation_time(dec_time_ms);
+        app.benchmark->set_decimation_percentiles(dec_pct, dec_queue_pct);
+        app.benchmark->set_credit_stalls(credit_stalls, credit_stall_ms);
         app.benchmark->set_decimation_ratio(dec_ratio);
 
         // Data rate: from SyntheticSource (embedded) or stored atomic
@@ -335,7 +357,10 @@ void run_main_loop(AppComponents& app) {
         }
 
         // SG-side drops (IPC mode only)
-        uint64_t sg_drops = app.transport_source ? app.transport_source->sg_drops_total() : 0;
+        uint64_t sg_drops = app.shm_consumer ? app.shm_consumer->sg_drops_total()
+                          : app.transport_source ? app.transport_source->sg_drops_total() : 0;
+        // Frames lost in transit (UDP mode only)
+        uint64_t net_lost = app.udp_consumer ? app.udp_consumer->lost_frames() : 0;
 
         // Build ImGui frame
         app.hud->new_frame();
@@ -364,6 +389,7 @@ void run_main_loop(AppComponents& app) {
                                   app.num_channels,
                                   queue_drops,
                                   sg_drops,
+                                  net_lost,
                                   window_coverage,
                                   visible_time_span_s,
                                   min_time_span_s,
@@ -454,7 +480,7 @@ void run_main_loop(AppComponents& app) {
                           telemetry.fps, telemetry.frame_time_ms,
                           app.num_channels,
                           decimation_mode_name(app.dec_stage ? app.dec_stage->effective_mode() : DecimationMode::MinMax),
-                          app.transport_source ? " | IPC" : "");
+                          app.shm_consumer ? " | IPC (shm)" : app.transport_source ? " | IPC" : "");
             glfwSetWindowTitle(app.window, title);
             last_title_update = now;
         }
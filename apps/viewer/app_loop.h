@@ -11,6 +11,8 @@ class VulkanRenderer;
 class Hud;
 class SyntheticSource;
 class TransportSource;
+class ShmConsumer;
+class UdpConsumer;
 namespace grebe {
     class LinearRuntime;
     class DecimationStage;
@@ -26,6 +28,8 @@ struct AppComponents {
     Hud* hud;
     SyntheticSource* synthetic_source = nullptr;  // non-null in embedded mode
     TransportSource* transport_source = nullptr;   // non-null in IPC/UDP mode
+    ShmConsumer* shm_consumer = nullptr;           // non-null in shm mode (frames bypass transport_source)
+    UdpConsumer* udp_consumer = nullptr;           // non-null in UDP mode (loss telemetry)
     grebe::LinearRuntime* runtime = nullptr;
     grebe::DecimationStage* dec_stage = nullptr;   // direct control (mode, rate)
     grebe::VisualizationStage* viz_stage = nullptr;  // display windowing + decimation
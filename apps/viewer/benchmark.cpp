@@ -91,6 +91,17 @@ void Benchmark::set_data_rate(double samples_per_sec) {
     data_rate_ = samples_per_sec;
 }
 
+void Benchmark::set_decimation_percentiles(const grebe::Percentiles& process_ms,
+                                           const grebe::Percentiles& queue_ms) {
+    decimate_pct_ = process_ms;
+    queue_pct_ = queue_ms;
+}
+
+void Benchmark::set_credit_stalls(uint64_t stalls, double stall_ms) {
+    credit_stalls_ = stalls;
+    credit_stall_ms_ = stall_ms;
+}
+
 grebe::TelemetrySnapshot Benchmark::snapshot() const {
     grebe::TelemetrySnapshot s;
     s.fps = fps_;
@@ -101,7 +112,15 @@ grebe::TelemetrySnapshot Benchmark::snapshot() const {
     s.render_time_ms = render_avg_;
     s.decimation_time_ms = decimate_avg_;
     s.decimation_ratio = decimate_ratio_;
+    s.decimation_p99_ms = decimate_pct_.p99;
+    s.decimation_max_ms = decimate_pct_.max;
+    s.queue_p99_ms = queue_pct_.p99;
+    const auto e2e = display_latency_.percentiles(1e-6);
+    s.e2e_p50_ms = e2e.p50;
+    s.e2e_p99_ms = e2e.p99;
     s.data_rate = data_rate_;
+    s.credit_stalls = credit_stalls_;
+    s.credit_stall_ms = credit_stall_ms_;
     s.samples_per_frame = static_cast<uint32_t>(samples_avg_);
     s.vertex_count = static_cast<uint32_t>(vtx_avg_);
     return s;
@@ -120,7 +139,11 @@ bool Benchmark::start_logging(const std::string& path) {
 
     // CSV header
     log_file_ << "frame,time_s,frame_ms,fps,drain_ms,decimate_ms,upload_ms,swap_ms,render_ms,"
-                 "samples,vtx,decimate_ratio,data_rate\n";
+                 "samples,vtx,decimate_ratio,data_rate,"
+                 "dec_p50_ms,dec_p90_ms,dec_p99_ms,dec_p999_ms,dec_max_ms,"
+                 "queue_p50_ms,queue_p90_ms,queue_p99_ms,queue_p999_ms,queue_max_ms,"
+                 "e2e_p50_ms,e2e_p90_ms,e2e_p99_ms,e2e_p999_ms,e2e_max_ms,"
+                 "credit_stalls,credit_stall_ms\n";
 
     spdlog::info("Telemetry logging started: {}", path);
     return true;
@@ -136,22 +159,33 @@ void Benchmark::write_log_row() {
     double time_s = std::chrono::duration<double>(Clock::now() - log_start_).count();
 
     // CSV row (every frame)
-    char buf[512];
+    const auto e2e = display_latency_.percentiles(1e-6);
+    char buf[1024];
     std::snprintf(buf, sizeof(buf),
-                  "%lu,%.4f,%.3f,%.1f,%.3f,%.3f,%.3f,%.3f,%.3f,%u,%u,%.1f,%.0f\n",
+                  "%lu,%.4f,%.3f,%.1f,%.3f,%.3f,%.3f,%.3f,%.3f,%u,%u,%.1f,%.0f,"
+                  "%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,"
+                  "%.4f,%.4f,%.4f,%.4f,%.4f,%llu,%.3f\n",
                   static_cast<unsigned long>(log_frame_), time_s,
                   frame_time_ms_, fps_,
                   drain_raw_, decimate_raw_, upload_raw_, swap_raw_, render_raw_,
-                  samples_raw_, vtx_raw_, decimate_ratio_raw_, data_rate_);
+                  samples_raw_, vtx_raw_, decimate_ratio_raw_, data_rate_,
+                  decimate_pct_.p50, decimate_pct_.p90, decimate_pct_.p99,
+                  decimate_pct_.p999, decimate_pct_.max,
+                  queue_pct_.p50, queue_pct_.p90, queue_pct_.p99,
+                  queue_pct_.p999, queue_pct_.max,
+                  e2e.p50, e2e.p90, e2e.p99, e2e.p999, e2e.max,
+                  static_cast<unsigned long long>(credit_stalls_), credit_stall_ms_);
     log_file_ << buf;
 
     // Stdout summary (throttled to ~1 Hz: every 60 frames)
     if (log_stdout_counter_ % 60 == 0) {
         spdlog::info("[telemetry] frame={} fps={:.1f} frame={:.2f}ms "
-                     "drain={:.2f} dec={:.2f}({:.0f}:1) upload={:.2f} swap={:.2f} render={:.2f} "
+                     "drain={:.2f} dec={:.2f}({:.0f}:1) dec_p99={:.2f} queue_p99={:.2f} "
+                     "e2e_p50={:.2f} e2e_p99={:.2f} upload={:.2f} swap={:.2f} render={:.2f} "
                      "smp={} vtx={} rate={:.0f}",
                      log_frame_, fps_, frame_time_ms_,
                      drain_raw_, decimate_raw_, decimate_ratio_raw_,
+                     decimate_pct_.p99, queue_pct_.p99, e2e.p50, e2e.p99,
                      upload_raw_, swap_raw_, render_raw_,
                      samples_raw_, vtx_raw_, data_rate_);
     }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "grebe/telemetry.h"
+#include "grebe/histogram.h"
 
 #include <chrono>
 #include <cstdint>
@@ -32,6 +33,13 @@ public:
     void set_decimation_time(double ms);
     void set_decimation_ratio(double ratio);
     void set_data_rate(double samples_per_sec);
+    // Decimation stage distributions (cumulative, from StageTelemetry)
+    void set_decimation_percentiles(const grebe::Percentiles& process_ms,
+                                    const grebe::Percentiles& queue_ms);
+    // Credit-based flow control stalls (cumulative, from StageTelemetry)
+    void set_credit_stalls(uint64_t stalls, double stall_ms);
+    // End-to-end display latency: producer timestamp → vertices uploaded (ns)
+    void record_display_latency(uint64_t ns) { display_latency_.record(ns); }
 
     double drain_time_avg()  const { return drain_avg_; }
     double upload_time_avg() const { return upload_avg_; }
@@ -107,6 +115,11 @@ private:
     double decimate_raw_    = 0.0;
     double decimate_ratio_raw_ = 1.0;
     double data_rate_   = 0.0;
+    grebe::Percentiles decimate_pct_{};
+    grebe::Percentiles queue_pct_{};
+    grebe::HdrHistogram display_latency_;
+    uint64_t credit_stalls_ = 0;
+    double credit_stall_ms_ = 0.0;
 
     // CSV log
     std::ofstream log_file_;
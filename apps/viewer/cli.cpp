@@ -15,12 +15,25 @@ static void print_help() {
         "  (default)        Pipe mode: auto-spawn grebe-sg subprocess\n"
         "  --embedded       Single-process mode (SyntheticSource, no grebe-sg)\n"
         "  --udp=PORT       UDP mode: listen on PORT for external grebe-sg\n"
+        "  --shm            Shared-memory mode: auto-spawn grebe-sg, frames are read\n"
+        "                   in place from shared memory (commands via pipe)\n"
         "\n"
         "Options:\n"
         "  --channels=N     Number of channels, 1-8 (default: 1)\n"
         "  --ring-size=SIZE Ring buffer size with K/M/G suffix (default: 64M)\n"
         "  --block-size=N   Samples per channel per frame, power of 2 (default: 16384)\n"
         "  --file=PATH      Binary file playback (.grb format, via grebe-sg)\n"
+        "  --virtual-clock  Unpaced replay (--embedded or --file): the source runs as\n"
+        "                   fast as the pipeline accepts, frames carry simulated time\n"
+        "  --dec-replicas=N Parallel decimation instances, 1-16 (default: 1)\n"
+        "  --coalesce=N     Merge contiguous source frames into blocks of N samples per\n"
+        "                   channel before decimation, 1024-1048576 (default: off)\n"
+        "  --flow=MODE      Decimation backpressure: credit (stall source, adapt block\n"
+        "                   size) or drop (discard oldest frames) (default: credit)\n"
+        "  --source-placement=SPEC     Source stage thread placement\n"
+        "  --dec-placement=SPEC        Decimation stage thread placement\n"
+        "  --sg-sender-placement=SPEC  grebe-sg sender thread placement (pipe/shm mode)\n"
+        "                   SPEC = CPUS[:fifo=PRIO][:numa=NODE], e.g. 2-3:fifo=50:numa=0\n"
         "  --no-vsync       Disable V-Sync at startup\n"
         "  --minimized      Start window iconified\n"
         "  --log            CSV telemetry logging to ./tmp/\n"
@@ -73,8 +86,51 @@ int parse_cli(int argc, char* argv[], CliOptions& opts) {
             }
         } else if (arg.rfind("--file=", 0) == 0) {
             opts.file_path = arg.substr(7);
+        } else if (arg == "--virtual-clock") {
+            opts.virtual_clock = true;
         } else if (arg.rfind("--udp=", 0) == 0) {
             opts.udp_port = static_cast<uint16_t>(std::stoul(arg.substr(6)));
+        } else if (arg == "--shm") {
+            opts.shm = true;
+        } else if (arg.rfind("--dec-replicas=", 0) == 0) {
+            opts.dec_replicas = static_cast<uint32_t>(std::stoul(arg.substr(15)));
+            if (opts.dec_replicas < 1 || opts.dec_replicas > 16) {
+                spdlog::error("--dec-replicas must be 1-16, got {}", opts.dec_replicas);
+                return 1;
+            }
+        } else if (arg.rfind("--coalesce=", 0) == 0) {
+            opts.coalesce = static_cast<uint32_t>(std::stoul(arg.substr(11)));
+            if (opts.coalesce < 1024 || opts.coalesce > 1'048'576) {
+                spdlog::error("--coalesce must be 1024-1048576, got {}", opts.coalesce);
+                return 1;
+            }
+        } else if (arg.rfind("--flow=", 0) == 0) {
+            const std::string mode = arg.substr(7);
+            if (mode == "credit") {
+                opts.credit_flow = true;
+            } else if (mode == "drop") {
+                opts.credit_flow = false;
+            } else {
+                spdlog::error("--flow must be 'credit' or 'drop', got '{}'", mode);
+                return 1;
+            }
+        } else if (arg.rfind("--source-placement=", 0) == 0) {
+            if (!grebe::parse_thread_placement(arg.substr(19), opts.source_placement)) {
+                spdlog::error("Invalid --source-placement: '{}'", arg.substr(19));
+                return 1;
+            }
+        } else if (arg.rfind("--dec-placement=", 0) == 0) {
+            if (!grebe::parse_thread_placement(arg.substr(16), opts.dec_placement)) {
+                spdlog::error("Invalid --dec-placement: '{}'", arg.substr(16));
+                return 1;
+            }
+        } else if (arg.rfind("--sg-sender-placement=", 0) == 0) {
+            grebe::ThreadPlacement check;
+            opts.sg_sender_placement = arg.substr(22);
+            if (!grebe::parse_thread_placement(opts.sg_sender_placement, check)) {
+                spdlog::error("Invalid --sg-sender-placement: '{}'", opts.sg_sender_placement);
+                return 1;
+            }
         }
     }
     if (!opts.file_path.empty() && opts.embedded) {
@@ -85,5 +141,19 @@ int parse_cli(int argc, char* argv[], CliOptions& opts) {
         spdlog::error("--udp and --embedded are mutually exclusive");
         return 1;
     }
+    if (opts.shm && (opts.embedded || opts.udp_port > 0)) {
+        spdlog::error("--shm cannot be combined with --embedded or --udp");
+        return 1;
+    }
+    if (opts.virtual_clock) {
+        if (!opts.embedded && opts.file_path.empty()) {
+            spdlog::error("--virtual-clock requires --embedded or --file");
+            return 1;
+        }
+        if (!opts.credit_flow) {
+            spdlog::error("--virtual-clock requires --flow=credit");
+            return 1;
+        }
+    }
     return 0;
 }
@@ -4,6 +4,8 @@
 #include <cstdint>
 #include <string>
 
+#include "grebe/thread_placement.h"
+
 struct CliOptions {
     bool enable_log = false;
     bool enable_profile = false;
@@ -15,7 +17,15 @@ struct CliOptions {
     bool no_vsync = false;          // --no-vsync: disable V-Sync
     bool minimized = false;         // --minimized: start window iconified
     std::string file_path;          // --file=PATH: binary file playback via grebe-sg
+    bool virtual_clock = false;     // --virtual-clock: unpaced replay with simulated timestamps
     uint16_t udp_port = 0;          // --udp=PORT: receive from external grebe-sg via UDP
+    bool shm = false;               // --shm: auto-spawned grebe-sg, frames via shared memory
+    uint32_t dec_replicas = 1;      // --dec-replicas=N: parallel DecimationStage instances
+    uint32_t coalesce = 0;          // --coalesce=N: merge source frames to N samples/channel (0 = off)
+    bool credit_flow = true;        // --flow=credit|drop: decimation input edge backpressure
+    grebe::ThreadPlacement source_placement;  // --source-placement=SPEC: source stage (and its I/O reactor)
+    grebe::ThreadPlacement dec_placement;     // --dec-placement=SPEC: DecimationStage (all replicas)
+    std::string sg_sender_placement;          // --sg-sender-placement=SPEC: forwarded to grebe-sg
 };
 
 // Returns 0 on success, non-zero on error (caller should exit with that code).
@@ -9,6 +9,7 @@
 #include <algorithm>
 #include <cmath>
 #include <cstdio>
+#include <cstring>
 #include <stdexcept>
 
 namespace {
@@ -122,6 +123,7 @@ void Hud::build_status_bar(const grebe::TelemetrySnapshot& telemetry,
                             bool paused,
                             grebe::DecimationAlgorithm dec_algo, uint32_t channel_count,
                             uint64_t total_drops, uint64_t sg_drops,
+                            uint64_t net_lost,
                             double window_coverage,
                             double visible_time_span_s,
                             double min_time_span_s,
@@ -272,7 +274,7 @@ void Hud::build_status_bar(const grebe::TelemetrySnapshot& telemetry,
     else if (telemetry.vertex_count >= 1'000) { display_vtx = telemetry.vertex_count / 1e3; vtx_suffix = "K"; }
 
     // Line 1: overview
-    bool has_drops = (total_drops > 0 || sg_drops > 0);
+    bool has_drops = (total_drops > 0 || sg_drops > 0 || net_lost > 0);
     if (has_drops) {
         char alert_str[128] = "";
         if (sg_drops > 0 && total_drops > 0) {
@@ -282,10 +284,15 @@ void Hud::build_status_bar(const grebe::TelemetrySnapshot& telemetry,
         } else if (sg_drops > 0) {
             std::snprintf(alert_str, sizeof(alert_str), "SG-DROP:%llu",
                           static_cast<unsigned long long>(sg_drops));
-        } else {
+        } else if (total_drops > 0) {
             std::snprintf(alert_str, sizeof(alert_str), "DROP:%llu",
                           static_cast<unsigned long long>(total_drops));
         }
+        if (net_lost > 0) {
+            const size_t len = std::strlen(alert_str);
+            std::snprintf(alert_str + len, sizeof(alert_str) - len, "%sNET-LOSS:%llu",
+                          len > 0 ? " " : "", static_cast<unsigned long long>(net_lost));
+        }
         ImGui::Text("FPS: %.1f | Frame: %.2f ms | %uch | Rate: %.1f %s | Vtx: %.1f%s | %s | %s%s",
                     telemetry.fps, telemetry.frame_time_ms, channel_count, display_rate, rate_suffix,
                     display_vtx, vtx_suffix,
@@ -301,9 +308,13 @@ void Hud::build_status_bar(const grebe::TelemetrySnapshot& telemetry,
     }
 
     // Line 2: per-phase telemetry + visible span + window coverage
-    ImGui::Text("Drain: %.2f ms | Dec: %.2f ms (%.0f:1) | Upload: %.2f ms | Swap: %.2f ms | Render: %.2f ms | Smp/f: %u | Span: %s | WCov: %.0f%%",
+    ImGui::Text("Drain: %.2f ms | Credit stalls: %llu (%.0f ms) | Dec: %.2f ms (%.0f:1, p99 %.2f, max %.2f, queue p99 %.2f) | E2E: p50 %.2f p99 %.2f ms | Upload: %.2f ms | Swap: %.2f ms | Render: %.2f ms | Smp/f: %u | Span: %s | WCov: %.0f%%",
                 telemetry.drain_time_ms,
+                static_cast<unsigned long long>(telemetry.credit_stalls), telemetry.credit_stall_ms,
                 telemetry.decimation_time_ms, telemetry.decimation_ratio,
+                telemetry.decimation_p99_ms, telemetry.decimation_max_ms,
+                telemetry.queue_p99_ms,
+                telemetry.e2e_p50_ms, telemetry.e2e_p99_ms,
                 telemetry.upload_time_ms,
                 telemetry.swap_time_ms, telemetry.render_time_ms,
                 telemetry.samples_per_frame,
@@ -38,6 +38,7 @@ public:
                           uint32_t channel_count = 1,
                           uint64_t total_drops = 0,
                           uint64_t sg_drops = 0,
+                          uint64_t net_lost = 0,
                           double window_coverage = 0.0,
                           double visible_time_span_s = 0.0,
                           double min_time_span_s = 0.0,
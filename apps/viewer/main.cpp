@@ -4,12 +4,17 @@
 #include "vulkan_renderer.h"
 #include "synthetic_source.h"
 #include "transport_source.h"
+#include "grebe/alloc_tracker.h"
+#include "grebe/async.h"
 #include "grebe/config.h"
 #include "grebe/runtime.h"
 #include "grebe/queue.h"
 #include "stages/data_source_adapter.h"
+#include "stages/coalesce_stage.h"
 #include "stages/decimation_stage.h"
 #include "stages/visualization_stage.h"
+#include "stages/shm_reader_stage.h"
+#include "stages/async_transport_rx_stage.h"
 #include "benchmark.h"
 #include "hud.h"
 #include "profiler.h"
@@ -17,6 +22,7 @@
 #include "process_handle.h"
 #include "ipc/pipe_transport.h"
 #include "ipc/udp_transport.h"
+#include "ipc/shm_transport.h"
 #include "ipc/contracts.h"
 
 #include <GLFW/glfw3.h>
@@ -29,6 +35,13 @@
 #include <string>
 #include <vector>
 
+#ifdef _WIN32
+#include <io.h>
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
 // Find the grebe-sg binary next to the grebe binary
 static std::string find_sg_binary(const char* argv0) {
     std::filesystem::path exe_path(argv0);
@@ -119,13 +132,18 @@ int main(int argc, char* argv[]) {
                  vk_renderer.render_pass(), vk_renderer.image_count());
 
         // =====================================================================
-        // Data source: SyntheticSource / TransportSource (pipe or UDP)
+        // Data source: SyntheticSource / TransportSource (pipe or UDP) /
+        // ShmConsumer (frames read in place; TransportSource only for commands)
         // =====================================================================
         std::unique_ptr<SyntheticSource> synthetic_source;
         std::unique_ptr<TransportSource> transport_source;
         std::unique_ptr<ProcessHandle> sg_process;
         std::unique_ptr<PipeConsumer> pipe_consumer;
         std::unique_ptr<UdpConsumer> udp_consumer;
+        std::unique_ptr<ShmConsumer> shm_consumer;
+        // Drives AsyncTransportRxStage; declared before the runtime so it
+        // outlives the stage
+        std::unique_ptr<grebe::Reactor> reactor;
 
         if (opts.udp_port > 0) {
             // UDP mode: receive from external grebe-sg, no subprocess
@@ -137,8 +155,10 @@ int main(int argc, char* argv[]) {
         } else if (opts.embedded) {
             synthetic_source = std::make_unique<SyntheticSource>(
                 pipeline_config.channel_count, 1'000'000.0, WaveformType::Sine);
+            synthetic_source->set_virtual_clock(opts.virtual_clock);
             synthetic_source->start();
-            spdlog::info("Embedded mode: SyntheticSource");
+            spdlog::info("Embedded mode: SyntheticSource{}",
+                         opts.virtual_clock ? " (virtual clock)" : "");
         } else {
             std::string sg_path = find_sg_binary(argv[0]);
             std::vector<std::string> sg_args;
@@ -150,6 +170,34 @@ int main(int argc, char* argv[]) {
             if (!opts.file_path.empty()) {
                 sg_args.push_back("--file=" + opts.file_path);
             }
+            if (opts.virtual_clock) {
+                sg_args.push_back("--virtual-clock");
+            }
+            if (!opts.sg_sender_placement.empty()) {
+                sg_args.push_back("--sender-placement=" + opts.sg_sender_placement);
+            }
+#ifdef _WIN32
+            const int viewer_pid = _getpid();
+#else
+            const int viewer_pid = static_cast<int>(getpid());
+#endif
+            // POSIX: a memfd session handed over a Unix socket (nothing to
+            // clean up after a crash); Windows: a named mapping
+#ifdef _WIN32
+            const std::string shm_name = "/grebe-sg-" + std::to_string(viewer_pid);
+#elif defined(__linux__)
+            const std::string shm_name = "@grebe-sg-" + std::to_string(viewer_pid);
+#else
+            const std::string shm_name = "/tmp/grebe-sg-" + std::to_string(viewer_pid) + ".sock";
+#endif
+            if (opts.shm) {
+                sg_args.push_back("--transport=shm");
+#ifdef _WIN32
+                sg_args.push_back("--shm-name=" + shm_name);
+#else
+                sg_args.push_back("--shm-socket=" + shm_name);
+#endif
+            }
 
             sg_process = std::make_unique<ProcessHandle>();
             int stdin_fd = -1, stdout_fd = -1;
@@ -158,20 +206,63 @@ int main(int argc, char* argv[]) {
             }
             spdlog::info("IPC mode: spawned grebe-sg PID {}", sg_process->pid());
 
-            pipe_consumer = std::make_unique<PipeConsumer>(stdout_fd, stdin_fd);
-            transport_source = std::make_unique<TransportSource>(
-                *pipe_consumer, pipeline_config.channel_count);
+            if (opts.shm) {
+                // Frames arrive through shared memory; stdin stays the command channel
+#ifdef _WIN32
+                _close(stdout_fd);
+#else
+                ::close(stdout_fd);
+#endif
+#ifdef _WIN32
+                shm_consumer = std::make_unique<ShmConsumer>(shm_name, stdin_fd);
+#else
+                ShmConsumer::Session session;
+                session.socket_path = shm_name;
+                session.geometry.channels = pipeline_config.channel_count;
+                shm_consumer = std::make_unique<ShmConsumer>(session, stdin_fd);
+#endif
+                transport_source = std::make_unique<TransportSource>(
+                    *shm_consumer, pipeline_config.channel_count);
+                spdlog::info("IPC mode: shared memory {}", shm_name);
+            } else {
+                pipe_consumer = std::make_unique<PipeConsumer>(stdout_fd, stdin_fd);
+                transport_source = std::make_unique<TransportSource>(
+                    *pipe_consumer, pipeline_config.channel_count);
+            }
             transport_source->start();
         }
 
         // =====================================================================
-        // Stage pipeline: DataSourceAdapter → DecimationStage
+        // Stage pipeline: DataSourceAdapter / ShmReaderStage /
+        // AsyncTransportRxStage → DecimationStage
         // =====================================================================
         grebe::IDataSource* data_source = synthetic_source
             ? static_cast<grebe::IDataSource*>(synthetic_source.get())
             : static_cast<grebe::IDataSource*>(transport_source.get());
 
-        auto adapter = std::make_unique<grebe::DataSourceAdapter>(*data_source);
+        // shm: Borrowed frames straight from the shared slots (no copy, no
+        // block-size adaptation: the bounded slot pool stalls grebe-sg instead)
+        std::unique_ptr<grebe::IStage> source_stage;
+        ITransportConsumer* rx_consumer = udp_consumer
+            ? static_cast<ITransportConsumer*>(udp_consumer.get())
+            : static_cast<ITransportConsumer*>(pipe_consumer.get());
+        if (shm_consumer) {
+            source_stage = std::make_unique<ShmReaderStage>(*shm_consumer);
+        } else if (rx_consumer && grebe::Reactor::supported() && rx_consumer->poll_fd() >= 0) {
+            // UDP / pipe: the receive suspends on the reactor instead of
+            // blocking the stage thread, so runtime.stop() returns at once
+            // rather than after the socket's receive timeout. TransportSource
+            // stays the command channel and keeps the header telemetry
+            reactor = std::make_unique<grebe::Reactor>(opts.source_placement);
+            auto rx_stage = std::make_unique<AsyncTransportRxStage>(*reactor, *rx_consumer);
+            rx_stage->set_header_observer([ts = transport_source.get()](const FrameHeaderV2& hdr) {
+                ts->observe_header(hdr);
+            });
+            source_stage = std::move(rx_stage);
+            spdlog::info("Receiving on the I/O reactor (AsyncTransportRxStage)");
+        } else {
+            source_stage = std::make_unique<grebe::DataSourceAdapter>(*data_source);
+        }
         auto dec_stage = std::make_unique<grebe::DecimationStage>(
             DecimationMode::MinMax,
             pipeline_config.decimation.target_points);
@@ -180,13 +271,45 @@ int main(int argc, char* argv[]) {
         // Keep raw pointer for runtime control
         auto* dec_stage_ptr = dec_stage.get();
 
-        grebe::LinearRuntime runtime;
-        runtime.add_stage(std::move(adapter));
-        runtime.add_stage(std::move(dec_stage), 512, grebe::BackpressurePolicy::DropOldest);
+        grebe::RuntimeOptions runtime_opts;
+        // Per-stage allocation / page-fault rates for the profile report
+        runtime_opts.alloc_accounting = opts.enable_profile;
+        grebe::LinearRuntime runtime(runtime_opts);
+        grebe::StageOptions source_opts;
+        source_opts.placement = opts.source_placement;
+        runtime.add_stage(std::move(source_stage), source_opts);
+        grebe::StageOptions dec_opts;
+        dec_opts.queue_capacity = 512;
+        // Credit: the source stalls and grows its block size instead of the
+        // queue discarding raw frames when decimation falls behind
+        dec_opts.policy = opts.credit_flow ? grebe::BackpressurePolicy::Credit
+                                           : grebe::BackpressurePolicy::DropOldest;
+        dec_opts.queue_kind = grebe::QueueKind::Spsc;
+        if (opts.coalesce > 0) {
+            // Small source blocks (UDP datagrams, --block-size=1024): merge
+            // them so decimation runs on large blocks. Same queue settings,
+            // so credit stalls still propagate to the source
+            grebe::CoalesceOptions coalesce_opts;
+            coalesce_opts.target_samples_per_channel = opts.coalesce;
+            grebe::StageOptions coalesce_stage_opts = dec_opts;
+            coalesce_stage_opts.placement = {};
+            runtime.add_stage(std::make_unique<grebe::CoalesceStage>(coalesce_opts),
+                              coalesce_stage_opts);
+        }
+        // Spsc input edge: StageGraph builds it as Mpmc when replicas > 1
+        dec_opts.replicas = opts.dec_replicas;
+        dec_opts.placement = opts.dec_placement;
+        runtime.add_stage(std::move(dec_stage), dec_opts);
+        // Display output stays latest-wins: a stalled render loop (e.g. a
+        // minimized window) must not hold back the pipeline
+        runtime.set_output_options({512, grebe::BackpressurePolicy::DropOldest,
+                                    grebe::QueueKind::Spsc});
         runtime.start();
 
-        spdlog::info("Pipeline started: {}ch, 1 MSPS, decimation=MinMax (LinearRuntime)",
-                     pipeline_config.channel_count);
+        spdlog::info("Pipeline started: {}ch, 1 MSPS, decimation=MinMax x{}, flow={}, coalesce={} (LinearRuntime)",
+                     pipeline_config.channel_count, opts.dec_replicas,
+                     opts.credit_flow ? "credit" : "drop",
+                     opts.coalesce > 0 ? std::to_string(opts.coalesce) : std::string("off"));
 
         // Visualization stage (main-thread, not in pipeline)
         grebe::VisualizationStage viz_stage(pipeline_config.decimation.target_points);
@@ -194,6 +317,9 @@ int main(int argc, char* argv[]) {
         ProfileRunner profiler;
         profiler.set_channel_count(pipeline_config.channel_count);
         profiler.set_synthetic_source(synthetic_source.get());
+        profiler.set_runtime(&runtime);
+        // Render loop: visualization, upload and HUD allocations show up here
+        grebe::register_alloc_thread("main");
         if (opts.enable_profile) {
             spdlog::info("Profile mode enabled");
             if (!benchmark.is_logging()) {
@@ -217,6 +343,8 @@ int main(int argc, char* argv[]) {
         app.hud = &hud;
         app.synthetic_source = synthetic_source.get();
         app.transport_source = transport_source.get();
+        app.shm_consumer = shm_consumer.get();
+        app.udp_consumer = udp_consumer.get();
         app.runtime = &runtime;
         app.dec_stage = dec_stage_ptr;
         app.viz_stage = &viz_stage;
@@ -239,8 +367,15 @@ int main(int argc, char* argv[]) {
             synthetic_source->stop();
         } else if (transport_source) {
             // Close transport to unblock any blocking receive_frame()
-            if (udp_consumer) udp_consumer->close();
+            // (DataSourceAdapter fallback without a reactor)
+            if (udp_consumer) {
+                udp_consumer->close();
+                spdlog::info("UDP: {} frames lost, {} reordered, {} duplicates, {} reassembly drops",
+                             udp_consumer->lost_frames(), udp_consumer->reordered_frames(),
+                             udp_consumer->duplicate_frames(), udp_consumer->reassembly_drops());
+            }
             if (pipe_consumer) pipe_consumer.reset();
+            if (shm_consumer) shm_consumer->close();
             transport_source->stop();
         }
 
@@ -161,6 +161,10 @@ void ProfileRunner::on_frame(const Benchmark& bench, uint32_t vertex_count,
 
     // Collect metrics during measurement phase
     if (!in_warmup) {
+        if (frame_in_scenario_ == scenario.warmup_frames) {
+            snapshot_allocs();
+        }
+
         FrameSample sample;
         sample.frame_time_ms = bench.frame_time_ms();
         sample.drain_ms      = bench.drain_time_avg();
@@ -235,6 +239,7 @@ void ProfileRunner::on_frame(const Benchmark& bench, uint32_t vertex_count,
         result.drop_total = total_drops - drops_at_start_;
         result.sg_drop_total = sg_drops - sg_drops_at_start_;
         result.pass = result.fps.avg >= scenario.min_fps_threshold;
+        compute_alloc_rates(result);
 
         spdlog::info("[profile] Scenario '{}' complete: FPS avg={:.1f} min={:.1f} max={:.1f} drops={} coverage={:.1f}% envelope={:.1f}% \xe2\x86\x92 {}",
                      scenario.name, result.fps.avg, result.fps.min, result.fps.max,
@@ -243,6 +248,15 @@ void ProfileRunner::on_frame(const Benchmark& bench, uint32_t vertex_count,
                      v_envelope.empty() ? -1.0 : result.envelope_match_rate.avg * 100.0,
                      result.pass ? "PASS" : "FAIL");
 
+        for (const auto& a : result.stage_allocs) {
+            spdlog::info("[profile]   stage {:<20} {:>10.1f} allocs/s {:>12.0f} B/s {:>8.1f} faults/s",
+                         a.name, a.allocs_per_sec, a.bytes_per_sec, a.minor_faults_per_sec);
+        }
+        for (const auto& a : result.thread_allocs) {
+            spdlog::info("[profile]   thread {:<19} {:>10.1f} allocs/s {:>12.0f} B/s {:>8.1f} faults/s",
+                         a.name, a.allocs_per_sec, a.bytes_per_sec, a.minor_faults_per_sec);
+        }
+
         results_.push_back(result);
 
         // Next scenario
@@ -256,6 +270,64 @@ void ProfileRunner::on_frame(const Benchmark& bench, uint32_t vertex_count,
     }
 }
 
+void ProfileRunner::snapshot_allocs() {
+    measure_start_ = std::chrono::steady_clock::now();
+    stages_at_start_ = runtime_ ? runtime_->telemetry() : std::vector<grebe::StageTelemetry>{};
+    threads_at_start_ = grebe::alloc_thread_report();
+}
+
+void ProfileRunner::compute_alloc_rates(ScenarioResult& result) const {
+    const double secs = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - measure_start_).count();
+    auto make_rate = [secs](const std::string& name, uint64_t allocs, uint64_t bytes,
+                            uint64_t faults) {
+        AllocRate a;
+        a.name = name;
+        a.allocations = allocs;
+        a.bytes = bytes;
+        a.minor_faults = faults;
+        if (secs > 0.0) {
+            a.allocs_per_sec = static_cast<double>(allocs) / secs;
+            a.bytes_per_sec = static_cast<double>(bytes) / secs;
+            a.minor_faults_per_sec = static_cast<double>(faults) / secs;
+        }
+        return a;
+    };
+
+    if (runtime_) {
+        const auto stages = runtime_->telemetry();
+        for (size_t i = 0; i < stages.size() && i < stages_at_start_.size(); ++i) {
+            const auto& b = stages_at_start_[i];
+            const auto& e = stages[i];
+            result.stage_allocs.push_back(make_rate(e.name,
+                e.heap_allocations - b.heap_allocations,
+                e.heap_bytes - b.heap_bytes,
+                e.minor_faults - b.minor_faults));
+        }
+    }
+
+    // Threads registered after the snapshot (e.g. a restarted source) count
+    // from zero. An exited total also holds what threads that were live at
+    // the snapshot and have exited since had counted by then.
+    const auto threads = grebe::alloc_thread_report();
+    auto still_live = [&threads](const grebe::ThreadAllocReport& b) {
+        return std::any_of(threads.begin(), threads.end(), [&b](const auto& t) {
+            return !t.exited && t.thread_id == b.thread_id;
+        });
+    };
+    for (const auto& t : threads) {
+        grebe::AllocCounters delta = t.counters;
+        for (const auto& b : threads_at_start_) {
+            if (b.name != t.name) continue;
+            if (t.exited ? (b.exited || !still_live(b)) : b.thread_id == t.thread_id) {
+                delta -= b.counters;
+            }
+        }
+        result.thread_allocs.push_back(make_rate(t.name, delta.allocations, delta.bytes,
+                                                 delta.minor_faults));
+    }
+}
+
 MetricStats ProfileRunner::compute_stats(const std::vector<double>& values) {
     MetricStats stats;
     if (values.empty()) return stats;
@@ -327,6 +399,20 @@ static nlohmann::json stats_to_json(const MetricStats& s) {
     };
 }
 
+static nlohmann::json allocs_to_json(const std::vector<AllocRate>& rates) {
+    nlohmann::json arr = nlohmann::json::array();
+    for (const auto& a : rates) {
+        arr.push_back({
+            {"name", a.name},
+            {"allocations", a.allocations}, {"bytes", a.bytes},
+            {"minor_faults", a.minor_faults},
+            {"allocs_per_sec", a.allocs_per_sec}, {"bytes_per_sec", a.bytes_per_sec},
+            {"minor_faults_per_sec", a.minor_faults_per_sec},
+        });
+    }
+    return arr;
+}
+
 int ProfileRunner::generate_report() const {
     bool overall_pass = true;
 
@@ -385,11 +471,16 @@ int ProfileRunner::generate_report() const {
         };
         s["drop_total"] = r.drop_total;
         s["sg_drop_total"] = r.sg_drop_total;
+        s["allocations"] = {
+            {"stages",  allocs_to_json(r.stage_allocs)},
+            {"threads", allocs_to_json(r.thread_allocs)},
+        };
         s["pass"] = r.pass;
         scenarios_json.push_back(s);
     }
     report["scenarios"] = scenarios_json;
     report["channel_count"] = channel_count_;
+    report["alloc_hooks"] = grebe::alloc_hooks_installed();
     report["overall_pass"] = overall_pass;
 
     // Write JSON file
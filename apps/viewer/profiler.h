@@ -1,9 +1,12 @@
 #pragma once
 
+#include "grebe/alloc_tracker.h"
 #include "grebe/decimation_engine.h"
+#include "grebe/runtime.h"
 #include "envelope_verifier.h"
 #include "waveform_utils.h"
 
+#include <chrono>
 #include <cstdint>
 #include <string>
 #include <vector>
@@ -44,6 +47,17 @@ struct ScenarioConfig {
     double min_fps_threshold = 30.0;
 };
 
+// Heap activity of one runtime stage or named thread during the measurement phase
+struct AllocRate {
+    std::string name;
+    uint64_t allocations = 0;
+    uint64_t bytes = 0;
+    uint64_t minor_faults = 0;
+    double allocs_per_sec = 0.0;
+    double bytes_per_sec = 0.0;
+    double minor_faults_per_sec = 0.0;
+};
+
 struct ScenarioResult {
     ScenarioConfig config;
     MetricStats fps;
@@ -60,6 +74,8 @@ struct ScenarioResult {
     MetricStats envelope_match_rate;  // excludes skipped frames (-1)
     uint64_t drop_total = 0;     // net viewer-side drops during measurement phase
     uint64_t sg_drop_total = 0;  // SG-side drops at end of measurement phase
+    std::vector<AllocRate> stage_allocs;   // per runtime stage (alloc_accounting)
+    std::vector<AllocRate> thread_allocs;  // per registered thread
     bool pass = false;
 };
 
@@ -86,6 +102,7 @@ public:
 
     void set_channel_count(uint32_t n) { channel_count_ = n; }
     void set_synthetic_source(SyntheticSource* src) { synthetic_source_ = src; }
+    void set_runtime(const grebe::LinearRuntime* rt) { runtime_ = rt; }
 
     // Generate report to stdout + JSON file.
     // Returns exit code: 0 = all pass, 1 = any fail.
@@ -96,6 +113,8 @@ private:
     static MetricStats derive_fps_stats(const std::vector<double>& frame_ms_values);
     void build_scenarios();
     void init_envelope_verifiers();
+    void snapshot_allocs();
+    void compute_alloc_rates(ScenarioResult& result) const;
     double run_envelope_verification(const int16_t* frame_data, uint32_t per_ch_vtx,
                                       uint32_t raw_samples, grebe::DecimationAlgorithm dec_algo,
                                       const std::vector<uint32_t>* per_ch_raw);
@@ -114,6 +133,12 @@ private:
     uint64_t sg_drops_at_start_ = 0;  // snapshot at scenario start (SG-side)
 
     SyntheticSource* synthetic_source_ = nullptr;
+    const grebe::LinearRuntime* runtime_ = nullptr;
+
+    // Allocation counters at the start of the measurement phase
+    std::chrono::steady_clock::time_point measure_start_;
+    std::vector<grebe::StageTelemetry> stages_at_start_;
+    std::vector<grebe::ThreadAllocReport> threads_at_start_;
     std::vector<EnvelopeVerifier> envelope_verifiers_;
     std::vector<std::vector<int16_t>> ipc_period_buffers_;  // IPC mode: locally-generated period buffers
     bool envelope_verifiers_initialized_ = false;
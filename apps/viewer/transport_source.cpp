@@ -1,6 +1,7 @@
 #include "transport_source.h"
 #include "ipc/transport.h"
 #include "ipc/contracts.h"
+#include "grebe/frame.h"
 
 #include <spdlog/spdlog.h>
 
@@ -29,28 +30,42 @@ grebe::ReadResult TransportSource::read_frame(grebe::FrameBuffer& frame) {
         return grebe::ReadResult::EndOfStream;
     }
 
+    // Receive straight into the caller's buffer (reuses its capacity)
     FrameHeaderV2 hdr{};
-    std::vector<int16_t> payload;
 
-    if (!transport_.receive_frame(hdr, payload)) {
+    if (!transport_.receive_frame(hdr, frame.data)) {
         spdlog::info("TransportSource: connection closed");
         return grebe::ReadResult::EndOfStream;
     }
 
-    // Update sample rate from header
-    if (hdr.sample_rate_hz > 0.0) {
-        sample_rate_.store(hdr.sample_rate_hz, std::memory_order_relaxed);
-    }
-
-    // Track SG-side drops
-    sg_drops_total_.store(hdr.sg_drops_total, std::memory_order_relaxed);
+    observe_header(hdr);
 
     // Convert to FrameBuffer
     frame.sequence = hdr.sequence;
     frame.producer_ts_ns = hdr.producer_ts_ns;
+    frame.first_sample_index = hdr.first_sample_index;
+    frame.receive_ts_ns = grebe::steady_now_ns();
     frame.channel_count = hdr.channel_count;
     frame.samples_per_channel = hdr.block_length_samples;
-    frame.data = std::move(payload);
+    frame.flags = hdr.flags | (continuity_.gap(hdr) ? grebe::kFrameDiscontinuity : 0);
 
     return grebe::ReadResult::Ok;
 }
+
+void TransportSource::observe_header(const FrameHeaderV2& hdr) {
+    // Update sample rate from header
+    if (hdr.sample_rate_hz > 0.0) {
+        sample_rate_.store(hdr.sample_rate_hz, std::memory_order_relaxed);
+    }
+
+    // Track SG-side drops
+    sg_drops_total_.store(hdr.sg_drops_total, std::memory_order_relaxed);
+}
+
+bool TransportSource::request_block_size(uint32_t samples_per_channel) {
+    // Forwarded to grebe-sg (pipe); UDP has no command channel
+    IpcCommand cmd{};
+    cmd.type = IpcCommand::SET_BLOCK_SIZE;
+    cmd.value = static_cast<double>(samples_per_channel);
+    return transport_.send_command(cmd);
+}
@@ -1,15 +1,16 @@
 #pragma once
 
 #include "grebe/data_source.h"
+#include "ipc/transport.h"
 
 #include <atomic>
 #include <cstdint>
 
-class ITransportConsumer;
-struct FrameHeaderV2;
-
 /// TransportSource: IDataSource implementation wrapping any ITransportConsumer.
-/// Receives frames from grebe-sg via pipe, UDP, or other transport.
+/// Receives frames from grebe-sg via pipe, UDP, or other transport. Where a
+/// stage receives the frames instead (ShmReaderStage, AsyncTransportRxStage),
+/// it carries the commands, plus the header telemetry the stage feeds to
+/// observe_header().
 class TransportSource : public grebe::IDataSource {
 public:
     TransportSource(ITransportConsumer& transport, uint32_t num_channels);
@@ -20,12 +21,17 @@ public:
     grebe::ReadResult read_frame(grebe::FrameBuffer& frame) override;
     void start() override;
     void stop() override;
+    bool request_block_size(uint32_t samples_per_channel) override;
 
     // IPC-specific: access the underlying transport for command sending
     ITransportConsumer& transport() { return transport_; }
 
-    // Telemetry propagated from SG headers
+    // Telemetry propagated from SG headers (read_frame(), or the receiving
+    // stage's header observer)
+    void observe_header(const FrameHeaderV2& hdr);
     uint64_t sg_drops_total() const { return sg_drops_total_.load(std::memory_order_relaxed); }
+    // Frames flagged kFrameDiscontinuity (gap in sequence / sample index)
+    uint64_t discontinuities() const { return continuity_.gaps(); }
 
 private:
     ITransportConsumer& transport_;
@@ -33,4 +39,5 @@ private:
     std::atomic<double> sample_rate_{0.0};
     std::atomic<uint64_t> sg_drops_total_{0};
     std::atomic<bool> started_{false};
+    RxContinuity continuity_;
 };
@@ -0,0 +1,76 @@
+#pragma once
+
+// AllocTracker — Heap allocation and page-fault accounting per thread (NFR-08)
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace grebe {
+
+/// Cumulative heap and page-fault counters of one thread.
+///
+/// Heap fields are maintained by the global operator new/delete hooks
+/// (src/core/alloc_hooks.cpp), which an application opts into by linking
+/// them (CMake GREBE_ALLOC_HOOKS; always linked into grebe-bench). Without
+/// the hooks they stay zero. minor_faults comes from the OS and is always
+/// available on Linux.
+struct AllocCounters {
+    uint64_t allocations  = 0;  ///< operator new calls
+    uint64_t frees        = 0;  ///< operator delete calls (non-null)
+    uint64_t bytes        = 0;  ///< bytes requested by operator new
+    uint64_t minor_faults = 0;  ///< minor page faults (first touch of a page)
+
+    AllocCounters& operator+=(const AllocCounters& o) {
+        allocations  += o.allocations;
+        frees        += o.frees;
+        bytes        += o.bytes;
+        minor_faults += o.minor_faults;
+        return *this;
+    }
+    AllocCounters& operator-=(const AllocCounters& o) {
+        allocations  -= o.allocations;
+        frees        -= o.frees;
+        bytes        -= o.bytes;
+        minor_faults -= o.minor_faults;
+        return *this;
+    }
+    friend AllocCounters operator-(AllocCounters a, const AllocCounters& b) { return a -= b; }
+};
+
+/// True if the operator new/delete hooks are linked into this binary.
+bool alloc_hooks_installed();
+
+/// Counters of the calling thread since it started.
+/// Costs one getrusage() call (minor faults); use thread_heap_counters()
+/// where only the heap fields are needed.
+AllocCounters thread_alloc_counters();
+
+/// Heap fields only (minor_faults = 0). Reads thread-local counters.
+AllocCounters thread_heap_counters();
+
+/// Minor page faults of the calling thread (0 where unsupported).
+uint64_t thread_minor_faults();
+
+/// Register the calling thread under @p name for alloc_thread_report().
+/// The runtime, decimation, ingestion, reactor and grebe-sg threads
+/// register themselves as they start; call it for other threads (e.g. the
+/// render loop). A second call renames. When the thread exits, its
+/// final counters are folded into one exited entry per name, so threads
+/// that come and go (reconnects, restarted sources) don't grow the report.
+void register_alloc_thread(const std::string& name);
+
+/// Counters of one registered thread, or of every exited thread of a name.
+struct ThreadAllocReport {
+    std::string   name;
+    uint64_t      thread_id = 0;  ///< OS thread id (0 for an exited total)
+    bool          exited    = false;
+    uint32_t      threads   = 1;  ///< exited threads summed into counters
+    AllocCounters counters;
+};
+
+/// Snapshot of every registered thread, in registration order. Minor
+/// faults of other live threads are read from /proc/self/task (Linux).
+std::vector<ThreadAllocReport> alloc_thread_report();
+
+} // namespace grebe
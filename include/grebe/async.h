@@ -0,0 +1,268 @@
+#pragma once
+
+// Reactor / AsyncTask / AsyncSourceStage — Coroutine-based I/O stages
+// I/O sources suspend on fd readiness instead of blocking a worker thread;
+// any number of them share one reactor thread.
+
+#include "grebe/stage.h"
+#include "grebe/frame.h"
+#include "grebe/thread_placement.h"
+
+#include <chrono>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+
+namespace grebe {
+
+/// Coroutine type of AsyncSourceStage::run().
+///
+/// Lazily started (created suspended) and owned by the AsyncTask object;
+/// destroying the object destroys the coroutine frame, which must not be
+/// running at that moment. The done callback fires on the thread that ran
+/// the coroutine to completion.
+class AsyncTask {
+public:
+    struct promise_type;
+    using Handle = std::coroutine_handle<promise_type>;
+
+    struct FinalAwaiter {
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(Handle h) noexcept {
+            // The owner may destroy the frame as soon as it is told: read
+            // everything first and make the callback the last access
+            auto* fn = h.promise().on_done;
+            void* arg = h.promise().on_done_arg;
+            if (fn) fn(arg);
+        }
+        void await_resume() const noexcept {}
+    };
+
+    struct promise_type {
+        void (*on_done)(void*) = nullptr;
+        void* on_done_arg = nullptr;
+        std::exception_ptr error;
+
+        AsyncTask get_return_object() { return AsyncTask(Handle::from_promise(*this)); }
+        std::suspend_always initial_suspend() const noexcept { return {}; }
+        FinalAwaiter final_suspend() const noexcept { return {}; }
+        void return_void() const noexcept {}
+        void unhandled_exception() noexcept { error = std::current_exception(); }
+    };
+
+    AsyncTask() = default;
+    explicit AsyncTask(Handle h) : handle_(h) {}
+    ~AsyncTask() { if (handle_) handle_.destroy(); }
+
+    AsyncTask(AsyncTask&& other) noexcept : handle_(other.handle_) { other.handle_ = {}; }
+    AsyncTask& operator=(AsyncTask&& other) noexcept {
+        if (this != &other) {
+            if (handle_) handle_.destroy();
+            handle_ = other.handle_;
+            other.handle_ = {};
+        }
+        return *this;
+    }
+    AsyncTask(const AsyncTask&) = delete;
+    AsyncTask& operator=(const AsyncTask&) = delete;
+
+    explicit operator bool() const { return static_cast<bool>(handle_); }
+    Handle handle() const { return handle_; }
+
+    /// Called once the coroutine has finished (set before starting it).
+    void on_done(void (*fn)(void*), void* arg) {
+        handle_.promise().on_done = fn;
+        handle_.promise().on_done_arg = arg;
+    }
+
+private:
+    Handle handle_;
+};
+
+/// Single-threaded I/O event loop (epoll on Linux).
+///
+/// Coroutines suspended on readable() are resumed on the reactor thread when
+/// their fd becomes readable; post() runs a coroutine or callback there.
+/// Everything a reactor resumes runs on its one thread, so coroutines sharing
+/// a reactor never race with each other. Waiting costs no thread: a blocked
+/// socket is one epoll registration.
+///
+/// Fds that epoll cannot watch (regular files) are reported readable at once,
+/// so file reads degrade to short blocking reads on the reactor thread.
+/// Not available on Windows (supported() is false; readable() then resumes
+/// with false as if cancelled).
+///
+/// Must outlive every coroutine waiting on it.
+class Reactor {
+public:
+    /// Starts the reactor thread ("grebe-reactor") with @p placement.
+    explicit Reactor(const ThreadPlacement& placement = {});
+    ~Reactor();
+
+    Reactor(const Reactor&) = delete;
+    Reactor& operator=(const Reactor&) = delete;
+
+    /// Whether readiness waits are implemented on this platform.
+    static bool supported();
+
+    /// Resume @p handle on the reactor thread (FIFO with other posts).
+    void post(std::coroutine_handle<> handle);
+
+    /// Call @p fn(@p arg) on the reactor thread (FIFO with other posts).
+    void post(void (*fn)(void*), void* arg);
+
+    using Deadline = std::chrono::steady_clock::time_point;
+
+    /// Awaitable returned by readable(): true once the fd is readable (or
+    /// hung up / in error — the next read reports it) or the deadline has
+    /// passed, false if cancelled.
+    class ReadableAwaiter {
+    public:
+        ReadableAwaiter(Reactor& reactor, int fd, Deadline deadline)
+            : reactor_(reactor), fd_(fd), deadline_(deadline) {}
+        bool await_ready() const noexcept { return false; }
+        bool await_suspend(std::coroutine_handle<> handle);
+        bool await_resume() const noexcept { return ok_; }
+
+    private:
+        Reactor& reactor_;
+        int fd_;
+        Deadline deadline_;
+        bool ok_ = false;
+    };
+
+    /// Suspend the calling coroutine until @p fd is readable, or until
+    /// @p deadline (then it resumes as if readable: retry the read).
+    /// At most one coroutine may wait on a given fd.
+    ReadableAwaiter readable(int fd, Deadline deadline = Deadline::max()) {
+        return ReadableAwaiter(*this, fd, deadline);
+    }
+
+    /// Resume the coroutine waiting on @p fd with false (on the reactor
+    /// thread). No-op if nothing is waiting on @p fd.
+    void cancel(int fd);
+
+    /// True when called from the reactor thread.
+    bool in_reactor_thread() const;
+
+    /// Fds currently being waited on.
+    size_t waiting() const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+/// SourceStage whose I/O loop is a coroutine running on a shared Reactor.
+///
+/// Derived stages implement run(): read from a non-blocking fd, co_await
+/// readable() when it would block, co_await emit() for each frame, and
+/// co_return at end of stream. Emitted frames are handed to the stage's
+/// process() (called by the runtime executor) through a bounded handoff
+/// ring; when the ring is full, emit() suspends the coroutine until
+/// process() drains it, so runtime backpressure (Block / Credit edges)
+/// reaches the fd and nothing is dropped here.
+///
+/// process() never blocks on I/O. With a dedicated worker
+/// (ExecContext::wait_budget_ns > 0) it sleeps on the handoff ring for at
+/// most the budget, and request_stop() wakes it, so LinearRuntime::stop()
+/// does not depend on socket timeouts. request_stop() also cancels the
+/// coroutine (pending awaits resume with false) and waits for it to return;
+/// the next process() after a restart runs run() again.
+///
+/// The stage must be stopped before it is destroyed (the runtime does this
+/// in stop()); the base destructor cannot wait for a coroutine that uses
+/// members of an already-destroyed derived stage.
+class AsyncSourceStage : public IStage {
+public:
+    /// @param reactor           Reactor running run(); shared between stages.
+    /// @param handoff_capacity  Frames buffered between run() and process().
+    explicit AsyncSourceStage(Reactor& reactor, size_t handoff_capacity = 64);
+    ~AsyncSourceStage() override;
+
+    StageResult process(BatchView& in, BatchWriter& out,
+                        ExecContext& ctx) final;
+
+    void request_stop() override;
+
+    Reactor& reactor() { return reactor_; }
+
+protected:
+    /// The stage's I/O loop, resumed only on the reactor thread.
+    /// Returning ends the stream (process() then reports EOS once drained).
+    virtual AsyncTask run() = 0;
+
+    class EmitAwaiter {
+    public:
+        EmitAwaiter(AsyncSourceStage& stage, Frame&& frame)
+            : stage_(stage), frame_(std::move(frame)) {}
+        bool await_ready() const noexcept { return false; }
+        bool await_suspend(std::coroutine_handle<> handle);
+        bool await_resume();
+
+    private:
+        AsyncSourceStage& stage_;
+        Frame frame_;
+        bool ok_ = false;
+        bool suspended_ = false;
+    };
+
+    class ReadableAwaiter {
+    public:
+        ReadableAwaiter(AsyncSourceStage& stage, int fd, Reactor::Deadline deadline)
+            : stage_(stage), inner_(stage.reactor_.readable(fd, deadline)), fd_(fd) {}
+        bool await_ready() const noexcept { return false; }
+        bool await_suspend(std::coroutine_handle<> handle);
+        bool await_resume();
+
+    private:
+        AsyncSourceStage& stage_;
+        Reactor::ReadableAwaiter inner_;
+        int fd_;
+        bool cancelled_ = false;
+    };
+
+    class YieldAwaiter {
+    public:
+        explicit YieldAwaiter(AsyncSourceStage& stage) : stage_(stage) {}
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> handle);
+        bool await_resume() const;
+
+    private:
+        AsyncSourceStage& stage_;
+    };
+
+    /// Hand @p frame to the runtime; suspends while the handoff ring is full.
+    /// false: the stage is stopping (the frame is discarded) — co_return.
+    EmitAwaiter emit(Frame&& frame) { return EmitAwaiter(*this, std::move(frame)); }
+
+    /// Suspend until @p fd is readable or @p deadline has passed.
+    /// false: stopping — co_return.
+    ReadableAwaiter readable(int fd, Reactor::Deadline deadline = Reactor::Deadline::max()) {
+        return ReadableAwaiter(*this, fd, deadline);
+    }
+
+    /// Let other coroutines on the reactor run (use in long bursts).
+    /// false: stopping — co_return.
+    YieldAwaiter reschedule() { return YieldAwaiter(*this); }
+
+    /// Called by process() on the executor thread once it has handed the
+    /// frames out[first..] emitted by run() to the runtime, e.g. to steer the
+    /// producer by downstream credit (ExecContext::credits).
+    virtual void delivered(const BatchWriter& /*out*/, size_t /*first*/,
+                           const ExecContext& /*ctx*/) {}
+
+private:
+    struct State;
+
+    /// Reactor-thread job posted by request_stop(): resume run() with false.
+    static void cancel_io(void* stage);
+
+    Reactor& reactor_;
+    std::unique_ptr<State> state_;
+};
+
+} // namespace grebe
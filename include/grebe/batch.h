@@ -11,8 +11,9 @@
 
 namespace grebe {
 
-/// Const view over a batch of frames (input side of Stage::process).
+/// View over a batch of frames (input side of Stage::process).
 /// Runtime constructs this by moving frames drained from the upstream queue.
+/// Frames are read-only; a stage may only move one out whole (take()).
 class BatchView {
 public:
     BatchView() = default;
@@ -25,10 +26,19 @@ public:
 
     const Frame& operator[](size_t i) const { return frames_[i]; }
 
+    /// Move frame @p i out of the view, e.g. to forward it downstream
+    /// unchanged instead of copying it. The slot is left empty and must not
+    /// be read again.
+    Frame take(size_t i) { return std::move(frames_[i]); }
+
     // Range-for support
     auto begin() const { return frames_.cbegin(); }
     auto end()   const { return frames_.cend(); }
 
+    /// Hand the frame storage back to the Runtime so its capacity can be
+    /// reused for the next batch (the view is left empty).
+    std::vector<Frame> release() { return std::move(frames_); }
+
 private:
     std::vector<Frame> frames_;
 };
@@ -41,12 +51,26 @@ public:
 
     void push(Frame&& frame) { frames_.push_back(std::move(frame)); }
 
+    /// Pre-size the storage for @p n frames (called by Runtime).
+    void reserve(size_t n) { frames_.reserve(n); }
+
     size_t size()  const { return frames_.size(); }
     bool   empty() const { return frames_.empty(); }
 
+    /// Frame pushed i-th since the last drain.
+    const Frame& operator[](size_t i) const { return frames_[i]; }
+
     /// Drain all accumulated frames (called by Runtime).
     std::vector<Frame> take() { return std::move(frames_); }
 
+    /// Drain into @p dst by swapping storage (called by Runtime).
+    /// @p dst must be empty; its capacity is kept for the next push() cycle,
+    /// so a Runtime that clears and passes the same vector never reallocates.
+    void take_into(std::vector<Frame>& dst) {
+        dst.swap(frames_);
+        frames_.clear();
+    }
+
 private:
     std::vector<Frame> frames_;
 };
@@ -57,6 +81,20 @@ struct ExecContext {
     uint64_t iteration   = 0;   ///< Monotonic process() call counter
     uint32_t stage_id    = 0;   ///< Runtime-assigned stage identifier
     double   wall_time_s = 0.0; ///< Seconds since runtime start
+
+    /// Credit-based flow control (BackpressurePolicy::Credit output edges):
+    /// free slots on the most constrained Credit edge, and that edge's
+    /// capacity. credit_window == 0 means the stage has no Credit edge.
+    uint32_t credits       = 0;
+    uint32_t credit_window = 0;
+
+    /// SourceStages: how long process() may sleep waiting for data before
+    /// returning NoData (ns). Non-zero only on a dedicated worker thread
+    /// (ThreadPerStage); 0 on a shared pool worker, which must not block.
+    uint64_t wait_budget_ns = 0;
+    /// Set by a SourceStage that slept inside process(): the worker then
+    /// calls again at once instead of adding its own idle backoff.
+    bool waited = false;
 };
 
 } // namespace grebe
@@ -20,8 +20,11 @@ struct DataSourceInfo {
 struct FrameBuffer {
     uint64_t sequence = 0;
     uint64_t producer_ts_ns = 0;
+    uint64_t receive_ts_ns = 0;   // transport receive time (0 = not received over IPC)
+    uint64_t first_sample_index = 0;  // absolute index of the first sample (per channel)
     uint32_t channel_count = 0;
     uint32_t samples_per_channel = 0;
+    uint32_t flags = 0;               // Frame::flags (kFrameDiscontinuity, kFrameVirtualClock)
     std::vector<int16_t> data;
 };
 
@@ -50,6 +53,20 @@ public:
     /// - FileSource: blocks for rate pacing
     virtual ReadResult read_frame(FrameBuffer& frame) = 0;
 
+    /// Flow control hint: deliver about @p samples_per_channel samples per
+    /// block from now on (0 = source default). Called from the reading thread
+    /// by DataSourceAdapter when downstream credit runs low.
+    /// Returns false if the source cannot change its block size.
+    virtual bool request_block_size(uint32_t /*samples_per_channel*/) { return false; }
+
+    /// Virtual-clock replay: when @p enabled, read_frame() no longer paces
+    /// against the wall clock but returns blocks as fast as it is called, and
+    /// producer_ts_ns carries simulated time (start time + samples emitted /
+    /// sample rate). Downstream credit flow then sets the rate, which makes
+    /// the maximum sustainable rate of a pipeline measurable. Call before
+    /// start(). Returns false if the source cannot run unpaced (live input).
+    virtual bool set_virtual_clock(bool /*enabled*/) { return false; }
+
     /// Prepare the source for reading (e.g., open file, init state).
     virtual void start() = 0;
 
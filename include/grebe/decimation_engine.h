@@ -3,8 +3,11 @@
 // DecimationEngine — Public decimation pipeline API (FR-02, FR-03)
 // Implemented in Phase 4
 
+#include "grebe/thread_placement.h"
+
 #include <cstdint>
 #include <memory>
+#include <string>
 #include <vector>
 
 template <typename T> class RingBuffer;
@@ -24,6 +27,12 @@ struct DecimationConfig {
     DecimationAlgorithm algorithm = DecimationAlgorithm::MinMax;
     double sample_rate = 1e6;           // current input sample rate
     double visible_time_span_s = 0.010; // visible time window (seconds)
+
+    /// Thread placement for the coordinator and the per-channel workers
+    /// (worker w uses worker_placement[w % size]). A non-empty
+    /// worker_placement also sets the worker count (capped at channels).
+    ThreadPlacement coordinator_placement;
+    std::vector<ThreadPlacement> worker_placement;
 };
 
 /// Decimated frame output.
@@ -40,6 +49,7 @@ struct DecimationMetrics {
     double decimation_ratio = 1.0;       // input:output ratio
     double ring_fill_ratio = 0.0;        // ring buffer fill level [0,1]
     DecimationAlgorithm effective_algorithm = DecimationAlgorithm::None;
+    std::string placement;               // effective thread placement (coordinator + workers)
 };
 
 /// DecimationEngine: public facade over the internal DecimationThread.
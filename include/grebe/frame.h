@@ -3,9 +3,13 @@
 // Frame — Unified data frame with ownership model (RDD §5.1)
 // Phase 10: IStage contract foundation
 
+#include "grebe/frame_payload.h"
+#include "grebe/frame_pool.h"
+
+#include <array>
+#include <chrono>
 #include <cstdint>
 #include <vector>
-#include <functional>
 #include <cassert>
 #include <cstring>
 #include <utility>
@@ -16,15 +20,79 @@ namespace grebe {
 struct FrameBuffer;
 
 /// Ownership model for Frame data (RDD §5.1).
+///
+/// An Owned frame may additionally be *pooled*: its vector was leased from a
+/// FramePool and is returned there on destruction instead of being freed.
+/// A Borrowed frame usually holds a reference on a FramePayload, which keeps
+/// the memory valid until every frame sharing it is gone.
 enum class OwnershipModel : uint8_t {
     Owned,     ///< Frame owns data via std::vector (Pipe/UDP, low-bandwidth)
-    Borrowed,  ///< Frame borrows external buffer — shm, DMA (zero-copy)
+    Borrowed,  ///< Frame borrows external buffer — shm, DMA, shared (zero-copy)
+};
+
+/// Timebase of Frame::producer_ts_ns, enqueue_ts_ns and FrameTrace:
+/// steady_clock in ns (CLOCK_MONOTONIC on Linux, shared across processes).
+inline uint64_t steady_now_ns() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+/// Well-known FrameTrace points outside the stage graph. Point values below
+/// kTraceStageLimit are StageIds: the frame left that StageGraph stage.
+enum class TracePoint : uint8_t {
+    Receive   = 0xF0,  ///< taken off a transport (pipe / UDP) by the consumer
+    Visualize = 0xF1,  ///< VisualizationStage produced display output from it
+    Upload    = 0xF2,  ///< display vertices handed to the render backend
+};
+inline constexpr uint8_t kTraceStageLimit = 0xF0;
+
+/// Frame::flags bit: the samples do not continue the previous frame of the
+/// stream (frames lost in transit or dropped, producer restart). Stages that
+/// carry samples across frames reset that state instead of joining the gap.
+inline constexpr uint32_t kFrameDiscontinuity = 1u << 0;
+
+/// Frame::flags bit: producer_ts_ns is the block's position on a simulated
+/// timeline (virtual clock replay), not a steady_clock reading. No latency
+/// is measured or traced against it.
+inline constexpr uint32_t kFrameVirtualClock = 1u << 1;
+
+/// Fixed-size per-hop timestamps, stored as offsets from producer_ts_ns so
+/// the trace stays small (44 bytes) and trivially copyable. Offsets saturate
+/// at ~4.29 s; hops past kMaxHops are dropped (the earliest are kept).
+/// Frames without a producer timestamp are not traced.
+struct FrameTrace {
+    static constexpr size_t kMaxHops = 8;
+
+    std::array<uint32_t, kMaxHops> offset_ns{};
+    std::array<uint8_t, kMaxHops>  point{};
+    uint8_t count = 0;
+
+    void mark(uint8_t p, uint64_t producer_ts_ns, uint64_t now_ns) noexcept {
+        if (count >= kMaxHops || producer_ts_ns == 0) return;
+        const uint64_t d = (now_ns > producer_ts_ns) ? now_ns - producer_ts_ns : 0;
+        offset_ns[count] = d > UINT32_MAX ? UINT32_MAX : static_cast<uint32_t>(d);
+        point[count] = p;
+        ++count;
+    }
+    void mark(TracePoint p, uint64_t producer_ts_ns, uint64_t now_ns) noexcept {
+        mark(static_cast<uint8_t>(p), producer_ts_ns, now_ns);
+    }
+
+    /// Offset of the first hop recorded at @p p, or -1 if absent.
+    int64_t offset_of(uint8_t p) const noexcept {
+        for (uint8_t i = 0; i < count; ++i) {
+            if (point[i] == p) return offset_ns[i];
+        }
+        return -1;
+    }
+    int64_t offset_of(TracePoint p) const noexcept { return offset_of(static_cast<uint8_t>(p)); }
 };
 
 /// Unified data frame carrying channel-major int16_t samples.
 ///
 /// Superset of FrameBuffer (legacy) and FrameHeaderV2 (wire format).
-/// Move-only — use to_owned() for explicit deep copy.
+/// Move-only — use share() for a reference to the same payload (zero-copy
+/// fan-out) and to_owned() for an explicit deep copy.
 class Frame {
 public:
     // ---- Metadata (public, directly accessible) ----
@@ -34,7 +102,12 @@ public:
     uint32_t samples_per_channel = 0;
     double   sample_rate_hz      = 0.0;
     uint64_t first_sample_index  = 0;
-    uint32_t flags               = 0;  // reserved (discontinuity, etc.)
+    uint32_t flags               = 0;  // kFrameDiscontinuity, kFrameVirtualClock
+    /// steady_clock time (ns) the runtime last enqueued this frame on an
+    /// edge; used for queue residency telemetry. 0 = not enqueued yet.
+    uint64_t enqueue_ts_ns       = 0;
+    /// Per-hop latency trace (transport receive, each stage, display).
+    FrameTrace trace;
 
     // ---- Factory: Owned ----
 
@@ -48,23 +121,37 @@ public:
         return f;
     }
 
+    /// Create an Owned frame whose buffer is leased from @p pool and returned
+    /// to it on destruction (no heap allocation once the pool is warm).
+    /// Sample contents are unspecified — the caller overwrites them.
+    static Frame make_pooled(uint32_t channels, uint32_t samples_per_ch,
+                             FramePool& pool = FramePool::global()) {
+        Frame f;
+        f.ownership_ = OwnershipModel::Owned;
+        f.channel_count = channels;
+        f.samples_per_channel = samples_per_ch;
+        f.owned_data_ = pool.acquire(static_cast<size_t>(channels) * samples_per_ch);
+        f.pool_ = &pool;
+        return f;
+    }
+
     /// Create an Owned frame from a legacy FrameBuffer (copies data).
     static Frame from_frame_buffer(const FrameBuffer& fb);
 
     // ---- Factory: Borrowed ----
 
-    /// Callback invoked when a Borrowed frame releases its reference.
-    using ReleaseCallback = std::function<void(const int16_t*, size_t)>;
-
-    /// Create a Borrowed frame referencing external memory.
-    /// The release callback is called on destruction or move-assignment.
+    /// Create a Borrowed frame referencing external memory. Takes a
+    /// reference on @p payload, dropped on destruction or move-assignment;
+    /// the payload's on_release() runs once no frame references it.
+    /// nullptr: unmanaged memory the caller keeps valid for the frame's life.
     static Frame make_borrowed(const int16_t* ptr, size_t count,
-                               ReleaseCallback release) {
+                               FramePayload* payload = nullptr) {
         Frame f;
         f.ownership_ = OwnershipModel::Borrowed;
         f.borrowed_ptr_ = ptr;
         f.borrowed_count_ = count;
-        f.release_cb_ = std::move(release);
+        f.payload_ = payload;
+        if (payload) payload->retain();
         return f;
     }
 
@@ -73,6 +160,10 @@ public:
     OwnershipModel ownership() const { return ownership_; }
     bool is_owned() const { return ownership_ == OwnershipModel::Owned; }
     bool is_borrowed() const { return ownership_ == OwnershipModel::Borrowed; }
+    bool is_pooled() const { return pool_ != nullptr; }
+
+    /// Payload referenced by a Borrowed frame (nullptr: Owned or unmanaged).
+    const FramePayload* payload() const { return payload_; }
 
     /// Pointer to sample data (read-only, valid for both ownership models).
     const int16_t* data() const {
@@ -92,21 +183,48 @@ public:
             : borrowed_count_;
     }
 
+    /// Exchange the owned sample buffer with @p other without copying
+    /// (Owned only). Used to hand a producer's filled buffer to a pooled
+    /// frame while the producer keeps the pooled buffer for its next fill.
+    void swap_storage(std::vector<int16_t>& other) {
+        assert(is_owned() && "swap_storage() requires Owned frame");
+        owned_data_.swap(other);
+    }
+
     // ---- Ownership transfer ----
 
+    /// Another frame referencing the same samples (refcount bump, no copy),
+    /// with a copy of the metadata.
+    ///
+    /// An Owned frame first moves its buffer into a reference-counted holder
+    /// from its FramePool (FramePool::global() if not pooled) and becomes
+    /// Borrowed itself; the buffer goes back to the pool once the last
+    /// sharing frame is released. Shared samples are read-only.
+    /// Unmanaged Borrowed frames (no payload) are copied by pointer.
+    Frame share() {
+        if (is_owned()) {
+            FramePool& pool = pool_ ? *pool_ : FramePool::global();
+            const bool recycle = (pool_ != nullptr);
+            // Moving the vector keeps its storage, so data() stays valid
+            borrowed_ptr_ = owned_data_.data();
+            borrowed_count_ = owned_data_.size();
+            payload_ = pool.share(std::move(owned_data_), recycle);
+            payload_->retain();
+            owned_data_ = {};
+            pool_ = nullptr;
+            ownership_ = OwnershipModel::Borrowed;
+        }
+        Frame f = make_borrowed(borrowed_ptr_, borrowed_count_, payload_);
+        f.copy_metadata(*this);
+        return f;
+    }
+
     /// Deep-copy to an Owned frame. Borrowed → Owned copies data.
     /// Owned → new Owned also copies data.
     Frame to_owned() const {
         Frame f;
         f.ownership_ = OwnershipModel::Owned;
-        // Copy metadata
-        f.sequence            = sequence;
-        f.producer_ts_ns      = producer_ts_ns;
-        f.channel_count       = channel_count;
-        f.samples_per_channel = samples_per_channel;
-        f.sample_rate_hz      = sample_rate_hz;
-        f.first_sample_index  = first_sample_index;
-        f.flags               = flags;
+        f.copy_metadata(*this);
         // Copy data
         const auto count = data_count();
         f.owned_data_.resize(count);
@@ -130,23 +248,28 @@ public:
         , sample_rate_hz(other.sample_rate_hz)
         , first_sample_index(other.first_sample_index)
         , flags(other.flags)
+        , enqueue_ts_ns(other.enqueue_ts_ns)
+        , trace(other.trace)
         , ownership_(other.ownership_)
         , owned_data_(std::move(other.owned_data_))
+        , pool_(other.pool_)
         , borrowed_ptr_(other.borrowed_ptr_)
         , borrowed_count_(other.borrowed_count_)
-        , release_cb_(std::move(other.release_cb_))
+        , payload_(other.payload_)
     {
         // Nullify source to prevent double-release
+        other.pool_ = nullptr;
         other.borrowed_ptr_ = nullptr;
         other.borrowed_count_ = 0;
-        other.release_cb_ = nullptr;
+        other.payload_ = nullptr;
         other.ownership_ = OwnershipModel::Owned;
     }
 
     Frame& operator=(Frame&& other) noexcept {
         if (this != &other) {
-            // Release current borrowed reference if any
+            // Release current borrowed reference / pooled buffer if any
             release_borrowed();
+            release_pooled();
             // Move fields
             sequence            = other.sequence;
             producer_ts_ns      = other.producer_ts_ns;
@@ -155,15 +278,19 @@ public:
             sample_rate_hz      = other.sample_rate_hz;
             first_sample_index  = other.first_sample_index;
             flags               = other.flags;
+            enqueue_ts_ns       = other.enqueue_ts_ns;
+            trace               = other.trace;
             ownership_          = other.ownership_;
             owned_data_         = std::move(other.owned_data_);
+            pool_               = other.pool_;
             borrowed_ptr_       = other.borrowed_ptr_;
             borrowed_count_     = other.borrowed_count_;
-            release_cb_         = std::move(other.release_cb_);
+            payload_            = other.payload_;
             // Nullify source
+            other.pool_ = nullptr;
             other.borrowed_ptr_ = nullptr;
             other.borrowed_count_ = 0;
-            other.release_cb_ = nullptr;
+            other.payload_ = nullptr;
             other.ownership_ = OwnershipModel::Owned;
         }
         return *this;
@@ -171,6 +298,7 @@ public:
 
     ~Frame() {
         release_borrowed();
+        release_pooled();
     }
 
 private:
@@ -178,20 +306,39 @@ private:
     Frame(const Frame&) = delete;
     Frame& operator=(const Frame&) = delete;
 
+    void copy_metadata(const Frame& o) {
+        sequence            = o.sequence;
+        producer_ts_ns      = o.producer_ts_ns;
+        channel_count       = o.channel_count;
+        samples_per_channel = o.samples_per_channel;
+        sample_rate_hz      = o.sample_rate_hz;
+        first_sample_index  = o.first_sample_index;
+        flags               = o.flags;
+        enqueue_ts_ns       = o.enqueue_ts_ns;
+        trace               = o.trace;
+    }
+
     void release_borrowed() {
-        if (is_borrowed() && release_cb_ && borrowed_ptr_) {
-            release_cb_(borrowed_ptr_, borrowed_count_);
-        }
-        release_cb_ = nullptr;
+        if (payload_) payload_->release();
+        payload_ = nullptr;
         borrowed_ptr_ = nullptr;
         borrowed_count_ = 0;
     }
 
+    void release_pooled() {
+        if (pool_) {
+            pool_->recycle(std::move(owned_data_));
+            owned_data_ = {};
+            pool_ = nullptr;
+        }
+    }
+
     OwnershipModel ownership_ = OwnershipModel::Owned;
     std::vector<int16_t> owned_data_;
+    FramePool* pool_ = nullptr;  // non-null: owned_data_ returns to this pool
     const int16_t* borrowed_ptr_ = nullptr;
     size_t borrowed_count_ = 0;
-    ReleaseCallback release_cb_;
+    FramePayload* payload_ = nullptr;  // Borrowed: one reference held
 };
 
 // ---- FrameBuffer conversion (inline, depends on data_source.h) ----
@@ -213,8 +360,8 @@ inline Frame Frame::from_frame_buffer(const FrameBuffer& fb) {
     f.channel_count = fb.channel_count;
     f.samples_per_channel = fb.samples_per_channel;
     f.sample_rate_hz = 0.0;  // FrameBuffer lacks this field
-    f.first_sample_index = 0;
-    f.flags = 0;
+    f.first_sample_index = fb.first_sample_index;
+    f.flags = fb.flags;
     f.owned_data_ = fb.data;  // copy
     return f;
 }
@@ -223,8 +370,10 @@ inline FrameBuffer Frame::to_frame_buffer() const {
     FrameBuffer fb;
     fb.sequence = sequence;
     fb.producer_ts_ns = producer_ts_ns;
+    fb.first_sample_index = first_sample_index;
     fb.channel_count = channel_count;
     fb.samples_per_channel = samples_per_channel;
+    fb.flags = flags;
     const auto count = data_count();
     fb.data.resize(count);
     if (count > 0) {
@@ -0,0 +1,47 @@
+#pragma once
+
+// FramePayload — Intrusive reference count for shared Frame sample storage
+
+#include <atomic>
+#include <cstdint>
+
+namespace grebe {
+
+/// Owner of sample memory referenced by Borrowed frames (shared FramePool
+/// buffers, shared-memory slots, DMA buffers).
+///
+/// Every Borrowed frame that references a payload holds one reference;
+/// Frame::share() adds one, destroying or overwriting a frame drops it.
+/// When the last reference is dropped on_release() runs exactly once, on
+/// the releasing thread, and may recycle the memory — no other frame can
+/// still be reading it. Counting starts at zero: the first frame created
+/// with Frame::make_borrowed() takes the first reference.
+class FramePayload {
+public:
+    FramePayload(const FramePayload&) = delete;
+    FramePayload& operator=(const FramePayload&) = delete;
+
+    void retain() noexcept { refs_.fetch_add(1, std::memory_order_relaxed); }
+
+    void release() noexcept {
+        // acq_rel: every holder's reads happen before on_release() reuses the memory
+        if (refs_.fetch_sub(1, std::memory_order_acq_rel) == 1) on_release();
+    }
+
+    /// Current number of references (diagnostics only; racy while shared).
+    uint32_t use_count() const noexcept { return refs_.load(std::memory_order_relaxed); }
+
+protected:
+    FramePayload() = default;
+    virtual ~FramePayload() = default;
+
+    /// Last reference dropped: free or recycle the memory (and possibly
+    /// this object, e.g. `delete this` or return it to a free list).
+    /// The count is back at zero, so the object may be reused as is.
+    virtual void on_release() noexcept = 0;
+
+private:
+    std::atomic<uint32_t> refs_{0};
+};
+
+} // namespace grebe
@@ -0,0 +1,85 @@
+#pragma once
+
+// FramePool — Size-classed recycling pool for Frame sample buffers (NFR-08)
+
+#include "grebe/frame_payload.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace grebe {
+
+/// Recycling pool for Frame sample storage.
+///
+/// Buffers are grouped into power-of-two capacity classes. A pooled Frame
+/// (Frame::make_pooled) leases a buffer on creation and returns it here on
+/// destruction, so a pipeline in steady state performs no heap allocation
+/// for frame data. Thread-safe: frames may be created and destroyed on any
+/// thread.
+///
+/// The pool must outlive every Frame leased from it. global() is never
+/// destroyed for that reason.
+class FramePool {
+public:
+    struct Stats {
+        uint64_t hits   = 0;  ///< acquire() served from a cached buffer
+        uint64_t misses = 0;  ///< acquire() that had to allocate
+        size_t   cached_buffers = 0;
+        size_t   cached_bytes   = 0;
+        size_t   cached_payloads = 0;  ///< idle shared-buffer holders (share())
+    };
+
+    /// @param max_cached_per_class  Buffers kept per size class; extra returns are freed.
+    ///                              Should cover the peak number of frames in flight
+    ///                              (queue capacities + batch sizes) per size class;
+    ///                              StageGraph::start() raises it via reserve().
+    explicit FramePool(size_t max_cached_per_class = 256);
+    ~FramePool();
+
+    FramePool(const FramePool&) = delete;
+    FramePool& operator=(const FramePool&) = delete;
+
+    /// Process-wide pool used by default for pooled frames.
+    static FramePool& global();
+
+    /// Lease a buffer with size() == count. Contents are unspecified
+    /// (not zeroed); the caller is expected to overwrite every sample.
+    std::vector<int16_t> acquire(size_t count);
+
+    /// Return a buffer to its size class (called by Frame on destruction).
+    void recycle(std::vector<int16_t> buffer);
+
+    /// Move @p buffer into a reference-counted holder (Frame::share()).
+    /// When the last reference is released the buffer is recycled into this
+    /// pool if @p recycle, freed otherwise. Holders are cached like buffers,
+    /// so sharing performs no heap allocation once the pool is warm.
+    FramePayload* share(std::vector<int16_t> buffer, bool recycle);
+
+    /// Raise the number of buffers kept per size class to at least
+    /// @p max_cached_per_class (never lowers it). StageGraph::start() calls
+    /// this on global() with the frames its queues and batches can hold.
+    void reserve(size_t max_cached_per_class);
+
+    /// Free all cached buffers and idle holders.
+    void clear();
+
+    Stats stats() const;
+
+    /// Number of allocating acquire() calls made by the calling thread,
+    /// across all pools. The runtime diffs this around process() to
+    /// attribute allocations to stages.
+    static uint64_t thread_allocations();
+
+private:
+    struct SharedBuffer;
+    struct Impl;
+
+    /// Last reference to a share() holder dropped (SharedBuffer::on_release()).
+    void release_shared(SharedBuffer* holder) noexcept;
+
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace grebe
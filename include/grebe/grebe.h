@@ -11,6 +11,11 @@
 
 // Phase 10: Stage/Interface contract types
 #include "grebe/frame.h"
+#include "grebe/frame_pool.h"
+#include "grebe/alloc_tracker.h"
 #include "grebe/batch.h"
 #include "grebe/stage.h"
 #include "grebe/queue.h"
+#include "grebe/thread_placement.h"
+#include "grebe/histogram.h"
+#include "grebe/async.h"
@@ -0,0 +1,83 @@
+#pragma once
+
+// HdrHistogram — Lock-free log-linear histogram for tail latency telemetry
+// Used by StageGraph/LinearRuntime for per-stage process/queue time and batch size.
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+namespace grebe {
+
+/// Percentile summary of a histogram, scaled to the caller's unit (e.g. ms).
+struct Percentiles {
+    uint64_t count = 0;
+    double p50  = 0.0;
+    double p90  = 0.0;
+    double p99  = 0.0;
+    double p999 = 0.0;
+    double max  = 0.0;
+};
+
+/// HDR-style histogram of non-negative integers (ns, frame counts, ...).
+///
+/// Values below 2^kSubBucketBits are counted exactly; every power-of-two
+/// range above that is split into 2^kSubBucketBits linear sub-buckets, so a
+/// reported percentile is within ~3% of the recorded value. Values up to
+/// 2^kMaxValueBits - 1 (about 73 minutes in ns) are tracked; larger ones
+/// land in the last bucket, while max stays exact.
+///
+/// record() is wait-free apart from the max update (a CAS only when a new
+/// maximum is seen) and may be called concurrently from any thread.
+/// Readers take a relaxed snapshot: counts are consistent per bucket, not
+/// across buckets.
+class HdrHistogram {
+public:
+    static constexpr unsigned kSubBucketBits = 5;
+    static constexpr unsigned kMaxValueBits  = 42;
+    static constexpr size_t   kBucketCount   =
+        static_cast<size_t>(kMaxValueBits - kSubBucketBits + 1) << kSubBucketBits;
+
+    void record(uint64_t value, uint64_t count = 1) noexcept {
+        counts_[bucket_index(value)].fetch_add(count, std::memory_order_relaxed);
+        uint64_t prev = max_.load(std::memory_order_relaxed);
+        while (value > prev &&
+               !max_.compare_exchange_weak(prev, value, std::memory_order_relaxed)) {
+        }
+    }
+
+    /// p50/p90/p99/p99.9/max of everything recorded so far, each multiplied
+    /// by @p scale (e.g. 1e-6 to report ns values in ms).
+    Percentiles percentiles(double scale = 1.0) const;
+
+    uint64_t total_count() const;
+    void reset() noexcept;
+
+    /// Bucket holding @p value.
+    static constexpr size_t bucket_index(uint64_t value) noexcept {
+        constexpr uint64_t kSub = uint64_t{1} << kSubBucketBits;
+        constexpr uint64_t kLimit = (uint64_t{1} << kMaxValueBits) - 1;
+        if (value < kSub) return static_cast<size_t>(value);
+        if (value > kLimit) value = kLimit;
+        const unsigned shift = static_cast<unsigned>(std::bit_width(value)) - 1 - kSubBucketBits;
+        return (static_cast<size_t>(shift + 1) << kSubBucketBits) +
+               static_cast<size_t>((value >> shift) - kSub);
+    }
+
+    /// Largest value that maps to bucket @p index.
+    static constexpr uint64_t bucket_upper(size_t index) noexcept {
+        constexpr uint64_t kSub = uint64_t{1} << kSubBucketBits;
+        if (index < kSub) return index;
+        const unsigned shift = static_cast<unsigned>(index >> kSubBucketBits) - 1;
+        const uint64_t lower = (kSub + (index & (kSub - 1))) << shift;
+        return lower + ((uint64_t{1} << shift) - 1);
+    }
+
+private:
+    std::array<std::atomic<uint64_t>, kBucketCount> counts_{};
+    std::atomic<uint64_t> max_{0};
+};
+
+} // namespace grebe
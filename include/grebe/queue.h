@@ -3,8 +3,10 @@
 // IQueue — Bounded queue contract with backpressure policy (RDD §5.3)
 // Phase 11: Queue contract foundation
 
+#include <chrono>
 #include <cstdint>
 #include <optional>
+#include <vector>
 
 namespace grebe {
 
@@ -13,12 +15,30 @@ enum class BackpressurePolicy {
     DropLatest,  ///< Discard the incoming (newest) frame
     DropOldest,  ///< Discard the oldest frame in the queue, then enqueue
     Block,       ///< Block the producer until space is available
+    /// Credit-based flow control: each free slot is a credit advertised to
+    /// the producing stage, which is not run while it has no credit (a
+    /// credit stall) and can adapt its output (e.g. block size) as credit
+    /// runs low. The queue itself behaves like Block, so nothing is dropped.
+    Credit,
+};
+
+/// Whether a full queue with @p policy makes enqueue wait (Block / Credit).
+constexpr bool blocks_when_full(BackpressurePolicy policy) {
+    return policy == BackpressurePolicy::Block || policy == BackpressurePolicy::Credit;
+}
+
+/// Queue implementation selected per pipeline edge.
+enum class QueueKind {
+    Mutex,  ///< InProcessQueue (std::deque + mutex)
+    Spsc,   ///< LockFreeQueue, single producer / single consumer
+    Mpmc,   ///< LockFreeQueue, multi producer / multi consumer
 };
 
 /// Abstract bounded queue interface.
 ///
 /// Implementations:
 ///   - InProcessQueue  (Phase 11, in-process std::deque + mutex)
+///   - LockFreeQueue   (in-process preallocated slot ring, SPSC / MPMC)
 ///   - ShmQueue        (Phase 14, SharedMemory backing)
 template <typename T>
 class IQueue {
@@ -28,12 +48,21 @@ public:
     /// Enqueue an item. Behavior on full queue depends on BackpressurePolicy:
     ///   - DropLatest: returns false (item discarded)
     ///   - DropOldest: drops oldest, enqueues new, returns true
-    ///   - Block: blocks until space available, returns true
+    ///   - Block, Credit: blocks until space available, returns true
     virtual bool enqueue(T&& item) = 0;
 
     /// Dequeue an item (non-blocking). Returns std::nullopt if empty.
     virtual std::optional<T> dequeue() = 0;
 
+    /// Dequeue an item, waiting up to @p timeout for one to arrive.
+    /// Returns std::nullopt on timeout or after shutdown().
+    /// The consumer thread sleeps (no spinning) while waiting.
+    virtual std::optional<T> dequeue_wait(std::chrono::nanoseconds timeout) = 0;
+
+    /// Dequeue up to @p max_items (non-blocking), appending to @p out in
+    /// FIFO order. Returns the number of items appended.
+    virtual size_t dequeue_bulk(std::vector<T>& out, size_t max_items) = 0;
+
     /// Maximum number of items the queue can hold.
     virtual size_t capacity() const = 0;
 
@@ -54,8 +83,12 @@ public:
     /// Total items dropped (DropLatest or DropOldest policy).
     virtual uint64_t total_dropped() const = 0;
 
-    /// Total time spent blocking in enqueue (nanoseconds, Block policy).
+    /// Total time spent blocking in enqueue (nanoseconds, Block / Credit policy).
     virtual uint64_t total_blocked_ns() const = 0;
+
+    /// Wake blocked producers and waiting consumers; further blocking
+    /// enqueues fail (used during runtime shutdown).
+    virtual void shutdown() = 0;
 };
 
 } // namespace grebe
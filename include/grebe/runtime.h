@@ -1,12 +1,18 @@
 #pragma once
 
-// LinearRuntime — Stage pipeline execution engine (RDD §4.2)
+// LinearRuntime / StageGraph — Stage pipeline execution engines (RDD §4.2, §4.3)
 // Phase 13: Runtime foundation
+// Phase 15: StageGraph with fan-out edges (FR-11)
 
 #include "grebe/stage.h"
 #include "grebe/queue.h"
+#include "grebe/histogram.h"
+#include "grebe/thread_placement.h"
 
+#include <array>
+#include <chrono>
 #include <cstdint>
+#include <limits>
 #include <memory>
 #include <optional>
 #include <string>
@@ -14,19 +20,264 @@
 
 namespace grebe {
 
+/// Number of power-of-two bins in StageTelemetry::batch_size_hist.
+inline constexpr size_t kBatchHistogramBins = 8;
+
 /// Per-stage telemetry snapshot.
 struct StageTelemetry {
     std::string name;
     uint64_t frames_processed   = 0;
     double   avg_process_time_ms = 0.0;
     uint64_t queue_dropped      = 0;  ///< drops in this stage's input queue
+
+    /// Credit-based flow control: episodes in which the stage was held back
+    /// because a Credit output edge had no free slot, and the total time held.
+    /// Where Credit replaces DropOldest, these stalls replace downstream drops.
+    uint64_t credit_stalls      = 0;
+    double   credit_stall_ms    = 0.0;
+
+    /// Distributions since start() (HdrHistogram, ~3% resolution).
+    /// process_time_ms: per process() call (source NoData polls excluded).
+    /// queue_time_ms: per frame, residency in the input queue (emit → dequeue).
+    /// batch_frames: frames per input batch (queue-fed stages only).
+    /// e2e_latency_ms: per frame, Frame::producer_ts_ns → emitted by this
+    /// stage (frames with a producer timestamp; cross-process on one host).
+    Percentiles process_time_ms;
+    Percentiles queue_time_ms;
+    Percentiles batch_frames;
+    Percentiles e2e_latency_ms;
+
+    /// Input batch sizes per process() call (queue-fed stages only).
+    /// Bin i counts batches of [2^i, 2^(i+1)) frames; the last bin is open-ended.
+    std::array<uint64_t, kBatchHistogramBins> batch_size_hist{};
+    double   avg_batch_size     = 0.0;
+
+    /// Frame buffer heap allocations (FramePool misses) made inside this
+    /// stage's process(). Stays flat after warm-up in steady state (NFR-08).
+    uint64_t buffer_allocations = 0;
+
+    /// Heap activity on the stage's worker thread(s) while running this
+    /// stage (RuntimeOptions::alloc_accounting; zero otherwise): operator new
+    /// calls and bytes requested (needs the alloc hooks, see alloc_tracker.h)
+    /// and minor page faults. Rates are averages since start().
+    uint64_t heap_allocations     = 0;
+    uint64_t heap_bytes           = 0;
+    uint64_t minor_faults         = 0;
+    double   heap_allocs_per_sec  = 0.0;
+    double   heap_bytes_per_sec   = 0.0;
+    double   minor_faults_per_sec = 0.0;
+
+    /// Parallel instances running this stage (StageOptions::replicas).
+    uint32_t replicas = 1;
+
+    /// Stage was removed with StageGraph::detach(); counters are final.
+    bool detached = false;
+
+    /// Effective thread placement of the stage's worker(s) as read back from
+    /// the OS, e.g. "cpus=2-3 fifo=50 numa=0"; "pool: ..." under WorkStealing.
+    /// Empty until the worker has started.
+    std::string placement;
+};
+
+/// How a stage worker waits when its input queue is empty (or, for a
+/// SourceStage, when process() returns NoData).
+enum class IdlePolicy {
+    Yield,     ///< yield() loop — lowest latency, keeps a core busy
+    Park,      ///< Sleep in dequeue_wait() immediately
+    Adaptive,  ///< Spin, then yield, then park
+};
+
+/// Options for one bounded queue (edge) between stages.
+struct QueueOptions {
+    size_t             queue_capacity = 64;
+    BackpressurePolicy policy         = BackpressurePolicy::DropOldest;
+    QueueKind          queue_kind     = QueueKind::Mutex;
+};
+
+/// Per-stage options: the stage's input queue (edge from previous stage)
+/// and how its worker waits for work.
+/// StageGraph uses the queue fields as the default for edges into the stage.
+struct StageOptions : QueueOptions {
+    /// Max frames drained from the input queue per process() call.
+    /// Batches only grow when the queue has backed up.
+    size_t max_batch_frames = 32;
+    /// Max payload bytes per batch (0 = unlimited). Converted to a frame
+    /// count using the first frame of the batch.
+    size_t max_batch_bytes  = 0;
+
+    /// Data-parallel instances of a stateless stage (IStage::clone()).
+    /// Input batches are dispatched to whichever instance is free; outputs
+    /// are reassembled in dispatch order before the outgoing edges, so
+    /// downstream sees the same frame order as with a single instance.
+    /// Ignored (1) for SourceStages and stages whose clone() returns nullptr.
+    /// The replicas share the input edge, so a QueueKind::Spsc input edge is
+    /// built as Mpmc.
+    uint32_t replicas = 1;
+
+    IdlePolicy idle_policy = IdlePolicy::Adaptive;
+    uint32_t   spin_count  = 256;  ///< Adaptive: polls with cpu pause before yielding
+    uint32_t   yield_count = 16;   ///< Adaptive: polls with yield() before parking
+    /// Max single park duration. Bounds the source NoData backoff sleep and
+    /// the interval at which a parked worker re-checks stop.
+    std::chrono::microseconds park_timeout{1000};
+
+    /// CPU set / SCHED_FIFO priority / NUMA node for the stage's dedicated
+    /// thread(s) under ThreadPerStage (applied to every replica). Ignored by
+    /// WorkStealing, where stages migrate between pool workers; use
+    /// RuntimeOptions::worker_placement instead.
+    ThreadPlacement placement;
+};
+
+/// How stage process() invocations are mapped onto OS threads.
+enum class ExecutorKind {
+    /// One dedicated worker thread per stage, blocking on its input queue.
+    /// Lowest latency for small pipelines; thread count grows with stages.
+    ThreadPerStage,
+    /// Fixed pool of workers with work-stealing deques. A stage is scheduled
+    /// when frames are enqueued to its input edge (sources are re-polled with
+    /// backoff after NoData), so idle stages cost no thread.
+    WorkStealing,
+};
+
+/// Runtime-wide options, fixed at construction.
+struct RuntimeOptions {
+    ExecutorKind executor = ExecutorKind::ThreadPerStage;
+    /// WorkStealing pool size (0 = std::thread::hardware_concurrency()).
+    size_t worker_threads = 0;
+    /// WorkStealing: placement of pool worker i is worker_placement[i % size]
+    /// (empty = workers float freely).
+    std::vector<ThreadPlacement> worker_placement;
+    /// Stages that StageGraph::attach() may add while running on top of
+    /// those present at start() (slots reserved at start()). Slots freed by
+    /// detach() are reused, so this bounds concurrently attached stages.
+    size_t max_live_stages = 8;
+    /// Attribute heap allocations and minor page faults to stages
+    /// (StageTelemetry::heap_*). Adds two getrusage() calls per stage
+    /// invocation, so it is meant for profiling and benchmark runs.
+    bool alloc_accounting = false;
+};
+
+/// Stage identifier within a StageGraph (index in add_stage() order).
+using StageId = size_t;
+/// Returned by StageGraph::attach() on failure.
+inline constexpr StageId kInvalidStageId = std::numeric_limits<StageId>::max();
+/// Output identifier for queues polled by the application (add_output()).
+using OutputId = size_t;
+
+/// DAG runtime: stages connected by per-edge bounded queues with fan-out.
+///
+/// Each stage has at most one upstream (no fan-in) and any number of
+/// downstream edges. A frame produced by a stage with several outgoing
+/// edges is shared by reference (Frame::share()): each edge receives a
+/// Borrowed frame on the same refcounted payload, which returns to its
+/// FramePool when the last consumer drops it, so no per-consumer copy or
+/// heap allocation is made. Every edge has its own
+/// capacity and BackpressurePolicy, so a slow consumer on a Drop* edge
+/// (e.g. a disk recorder) never stalls the other branches.
+///
+/// Usage:
+///   StageGraph g;
+///   auto src = g.add_stage(make_unique<DataSourceAdapter>(source));
+///   auto dec = g.add_stage(make_unique<DecimationStage>(mode, 3840));
+///   auto rec = g.add_stage(make_unique<RecorderStage>(path));
+///   g.connect(src, dec);                                   // display path
+///   g.connect(src, rec, {256, BackpressurePolicy::DropOldest});
+///   auto out = g.add_output(dec);
+///   g.start();
+///   while (auto frame = g.poll_output(out)) { render(*frame); }
+///   g.stop();
+///
+/// Branches can also be attached and detached while running (attach() /
+/// detach()), e.g. to run an expensive analysis only while it is enabled;
+/// the rest of the graph keeps its queues and keeps running.
+class StageGraph {
+public:
+    explicit StageGraph(const RuntimeOptions& options = {});
+    ~StageGraph();
+
+    StageGraph(const StageGraph&) = delete;
+    StageGraph& operator=(const StageGraph&) = delete;
+
+    /// Add a stage. A stage that is never connected as a downstream is a
+    /// SourceStage (called with an empty input batch).
+    StageId add_stage(std::unique_ptr<IStage> stage, const StageOptions& options = {});
+
+    /// Connect @p from → @p to using @p to's StageOptions queue fields.
+    /// Returns false (and logs) if @p to already has an upstream, the edge
+    /// would create a cycle, an id is invalid, or the graph is running.
+    bool connect(StageId from, StageId to);
+
+    /// Connect @p from → @p to with explicit queue options for this edge.
+    bool connect(StageId from, StageId to, const QueueOptions& edge);
+
+    /// Add an application-polled output queue fed by @p from.
+    OutputId add_output(StageId from, const QueueOptions& edge = {});
+
+    /// Add @p stage as a new downstream of @p from (an extra fan-out edge
+    /// using @p options' queue fields). Stopped: same as add_stage() +
+    /// connect(). Running: the edge's queue and the stage's worker start at
+    /// once (a single instance: StageOptions::replicas is ignored), and
+    /// @p from begins emitting into it with its next batch;
+    /// no other edge is touched. Returns kInvalidStageId if @p from is
+    /// invalid or detached, or the RuntimeOptions::max_live_stages slots
+    /// reserved at start() are used up.
+    StageId attach(StageId from, std::unique_ptr<IStage> stage,
+                   const StageOptions& options = {});
+
+    /// Remove @p id and every stage downstream of it (its branch), also
+    /// while running: the branch is unlinked from its upstream, its stages
+    /// get request_stop() and their workers exit, frames still queued on its
+    /// edges are discarded, and the stage objects are destroyed. Output
+    /// queues fed by the branch stay empty. The detached stages remain in
+    /// telemetry() with detached = true until a later attach() reuses
+    /// their StageIds.
+    /// Returns false if @p id is invalid or already detached.
+    ///
+    /// attach() / detach() are called from the thread that controls the
+    /// graph, like start() and stop(). detach() returns once the branch's
+    /// workers are out of process(): a stage that blocks there and ignores
+    /// request_stop() delays it exactly as it would delay stop().
+    bool detach(StageId id);
+
+    /// Start the executor (per-stage threads or the worker pool).
+    void start();
+
+    /// Stop all workers (bounded time) and join threads.
+    void stop();
+
+    bool running() const;
+
+    /// OS threads used by the executor while running (0 when stopped).
+    size_t thread_count() const;
+
+    /// Poll an output queue (non-blocking).
+    std::optional<Frame> poll_output(OutputId output);
+
+    /// Drain an output queue, return the latest frame (discard older ones).
+    std::optional<Frame> poll_latest(OutputId output);
+
+    /// Access a stage for runtime control (e.g., set_mode).
+    /// nullptr for detached stages.
+    IStage* stage(StageId id);
+    size_t  stage_count() const;
+
+    /// Snapshot of per-stage telemetry (indexed by StageId).
+    /// queue_dropped reports the stage's own input edge.
+    std::vector<StageTelemetry> telemetry() const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
 };
 
 /// Linear pipeline runtime engine.
 ///
-/// Manages a linear sequence of Stages connected by InProcessQueues.
-/// Each Stage runs in its own worker thread. The main thread polls
-/// the output queue to consume processed frames.
+/// Manages a linear sequence of Stages connected by bounded queues
+/// (InProcessQueue or LockFreeQueue, selected per edge via StageOptions).
+/// Implemented as a chain-shaped StageGraph.
+/// By default each Stage runs in its own worker thread; pass
+/// RuntimeOptions{ExecutorKind::WorkStealing} to share a fixed worker pool.
+/// The main thread polls the output queue to consume processed frames.
 ///
 /// Usage:
 ///   LinearRuntime rt;
@@ -37,7 +288,7 @@ struct StageTelemetry {
 ///   rt.stop();
 class LinearRuntime {
 public:
-    LinearRuntime();
+    explicit LinearRuntime(const RuntimeOptions& options = {});
     ~LinearRuntime();
 
     LinearRuntime(const LinearRuntime&) = delete;
@@ -51,6 +302,25 @@ public:
                    size_t queue_capacity = 64,
                    BackpressurePolicy policy = BackpressurePolicy::DropOldest);
 
+    /// Add a stage with full per-edge options (queue kind, capacity, policy).
+    void add_stage(std::unique_ptr<IStage> stage, const StageOptions& options);
+
+    /// Attach a branch stage fed by stage @p from (fan-out next to the
+    /// pipeline), also while running; see StageGraph::attach(). The id
+    /// is its index in stage() / telemetry(); later add_stage() calls still
+    /// extend the pipeline. Returns kInvalidStageId on failure.
+    StageId attach(StageId from, std::unique_ptr<IStage> stage,
+                   const StageOptions& options = {});
+
+    /// Remove an attached branch (and anything attached to it), also while
+    /// running; see StageGraph::detach(). Pipeline stages cannot be detached.
+    bool detach(StageId id);
+
+    /// Queue options of the poll_output() queue (call before start()).
+    /// Default: the last stage's queue options. E.g. keep the display output
+    /// DropOldest while inner edges use Credit flow control.
+    void set_output_options(const QueueOptions& options);
+
     /// Start all worker threads.
     void start();
 
@@ -60,6 +330,9 @@ public:
     /// Whether the runtime is currently running.
     bool running() const;
 
+    /// OS threads used by the executor while running (0 when stopped).
+    size_t thread_count() const;
+
     /// Poll the output queue (non-blocking). Returns the latest frame or nullopt.
     std::optional<Frame> poll_output();
 
@@ -5,6 +5,7 @@
 
 #include "grebe/batch.h"
 
+#include <memory>
 #include <string>
 
 namespace grebe {
@@ -36,13 +37,31 @@ public:
     /// - SinkStage: consume `in`; `out` typically empty.
     ///
     /// Borrowed frames received in `in` must be either:
-    ///   (a) released after processing, or
-    ///   (b) converted to Owned via to_owned() before passing downstream.
-    virtual StageResult process(const BatchView& in, BatchWriter& out,
+    ///   (a) released after processing,
+    ///   (b) converted to Owned via to_owned() before passing downstream, or
+    ///   (c) forwarded via share() when backed by a FramePayload, which
+    ///       keeps the samples valid until the last reference is dropped.
+    /// A stage may also move an input frame downstream unchanged with
+    /// BatchView::take(); the runtime drops whatever is left in `in`.
+    virtual StageResult process(BatchView& in, BatchWriter& out,
                                 ExecContext& ctx) = 0;
 
     /// Human-readable stage name for telemetry and logging.
     virtual std::string name() const = 0;
+
+    /// Create another instance for data-parallel replication
+    /// (StageOptions::replicas). Only stateless stages — whose output for a
+    /// frame does not depend on previously seen frames — should override.
+    /// Replicas should share runtime-controlled parameters (e.g. mode) with
+    /// the original so that control through the original applies to all.
+    /// Default: nullptr (not replicable).
+    virtual std::unique_ptr<IStage> clone() const { return nullptr; }
+
+    /// Called by the Runtime at the start of stop(), from the stopping
+    /// thread, possibly while process() runs on a worker. A stage waiting
+    /// inside process() (e.g. for I/O) must return promptly; stages with
+    /// background work (AsyncSourceStage) end it here. Default: no-op.
+    virtual void request_stop() {}
 };
 
 } // namespace grebe
@@ -20,9 +20,22 @@ struct TelemetrySnapshot {
     double decimation_time_ms = 0.0;
     double decimation_ratio = 1.0;
 
+    // Decimation stage tail latency (runtime HDR histograms, since start)
+    double decimation_p99_ms = 0.0;
+    double decimation_max_ms = 0.0;
+    double queue_p99_ms = 0.0;        // decimation input queue residency
+
+    // End-to-end latency: producer timestamp → display upload (since start)
+    double e2e_p50_ms = 0.0;
+    double e2e_p99_ms = 0.0;
+
     // Data flow
     double data_rate = 0.0;            // samples/sec
 
+    // Credit-based flow control: source held back for lack of downstream credit
+    uint64_t credit_stalls = 0;
+    double credit_stall_ms = 0.0;
+
     // Counts
     uint32_t samples_per_frame = 0;
     uint32_t vertex_count = 0;
@@ -0,0 +1,50 @@
+#pragma once
+
+// ThreadPlacement — CPU affinity, real-time priority and NUMA policy per thread
+// Used by StageGraph/LinearRuntime, DecimationThread, IngestionThread, grebe-sg.
+
+#include <string>
+#include <vector>
+
+namespace grebe {
+
+/// Requested placement for one thread. Default-constructed = leave as is.
+struct ThreadPlacement {
+    /// CPUs the thread may run on (empty = inherit, no pinning).
+    std::vector<int> cpus;
+    /// SCHED_FIFO priority 1-99 (0 = keep the default time-sharing policy).
+    /// Windows: any value > 0 maps to THREAD_PRIORITY_TIME_CRITICAL.
+    int fifo_priority = 0;
+    /// Preferred NUMA node for memory the thread allocates, e.g. pooled
+    /// frame buffers produced by a stage (-1 = system default). Linux only.
+    int numa_node = -1;
+
+    bool empty() const { return cpus.empty() && fifo_priority == 0 && numa_node < 0; }
+};
+
+/// Placement in effect for a thread, read back from the OS after applying.
+struct EffectivePlacement {
+    std::vector<int> cpus;   ///< Allowed CPUs (empty = unknown)
+    int  fifo_priority = 0;  ///< 0 = time-sharing policy
+    int  numa_node = -1;     ///< Preferred node (-1 = system default)
+    /// False if any requested attribute could not be applied (e.g. EPERM
+    /// for SCHED_FIFO without CAP_SYS_NICE); the thread keeps running.
+    bool ok = true;
+};
+
+/// Apply @p placement to the calling thread and name it @p thread_name
+/// (truncated to the OS limit). Failures are logged, never thrown.
+/// An empty placement only names the thread and reads back its state.
+EffectivePlacement apply_thread_placement(const ThreadPlacement& placement,
+                                          const std::string& thread_name);
+
+/// Parse a placement spec: "CPUS[:fifo=N][:numa=N]", where CPUS is a list
+/// like "2-3,6" and may be empty (":fifo=50"). Returns false on syntax error
+/// or a CPU index the affinity mask cannot hold (>= CPU_SETSIZE on Linux),
+/// or a NUMA node outside the node mask (>= 1024).
+bool parse_thread_placement(const std::string& spec, ThreadPlacement& out);
+
+/// Compact description for telemetry/logging, e.g. "cpus=2-3 fifo=50 numa=0".
+std::string to_string(const EffectivePlacement& placement);
+
+} // namespace grebe
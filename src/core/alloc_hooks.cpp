@@ -0,0 +1,118 @@
+// Global operator new/delete replacements that count heap activity per
+// thread (grebe/alloc_tracker.h). Not part of libgrebe: an executable opts
+// in by linking the grebe_alloc_hooks object library.
+
+#include "core/alloc_tally.h"
+
+#include <cstdlib>
+#include <new>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+namespace {
+
+using grebe::detail::tl_alloc_tally;
+
+[[maybe_unused]] const bool installed = [] {
+    grebe::detail::g_alloc_hooks_installed.store(true, std::memory_order_relaxed);
+    return true;
+}();
+
+void count_alloc(std::size_t size) {
+    auto& t = tl_alloc_tally;
+    t.add(t.allocations, 1);
+    t.add(t.bytes, size);
+}
+
+void count_free(void* p) {
+    if (p) tl_alloc_tally.add(tl_alloc_tally.frees, 1);
+}
+
+void* counted_alloc(std::size_t size) noexcept {
+    count_alloc(size);
+    return std::malloc(size ? size : 1);
+}
+
+void* counted_aligned_alloc(std::size_t size, std::align_val_t al) noexcept {
+    count_alloc(size);
+    const auto align = static_cast<std::size_t>(al);
+#ifdef _WIN32
+    return _aligned_malloc(size ? size : 1, align);
+#else
+    void* p = nullptr;
+    return posix_memalign(&p, align < sizeof(void*) ? sizeof(void*) : align,
+                          size ? size : 1) == 0 ? p : nullptr;
+#endif
+}
+
+void counted_free(void* p) noexcept {
+    count_free(p);
+    std::free(p);
+}
+
+void counted_aligned_free(void* p) noexcept {
+    count_free(p);
+#ifdef _WIN32
+    _aligned_free(p);
+#else
+    std::free(p);
+#endif
+}
+
+} // namespace
+
+void* operator new(std::size_t size) {
+    if (void* p = counted_alloc(size)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    if (void* p = counted_alloc(size)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return counted_alloc(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return counted_alloc(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t al) {
+    if (void* p = counted_aligned_alloc(size, al)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size, std::align_val_t al) {
+    if (void* p = counted_aligned_alloc(size, al)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, std::align_val_t al, const std::nothrow_t&) noexcept {
+    return counted_aligned_alloc(size, al);
+}
+
+void* operator new[](std::size_t size, std::align_val_t al, const std::nothrow_t&) noexcept {
+    return counted_aligned_alloc(size, al);
+}
+
+void operator delete(void* p) noexcept { counted_free(p); }
+void operator delete[](void* p) noexcept { counted_free(p); }
+void operator delete(void* p, std::size_t) noexcept { counted_free(p); }
+void operator delete[](void* p, std::size_t) noexcept { counted_free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { counted_free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { counted_free(p); }
+
+void operator delete(void* p, std::align_val_t) noexcept { counted_aligned_free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { counted_aligned_free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { counted_aligned_free(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { counted_aligned_free(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept {
+    counted_aligned_free(p);
+}
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept {
+    counted_aligned_free(p);
+}
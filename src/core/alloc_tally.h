@@ -0,0 +1,30 @@
+#pragma once
+
+// AllocTally — Thread-local heap counters shared by alloc_tracker.cpp and
+// the operator new/delete hooks (alloc_hooks.cpp)
+
+#include <atomic>
+#include <cstdint>
+
+namespace grebe::detail {
+
+/// Written only by the owning thread (plain load + store, no lock prefix);
+/// atomic so alloc_thread_report() may read another thread's tally.
+struct AllocTally {
+    std::atomic<uint64_t> allocations{0};
+    std::atomic<uint64_t> frees{0};
+    std::atomic<uint64_t> bytes{0};
+
+    void add(std::atomic<uint64_t>& counter, uint64_t n) {
+        counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+};
+
+/// Constant-initialized and trivially destructible, so the hooks may use it
+/// at any point of a thread's life, including thread_local destructors.
+extern constinit thread_local AllocTally tl_alloc_tally;
+
+/// Set by alloc_hooks.cpp's static initializer when the hooks are linked.
+extern std::atomic<bool> g_alloc_hooks_installed;
+
+} // namespace grebe::detail
@@ -0,0 +1,177 @@
+#include "grebe/alloc_tracker.h"
+#include "core/alloc_tally.h"
+
+#include <algorithm>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+
+#ifdef __linux__
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace grebe {
+
+namespace detail {
+
+constinit thread_local AllocTally tl_alloc_tally;
+std::atomic<bool> g_alloc_hooks_installed{false};
+
+} // namespace detail
+
+namespace {
+
+struct ThreadEntry {
+    std::string name;
+    uint64_t thread_id = 0;
+    const detail::AllocTally* tally = nullptr;  // nullptr: exited total of `name`
+    AllocCounters final_counters;               // valid once exited
+    uint32_t exited_threads = 0;
+};
+
+struct Registry {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<ThreadEntry>> entries;
+};
+
+/// Never destroyed: threads may exit (and unregister) during static destruction.
+Registry& registry() {
+    static Registry* r = new Registry;
+    return *r;
+}
+
+uint64_t current_thread_id() {
+#ifdef __linux__
+    return static_cast<uint64_t>(syscall(SYS_gettid));
+#else
+    return 0;
+#endif
+}
+
+AllocCounters read_heap(const detail::AllocTally& t) {
+    AllocCounters c;
+    c.allocations = t.allocations.load(std::memory_order_relaxed);
+    c.frees       = t.frees.load(std::memory_order_relaxed);
+    c.bytes       = t.bytes.load(std::memory_order_relaxed);
+    return c;
+}
+
+/// minflt (field 10) of /proc/self/task/<tid>/stat; 0 if unavailable.
+uint64_t task_minor_faults([[maybe_unused]] uint64_t tid) {
+#ifdef __linux__
+    std::ifstream in("/proc/self/task/" + std::to_string(tid) + "/stat");
+    std::string line;
+    if (!std::getline(in, line)) return 0;
+    // comm (field 2) may contain spaces: parse after its closing parenthesis
+    const size_t close = line.rfind(')');
+    if (close == std::string::npos) return 0;
+    std::istringstream fields(line.substr(close + 1));
+    std::string field;
+    for (int i = 3; i < 10 && (fields >> field); ++i) {}
+    uint64_t minflt = 0;
+    fields >> minflt;
+    return minflt;
+#else
+    return 0;
+#endif
+}
+
+/// Folds the calling thread's final counters into the exited total of its
+/// name, which this thread's entry becomes if there is none yet.
+struct Registration {
+    ThreadEntry* entry = nullptr;
+
+    ~Registration() {
+        if (!entry) return;
+        auto counters = thread_alloc_counters();
+        auto& entries = registry().entries;
+        std::lock_guard<std::mutex> lock(registry().mutex);
+        for (auto it = entries.begin(); it != entries.end(); ++it) {
+            auto& total = **it;
+            if (total.tally || total.name != entry->name) continue;
+            total.final_counters += counters;
+            ++total.exited_threads;
+            entries.erase(std::find_if(entries.begin(), entries.end(),
+                [this](const auto& e) { return e.get() == entry; }));
+            return;
+        }
+        entry->final_counters = counters;
+        entry->exited_threads = 1;
+        entry->thread_id = 0;
+        entry->tally = nullptr;
+    }
+};
+
+thread_local Registration tl_registration;
+
+} // namespace
+
+bool alloc_hooks_installed() {
+    return detail::g_alloc_hooks_installed.load(std::memory_order_relaxed);
+}
+
+AllocCounters thread_heap_counters() {
+    return read_heap(detail::tl_alloc_tally);
+}
+
+uint64_t thread_minor_faults() {
+#ifdef __linux__
+    rusage ru{};
+    if (getrusage(RUSAGE_THREAD, &ru) == 0) {
+        return static_cast<uint64_t>(ru.ru_minflt);
+    }
+#endif
+    return 0;
+}
+
+AllocCounters thread_alloc_counters() {
+    AllocCounters c = thread_heap_counters();
+    c.minor_faults = thread_minor_faults();
+    return c;
+}
+
+void register_alloc_thread(const std::string& name) {
+    auto& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    if (tl_registration.entry) {
+        tl_registration.entry->name = name;
+        return;
+    }
+    auto entry = std::make_unique<ThreadEntry>();
+    entry->name = name;
+    entry->thread_id = current_thread_id();
+    entry->tally = &detail::tl_alloc_tally;
+    tl_registration.entry = entry.get();
+    reg.entries.push_back(std::move(entry));
+}
+
+std::vector<ThreadAllocReport> alloc_thread_report() {
+    auto& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+
+    std::vector<ThreadAllocReport> result;
+    result.reserve(reg.entries.size());
+    for (const auto& e : reg.entries) {
+        ThreadAllocReport r;
+        r.name = e->name;
+        r.thread_id = e->thread_id;
+        r.exited = (e->tally == nullptr);
+        if (r.exited) {
+            r.threads = e->exited_threads;
+            r.counters = e->final_counters;
+        } else if (e.get() == tl_registration.entry) {
+            r.counters = thread_alloc_counters();
+        } else {
+            r.counters = read_heap(*e->tally);
+            r.counters.minor_faults = task_minor_faults(e->thread_id);
+        }
+        result.push_back(std::move(r));
+    }
+    return result;
+}
+
+} // namespace grebe
@@ -0,0 +1,276 @@
+#include "grebe/async.h"
+#include "core/event_notifier.h"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace grebe {
+
+/// Handoff between run() (reactor thread) and process() (executor thread).
+struct AsyncSourceStage::State {
+    explicit State(size_t capacity) : ring(std::max<size_t>(1, capacity)) {}
+
+    std::mutex mutex;
+    std::condition_variable done_cv;  // request_stop() waits for run() to return
+    EventNotifier ready;              // frames emitted / run() finished
+
+    // ---- mutex ----
+    std::vector<std::optional<Frame>> ring;  // emitted, not yet taken by process()
+    size_t head  = 0;
+    size_t count = 0;
+    std::coroutine_handle<> blocked_emit;  // run() suspended in emit(): ring full
+    AsyncTask task;
+    bool started  = false;  // run() created and posted
+    bool finished = false;  // run() returned (stream ended or cancelled)
+    bool stopped  = false;  // request_stop() done; restart on the next runtime start
+
+    // ---- reactor thread only ----
+    int waiting_fd = -1;  // run() suspended in readable()
+    std::atomic<bool> cancel{false};
+
+    bool push(Frame&& frame) {
+        if (count == ring.size()) return false;
+        ring[(head + count) % ring.size()].emplace(std::move(frame));
+        ++count;
+        return true;
+    }
+
+    size_t drain(BatchWriter& out, size_t limit, std::coroutine_handle<>& resume) {
+        const size_t n = std::min(count, limit);
+        for (size_t i = 0; i < n; ++i) {
+            out.push(std::move(*ring[head]));
+            ring[head].reset();
+            head = (head + 1) % ring.size();
+        }
+        count -= n;
+        if (n > 0) resume = std::exchange(blocked_emit, {});
+        return n;
+    }
+
+    static void on_done(void* arg) {
+        auto* st = static_cast<State*>(arg);
+        // Notify under the lock: request_stop() may destroy the stage as
+        // soon as it observes finished
+        std::lock_guard<std::mutex> lock(st->mutex);
+        st->finished = true;
+        st->done_cv.notify_all();
+        st->ready.notify_all();
+    }
+};
+
+AsyncSourceStage::AsyncSourceStage(Reactor& reactor, size_t handoff_capacity)
+    : reactor_(reactor)
+    , state_(std::make_unique<State>(handoff_capacity)) {}
+
+AsyncSourceStage::~AsyncSourceStage() {
+    bool running;
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        running = state_->started && !state_->finished;
+    }
+    if (running) {
+        spdlog::warn("AsyncSourceStage: destroyed while running, stopping it now");
+        request_stop();
+    }
+}
+
+void AsyncSourceStage::cancel_io(void* arg) {
+    // Runs on the reactor thread, so run() is suspended at one of its awaits
+    auto& stage = *static_cast<AsyncSourceStage*>(arg);
+    auto& st = *stage.state_;
+    st.cancel.store(true, std::memory_order_relaxed);
+    if (st.waiting_fd >= 0) stage.reactor_.cancel(st.waiting_fd);
+
+    std::coroutine_handle<> blocked;
+    {
+        std::lock_guard<std::mutex> lock(st.mutex);
+        blocked = std::exchange(st.blocked_emit, {});
+    }
+    if (blocked) stage.reactor_.post(blocked);
+}
+
+StageResult AsyncSourceStage::process(BatchView& /*in*/, BatchWriter& out,
+                                      ExecContext& ctx) {
+    auto& st = *state_;
+
+    bool start = false;
+    {
+        std::lock_guard<std::mutex> lock(st.mutex);
+        if (st.stopped) {
+            // A worker still draining after request_stop(): only a fresh
+            // runtime start (iteration 0) runs the I/O loop again
+            if (ctx.iteration != 0) return StageResult::NoData;
+            st.stopped = false;
+        }
+        if (!st.started) {
+            st.started = true;
+            st.finished = false;
+            start = true;
+        }
+    }
+    if (start) {
+        auto task = run();
+        task.on_done(&State::on_done, &st);
+        const auto handle = task.handle();
+        {
+            std::lock_guard<std::mutex> lock(st.mutex);
+            st.task = std::move(task);
+        }
+        reactor_.post(handle);
+    }
+
+    // Credit edges: take no more than can be emitted downstream
+    const size_t limit = ctx.credit_window > 0
+        ? std::max<size_t>(1, ctx.credits)
+        : st.ring.size();
+
+    std::coroutine_handle<> resume;
+    const size_t first = out.size();
+    size_t n;
+    bool finished;
+    {
+        std::lock_guard<std::mutex> lock(st.mutex);
+        n = st.drain(out, limit, resume);
+        finished = st.finished && st.count == 0;
+    }
+
+    if (n == 0 && !finished && ctx.wait_budget_ns > 0) {
+        // Dedicated worker: sleep until run() emits (or request_stop())
+        const uint32_t token = st.ready.prepare_wait();
+        bool wait;
+        {
+            std::lock_guard<std::mutex> lock(st.mutex);
+            wait = st.count == 0 && !st.finished && !st.stopped;
+        }
+        if (wait) {
+            st.ready.wait(token, std::chrono::nanoseconds(ctx.wait_budget_ns));
+            ctx.waited = true;
+        } else {
+            st.ready.cancel_wait();
+        }
+        std::lock_guard<std::mutex> lock(st.mutex);
+        n = st.drain(out, limit, resume);
+        finished = st.finished && st.count == 0;
+    }
+
+    // Space freed: let a run() suspended in emit() continue
+    if (resume) reactor_.post(resume);
+    if (out.size() > first) delivered(out, first, ctx);
+
+    if (n > 0) return StageResult::Ok;
+    if (finished) {
+        std::lock_guard<std::mutex> lock(st.mutex);
+        if (st.stopped) return StageResult::NoData;  // cancelled, not end of stream
+        if (auto error = st.task.handle().promise().error) {
+            try {
+                std::rethrow_exception(error);
+            } catch (const std::exception& e) {
+                spdlog::error("{}: I/O loop failed: {}", name(), e.what());
+            } catch (...) {
+                spdlog::error("{}: I/O loop failed", name());
+            }
+            return StageResult::Error;
+        }
+        return StageResult::EOS;
+    }
+    return StageResult::NoData;
+}
+
+void AsyncSourceStage::request_stop() {
+    auto& st = *state_;
+    bool running;
+    {
+        std::lock_guard<std::mutex> lock(st.mutex);
+        running = st.started && !st.finished;
+        st.stopped = true;
+    }
+    st.ready.notify_all();  // wake a process() sleeping on the ring
+
+    if (running) {
+        if (reactor_.in_reactor_thread()) {
+            spdlog::error("{}: request_stop() called on the reactor thread", name());
+            return;
+        }
+        reactor_.post(&AsyncSourceStage::cancel_io, this);
+    }
+
+    std::unique_lock<std::mutex> lock(st.mutex);
+    st.done_cv.wait(lock, [&] { return !st.started || st.finished; });
+    st.task = AsyncTask{};
+    st.started = false;
+    st.finished = false;
+    st.cancel.store(false, std::memory_order_relaxed);
+}
+
+// ---- Awaiters (reactor thread) ----
+
+bool AsyncSourceStage::EmitAwaiter::await_suspend(std::coroutine_handle<> handle) {
+    auto& st = *stage_.state_;
+    if (st.cancel.load(std::memory_order_relaxed)) {
+        ok_ = false;
+        return false;
+    }
+    {
+        std::lock_guard<std::mutex> lock(st.mutex);
+        if (!st.push(std::move(frame_))) {
+            st.blocked_emit = handle;
+            suspended_ = true;
+            return true;
+        }
+    }
+    st.ready.notify_all();
+    ok_ = true;
+    return false;
+}
+
+bool AsyncSourceStage::EmitAwaiter::await_resume() {
+    if (!suspended_) return ok_;
+    auto& st = *stage_.state_;
+    if (st.cancel.load(std::memory_order_relaxed)) return false;
+    {
+        // Resumed by process() after it freed space
+        std::lock_guard<std::mutex> lock(st.mutex);
+        st.push(std::move(frame_));
+    }
+    st.ready.notify_all();
+    return true;
+}
+
+bool AsyncSourceStage::ReadableAwaiter::await_suspend(std::coroutine_handle<> handle) {
+    auto& st = *stage_.state_;
+    if (st.cancel.load(std::memory_order_relaxed)) {
+        cancelled_ = true;
+        return false;
+    }
+    st.waiting_fd = fd_;
+    if (!inner_.await_suspend(handle)) {
+        st.waiting_fd = -1;
+        return false;
+    }
+    return true;
+}
+
+bool AsyncSourceStage::ReadableAwaiter::await_resume() {
+    auto& st = *stage_.state_;
+    st.waiting_fd = -1;
+    if (cancelled_ || st.cancel.load(std::memory_order_relaxed)) return false;
+    return inner_.await_resume();
+}
+
+void AsyncSourceStage::YieldAwaiter::await_suspend(std::coroutine_handle<> handle) {
+    stage_.reactor_.post(handle);
+}
+
+bool AsyncSourceStage::YieldAwaiter::await_resume() const {
+    return !stage_.state_->cancel.load(std::memory_order_relaxed);
+}
+
+} // namespace grebe
@@ -0,0 +1,58 @@
+#include "core/event_notifier.h"
+
+#ifdef __linux__
+#include <climits>
+#include <ctime>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace grebe {
+
+uint32_t EventNotifier::prepare_wait() {
+    waiters_.fetch_add(1, std::memory_order_seq_cst);
+    // Order the waiter registration before the caller's condition re-check
+    // (pairs with the fence in notify_all()).
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    return epoch_.load(std::memory_order_acquire);
+}
+
+void EventNotifier::cancel_wait() {
+    waiters_.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void EventNotifier::wait(uint32_t token, std::chrono::nanoseconds timeout) {
+    if (timeout.count() > 0 && epoch_.load(std::memory_order_acquire) == token) {
+#ifdef __linux__
+        struct timespec ts;
+        ts.tv_sec  = static_cast<time_t>(timeout.count() / 1000000000);
+        ts.tv_nsec = static_cast<long>(timeout.count() % 1000000000);
+        // Returns immediately (EAGAIN) if the epoch already moved on
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&epoch_),
+                FUTEX_WAIT_PRIVATE, token, &ts, nullptr, 0);
+#else
+        std::unique_lock lock(mutex_);
+        cv_.wait_for(lock, timeout, [&] {
+            return epoch_.load(std::memory_order_acquire) != token;
+        });
+#endif
+    }
+    waiters_.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void EventNotifier::notify_all() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (waiters_.load(std::memory_order_relaxed) == 0) return;
+
+    epoch_.fetch_add(1, std::memory_order_release);
+#ifdef __linux__
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&epoch_),
+            FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+#else
+    { std::lock_guard lock(mutex_); }  // serialize with waiters' predicate check
+    cv_.notify_all();
+#endif
+}
+
+} // namespace grebe
@@ -0,0 +1,65 @@
+#pragma once
+
+// EventNotifier — Lightweight wait/notify primitive for queue wakeups
+// Linux: futex on an epoch counter. Other platforms: mutex + condition_variable.
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#ifndef __linux__
+#include <condition_variable>
+#include <mutex>
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#include <immintrin.h>
+#endif
+
+namespace grebe {
+
+/// CPU spin-wait hint (PAUSE on x86, no-op elsewhere).
+inline void cpu_relax() {
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    _mm_pause();
+#endif
+}
+
+/// Epoch-based event notifier.
+///
+/// Waiter protocol (avoids lost wakeups):
+///   auto token = n.prepare_wait();
+///   if (condition_met()) { n.cancel_wait(); return; }
+///   n.wait(token, timeout);
+///
+/// notify_all() costs a fence and one relaxed load when nobody is waiting,
+/// so producers can call it after every enqueue.
+class EventNotifier {
+public:
+    EventNotifier() = default;
+    EventNotifier(const EventNotifier&) = delete;
+    EventNotifier& operator=(const EventNotifier&) = delete;
+
+    /// Register as a waiter and return the current epoch token.
+    uint32_t prepare_wait();
+
+    /// Deregister without sleeping (condition became true after prepare_wait).
+    void cancel_wait();
+
+    /// Sleep until notify_all() advances the epoch past @p token or the
+    /// timeout expires. Deregisters the waiter before returning.
+    void wait(uint32_t token, std::chrono::nanoseconds timeout);
+
+    /// Wake all registered waiters. No syscall if there are none.
+    void notify_all();
+
+private:
+    std::atomic<uint32_t> epoch_{0};
+    std::atomic<uint32_t> waiters_{0};
+#ifndef __linux__
+    std::mutex mutex_;
+    std::condition_variable cv_;
+#endif
+};
+
+} // namespace grebe
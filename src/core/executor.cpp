@@ -0,0 +1,569 @@
+#include "core/executor.h"
+#include "core/event_notifier.h"
+#include "grebe/alloc_tracker.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace grebe {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+int64_t to_ns(Clock::time_point t) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(t.time_since_epoch()).count();
+}
+
+/// Backoff for a SourceStage returning NoData (no queue to park on):
+/// spin, then yield, then sleep with exponential growth up to park_timeout.
+class IdleBackoff {
+public:
+    explicit IdleBackoff(const StageOptions& opts) : opts_(opts) {}
+
+    void reset() { idle_ = 0; sleep_us_ = 1; }
+
+    void wait() {
+        if (opts_.idle_policy == IdlePolicy::Yield) {
+            std::this_thread::yield();
+            return;
+        }
+        if (opts_.idle_policy == IdlePolicy::Adaptive) {
+            if (idle_ < opts_.spin_count) {
+                ++idle_;
+                cpu_relax();
+                return;
+            }
+            if (idle_ < opts_.spin_count + opts_.yield_count) {
+                ++idle_;
+                std::this_thread::yield();
+                return;
+            }
+        }
+        const auto max_us = std::max<int64_t>(1, opts_.park_timeout.count());
+        std::this_thread::sleep_for(std::chrono::microseconds(sleep_us_));
+        sleep_us_ = std::min<int64_t>(sleep_us_ * 2, max_us);
+    }
+
+private:
+    const StageOptions& opts_;
+    uint32_t idle_ = 0;
+    int64_t sleep_us_ = 1;
+};
+
+// ---------------------------------------------------------------------------
+// ThreadPerStage
+// ---------------------------------------------------------------------------
+
+/// One dedicated thread per task (per stage, or per replica).
+class ThreadPerStageExecutor final : public IExecutor {
+public:
+    explicit ThreadPerStageExecutor(IStageRunner& runner) : runner_(runner) {}
+
+    void start() override {
+        const size_t n = runner_.task_count();
+        threads_.reserve(runner_.task_capacity());
+        for (TaskId id = 0; id < n; ++id) {
+            threads_.emplace_back(&ThreadPerStageExecutor::run, this, id);
+        }
+    }
+
+    void stop() override {
+        for (auto& t : threads_) {
+            if (t.joinable()) t.join();
+        }
+        threads_.clear();
+    }
+
+    // threads_ is indexed by TaskId and only touched by the controlling thread
+    void add_task(TaskId id) override {
+        if (threads_.size() <= id) threads_.resize(id + 1);
+        threads_[id] = std::thread(&ThreadPerStageExecutor::run, this, id);
+    }
+
+    void remove_task(TaskId id) override {
+        if (id < threads_.size() && threads_[id].joinable()) threads_[id].join();
+    }
+
+    // Workers block on their queues; enqueue/dequeue itself wakes them
+    void notify_input(TaskId) override {}
+    void notify_space(TaskId) override {}
+
+    size_t thread_count() const override {
+        return static_cast<size_t>(std::count_if(threads_.begin(), threads_.end(),
+                                                 [](const std::thread& t) { return t.joinable(); }));
+    }
+
+private:
+    void run(TaskId id) {
+        const std::string name = runner_.task_name(id);
+        register_alloc_thread(name);
+        const auto placement = apply_thread_placement(runner_.task_options(id).placement, name);
+        runner_.report_placement(id, to_string(placement));
+
+        IdleBackoff backoff(runner_.task_options(id));
+        const bool source = runner_.is_source(id);
+
+        while (!runner_.stopping()) {
+            switch (runner_.step(id, true)) {
+            case StepResult::Progress:
+                backoff.reset();
+                break;
+            case StepResult::Idle:
+                // Queue-fed stages already waited on their input queue
+                if (source && !runner_.stopping()) backoff.wait();
+                break;
+            case StepResult::Blocked:
+                // No output credit, or replica reorder window full
+                if (!runner_.stopping()) backoff.wait();
+                break;
+            case StepResult::Finished:
+                return;
+            }
+        }
+    }
+
+    IStageRunner& runner_;
+    std::vector<std::thread> threads_;
+};
+
+// ---------------------------------------------------------------------------
+// WorkStealing
+// ---------------------------------------------------------------------------
+
+/// Chase-Lev work-stealing deque of TaskIds with fixed capacity.
+/// The owner pushes/pops at the bottom (LIFO); thieves steal from the top.
+/// A task is queued at most once at a time, so capacity > task count
+/// means the ring never overflows.
+class StealDeque {
+public:
+    explicit StealDeque(size_t capacity) {
+        size_t cap = 1;
+        while (cap < capacity) cap <<= 1;
+        mask_ = cap - 1;
+        buf_ = std::make_unique<std::atomic<TaskId>[]>(cap);
+    }
+
+    void push(TaskId id) {
+        const int64_t b = bottom_.load(std::memory_order_relaxed);
+        buf_[static_cast<size_t>(b) & mask_].store(id, std::memory_order_relaxed);
+        bottom_.store(b + 1, std::memory_order_release);
+    }
+
+    std::optional<TaskId> pop() {
+        const int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+        bottom_.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = top_.load(std::memory_order_relaxed);
+
+        if (t > b) {
+            bottom_.store(b + 1, std::memory_order_relaxed);
+            return std::nullopt;  // empty
+        }
+        TaskId id = buf_[static_cast<size_t>(b) & mask_].load(std::memory_order_relaxed);
+        if (t == b) {
+            // Last element: race thieves for it
+            const bool won = top_.compare_exchange_strong(
+                t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+            bottom_.store(b + 1, std::memory_order_relaxed);
+            if (!won) return std::nullopt;
+        }
+        return id;
+    }
+
+    std::optional<TaskId> steal() {
+        int64_t t = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const int64_t b = bottom_.load(std::memory_order_acquire);
+        if (t >= b) return std::nullopt;
+
+        TaskId id = buf_[static_cast<size_t>(t) & mask_].load(std::memory_order_relaxed);
+        if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                          std::memory_order_relaxed)) {
+            return std::nullopt;  // lost to the owner or another thief
+        }
+        return id;
+    }
+
+    bool empty() const {
+        return bottom_.load(std::memory_order_relaxed) <= top_.load(std::memory_order_relaxed);
+    }
+
+private:
+    size_t mask_ = 0;
+    std::unique_ptr<std::atomic<TaskId>[]> buf_;
+    alignas(64) std::atomic<int64_t> top_{0};
+    alignas(64) std::atomic<int64_t> bottom_{0};
+};
+
+// Pool worker identity of the calling thread (null outside any pool)
+thread_local const void* t_pool = nullptr;
+thread_local size_t t_worker = 0;
+
+// Max park duration for an idle pool worker (bounds stop latency)
+constexpr auto kPoolParkSlice = std::chrono::milliseconds(1);
+
+// Consecutive steps a task may take per dispatch while it keeps making
+// progress. Lets a saturated producer fill a batch for its consumer instead
+// of handing over one frame at a time; other workers steal meanwhile.
+constexpr uint32_t kStepBudget = 32;
+
+/// Fixed worker pool. Each stage instance is a schedulable task: it is queued
+/// when frames arrive on its input edge (notify_input) and re-queued after each
+/// invocation that made progress. SourceStages returning NoData and stages
+/// Blocked on a full output edge are re-polled from a timer list with
+/// exponential backoff bounded by the stage's park_timeout; a Blocked stage's
+/// timer fires early when its consumer drains the edge (notify_space).
+class WorkStealingExecutor final : public IExecutor {
+public:
+    WorkStealingExecutor(IStageRunner& runner, size_t threads,
+                         std::vector<ThreadPlacement> placement)
+        : runner_(runner)
+        , placement_(std::move(placement))
+        , task_capacity_(runner.task_capacity())
+        , tasks_(std::make_unique<TaskSlot[]>(task_capacity_))
+        , known_tasks_(runner.task_count()) {
+        workers_.reserve(threads);
+        for (size_t i = 0; i < threads; ++i) {
+            workers_.push_back(std::make_unique<Worker>(task_capacity_ + 1));
+        }
+    }
+
+    void start() override {
+        // Sources have no input edge to notify them: seed them once
+        for (TaskId id = 0; id < known_tasks_; ++id) {
+            if (runner_.is_source(id)) schedule(id);
+        }
+        for (size_t i = 0; i < workers_.size(); ++i) {
+            workers_[i]->thread = std::thread(&WorkStealingExecutor::run, this, i);
+        }
+    }
+
+    void stop() override {
+        work_available_.notify_all();
+        for (auto& w : workers_) {
+            if (w->thread.joinable()) w->thread.join();
+        }
+    }
+
+    void add_task(TaskId id) override {
+        // The slot may be one that remove_task() released
+        auto& slot = tasks_[id];
+        slot.finished.store(false, std::memory_order_relaxed);
+        slot.blocked.store(false, std::memory_order_relaxed);
+        slot.removing.store(false, std::memory_order_relaxed);
+        slot.backoff_us = 0;
+        slot.scheduled.store(false, std::memory_order_release);
+        {
+            std::lock_guard<std::mutex> lock(placement_mutex_);
+            known_tasks_ = std::max(known_tasks_, id + 1);
+            if (!pool_placement_.empty()) runner_.report_placement(id, pool_placement_);
+        }
+        if (runner_.is_source(id)) schedule(id);
+    }
+
+    // A detached task's step() returns Finished, which drops it the next
+    // time it is dispatched (from a deque or the timer list). Wait for that
+    // so the id can be reused; claiming an idle slot keeps it from being
+    // queued meanwhile. A worker already inside step() sees `removing` and
+    // marks the slot finished itself, whatever the step returned.
+    void remove_task(TaskId id) override {
+        auto& slot = tasks_[id];
+        slot.removing.store(true, std::memory_order_seq_cst);
+        if (!slot.scheduled.exchange(true, std::memory_order_seq_cst)) return;
+        while (!slot.finished.load(std::memory_order_acquire)) std::this_thread::yield();
+    }
+
+    void notify_input(TaskId id) override {
+        // Pairs with the fence in run_task(): either the consumer sees the
+        // new frames when it re-checks has_input(), or we see it unscheduled
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        schedule(id);
+    }
+
+    void notify_space(TaskId producer) override {
+        // Fire the Blocked producer's retry timer now instead of after backoff
+        if (!tasks_[producer].blocked.exchange(false, std::memory_order_acq_rel)) return;
+        {
+            std::lock_guard<std::mutex> lock(timer_mutex_);
+            for (auto& t : timers_) {
+                if (t.id == producer) t.due = Clock::time_point{};
+            }
+            next_due_ns_.store(0, std::memory_order_release);
+        }
+        work_available_.notify_all();
+    }
+
+    size_t thread_count() const override { return workers_.size(); }
+
+private:
+    struct TaskSlot {
+        std::atomic<bool> scheduled{false};
+        std::atomic<bool> blocked{false};  // waiting in timers_ for output space
+        std::atomic<bool> finished{false}; // returned Finished: no longer queued anywhere
+        std::atomic<bool> removing{false}; // remove_task() is waiting for `finished`
+        int64_t backoff_us = 0;  // timer retry delay; owned by the running worker
+    };
+
+    struct Worker {
+        explicit Worker(size_t capacity) : deque(capacity) {}
+        StealDeque deque;
+        std::vector<TaskId> deferred;  // made progress; re-queued once local work drains
+        std::thread thread;
+        std::string placement;  // effective placement, written once at startup
+    };
+
+    struct Timer {
+        Clock::time_point due;
+        TaskId id;
+    };
+
+    /// Queue @p id unless it is already queued or running.
+    void schedule(TaskId id) {
+        if (tasks_[id].scheduled.exchange(true, std::memory_order_acq_rel)) return;
+        enqueue(id);
+    }
+
+    /// Hand a scheduled task to a worker: the caller's own deque if it is a
+    /// pool worker, otherwise the injection queue.
+    void enqueue(TaskId id) {
+        if (t_pool == this) {
+            workers_[t_worker]->deque.push(id);
+        } else {
+            std::lock_guard<std::mutex> lock(inject_mutex_);
+            injected_.push_back(id);
+            injected_count_.fetch_add(1, std::memory_order_release);
+        }
+        work_available_.notify_all();
+    }
+
+    /// Re-poll a scheduled task after its backoff delay.
+    void defer(TaskId id) {
+        auto& slot = tasks_[id];
+        const auto max_us = std::max<int64_t>(1, runner_.task_options(id).park_timeout.count());
+        slot.backoff_us = std::clamp<int64_t>(slot.backoff_us * 2, 1, max_us);
+
+        const auto due = Clock::now() + std::chrono::microseconds(slot.backoff_us);
+        std::lock_guard<std::mutex> lock(timer_mutex_);
+        timers_.push_back({due, id});
+        const auto due_ns = to_ns(due);
+        if (due_ns < next_due_ns_.load(std::memory_order_relaxed)) {
+            next_due_ns_.store(due_ns, std::memory_order_release);
+        }
+    }
+
+    /// Move due timers and injected tasks into @p w's deque.
+    void poll_shared(Worker& w) {
+        if (injected_count_.load(std::memory_order_acquire) > 0) {
+            std::lock_guard<std::mutex> lock(inject_mutex_);
+            for (TaskId id : injected_) w.deque.push(id);
+            injected_count_.fetch_sub(injected_.size(), std::memory_order_relaxed);
+            injected_.clear();
+        }
+
+        const auto now = Clock::now();
+        if (next_due_ns_.load(std::memory_order_acquire) > to_ns(now)) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(timer_mutex_);
+        auto next = std::numeric_limits<int64_t>::max();
+        auto keep = timers_.begin();
+        for (auto& t : timers_) {
+            if (t.due <= now) {
+                tasks_[t.id].blocked.store(false, std::memory_order_relaxed);
+                w.deque.push(t.id);
+            } else {
+                next = std::min(next, to_ns(t.due));
+                *keep++ = t;
+            }
+        }
+        timers_.erase(keep, timers_.end());
+        next_due_ns_.store(next, std::memory_order_release);
+    }
+
+    std::optional<TaskId> steal(size_t self) {
+        const size_t n = workers_.size();
+        for (size_t i = 1; i < n; ++i) {
+            if (auto id = workers_[(self + i) % n]->deque.steal()) return id;
+        }
+        return std::nullopt;
+    }
+
+    bool work_visible() const {
+        if (injected_count_.load(std::memory_order_acquire) > 0) return true;
+        if (next_due_ns_.load(std::memory_order_acquire) <= to_ns(Clock::now())) {
+            return true;
+        }
+        for (const auto& w : workers_) {
+            if (!w->deque.empty()) return true;
+        }
+        return false;
+    }
+
+    void park() {
+        auto token = work_available_.prepare_wait();
+        if (work_visible() || runner_.stopping()) {
+            work_available_.cancel_wait();
+            return;
+        }
+        auto timeout = std::chrono::duration_cast<std::chrono::nanoseconds>(kPoolParkSlice);
+        const auto next = next_due_ns_.load(std::memory_order_acquire);
+        if (next != std::numeric_limits<int64_t>::max()) {
+            const auto until = std::chrono::nanoseconds(next - to_ns(Clock::now()));
+            timeout = std::clamp(until, std::chrono::nanoseconds(0), timeout);
+        }
+        work_available_.wait(token, timeout);
+    }
+
+    void run(size_t index) {
+        t_pool = this;
+        t_worker = index;
+        Worker& w = *workers_[index];
+        apply_placement(index, w);
+
+        while (!runner_.stopping()) {
+            poll_shared(w);
+
+            auto id = w.deque.pop();
+            if (!id && !w.deferred.empty()) {
+                // Local work drained: re-queue stages that made progress
+                // (after the downstream work they produced, and stealable)
+                for (TaskId d : w.deferred) w.deque.push(d);
+                w.deferred.clear();
+                id = w.deque.pop();
+            }
+            if (!id) id = steal(index);
+            if (!id) {
+                park();
+                continue;
+            }
+            run_task(*id, w);
+        }
+
+        t_pool = nullptr;
+    }
+
+    /// Pin worker @p index per RuntimeOptions::worker_placement. The last
+    /// worker to start reports the pool's placement for every task, since
+    /// any worker may run any task.
+    void apply_placement(size_t index, Worker& w) {
+        const ThreadPlacement requested = placement_.empty()
+            ? ThreadPlacement{} : placement_[index % placement_.size()];
+        const std::string name = "grebe-pool-" + std::to_string(index);
+        register_alloc_thread(name);
+        w.placement = to_string(apply_thread_placement(requested, name));
+        if (placed_.fetch_add(1, std::memory_order_acq_rel) + 1 != workers_.size()) return;
+
+        std::string summary = "pool:";
+        std::vector<std::string> seen;
+        for (const auto& other : workers_) {
+            if (std::find(seen.begin(), seen.end(), other->placement) != seen.end()) continue;
+            seen.push_back(other->placement);
+            summary += (seen.size() == 1 ? " " : "; ") + other->placement;
+        }
+        std::lock_guard<std::mutex> lock(placement_mutex_);
+        pool_placement_ = summary;
+        for (TaskId id = 0; id < known_tasks_; ++id) runner_.report_placement(id, summary);
+    }
+
+    void run_task(TaskId id, Worker& w) {
+        auto& slot = tasks_[id];
+        StepResult result = runner_.step(id, false);
+        for (uint32_t n = 1; result == StepResult::Progress && n < kStepBudget &&
+                             !runner_.stopping(); ++n) {
+            result = runner_.step(id, false);
+        }
+
+        // Removed while we were in step(): we still hold the slot, so drop
+        // the task here instead of requeueing it. An Idle step would
+        // otherwise unschedule it and never be dispatched again.
+        if (result != StepResult::Finished && slot.removing.load(std::memory_order_seq_cst)) {
+            slot.finished.store(true, std::memory_order_release);
+            return;
+        }
+
+        switch (result) {
+        case StepResult::Progress:
+            slot.backoff_us = 0;
+            w.deferred.push_back(id);  // stays scheduled
+            break;
+        case StepResult::Blocked:
+            slot.blocked.store(true, std::memory_order_release);
+            defer(id);
+            break;
+        case StepResult::Idle:
+            if (runner_.is_source(id)) {
+                defer(id);
+                break;
+            }
+            // Unschedule, then re-check for frames that raced with us
+            slot.backoff_us = 0;
+            slot.scheduled.store(false, std::memory_order_seq_cst);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (slot.removing.load(std::memory_order_seq_cst)) {
+                // remove_task() raced with the unschedule: whoever re-claims
+                // the slot first owns it; if it is us, nothing else will
+                // dispatch the task to set `finished`
+                if (!slot.scheduled.exchange(true, std::memory_order_seq_cst)) {
+                    slot.finished.store(true, std::memory_order_release);
+                }
+                break;
+            }
+            if (runner_.has_input(id)) schedule(id);
+            break;
+        case StepResult::Finished:
+            // Stays "scheduled" so it is never queued again
+            slot.finished.store(true, std::memory_order_release);
+            break;
+        }
+    }
+
+    IStageRunner& runner_;
+    const std::vector<ThreadPlacement> placement_;  // RuntimeOptions::worker_placement
+    const size_t task_capacity_;
+    std::unique_ptr<TaskSlot[]> tasks_;  // by TaskId, sized for attach()ed tasks
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::atomic<size_t> placed_{0};  // workers that applied their placement
+
+    std::mutex placement_mutex_;
+    size_t known_tasks_;          // tasks started or added so far (placement_mutex_)
+    std::string pool_placement_;  // summary once every worker is placed (placement_mutex_)
+
+    std::mutex inject_mutex_;
+    std::vector<TaskId> injected_;
+    std::atomic<size_t> injected_count_{0};
+
+    std::mutex timer_mutex_;
+    std::vector<Timer> timers_;
+    std::atomic<int64_t> next_due_ns_{std::numeric_limits<int64_t>::max()};
+
+    EventNotifier work_available_;  // idle workers park here
+};
+
+} // namespace
+
+std::unique_ptr<IExecutor> make_executor(const RuntimeOptions& options,
+                                         IStageRunner& runner) {
+    switch (options.executor) {
+    case ExecutorKind::WorkStealing: {
+        size_t threads = options.worker_threads;
+        if (threads == 0) {
+            threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+        }
+        return std::make_unique<WorkStealingExecutor>(runner, threads, options.worker_placement);
+    }
+    case ExecutorKind::ThreadPerStage:
+        break;
+    }
+    return std::make_unique<ThreadPerStageExecutor>(runner);
+}
+
+} // namespace grebe
@@ -0,0 +1,99 @@
+#pragma once
+
+// Executor — Maps StageGraph stage invocations onto OS threads
+// ThreadPerStage: one blocking worker per stage. WorkStealing: fixed pool.
+
+#include "grebe/runtime.h"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace grebe {
+
+/// Schedulable unit: one instance of a stage. A stage with
+/// StageOptions::replicas = N contributes N tasks; otherwise task == stage.
+using TaskId = size_t;
+
+/// Outcome of one stage invocation (IStageRunner::step()).
+enum class StepResult {
+    Progress,  ///< process() ran and returned Ok/Retry, or a source already
+               ///< waited for data (ExecContext::waited) — run again soon
+    Idle,      ///< No input queued, or a SourceStage returned NoData
+    Blocked,   ///< Output pending on a full Block edge, no credit on a Credit
+               ///< edge, or reorder window full
+    Finished,  ///< EOS or Error — never run this stage again
+};
+
+/// Stage-side interface driven by an executor (implemented by StageGraph).
+/// step() is never called concurrently for the same task.
+class IStageRunner {
+public:
+    virtual ~IStageRunner() = default;
+
+    virtual size_t task_count() const = 0;
+
+    /// Upper bound for TaskIds while running, including tasks that
+    /// StageGraph::attach() may add (IExecutor::add_task()).
+    virtual size_t task_capacity() const = 0;
+
+    virtual const StageOptions& task_options(TaskId id) const = 0;
+
+    /// Thread name for a dedicated task thread (stage name, replica suffix).
+    virtual std::string task_name(TaskId id) const = 0;
+
+    /// True for tasks of stages without an input edge (polled, never notified).
+    virtual bool is_source(TaskId id) const = 0;
+
+    /// Whether frames are queued on the task's input edge.
+    virtual bool has_input(TaskId id) const = 0;
+
+    /// Run one process() invocation.
+    /// @param blocking  true: wait for input per IdlePolicy and block on full
+    ///                  Block edges. false: never wait; undeliverable output
+    ///                  is kept pending and reported as Blocked.
+    /// Returns Finished for a detached task.
+    virtual StepResult step(TaskId id, bool blocking) = 0;
+
+    /// Set once stop() has begun; executors exit their loops.
+    virtual bool stopping() const = 0;
+
+    /// Effective thread placement of the thread(s) running @p id, reported
+    /// by the executor once applied (StageTelemetry::placement).
+    virtual void report_placement(TaskId id, const std::string& placement) = 0;
+};
+
+/// Executor interface. Created per StageGraph::start(), destroyed on stop().
+class IExecutor {
+public:
+    virtual ~IExecutor() = default;
+
+    /// Launch worker threads.
+    virtual void start() = 0;
+
+    /// Join worker threads. The runner is already stopping and all queues
+    /// are shut down, so no worker stays blocked.
+    virtual void stop() = 0;
+
+    /// Task @p id (< task_capacity()) was added while running: run it.
+    virtual void add_task(TaskId id) = 0;
+
+    /// Task @p id was detached while running. Its step() now returns
+    /// Finished at once; release the thread running it, if any.
+    virtual void remove_task(TaskId id) = 0;
+
+    /// Frames were enqueued on @p id's input edge (called after each batch).
+    virtual void notify_input(TaskId id) = 0;
+
+    /// Frames were dequeued from a Block / Credit edge fed by @p producer, so a
+    /// producer reporting Blocked may be able to deliver again.
+    virtual void notify_space(TaskId producer) = 0;
+
+    /// OS threads owned by the executor.
+    virtual size_t thread_count() const = 0;
+};
+
+std::unique_ptr<IExecutor> make_executor(const RuntimeOptions& options,
+                                         IStageRunner& runner);
+
+} // namespace grebe
@@ -0,0 +1,196 @@
+#include "grebe/frame_pool.h"
+
+#include <atomic>
+#include <mutex>
+
+namespace grebe {
+
+namespace {
+
+// Size classes cover 2^6 .. 2^30 samples; smaller buffers are not worth
+// caching, larger ones are allocated and freed directly.
+constexpr size_t kMinClassLog2 = 6;
+constexpr size_t kMaxClassLog2 = 30;
+constexpr size_t kNumClasses   = kMaxClassLog2 - kMinClassLog2 + 1;
+
+thread_local uint64_t tl_allocations = 0;
+
+/// Smallest class whose buffers can hold @p count samples.
+size_t ceil_class(size_t count) {
+    size_t k = kMinClassLog2;
+    while (k <= kMaxClassLog2 && (size_t{1} << k) < count) ++k;
+    return k;
+}
+
+/// Largest class whose minimum capacity @p capacity satisfies.
+size_t floor_class(size_t capacity) {
+    size_t k = kMinClassLog2;
+    while (k < kMaxClassLog2 && (size_t{1} << (k + 1)) <= capacity) ++k;
+    return k;
+}
+
+} // namespace
+
+/// Holder behind FramePool::share(): owns the buffer while frames share it.
+struct FramePool::SharedBuffer final : FramePayload {
+    explicit SharedBuffer(FramePool& owner) : pool(owner) {}
+    ~SharedBuffer() override = default;
+
+    void on_release() noexcept override { pool.release_shared(this); }
+
+    FramePool& pool;
+    std::vector<int16_t> buffer;
+    bool recycle = false;
+};
+
+struct FramePool::Impl {
+    explicit Impl(size_t max_cached) : max_cached(max_cached) {
+        for (auto& list : free_lists) list.reserve(max_cached);
+        free_holders.reserve(max_cached);
+    }
+    ~Impl() {
+        for (auto* h : free_holders) delete h;
+    }
+
+    size_t max_cached;  // guarded by mutex
+    mutable std::mutex mutex;
+    std::vector<std::vector<int16_t>> free_lists[kNumClasses];
+    std::vector<SharedBuffer*> free_holders;  // idle share() holders
+
+    std::atomic<uint64_t> hits{0};
+    std::atomic<uint64_t> misses{0};
+};
+
+FramePool::FramePool(size_t max_cached_per_class)
+    : impl_(std::make_unique<Impl>(max_cached_per_class)) {}
+
+FramePool::~FramePool() = default;
+
+FramePool& FramePool::global() {
+    // Intentionally leaked: pooled frames may be destroyed during static
+    // destruction, after a function-local static pool would be gone.
+    static FramePool* pool = new FramePool();
+    return *pool;
+}
+
+std::vector<int16_t> FramePool::acquire(size_t count) {
+    const size_t k = ceil_class(count);
+
+    if (k <= kMaxClassLog2) {
+        std::vector<int16_t> buf;
+        {
+            std::lock_guard lock(impl_->mutex);
+            auto& list = impl_->free_lists[k - kMinClassLog2];
+            if (!list.empty()) {
+                buf = std::move(list.back());
+                list.pop_back();
+            } else if (k > kMinClassLog2) {
+                // Buffers adopted from outside the pool (swap_storage) may have
+                // non power-of-two capacity and land one class lower
+                auto& lower = impl_->free_lists[k - 1 - kMinClassLog2];
+                for (size_t i = lower.size(); i-- > 0;) {
+                    if (lower[i].capacity() >= count) {
+                        buf = std::move(lower[i]);
+                        lower[i] = std::move(lower.back());
+                        lower.pop_back();
+                        break;
+                    }
+                }
+            }
+        }
+        if (buf.capacity() >= count && buf.capacity() > 0) {
+            impl_->hits.fetch_add(1, std::memory_order_relaxed);
+            buf.resize(count);
+            return buf;
+        }
+    }
+
+    impl_->misses.fetch_add(1, std::memory_order_relaxed);
+    ++tl_allocations;
+    std::vector<int16_t> buf;
+    buf.reserve(k <= kMaxClassLog2 ? (size_t{1} << k) : count);
+    buf.resize(count);
+    return buf;
+}
+
+void FramePool::recycle(std::vector<int16_t> buffer) {
+    // Buffers that are not cached are freed when the by-value parameter is
+    // destroyed, after the lock has been released
+    const size_t cap = buffer.capacity();
+    if (cap < (size_t{1} << kMinClassLog2) || cap >= (size_t{1} << (kMaxClassLog2 + 1))) {
+        return;
+    }
+
+    std::lock_guard lock(impl_->mutex);
+    auto& list = impl_->free_lists[floor_class(cap) - kMinClassLog2];
+    if (list.size() < impl_->max_cached) {
+        list.push_back(std::move(buffer));
+    }
+}
+
+FramePayload* FramePool::share(std::vector<int16_t> buffer, bool recycle) {
+    SharedBuffer* holder = nullptr;
+    {
+        std::lock_guard lock(impl_->mutex);
+        if (!impl_->free_holders.empty()) {
+            holder = impl_->free_holders.back();
+            impl_->free_holders.pop_back();
+        }
+    }
+    if (!holder) holder = new SharedBuffer(*this);
+    holder->buffer = std::move(buffer);
+    holder->recycle = recycle;
+    return holder;
+}
+
+void FramePool::release_shared(SharedBuffer* holder) noexcept {
+    auto buffer = std::move(holder->buffer);
+    holder->buffer = {};
+    if (holder->recycle) recycle(std::move(buffer));
+    {
+        std::lock_guard lock(impl_->mutex);
+        if (impl_->free_holders.size() < impl_->max_cached) {
+            impl_->free_holders.push_back(holder);
+            return;
+        }
+    }
+    delete holder;
+}
+
+void FramePool::reserve(size_t max_cached_per_class) {
+    std::lock_guard lock(impl_->mutex);
+    if (max_cached_per_class <= impl_->max_cached) return;
+    // Free lists keep their capacity, so recycle() never reallocates them
+    impl_->max_cached = max_cached_per_class;
+    for (auto& list : impl_->free_lists) list.reserve(max_cached_per_class);
+    impl_->free_holders.reserve(max_cached_per_class);
+}
+
+void FramePool::clear() {
+    std::vector<SharedBuffer*> holders;
+    {
+        std::lock_guard lock(impl_->mutex);
+        for (auto& list : impl_->free_lists) list.clear();
+        holders.swap(impl_->free_holders);
+    }
+    for (auto* h : holders) delete h;
+}
+
+FramePool::Stats FramePool::stats() const {
+    Stats s;
+    s.hits = impl_->hits.load(std::memory_order_relaxed);
+    s.misses = impl_->misses.load(std::memory_order_relaxed);
+    std::lock_guard lock(impl_->mutex);
+    for (const auto& list : impl_->free_lists) {
+        s.cached_buffers += list.size();
+        for (const auto& b : list) s.cached_bytes += b.capacity() * sizeof(int16_t);
+    }
+    s.cached_payloads = impl_->free_holders.size();
+    return s;
+}
+
+uint64_t FramePool::thread_allocations() {
+    return tl_allocations;
+}
+
+} // namespace grebe
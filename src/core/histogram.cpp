@@ -0,0 +1,54 @@
+#include "grebe/histogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace grebe {
+
+Percentiles HdrHistogram::percentiles(double scale) const {
+    // Snapshot once so the percentiles are monotonic even while recording
+    std::array<uint64_t, kBucketCount> counts;
+    uint64_t total = 0;
+    for (size_t i = 0; i < kBucketCount; ++i) {
+        counts[i] = counts_[i].load(std::memory_order_relaxed);
+        total += counts[i];
+    }
+
+    Percentiles p;
+    p.count = total;
+    if (total == 0) return p;
+
+    const uint64_t max = max_.load(std::memory_order_relaxed);
+    p.max = static_cast<double>(max) * scale;
+
+    constexpr double kQuantiles[] = {0.50, 0.90, 0.99, 0.999};
+    double* const out[] = {&p.p50, &p.p90, &p.p99, &p.p999};
+
+    size_t q = 0;
+    uint64_t seen = 0;
+    for (size_t i = 0; i < kBucketCount && q < 4; ++i) {
+        seen += counts[i];
+        while (q < 4) {
+            const auto rank = std::max<uint64_t>(
+                1, static_cast<uint64_t>(std::ceil(kQuantiles[q] * static_cast<double>(total))));
+            if (seen < rank) break;
+            // Bucket upper bound, but never above the exact maximum
+            *out[q] = static_cast<double>(std::min(bucket_upper(i), max)) * scale;
+            ++q;
+        }
+    }
+    return p;
+}
+
+uint64_t HdrHistogram::total_count() const {
+    uint64_t total = 0;
+    for (const auto& c : counts_) total += c.load(std::memory_order_relaxed);
+    return total;
+}
+
+void HdrHistogram::reset() noexcept {
+    for (auto& c : counts_) c.store(0, std::memory_order_relaxed);
+    max_.store(0, std::memory_order_relaxed);
+}
+
+} // namespace grebe
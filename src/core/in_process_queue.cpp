@@ -1,5 +1,6 @@
 #include "core/in_process_queue.h"
 
+#include <algorithm>
 #include <chrono>
 
 namespace grebe {
@@ -26,9 +27,11 @@ bool InProcessQueue::enqueue(Frame&& item) {
             ++total_dropped_;
             queue_.push_back(std::move(item));
             ++total_enqueued_;
+            if (waiting_consumers_ > 0) not_empty_.notify_one();
             return true;
 
-        case BackpressurePolicy::Block: {
+        case BackpressurePolicy::Block:
+        case BackpressurePolicy::Credit: {
             auto t0 = std::chrono::steady_clock::now();
             not_full_.wait(lock, [this] {
                 return queue_.size() < capacity_ || shutdown_;
@@ -45,6 +48,7 @@ bool InProcessQueue::enqueue(Frame&& item) {
 
     queue_.push_back(std::move(item));
     ++total_enqueued_;
+    if (waiting_consumers_ > 0) not_empty_.notify_one();
     return true;
 }
 
@@ -52,12 +56,45 @@ std::optional<Frame> InProcessQueue::dequeue() {
     std::lock_guard lock(mutex_);
 
     if (queue_.empty()) return std::nullopt;
+    return pop_front_locked();
+}
+
+std::optional<Frame> InProcessQueue::dequeue_wait(std::chrono::nanoseconds timeout) {
+    std::unique_lock lock(mutex_);
+
+    if (queue_.empty() && !shutdown_) {
+        ++waiting_consumers_;
+        not_empty_.wait_for(lock, timeout, [this] {
+            return !queue_.empty() || shutdown_;
+        });
+        --waiting_consumers_;
+    }
+
+    if (queue_.empty()) return std::nullopt;
+    return pop_front_locked();
+}
+
+size_t InProcessQueue::dequeue_bulk(std::vector<Frame>& out, size_t max_items) {
+    std::lock_guard lock(mutex_);
+
+    const size_t n = std::min(max_items, queue_.size());
+    for (size_t i = 0; i < n; ++i) {
+        out.push_back(std::move(queue_.front()));
+        queue_.pop_front();
+    }
+
+    if (n > 0 && blocks_when_full(policy_)) {
+        not_full_.notify_all();
+    }
+    return n;
+}
 
+Frame InProcessQueue::pop_front_locked() {
     Frame f = std::move(queue_.front());
     queue_.pop_front();
 
-    // Wake blocked producer if Block policy
-    if (policy_ == BackpressurePolicy::Block) {
+    // Wake blocked producer if Block / Credit policy
+    if (blocks_when_full(policy_)) {
         not_full_.notify_one();
     }
 
@@ -109,6 +146,7 @@ void InProcessQueue::shutdown() {
         shutdown_ = true;
     }
     not_full_.notify_all();
+    not_empty_.notify_all();
 }
 
 } // namespace grebe
@@ -16,7 +16,7 @@ namespace grebe {
 ///
 /// Thread-safe for concurrent enqueue/dequeue (MPSC or SPSC).
 /// Backpressure policy is applied on the enqueue (producer) side.
-/// Dequeue is always non-blocking (returns nullopt if empty).
+/// dequeue() is non-blocking; dequeue_wait() sleeps on a condition variable.
 class InProcessQueue final : public IQueue<Frame> {
 public:
     /// @param capacity  Maximum number of frames the queue can hold.
@@ -29,6 +29,8 @@ public:
     // ---- IQueue<Frame> ----
     bool enqueue(Frame&& item) override;
     std::optional<Frame> dequeue() override;
+    std::optional<Frame> dequeue_wait(std::chrono::nanoseconds timeout) override;
+    size_t dequeue_bulk(std::vector<Frame>& out, size_t max_items) override;
 
     size_t   capacity()   const override;
     size_t   size()       const override;
@@ -40,15 +42,20 @@ public:
     uint64_t total_dropped()    const override;
     uint64_t total_blocked_ns() const override;
 
-    /// Signal blocked producers to wake up (used during shutdown).
-    void shutdown();
+    /// Signal blocked producers and waiting consumers to wake up (used during shutdown).
+    void shutdown() override;
 
 private:
+    /// Pop the front frame (mutex_ held, queue non-empty).
+    Frame pop_front_locked();
+
     const size_t capacity_;
     const BackpressurePolicy policy_;
 
     mutable std::mutex mutex_;
     std::condition_variable not_full_;
+    std::condition_variable not_empty_;
+    uint32_t waiting_consumers_ = 0;  // notify not_empty_ only when non-zero
     bool shutdown_ = false;
 
     std::deque<Frame> queue_;
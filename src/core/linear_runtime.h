@@ -1,41 +1,25 @@
 #pragma once
 
 // LinearRuntime — Internal implementation header
-// Phase 13
+// Phase 13 (Phase 15: implemented as a chain-shaped StageGraph)
 
 #include "grebe/runtime.h"
-#include "core/in_process_queue.h"
 
-#include <atomic>
-#include <thread>
+#include <optional>
 #include <vector>
 
 namespace grebe {
 
 /// Internal state for LinearRuntime (pimpl target).
 struct LinearRuntime::Impl {
-    struct StageEntry {
-        std::unique_ptr<IStage> stage;
-        size_t queue_capacity = 64;
-        BackpressurePolicy policy = BackpressurePolicy::DropOldest;
-    };
-
-    struct WorkerState {
-        std::thread thread;
-        std::atomic<uint64_t> frames_processed{0};
-        std::atomic<uint64_t> total_process_ns{0};
-    };
-
-    std::vector<StageEntry> entries;
-    std::vector<std::unique_ptr<InProcessQueue>> queues;  // queues[i] = output of stage i
-    std::vector<std::unique_ptr<WorkerState>> workers;
-
-    std::atomic<bool> stop{false};
-    std::atomic<bool> is_running{false};
-
-    std::chrono::steady_clock::time_point start_time;
-
-    void worker_func(size_t stage_index);
+    explicit Impl(const RuntimeOptions& options) : graph(options) {}
+
+    StageGraph graph;
+    std::optional<StageId> tail;     // last pipeline stage (attach() adds branches)
+    std::vector<bool> pipeline;      // by StageId: added with add_stage()
+    std::optional<OutputId> output;  // added on first start()
+    QueueOptions output_options;     // last added stage's queue options
+    bool output_options_set = false; // set_output_options() overrides the above
 };
 
 } // namespace grebe
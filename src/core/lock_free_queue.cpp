@@ -0,0 +1,234 @@
+#include "core/lock_free_queue.h"
+
+#include <chrono>
+
+namespace grebe {
+
+namespace {
+
+// Block policy: spins before parking, and the park slice used to re-check shutdown
+constexpr uint32_t kBlockSpinCount = 64;
+constexpr auto     kBlockParkSlice = std::chrono::milliseconds(10);
+
+size_t round_up_pow2(size_t v) {
+    size_t p = 1;
+    while (p < v) p <<= 1;
+    return p;
+}
+
+} // namespace
+
+LockFreeQueue::LockFreeQueue(size_t capacity, BackpressurePolicy policy,
+                             bool multi_producer)
+    : capacity_(round_up_pow2(capacity > 0 ? capacity : 1))
+    , mask_(capacity_ - 1)
+    , policy_(policy)
+    , multi_producer_(multi_producer)
+    , slots_(std::make_unique<Slot[]>(capacity_)) {
+    for (size_t i = 0; i < capacity_; ++i) {
+        slots_[i].seq.store(i, std::memory_order_relaxed);
+    }
+}
+
+LockFreeQueue::~LockFreeQueue() {
+    shutdown();
+}
+
+bool LockFreeQueue::try_push(Frame& item) {
+    size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+    for (;;) {
+        Slot& slot = slots_[pos & mask_];
+        size_t seq = slot.seq.load(std::memory_order_acquire);
+        auto dif = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+
+        if (dif == 0) {
+            if (!multi_producer_) {
+                enqueue_pos_.store(pos + 1, std::memory_order_relaxed);
+                break;
+            }
+            if (enqueue_pos_.compare_exchange_weak(pos, pos + 1,
+                                                   std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (dif < 0) {
+            return false;  // full
+        } else {
+            pos = enqueue_pos_.load(std::memory_order_relaxed);
+        }
+    }
+
+    Slot& slot = slots_[pos & mask_];
+    slot.value.emplace(std::move(item));
+    slot.seq.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+std::optional<Frame> LockFreeQueue::try_pop() {
+    size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+    for (;;) {
+        Slot& slot = slots_[pos & mask_];
+        size_t seq = slot.seq.load(std::memory_order_acquire);
+        auto dif = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos + 1);
+
+        if (dif == 0) {
+            if (dequeue_pos_.compare_exchange_weak(pos, pos + 1,
+                                                   std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (dif < 0) {
+            return std::nullopt;  // empty
+        } else {
+            pos = dequeue_pos_.load(std::memory_order_relaxed);
+        }
+    }
+
+    Slot& slot = slots_[pos & mask_];
+    std::optional<Frame> out(std::move(*slot.value));
+    slot.value.reset();
+    slot.seq.store(pos + mask_ + 1, std::memory_order_release);
+    return out;
+}
+
+bool LockFreeQueue::enqueue(Frame&& item) {
+    if (try_push(item)) {
+        total_enqueued_.fetch_add(1, std::memory_order_relaxed);
+        not_empty_.notify_all();
+        return true;
+    }
+
+    switch (policy_) {
+    case BackpressurePolicy::DropLatest:
+        total_dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+
+    case BackpressurePolicy::DropOldest:
+        // Evict the oldest frame until our push succeeds. A concurrent
+        // consumer may free the slot first, in which case nothing is dropped.
+        do {
+            if (try_pop()) {
+                total_dropped_.fetch_add(1, std::memory_order_relaxed);
+            }
+        } while (!try_push(item));
+        total_enqueued_.fetch_add(1, std::memory_order_relaxed);
+        not_empty_.notify_all();
+        return true;
+
+    case BackpressurePolicy::Block:
+    case BackpressurePolicy::Credit: {
+        auto t0 = std::chrono::steady_clock::now();
+        uint32_t spins = 0;
+        bool pushed = false;
+        while (!shutdown_.load(std::memory_order_acquire)) {
+            if (try_push(item)) {
+                pushed = true;
+                break;
+            }
+            if (++spins < kBlockSpinCount) {
+                cpu_relax();
+                continue;
+            }
+            auto token = not_full_.prepare_wait();
+            if (!full() || shutdown_.load(std::memory_order_acquire)) {
+                not_full_.cancel_wait();
+                continue;
+            }
+            not_full_.wait(token, kBlockParkSlice);
+        }
+        auto t1 = std::chrono::steady_clock::now();
+        total_blocked_ns_.fetch_add(static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count()),
+            std::memory_order_relaxed);
+
+        if (!pushed) return false;
+        total_enqueued_.fetch_add(1, std::memory_order_relaxed);
+        not_empty_.notify_all();
+        return true;
+    }
+    }
+    return false;
+}
+
+std::optional<Frame> LockFreeQueue::dequeue() {
+    auto f = try_pop();
+    if (f && blocks_when_full(policy_)) {
+        not_full_.notify_all();
+    }
+    return f;
+}
+
+size_t LockFreeQueue::dequeue_bulk(std::vector<Frame>& out, size_t max_items) {
+    size_t n = 0;
+    while (n < max_items) {
+        auto f = try_pop();
+        if (!f) break;
+        out.push_back(std::move(*f));
+        ++n;
+    }
+    if (n > 0 && blocks_when_full(policy_)) {
+        not_full_.notify_all();
+    }
+    return n;
+}
+
+std::optional<Frame> LockFreeQueue::dequeue_wait(std::chrono::nanoseconds timeout) {
+    if (auto f = dequeue()) return f;
+
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    for (;;) {
+        auto token = not_empty_.prepare_wait();
+        if (auto f = dequeue()) {
+            not_empty_.cancel_wait();
+            return f;
+        }
+        auto now = std::chrono::steady_clock::now();
+        if (shutdown_.load(std::memory_order_acquire) || now >= deadline) {
+            not_empty_.cancel_wait();
+            return std::nullopt;
+        }
+        not_empty_.wait(token, deadline - now);
+    }
+}
+
+size_t LockFreeQueue::capacity() const {
+    return capacity_;
+}
+
+size_t LockFreeQueue::size() const {
+    // Load consumer first so the difference never underflows
+    size_t deq = dequeue_pos_.load(std::memory_order_relaxed);
+    size_t enq = enqueue_pos_.load(std::memory_order_relaxed);
+    size_t n = (enq > deq) ? (enq - deq) : 0;
+    return (n > capacity_) ? capacity_ : n;
+}
+
+double LockFreeQueue::fill_ratio() const {
+    return static_cast<double>(size()) / static_cast<double>(capacity_);
+}
+
+bool LockFreeQueue::empty() const {
+    return size() == 0;
+}
+
+bool LockFreeQueue::full() const {
+    return size() >= capacity_;
+}
+
+uint64_t LockFreeQueue::total_enqueued() const {
+    return total_enqueued_.load(std::memory_order_relaxed);
+}
+
+uint64_t LockFreeQueue::total_dropped() const {
+    return total_dropped_.load(std::memory_order_relaxed);
+}
+
+uint64_t LockFreeQueue::total_blocked_ns() const {
+    return total_blocked_ns_.load(std::memory_order_relaxed);
+}
+
+void LockFreeQueue::shutdown() {
+    shutdown_.store(true, std::memory_order_release);
+    not_empty_.notify_all();
+    not_full_.notify_all();
+}
+
+} // namespace grebe
@@ -0,0 +1,92 @@
+#pragma once
+
+// LockFreeQueue — Bounded lock-free queue for move-only Frame objects
+// IQueue<Frame> implementation with preallocated slots (SPSC / MPMC)
+
+#include "grebe/queue.h"
+#include "grebe/frame.h"
+#include "core/event_notifier.h"
+
+#include <atomic>
+#include <memory>
+#include <optional>
+
+namespace grebe {
+
+/// Bounded lock-free queue backed by a preallocated slot ring.
+///
+/// Each slot carries a sequence number (Vyukov bounded queue), so producers
+/// and consumers never take a lock and no memory is allocated per frame.
+/// Capacity is rounded up to the next power of two.
+///
+/// Producer side:
+///   - single producer (SPSC): enqueue position advanced with a plain store
+///   - multi producer (MPMC):  enqueue position advanced with CAS
+/// Consumer side always claims slots with CAS so that DropOldest can evict
+/// the oldest frame from the producer thread while a consumer is active.
+///
+/// Block policy spins, then parks on a futex until space is available or
+/// shutdown(). dequeue_wait() parks the consumer the same way; producers only
+/// issue a wake syscall when a consumer is actually parked.
+class LockFreeQueue final : public IQueue<Frame> {
+public:
+    /// @param capacity        Minimum number of frames the queue can hold.
+    /// @param policy          Backpressure policy applied when queue is full.
+    /// @param multi_producer  Allow concurrent enqueue from several threads.
+    explicit LockFreeQueue(size_t capacity,
+                           BackpressurePolicy policy = BackpressurePolicy::DropLatest,
+                           bool multi_producer = false);
+
+    ~LockFreeQueue() override;
+
+    // ---- IQueue<Frame> ----
+    bool enqueue(Frame&& item) override;
+    std::optional<Frame> dequeue() override;
+    std::optional<Frame> dequeue_wait(std::chrono::nanoseconds timeout) override;
+    size_t dequeue_bulk(std::vector<Frame>& out, size_t max_items) override;
+
+    size_t   capacity()   const override;
+    size_t   size()       const override;
+    double   fill_ratio() const override;
+    bool     empty()      const override;
+    bool     full()       const override;
+
+    uint64_t total_enqueued()   const override;
+    uint64_t total_dropped()    const override;
+    uint64_t total_blocked_ns() const override;
+
+    void shutdown() override;
+
+private:
+    struct alignas(64) Slot {
+        std::atomic<size_t> seq{0};
+        std::optional<Frame> value;
+    };
+
+    /// Try to place an item; returns false (item untouched) if full.
+    bool try_push(Frame& item);
+    /// Try to take the oldest item; returns nullopt if empty.
+    std::optional<Frame> try_pop();
+
+    const size_t capacity_;
+    const size_t mask_;
+    const BackpressurePolicy policy_;
+    const bool multi_producer_;
+
+    std::unique_ptr<Slot[]> slots_;
+
+    alignas(64) std::atomic<size_t> enqueue_pos_{0};
+    alignas(64) std::atomic<size_t> dequeue_pos_{0};
+
+    alignas(64) std::atomic<bool> shutdown_{false};
+
+    EventNotifier not_empty_;  // consumers parked in dequeue_wait()
+    EventNotifier not_full_;   // producers parked in Block enqueue
+
+    // Telemetry (relaxed; read concurrently without locking)
+    std::atomic<uint64_t> total_enqueued_{0};
+    std::atomic<uint64_t> total_dropped_{0};
+    std::atomic<uint64_t> total_blocked_ns_{0};
+};
+
+} // namespace grebe
@@ -0,0 +1,339 @@
+#include "grebe/async.h"
+#include "grebe/alloc_tracker.h"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#ifdef __linux__
+#include <cerrno>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#endif
+
+namespace grebe {
+
+namespace {
+
+/// Deferred work for the reactor thread: a coroutine or a callback.
+struct Job {
+    std::coroutine_handle<> handle;
+    void (*fn)(void*) = nullptr;
+    void* arg = nullptr;
+
+    void run() const {
+        if (fn) {
+            fn(arg);
+        } else if (handle) {
+            handle.resume();
+        }
+    }
+};
+
+/// A coroutine suspended in Reactor::readable().
+struct Waiter {
+    int fd = -1;
+    std::coroutine_handle<> handle;
+    bool* ok = nullptr;
+    Reactor::Deadline deadline = Reactor::Deadline::max();
+};
+
+#ifdef __linux__
+constexpr int kMaxEvents = 64;
+#endif
+
+} // namespace
+
+struct Reactor::Impl {
+    std::thread thread;
+    std::atomic<std::thread::id> thread_id{};  // set by the thread itself
+    std::atomic<bool> stop{false};
+
+    mutable std::mutex mutex;
+    std::vector<Job> jobs;        // posted, not yet run (mutex)
+    std::vector<Waiter> waiters;  // flat: a handful of fds per reactor (mutex)
+#ifdef __linux__
+    int epoll_fd = -1;
+    int wake_fd  = -1;  // eventfd: post() from other threads
+#else
+    std::condition_variable cv;
+#endif
+
+    /// Register @p handle to be resumed when @p fd is readable or at
+    /// @p deadline. Returns false (not suspended) with *ok set if no wait
+    /// is needed.
+    bool arm(int fd, std::coroutine_handle<> handle, bool* ok, Deadline deadline);
+
+#ifdef __linux__
+    /// epoll_wait timeout (ms) until the earliest waiter deadline; -1 = none.
+    int next_timeout() const;
+#endif
+
+    void push_job(const Job& job);
+    void wake();
+    void run(const ThreadPlacement& placement);
+
+    /// Run posted jobs until none are left (including jobs they post).
+    void drain_jobs(std::vector<Job>& scratch);
+};
+
+void Reactor::Impl::push_job(const Job& job) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        jobs.push_back(job);
+    }
+    // The reactor thread drains jobs before it waits again
+    if (std::this_thread::get_id() != thread_id.load(std::memory_order_relaxed)) wake();
+}
+
+void Reactor::Impl::wake() {
+#ifdef __linux__
+    const uint64_t one = 1;
+    [[maybe_unused]] ssize_t n = ::write(wake_fd, &one, sizeof(one));
+#else
+    cv.notify_one();
+#endif
+}
+
+void Reactor::Impl::drain_jobs(std::vector<Job>& scratch) {
+    for (;;) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (jobs.empty()) return;
+            scratch.swap(jobs);
+        }
+        for (const Job& job : scratch) job.run();
+        scratch.clear();
+    }
+}
+
+#ifdef __linux__
+
+bool Reactor::Impl::arm(int fd, std::coroutine_handle<> handle, bool* ok,
+                        Deadline deadline) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (std::any_of(waiters.begin(), waiters.end(),
+                    [fd](const Waiter& w) { return w.fd == fd; })) {
+        spdlog::error("Reactor: fd {} already has a waiter", fd);
+        *ok = false;
+        return false;
+    }
+
+    // One-shot: the event disarms itself, so each readable() is one wakeup.
+    // The fd stays registered between waits; closing it removes it.
+    epoll_event ev{};
+    ev.events = EPOLLIN | EPOLLRDHUP | EPOLLONESHOT;
+    ev.data.fd = fd;
+    int rc = epoll_ctl(epoll_fd, EPOLL_CTL_MOD, fd, &ev);
+    if (rc < 0 && errno == ENOENT) {
+        rc = epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev);
+    }
+    if (rc < 0) {
+        if (errno == EPERM) {
+            // Regular files are always readable; let the read proceed
+            *ok = true;
+            return false;
+        }
+        spdlog::error("Reactor: epoll_ctl(fd {}) failed: {}", fd, std::strerror(errno));
+        *ok = false;
+        return false;
+    }
+    waiters.push_back({fd, handle, ok, deadline});
+    // A thread already in epoll_wait must pick up the new timeout
+    if (deadline != Deadline::max() &&
+        std::this_thread::get_id() != thread_id.load(std::memory_order_relaxed)) {
+        wake();
+    }
+    return true;
+}
+
+int Reactor::Impl::next_timeout() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    Deadline earliest = Deadline::max();
+    for (const Waiter& w : waiters) earliest = std::min(earliest, w.deadline);
+    if (earliest == Deadline::max()) return -1;
+    const auto left = earliest - std::chrono::steady_clock::now();
+    if (left <= std::chrono::steady_clock::duration::zero()) return 0;
+    // Round up: waking before the deadline would only spin
+    const auto ms = std::chrono::ceil<std::chrono::milliseconds>(left).count();
+    return static_cast<int>(std::min<int64_t>(ms, 60000));
+}
+
+void Reactor::Impl::run(const ThreadPlacement& placement) {
+    thread_id.store(std::this_thread::get_id(), std::memory_order_relaxed);
+    register_alloc_thread("grebe-reactor");
+    apply_thread_placement(placement, "grebe-reactor");
+
+    epoll_event events[kMaxEvents];
+    std::vector<Job> scratch;
+    std::vector<std::coroutine_handle<>> ready;
+    scratch.reserve(16);
+    ready.reserve(kMaxEvents);
+
+    while (!stop.load(std::memory_order_acquire)) {
+        drain_jobs(scratch);
+
+        const int n = epoll_wait(epoll_fd, events, kMaxEvents, next_timeout());
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            spdlog::error("Reactor: epoll_wait failed: {}", std::strerror(errno));
+            break;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (int i = 0; i < n; ++i) {
+                const int fd = events[i].data.fd;
+                if (fd == wake_fd) {
+                    uint64_t count;
+                    [[maybe_unused]] ssize_t r = ::read(wake_fd, &count, sizeof(count));
+                    continue;
+                }
+                auto it = std::find_if(waiters.begin(), waiters.end(),
+                                       [fd](const Waiter& w) { return w.fd == fd; });
+                if (it == waiters.end()) continue;  // cancelled meanwhile
+                *it->ok = true;
+                ready.push_back(it->handle);
+                *it = waiters.back();
+                waiters.pop_back();
+            }
+            // Deadlines: resume as if readable, the caller retries its read.
+            // The one-shot registration stays armed; a later wakeup for an
+            // fd without a waiter is ignored above
+            const auto now = std::chrono::steady_clock::now();
+            for (size_t i = 0; i < waiters.size();) {
+                if (waiters[i].deadline > now) {
+                    ++i;
+                    continue;
+                }
+                *waiters[i].ok = true;
+                ready.push_back(waiters[i].handle);
+                waiters[i] = waiters.back();
+                waiters.pop_back();
+            }
+        }
+        for (auto h : ready) h.resume();
+        ready.clear();
+    }
+}
+
+#else  // !__linux__
+
+bool Reactor::Impl::arm(int /*fd*/, std::coroutine_handle<> /*handle*/, bool* ok,
+                        Deadline /*deadline*/) {
+    // No readiness API wired up: report cancellation so callers end cleanly
+    *ok = false;
+    return false;
+}
+
+void Reactor::Impl::run(const ThreadPlacement& placement) {
+    thread_id.store(std::this_thread::get_id(), std::memory_order_relaxed);
+    register_alloc_thread("grebe-reactor");
+    apply_thread_placement(placement, "grebe-reactor");
+
+    std::vector<Job> scratch;
+    while (!stop.load(std::memory_order_acquire)) {
+        drain_jobs(scratch);
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [this] { return !jobs.empty() || stop.load(std::memory_order_acquire); });
+    }
+}
+
+#endif
+
+// =========================================================================
+// Reactor
+// =========================================================================
+
+Reactor::Reactor(const ThreadPlacement& placement)
+    : impl_(std::make_unique<Impl>()) {
+#ifdef __linux__
+    impl_->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    impl_->wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (impl_->epoll_fd < 0 || impl_->wake_fd < 0) {
+        spdlog::error("Reactor: epoll/eventfd setup failed: {}", std::strerror(errno));
+    } else {
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.fd = impl_->wake_fd;
+        epoll_ctl(impl_->epoll_fd, EPOLL_CTL_ADD, impl_->wake_fd, &ev);
+    }
+#endif
+    impl_->thread = std::thread([impl = impl_.get(), placement] { impl->run(placement); });
+}
+
+Reactor::~Reactor() {
+    {
+        std::lock_guard<std::mutex> lock(impl_->mutex);
+        impl_->stop.store(true, std::memory_order_release);
+    }
+    impl_->wake();
+    if (impl_->thread.joinable()) impl_->thread.join();
+
+    if (!impl_->waiters.empty()) {
+        spdlog::warn("Reactor: destroyed with {} coroutine(s) still waiting",
+                     impl_->waiters.size());
+    }
+#ifdef __linux__
+    if (impl_->wake_fd >= 0) ::close(impl_->wake_fd);
+    if (impl_->epoll_fd >= 0) ::close(impl_->epoll_fd);
+#endif
+}
+
+bool Reactor::supported() {
+#ifdef __linux__
+    return true;
+#else
+    return false;
+#endif
+}
+
+void Reactor::post(std::coroutine_handle<> handle) {
+    impl_->push_job({handle, nullptr, nullptr});
+}
+
+void Reactor::post(void (*fn)(void*), void* arg) {
+    impl_->push_job({{}, fn, arg});
+}
+
+void Reactor::cancel(int fd) {
+    Waiter waiter;
+    {
+        std::lock_guard<std::mutex> lock(impl_->mutex);
+        auto it = std::find_if(impl_->waiters.begin(), impl_->waiters.end(),
+                               [fd](const Waiter& w) { return w.fd == fd; });
+        if (it == impl_->waiters.end()) return;
+        waiter = *it;
+        *it = impl_->waiters.back();
+        impl_->waiters.pop_back();
+#ifdef __linux__
+        epoll_ctl(impl_->epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+#endif
+    }
+    *waiter.ok = false;
+    post(waiter.handle);
+}
+
+bool Reactor::in_reactor_thread() const {
+    return std::this_thread::get_id() == impl_->thread_id.load(std::memory_order_relaxed);
+}
+
+size_t Reactor::waiting() const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    return impl_->waiters.size();
+}
+
+bool Reactor::ReadableAwaiter::await_suspend(std::coroutine_handle<> handle) {
+    return reactor_.impl_->arm(fd_, handle, &ok_, deadline_);
+}
+
+} // namespace grebe
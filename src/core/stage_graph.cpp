@@ -0,0 +1,963 @@
+#include "core/stage_graph.h"
+#include "core/in_process_queue.h"
+#include "core/lock_free_queue.h"
+#include "core/event_notifier.h"
+#include "core/executor.h"
+#include "grebe/alloc_tracker.h"
+#include "grebe/frame_pool.h"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <utility>
+
+namespace grebe {
+
+namespace {
+
+std::unique_ptr<IQueue<Frame>> make_queue(const QueueOptions& opts) {
+    switch (opts.queue_kind) {
+    case QueueKind::Spsc:
+        return std::make_unique<LockFreeQueue>(opts.queue_capacity, opts.policy, false);
+    case QueueKind::Mpmc:
+        return std::make_unique<LockFreeQueue>(opts.queue_capacity, opts.policy, true);
+    case QueueKind::Mutex:
+        break;
+    }
+    return std::make_unique<InProcessQueue>(opts.queue_capacity, opts.policy);
+}
+
+/// Wait for the next input frame according to the stage's IdlePolicy.
+/// Returns nullopt if nothing arrived (caller re-checks stop and retries).
+std::optional<Frame> wait_input(IQueue<Frame>& q, const StageOptions& opts) {
+    switch (opts.idle_policy) {
+    case IdlePolicy::Yield:
+        std::this_thread::yield();
+        return q.dequeue();
+    case IdlePolicy::Park:
+        return q.dequeue_wait(opts.park_timeout);
+    case IdlePolicy::Adaptive:
+        for (uint32_t i = 0; i < opts.spin_count; ++i) {
+            cpu_relax();
+            if (auto f = q.dequeue()) return f;
+        }
+        for (uint32_t i = 0; i < opts.yield_count; ++i) {
+            std::this_thread::yield();
+            if (auto f = q.dequeue()) return f;
+        }
+        return q.dequeue_wait(opts.park_timeout);
+    }
+    return std::nullopt;
+}
+
+/// Histogram bin for a batch of n >= 1 frames: floor(log2(n)), clamped.
+size_t batch_bin(size_t n) {
+    size_t bin = 0;
+    while (n > 1 && bin + 1 < kBatchHistogramBins) {
+        n >>= 1;
+        ++bin;
+    }
+    return bin;
+}
+
+/// Max frames for a batch starting with @p first, per max_batch_frames/bytes.
+size_t batch_limit(const Frame& first, const StageOptions& opts) {
+    size_t limit = std::max<size_t>(1, opts.max_batch_frames);
+    if (opts.max_batch_bytes > 0) {
+        const size_t frame_bytes = std::max<size_t>(1, first.data_count() * sizeof(int16_t));
+        limit = std::min(limit, std::max<size_t>(1, opts.max_batch_bytes / frame_bytes));
+    }
+    return limit;
+}
+
+/// steady_clock time point in ns (Frame timestamp timebase).
+uint64_t to_ns(std::chrono::steady_clock::time_point t) {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(t.time_since_epoch()).count());
+}
+
+} // namespace
+
+StageGraph::StageGraph(const RuntimeOptions& options)
+    : impl_(std::make_unique<Impl>(options)) {}
+
+StageGraph::~StageGraph() {
+    stop();
+}
+
+StageId StageGraph::add_stage(std::unique_ptr<IStage> stage, const StageOptions& options) {
+    Impl::Node node;
+    node.stage = std::move(stage);
+    node.options = options;
+
+    for (uint32_t r = 1; r < options.replicas; ++r) {
+        auto replica = node.stage->clone();
+        if (!replica) {
+            spdlog::warn("StageGraph: stage '{}' is not replicable (clone() returned null), "
+                         "running 1 instance", node.stage->name());
+            break;
+        }
+        node.clones.push_back(std::move(replica));
+    }
+
+    impl_->nodes.push_back(std::move(node));
+    return impl_->nodes.size() - 1;
+}
+
+bool StageGraph::connect(StageId from, StageId to) {
+    if (to >= impl_->nodes.size()) {
+        spdlog::error("StageGraph::connect: invalid stage id {}", to);
+        return false;
+    }
+    return impl_->add_edge(from, to, impl_->nodes[to].options);
+}
+
+bool StageGraph::connect(StageId from, StageId to, const QueueOptions& edge) {
+    return impl_->add_edge(from, to, edge);
+}
+
+OutputId StageGraph::add_output(StageId from, const QueueOptions& edge) {
+    if (!impl_->add_edge(from, Impl::kNoStage, edge)) {
+        return Impl::kNoStage;
+    }
+    impl_->outputs.push_back(impl_->edges.size() - 1);
+    return impl_->outputs.size() - 1;
+}
+
+bool StageGraph::Impl::add_edge(StageId from, StageId to, const QueueOptions& options) {
+    if (is_running.load()) {
+        spdlog::error("StageGraph: cannot change edges while running");
+        return false;
+    }
+    if (from >= nodes.size() || (to != kNoStage && to >= nodes.size()) ||
+        nodes[from].detached || (to != kNoStage && nodes[to].detached)) {
+        spdlog::error("StageGraph: invalid edge {} -> {}", from, to);
+        return false;
+    }
+    if (to != kNoStage) {
+        if (nodes[to].input_edge) {
+            spdlog::error("StageGraph: stage '{}' already has an upstream (fan-in unsupported)",
+                          nodes[to].stage->name());
+            return false;
+        }
+        // Walk upstream from `from`; reaching `to` means the edge closes a cycle
+        for (StageId s = from;;) {
+            if (s == to) {
+                spdlog::error("StageGraph: edge {} -> {} would create a cycle", from, to);
+                return false;
+            }
+            if (!nodes[s].input_edge) break;
+            s = edges[*nodes[s].input_edge].from;
+        }
+    }
+
+    Edge edge;
+    edge.from = from;
+    edge.to = to;
+    edge.options = options;
+    if (to != kNoStage && !nodes[to].clones.empty() &&
+        edge.options.queue_kind == QueueKind::Spsc) {
+        // Every replica dequeues from the input edge: one consumer is not enough
+        edge.options.queue_kind = QueueKind::Mpmc;
+        spdlog::debug("StageGraph: input edge of replicated stage '{}' upgraded to MPMC",
+                      nodes[to].stage->name());
+    }
+    edges.push_back(std::move(edge));
+
+    const size_t index = edges.size() - 1;
+    nodes[from].output_edges.push_back(index);
+    if (to != kNoStage) {
+        nodes[to].input_edge = index;
+    }
+    return true;
+}
+
+void StageGraph::start() {
+    if (impl_->is_running.load()) return;
+    if (impl_->nodes.empty()) return;
+
+    impl_->stop.store(false);
+    impl_->start_time = std::chrono::steady_clock::now();
+
+    // Fresh queues per run (shut-down queues are not reusable); a detached
+    // branch's output queues stay shut down and empty
+    for (auto& e : impl_->edges) {
+        if (!e.detached) e.queue = make_queue(e.options);
+    }
+
+    // Create all stage and task states before launching any thread. Workers
+    // index into these vectors, so they must never reallocate while running:
+    // reserve room for the stages attach() may add
+    const size_t n = impl_->nodes.size();
+    const size_t live = impl_->runtime_options.max_live_stages;
+    impl_->nodes.reserve(n + live);
+    impl_->edges.reserve(impl_->edges.size() + live);
+    impl_->states.clear();
+    impl_->states.reserve(n + live);
+    impl_->tasks.clear();
+    impl_->free_tasks.clear();
+    size_t task_total = 0;
+    for (const auto& node : impl_->nodes) {
+        if (!node.detached) task_total += 1 + node.clones.size();
+    }
+    impl_->max_tasks = task_total + live;
+    impl_->tasks.reserve(impl_->max_tasks);
+    for (StageId i = 0; i < n; ++i) {
+        impl_->init_stage(i);
+    }
+
+    // Every frame the graph can hold at once (queued, or in a stage's input
+    // and output batch) must fit the pool's cache, or buffers released by
+    // one stage are freed instead of serving the next acquire()
+    size_t in_flight = 0;
+    for (const auto& e : impl_->edges) {
+        if (!e.detached) in_flight += e.queue->capacity();
+    }
+    for (const auto& node : impl_->nodes) {
+        in_flight += node.task_count * 2 * std::max<size_t>(1, node.options.max_batch_frames);
+    }
+    FramePool::global().reserve(in_flight);
+
+    impl_->executor = make_executor(impl_->runtime_options, *impl_);
+    impl_->executor->start();
+
+    impl_->is_running.store(true);
+    spdlog::info("StageGraph started with {} stage(s), {} edge(s), {} thread(s)",
+                 n, impl_->edges.size(), impl_->executor->thread_count());
+}
+
+void StageGraph::Impl::init_stage(StageId id) {
+    auto& node = nodes[id];
+    auto state = std::make_unique<StageState>();
+    state->pending.resize(node.output_edges.size());
+
+    // Replicas need an input edge to dispatch from
+    node.task_count = node.detached ? 0 : 1 + node.clones.size();
+    if (node.task_count > 1 && !node.input_edge) {
+        spdlog::warn("StageGraph: source stage '{}' cannot be replicated, running 1 instance",
+                     node.stage->name());
+        node.task_count = 1;
+    }
+    if (node.task_count > 1) {
+        state->reorder = std::make_unique<Reorder>(2 * node.task_count);
+    }
+
+    node.first_task = tasks.size();
+    for (size_t r = 0; r < node.task_count; ++r) {
+        auto task = std::make_unique<TaskState>();
+        task->stage = id;
+        task->instance = (r == 0) ? node.stage.get() : node.clones[r - 1].get();
+        reserve_batches(*task, node.options);
+        tasks.push_back(std::move(task));
+    }
+    states.push_back(std::move(state));
+}
+
+void StageGraph::Impl::reserve_batches(TaskState& task, const StageOptions& options) {
+    // One output frame per input frame is the common case; output and
+    // produced swap storage every step, so both need the room
+    const size_t batch = std::max<size_t>(1, options.max_batch_frames);
+    task.input_frames.reserve(batch);
+    task.produced.reserve(batch);
+    task.output.reserve(batch);
+}
+
+std::vector<StageId> StageGraph::Impl::branch(StageId id) const {
+    std::vector<StageId> ids{id};
+    for (size_t i = 0; i < ids.size(); ++i) {
+        for (size_t e : nodes[ids[i]].output_edges) {
+            if (edges[e].to != kNoStage) ids.push_back(edges[e].to);
+        }
+    }
+    return ids;
+}
+
+StageId StageGraph::attach(StageId from, std::unique_ptr<IStage> stage,
+                           const StageOptions& options) {
+    auto& impl = *impl_;
+    if (from >= impl.nodes.size() || impl.nodes[from].detached) {
+        spdlog::error("StageGraph::attach: invalid stage id {}", from);
+        return kInvalidStageId;
+    }
+    if (!impl.is_running.load()) {
+        const StageId id = add_stage(std::move(stage), options);
+        connect(from, id);  // cannot fail: new stage, no upstream, no cycle
+        return id;
+    }
+
+    // Reuse a detached stage's slots, or take one reserved in start():
+    // growing further would reallocate vectors that workers index into
+    const bool reuse_node = !impl.free_nodes.empty();
+    const bool reuse_edge = !impl.free_edges.empty();
+    const bool reuse_task = !impl.free_tasks.empty();
+    if ((!reuse_node && impl.nodes.size() == impl.nodes.capacity()) ||
+        (!reuse_edge && impl.edges.size() == impl.edges.capacity()) ||
+        (!reuse_task && impl.tasks.size() == impl.max_tasks)) {
+        spdlog::error("StageGraph::attach: no live stage slot left for '{}' "
+                      "(RuntimeOptions::max_live_stages = {})",
+                      stage->name(), impl.runtime_options.max_live_stages);
+        return kInvalidStageId;
+    }
+    if (options.replicas > 1) {
+        spdlog::warn("StageGraph: '{}' attached while running, running 1 instance",
+                     stage->name());
+    }
+
+    // Build the node, its input edge and its task before anyone can see them
+    StageId id = impl.nodes.size();
+    if (reuse_node) {
+        id = impl.free_nodes.back();
+        impl.free_nodes.pop_back();
+    } else {
+        impl.nodes.emplace_back();
+        impl.states.emplace_back();
+    }
+    size_t e = impl.edges.size();
+    if (reuse_edge) {
+        e = impl.free_edges.back();
+        impl.free_edges.pop_back();
+    } else {
+        impl.edges.emplace_back();
+    }
+    TaskId t = impl.tasks.size();
+    if (reuse_task) {
+        t = impl.free_tasks.back();
+        impl.free_tasks.pop_back();
+    } else {
+        impl.tasks.emplace_back();
+    }
+
+    auto& edge = impl.edges[e];
+    edge = Impl::Edge{};
+    edge.from = from;
+    edge.to = id;
+    edge.options = options;
+    edge.queue = make_queue(options);
+
+    auto& node = impl.nodes[id];
+    node = Impl::Node{};
+    node.stage = std::move(stage);
+    node.options = options;
+    node.input_edge = e;
+    node.first_task = t;
+    node.task_count = 1;
+
+    auto task = std::make_unique<Impl::TaskState>();
+    task->stage = id;
+    task->instance = node.stage.get();
+    Impl::reserve_batches(*task, options);
+    impl.tasks[t] = std::move(task);
+    impl.states[id] = std::make_unique<Impl::StageState>();
+    impl.executor->add_task(t);
+
+    // Publish: the upstream's next emit() delivers into the new edge
+    {
+        auto& up = *impl.states[from];
+        std::lock_guard<std::mutex> lock(up.outputs_mutex);
+        impl.nodes[from].output_edges.push_back(e);
+        up.pending.emplace_back();
+    }
+
+    spdlog::info("StageGraph: attached '{}' (stage {}) to stage {}",
+                 node.stage->name(), id, from);
+    return id;
+}
+
+bool StageGraph::detach(StageId id) {
+    auto& impl = *impl_;
+    if (id >= impl.nodes.size() || impl.nodes[id].detached) {
+        spdlog::error("StageGraph::detach: invalid stage id {}", id);
+        return false;
+    }
+
+    const std::vector<StageId> ids = impl.branch(id);
+    const bool running = impl.is_running.load();
+
+    // Edges into and inside the branch, plus its application outputs
+    std::vector<size_t> branch_edges;
+    for (StageId s : ids) {
+        const auto& node = impl.nodes[s];
+        if (s == id && node.input_edge) branch_edges.push_back(*node.input_edge);
+        for (size_t e : node.output_edges) branch_edges.push_back(e);
+    }
+
+    if (running) {
+        // 1. Stop the branch's tasks from starting new work, and let
+        //    stages waiting inside process() return
+        for (StageId s : ids) {
+            const auto& node = impl.nodes[s];
+            for (size_t t = 0; t < node.task_count; ++t) {
+                impl.tasks[node.first_task + t]->detached.store(true);
+            }
+            node.stage->request_stop();
+            for (auto& clone : node.clones) clone->request_stop();
+        }
+
+        // 2. Unblock workers waiting on the branch's queues, including an
+        //    upstream blocked on a full input edge of the branch
+        for (size_t e : branch_edges) impl.edges[e].queue->shutdown();
+    }
+
+    // 3. Unlink the branch from its upstream
+    if (const auto in = impl.nodes[id].input_edge) {
+        const StageId from = impl.edges[*in].from;
+        auto& outs = impl.nodes[from].output_edges;
+        std::unique_lock<std::mutex> lock;
+        if (running) lock = std::unique_lock<std::mutex>(impl.states[from]->outputs_mutex);
+        const auto it = std::find(outs.begin(), outs.end(), *in);
+        if (running) {
+            auto& pending = impl.states[from]->pending;
+            pending.erase(pending.begin() + (it - outs.begin()));
+        }
+        outs.erase(it);
+    }
+
+    if (running) {
+        // 4. Wait for the branch's workers to leave step()
+        for (StageId s : ids) {
+            const auto& node = impl.nodes[s];
+            for (size_t t = 0; t < node.task_count; ++t) {
+                const TaskId task = node.first_task + t;
+                impl.executor->remove_task(task);
+                while (impl.tasks[task]->in_step.load()) std::this_thread::yield();
+            }
+        }
+
+        // 5. Discard what is still queued (returns pooled buffers now)
+        for (size_t e : branch_edges) {
+            while (impl.edges[e].queue->dequeue()) {}
+        }
+    }
+
+    for (size_t e : branch_edges) {
+        impl.edges[e].detached = true;
+        if (impl.edges[e].to != Impl::kNoStage) impl.free_edges.push_back(e);
+    }
+    for (StageId s : ids) {
+        auto& node = impl.nodes[s];
+        node.name = node.stage->name();
+        node.detached = true;
+        node.stage.reset();
+        node.clones.clear();
+        impl.free_nodes.push_back(s);
+        if (running) {
+            for (size_t t = 0; t < node.task_count; ++t) {
+                impl.free_tasks.push_back(node.first_task + t);
+            }
+        } else {
+            node.task_count = 0;
+        }
+    }
+
+    spdlog::info("StageGraph: detached stage {} ('{}') and {} stage(s) downstream",
+                 id, impl.nodes[id].name, ids.size() - 1);
+    return true;
+}
+
+void StageGraph::stop() {
+    if (!impl_->is_running.load()) return;
+
+    impl_->stop.store(true);
+
+    // Let stages waiting inside process() return (and end background I/O)
+    for (auto& node : impl_->nodes) {
+        if (node.detached) continue;
+        node.stage->request_stop();
+        for (auto& clone : node.clones) clone->request_stop();
+    }
+
+    // Shutdown all queues to unblock workers
+    for (auto& e : impl_->edges) {
+        if (e.queue) e.queue->shutdown();
+    }
+
+    // Join all worker threads
+    impl_->executor->stop();
+    impl_->executor.reset();
+
+    impl_->stop_time = std::chrono::steady_clock::now();
+    impl_->is_running.store(false);
+    spdlog::info("StageGraph stopped");
+}
+
+bool StageGraph::running() const {
+    return impl_->is_running.load();
+}
+
+size_t StageGraph::thread_count() const {
+    return impl_->executor ? impl_->executor->thread_count() : 0;
+}
+
+std::optional<Frame> StageGraph::poll_output(OutputId output) {
+    if (output >= impl_->outputs.size()) return std::nullopt;
+    auto& edge = impl_->edges[impl_->outputs[output]];
+    if (!edge.queue) return std::nullopt;
+
+    auto f = edge.queue->dequeue();
+    if (f) impl_->output_drained(edge);
+    return f;
+}
+
+std::optional<Frame> StageGraph::poll_latest(OutputId output) {
+    if (output >= impl_->outputs.size()) return std::nullopt;
+    auto& edge = impl_->edges[impl_->outputs[output]];
+    if (!edge.queue) return std::nullopt;
+
+    std::optional<Frame> latest;
+
+    // Drain all available frames, keep only the last one
+    while (auto f = edge.queue->dequeue()) {
+        latest = std::move(f);
+    }
+    if (latest) impl_->output_drained(edge);
+    return latest;
+}
+
+IStage* StageGraph::stage(StageId id) {
+    if (id >= impl_->nodes.size()) return nullptr;  // detached: stage is null
+    return impl_->nodes[id].stage.get();
+}
+
+size_t StageGraph::stage_count() const {
+    return impl_->nodes.size();
+}
+
+std::vector<StageTelemetry> StageGraph::telemetry() const {
+    std::vector<StageTelemetry> result;
+    result.reserve(impl_->nodes.size());
+
+    // Denominator of the StageTelemetry::*_per_sec rates
+    const auto until = impl_->is_running.load() ? std::chrono::steady_clock::now()
+                                                : impl_->stop_time;
+    const double elapsed_s = std::chrono::duration<double>(until - impl_->start_time).count();
+    auto per_sec = [elapsed_s](uint64_t n) {
+        return elapsed_s > 0.0 ? static_cast<double>(n) / elapsed_s : 0.0;
+    };
+
+    for (size_t i = 0; i < impl_->nodes.size(); ++i) {
+        const auto& node = impl_->nodes[i];
+        StageTelemetry st;
+        st.name = node.detached ? node.name : node.stage->name();
+        st.detached = node.detached;
+
+        if (i >= impl_->states.size()) {
+            result.push_back(std::move(st));
+            continue;
+        }
+
+        const auto& w = *impl_->states[i];
+        uint64_t fp = w.frames_processed.load(std::memory_order_relaxed);
+        uint64_t tp = w.total_process_ns.load(std::memory_order_relaxed);
+
+        st.frames_processed = fp;
+        st.avg_process_time_ms = (fp > 0)
+            ? (static_cast<double>(tp) / 1e6 / static_cast<double>(fp))
+            : 0.0;
+
+        uint64_t nb = w.batches.load(std::memory_order_relaxed);
+        uint64_t nf = w.batched_frames.load(std::memory_order_relaxed);
+        for (size_t b = 0; b < kBatchHistogramBins; ++b) {
+            st.batch_size_hist[b] = w.batch_hist[b].load(std::memory_order_relaxed);
+        }
+        st.avg_batch_size = (nb > 0)
+            ? static_cast<double>(nf) / static_cast<double>(nb)
+            : 0.0;
+        st.buffer_allocations = w.buffer_allocations.load(std::memory_order_relaxed);
+        st.heap_allocations = w.heap_allocations.load(std::memory_order_relaxed);
+        st.heap_bytes = w.heap_bytes.load(std::memory_order_relaxed);
+        st.minor_faults = w.minor_faults.load(std::memory_order_relaxed);
+        st.heap_allocs_per_sec = per_sec(st.heap_allocations);
+        st.heap_bytes_per_sec = per_sec(st.heap_bytes);
+        st.minor_faults_per_sec = per_sec(st.minor_faults);
+        st.replicas = static_cast<uint32_t>(std::max<size_t>(1, node.task_count));
+        st.process_time_ms = w.process_time.percentiles(1e-6);
+        st.queue_time_ms = w.queue_time.percentiles(1e-6);
+        st.batch_frames = w.batch_size.percentiles();
+        st.e2e_latency_ms = w.e2e_latency.percentiles(1e-6);
+        st.credit_stalls = w.credit_stalls.load(std::memory_order_relaxed);
+        st.credit_stall_ms =
+            static_cast<double>(w.credit_stall_ns.load(std::memory_order_relaxed)) / 1e6;
+        {
+            std::lock_guard<std::mutex> lock(w.placement_mutex);
+            st.placement = w.placement;
+        }
+
+        // Input edge drops (SourceStages have no input edge)
+        if (node.input_edge && impl_->edges[*node.input_edge].queue) {
+            st.queue_dropped = impl_->edges[*node.input_edge].queue->total_dropped();
+        }
+
+        result.push_back(std::move(st));
+    }
+    return result;
+}
+
+void StageGraph::Impl::emit(const Node& node, StageState& state,
+                            std::vector<Frame>& frames, bool blocking) {
+    const auto& outs = node.output_edges;
+    // One clock read per emitted batch: queue residency starts now, and
+    // the producer → this stage latency is recorded/traced
+    const uint64_t now_ns = steady_now_ns();
+    const auto id = static_cast<StageId>(&node - nodes.data());
+    for (auto& f : frames) {
+        // Virtual-clock timestamps are simulated time: no latency to measure
+        if (f.producer_ts_ns != 0 && now_ns >= f.producer_ts_ns &&
+            !(f.flags & kFrameVirtualClock)) {
+            state.e2e_latency.record(now_ns - f.producer_ts_ns);
+            if (id < kTraceStageLimit) {
+                f.trace.mark(static_cast<uint8_t>(id), f.producer_ts_ns, now_ns);
+            }
+        }
+        f.enqueue_ts_ns = now_ns;
+    }
+
+    // attach() / detach() may change the output edges between batches:
+    // deliver to the edges present now
+    std::unique_lock<std::mutex> lock(state.outputs_mutex);
+    if (outs.empty()) return;  // SinkStage output is discarded
+    auto& snapshot = state.emit_outputs;
+    for (size_t e : outs) {
+        const auto& edge = edges[e];
+        OutputRef ref{edge.queue, edge.options.policy};
+        if (edge.to != kNoStage) {
+            ref.first_task = nodes[edge.to].first_task;
+            ref.task_count = nodes[edge.to].task_count;
+        }
+        snapshot.push_back(std::move(ref));
+    }
+
+    // Blocking mode may wait on a full Block / Credit edge: release the lock
+    // so attach() / detach() of another branch are not held up meanwhile.
+    // A frame that reaches an edge detached in between lands in its
+    // shut-down queue and is released with it.
+    if (blocking) lock.unlock();
+
+    // Non-blocking mode: a Block / Credit edge only accepts frames while it
+    // has room (each edge has a single producer, so !full() guarantees no wait)
+    auto deliver = [&](size_t k, Frame&& f) {
+        auto& out = snapshot[k];
+        if (!blocking && blocks_when_full(out.policy) &&
+            (!state.pending[k].empty() || out.queue->full())) {
+            state.pending[k].push_back(std::move(f));
+            return;
+        }
+        out.queue->enqueue(std::move(f));
+    };
+
+    if (snapshot.size() == 1) {
+        for (auto& f : frames) {
+            deliver(0, std::move(f));
+        }
+    } else {
+        // Fan-out: every edge gets a frame referencing the same refcounted
+        // payload (the last edge the frame itself). Each edge applies its own
+        // backpressure policy independently.
+        for (auto& f : frames) {
+            for (size_t k = 0; k + 1 < snapshot.size(); ++k) {
+                deliver(k, f.share());
+            }
+            deliver(snapshot.size() - 1, std::move(f));
+        }
+    }
+
+    for (const auto& out : snapshot) {
+        for (size_t t = 0; t < out.task_count; ++t) {
+            executor->notify_input(out.first_task + t);
+        }
+    }
+    snapshot.clear();  // keeps capacity; drops the queue references
+}
+
+void StageGraph::Impl::complete_ticket(const Node& node, StageState& state, uint64_t ticket,
+                                       std::vector<Frame>& frames, bool blocking) {
+    auto& reorder = *state.reorder;
+    bool advanced = false;
+    {
+        std::lock_guard<std::mutex> lock(state.emit_mutex);
+        auto& slots = reorder.slots;
+        auto& mine = slots[ticket % slots.size()];
+        mine.frames.swap(frames);  // keeps both vectors' capacity in circulation
+        mine.ready = true;
+
+        for (;;) {
+            const uint64_t next = reorder.next_emit.load(std::memory_order_relaxed);
+            auto& slot = slots[next % slots.size()];
+            if (!slot.ready) break;
+            if (!slot.frames.empty()) {
+                state.frames_processed.fetch_add(static_cast<uint64_t>(slot.frames.size()),
+                                                 std::memory_order_relaxed);
+                emit(node, state, slot.frames, blocking);
+                slot.frames.clear();
+            }
+            slot.ready = false;
+            reorder.next_emit.store(next + 1, std::memory_order_release);
+            advanced = true;
+        }
+    }
+
+    // Sibling replicas may be Blocked on a full reorder window
+    if (advanced && !blocking) {
+        for (size_t t = 0; t < node.task_count; ++t) {
+            executor->notify_space(node.first_task + t);
+        }
+    }
+}
+
+bool StageGraph::Impl::flush_pending(const Node& node, StageState& state) {
+    std::lock_guard<std::mutex> lock(state.outputs_mutex);
+    bool done = true;
+    for (size_t k = 0; k < state.pending.size(); ++k) {
+        auto& pending = state.pending[k];
+        if (pending.empty()) continue;
+
+        auto& edge = edges[node.output_edges[k]];
+        while (!pending.empty() && !edge.queue->full()) {
+            edge.queue->enqueue(std::move(pending.front()));
+            pending.pop_front();
+        }
+        if (edge.to != kNoStage) {
+            const auto& dst = nodes[edge.to];
+            for (size_t t = 0; t < dst.task_count; ++t) {
+                executor->notify_input(dst.first_task + t);
+            }
+        }
+        done = done && pending.empty();
+    }
+    return done;
+}
+
+void StageGraph::Impl::output_drained(const Edge& edge) {
+    if (!blocks_when_full(edge.options.policy) || !executor) return;
+    const auto& src = nodes[edge.from];
+    for (size_t t = 0; t < src.task_count; ++t) {
+        executor->notify_space(src.first_task + t);
+    }
+}
+
+StageGraph::Impl::Credit StageGraph::Impl::output_credit(const Node& node,
+                                                         StageState& state) const {
+    std::lock_guard<std::mutex> lock(state.outputs_mutex);
+    Credit credit;
+    for (size_t e : node.output_edges) {
+        const auto& edge = edges[e];
+        if (edge.options.policy != BackpressurePolicy::Credit) continue;
+        const size_t cap = edge.queue->capacity();
+        const size_t used = std::min(edge.queue->size(), cap);
+        if (credit.window == 0 || cap - used < credit.available) {
+            credit.available = cap - used;
+            credit.window = cap;
+        }
+    }
+    return credit;
+}
+
+bool StageGraph::Impl::has_input(TaskId id) const {
+    const auto& node = nodes[tasks[id]->stage];
+    return node.input_edge && !edges[*node.input_edge].queue->empty();
+}
+
+std::string StageGraph::Impl::task_name(TaskId id) const {
+    const auto& task = *tasks[id];
+    const auto& node = nodes[task.stage];
+    std::string name = node.stage->name();
+    if (node.task_count > 1) name += "#" + std::to_string(id - node.first_task);
+    return name;
+}
+
+void StageGraph::Impl::report_placement(TaskId id, const std::string& placement) {
+    auto& state = *states[tasks[id]->stage];
+    std::lock_guard<std::mutex> lock(state.placement_mutex);
+    state.placement = placement;
+}
+
+// --- Task step (one process() invocation) ---
+
+StepResult StageGraph::Impl::step(TaskId task_index, bool blocking) {
+    // Handshake with detach(): it sets detached, then waits for in_step to
+    // clear, so once it returns no worker touches the released stage
+    auto& task = *tasks[task_index];
+    task.in_step.store(true);
+    if (task.detached.load()) {
+        task.in_step.store(false);
+        return StepResult::Finished;
+    }
+    if (!runtime_options.alloc_accounting) {
+        const StepResult result = run_step(task_index, blocking);
+        task.in_step.store(false);
+        return result;
+    }
+
+    // Everything this thread allocates or faults in until run_step() returns
+    // (process(), emit, fan-out sharing) is charged to the stage
+    const AllocCounters before = thread_alloc_counters();
+    const StepResult result = run_step(task_index, blocking);
+    const AllocCounters delta = thread_alloc_counters() - before;
+    auto& state = *states[task.stage];
+    if (delta.allocations) {
+        state.heap_allocations.fetch_add(delta.allocations, std::memory_order_relaxed);
+        state.heap_bytes.fetch_add(delta.bytes, std::memory_order_relaxed);
+    }
+    if (delta.minor_faults) {
+        state.minor_faults.fetch_add(delta.minor_faults, std::memory_order_relaxed);
+    }
+    task.in_step.store(false);
+    return result;
+}
+
+StepResult StageGraph::Impl::run_step(TaskId task_index, bool blocking) {
+    auto& task = *tasks[task_index];
+    auto& entry = nodes[task.stage];
+    auto& state = *states[task.stage];
+    auto* reorder = state.reorder.get();
+
+    // Output still waiting on a full Block edge: don't consume more input
+    if (!blocking) {
+        bool flushed;
+        if (reorder) {
+            std::lock_guard<std::mutex> lock(state.emit_mutex);
+            flushed = flush_pending(entry, state);
+        } else {
+            flushed = flush_pending(entry, state);
+        }
+        if (!flushed) return StepResult::Blocked;
+    }
+
+    // Credit edges: hold the stage back (instead of dropping downstream)
+    // until the consumer frees a slot; an episode counts as one stall
+    const Credit credit = output_credit(entry, state);
+    if (credit.window > 0) {
+        if (credit.available == 0) {
+            if (task.credit_stall_since_ns == 0) {
+                task.credit_stall_since_ns = steady_now_ns();
+                state.credit_stalls.fetch_add(1, std::memory_order_relaxed);
+            }
+            return StepResult::Blocked;
+        }
+        if (task.credit_stall_since_ns != 0) {
+            state.credit_stall_ns.fetch_add(steady_now_ns() - task.credit_stall_since_ns,
+                                            std::memory_order_relaxed);
+            task.credit_stall_since_ns = 0;
+        }
+    }
+
+    // Input queue: none for SourceStages (no upstream edge)
+    IQueue<Frame>* input_queue = entry.input_edge
+        ? edges[*entry.input_edge].queue.get()
+        : nullptr;
+
+    auto& input_frames = task.input_frames;
+    uint64_t ticket = 0;
+
+    // Build input batch: take the first frame (waiting for it in blocking
+    // mode), then drain whatever else is already queued up to the batch limit.
+    // Replicas dispatch one at a time so that tickets follow queue order.
+    if (input_queue) {
+        std::unique_lock<std::mutex> dispatch;
+        if (reorder) {
+            dispatch = std::unique_lock<std::mutex>(state.dispatch_mutex);
+            const uint64_t in_flight =
+                reorder->next_ticket - reorder->next_emit.load(std::memory_order_acquire);
+            if (in_flight >= reorder->slots.size()) return StepResult::Blocked;
+        }
+
+        auto frame = input_queue->dequeue();
+        if (!frame) {
+            if (!blocking || stop.load(std::memory_order_relaxed)) return StepResult::Idle;
+            frame = wait_input(*input_queue, entry.options);
+            if (!frame) return StepResult::Idle;
+        }
+        size_t limit = batch_limit(*frame, entry.options);
+        if (credit.window > 0) {
+            // One output frame per input frame is the common case: don't
+            // take more input than there is credit to emit it
+            limit = std::min(limit, credit.available);
+        }
+        input_frames.push_back(std::move(*frame));
+        if (limit > 1) {
+            input_queue->dequeue_bulk(input_frames, limit - 1);
+        }
+        if (reorder) ticket = reorder->next_ticket++;
+        if (dispatch) dispatch.unlock();
+
+        if (!blocking) output_drained(edges[*entry.input_edge]);
+
+        const size_t n = input_frames.size();
+        state.batches.fetch_add(1, std::memory_order_relaxed);
+        state.batched_frames.fetch_add(n, std::memory_order_relaxed);
+        state.batch_hist[batch_bin(n)].fetch_add(1, std::memory_order_relaxed);
+        state.batch_size.record(n);
+    }
+
+    auto t0 = std::chrono::steady_clock::now();
+    if (!input_frames.empty()) {
+        const uint64_t t0_ns = to_ns(t0);
+        for (const auto& f : input_frames) {
+            if (f.enqueue_ts_ns != 0 && t0_ns >= f.enqueue_ts_ns) {
+                state.queue_time.record(t0_ns - f.enqueue_ts_ns);
+            }
+        }
+    }
+
+    BatchView input(std::move(input_frames));
+
+    double wall_s = std::chrono::duration<double>(t0 - start_time).count();
+    ExecContext ctx{task.iteration++, static_cast<uint32_t>(task.stage), wall_s};
+    ctx.credits = static_cast<uint32_t>(std::min<size_t>(credit.available, UINT32_MAX));
+    ctx.credit_window = static_cast<uint32_t>(std::min<size_t>(credit.window, UINT32_MAX));
+    if (blocking && !input_queue && !stop.load(std::memory_order_relaxed)) {
+        // Dedicated worker: a source may wait for data inside process()
+        ctx.wait_budget_ns = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(entry.options.park_timeout).count());
+    }
+
+    const uint64_t allocs_before = FramePool::thread_allocations();
+    auto result = task.instance->process(input, task.output, ctx);
+    auto t1 = std::chrono::steady_clock::now();
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+
+    state.total_process_ns.fetch_add(static_cast<uint64_t>(ns), std::memory_order_relaxed);
+    if (result != StageResult::NoData) {
+        // Idle source polls would swamp the distribution
+        state.process_time.record(static_cast<uint64_t>(ns));
+    }
+    if (const uint64_t allocs = FramePool::thread_allocations() - allocs_before) {
+        state.buffer_allocations.fetch_add(allocs, std::memory_order_relaxed);
+    }
+
+    // Reclaim input storage (destroys consumed frames, keeps capacity)
+    input_frames = input.release();
+    input_frames.clear();
+
+    // Enqueue output frames (fan-out to every downstream edge); replicas
+    // go through the reorder window, which emits in dispatch order
+    task.output.take_into(task.produced);
+    if (reorder) {
+        complete_ticket(entry, state, ticket, task.produced, blocking);
+    } else if (!task.produced.empty()) {
+        state.frames_processed.fetch_add(static_cast<uint64_t>(task.produced.size()),
+                                         std::memory_order_relaxed);
+        emit(entry, state, task.produced, blocking);
+    }
+    task.produced.clear();
+
+    switch (result) {
+    case StageResult::Ok:
+    case StageResult::Retry:
+        return StepResult::Progress;
+    case StageResult::NoData:
+        // A source that already slept for data needs no backoff on top
+        return ctx.waited ? StepResult::Progress : StepResult::Idle;
+    case StageResult::EOS:
+        return StepResult::Finished;
+    case StageResult::Error:
+        spdlog::error("Stage '{}' returned Error", task.instance->name());
+        return StepResult::Finished;
+    }
+    return StepResult::Idle;
+}
+
+} // namespace grebe
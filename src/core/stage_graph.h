@@ -0,0 +1,219 @@
+#pragma once
+
+// StageGraph — Internal implementation header
+// Phase 15: shared worker engine for StageGraph and LinearRuntime
+
+#include "grebe/runtime.h"
+#include "grebe/batch.h"
+#include "grebe/frame.h"
+#include "grebe/histogram.h"
+#include "core/executor.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace grebe {
+
+/// Internal state for StageGraph (pimpl target).
+/// Implements IStageRunner: the executor decides which thread runs step().
+struct StageGraph::Impl final : IStageRunner {
+    static constexpr StageId kNoStage = std::numeric_limits<StageId>::max();
+
+    /// One bounded queue between a producer stage and a consumer
+    /// (a downstream stage, or the application for outputs).
+    struct Edge {
+        StageId from = kNoStage;
+        StageId to   = kNoStage;  // kNoStage = application-polled output
+        QueueOptions options;
+        /// Created in start() / attach(). Shared so that an emit() still
+        /// holding a snapshot of a detached edge keeps its queue alive.
+        std::shared_ptr<IQueue<Frame>> queue;
+        bool detached = false;                 // part of a detach()ed branch
+    };
+
+    struct Node {
+        std::unique_ptr<IStage> stage;
+        std::vector<std::unique_ptr<IStage>> clones;  // replicas 2..N (IStage::clone())
+        StageOptions options;
+        std::optional<size_t> input_edge;   // index into edges
+        std::vector<size_t> output_edges;   // indices into edges (fan-out)
+        TaskId first_task = 0;              // tasks [first_task, first_task + task_count)
+        size_t task_count = 1;              // assigned in start()
+        bool detached = false;              // detach(): stage released
+        std::string name;                   // detach(): name of the released stage
+    };
+
+    /// Reassembles replica outputs in dispatch order (replicas > 1 only).
+    /// Each dequeued input batch takes the next ticket; a completed batch's
+    /// output is parked in its ring slot until every earlier ticket has been
+    /// emitted. The window bounds how far fast replicas may run ahead.
+    struct Reorder {
+        struct Slot {
+            bool ready = false;
+            std::vector<Frame> frames;
+        };
+        explicit Reorder(size_t window) : slots(window) {}
+
+        std::vector<Slot> slots;             // ring by ticket % size (emit_mutex)
+        uint64_t next_ticket = 0;            // dispatch_mutex
+        std::atomic<uint64_t> next_emit{0};  // written under emit_mutex
+    };
+
+    /// An output edge as seen by one emit(): copied under outputs_mutex so
+    /// that frames can be delivered without holding it.
+    struct OutputRef {
+        std::shared_ptr<IQueue<Frame>> queue;
+        BackpressurePolicy policy = BackpressurePolicy::DropOldest;
+        TaskId first_task = 0;  // consumer tasks to notify (task_count 0: output)
+        size_t task_count = 0;
+    };
+
+    /// Per-stage telemetry and output state, shared by all of its tasks.
+    struct StageState {
+        std::atomic<uint64_t> frames_processed{0};
+        std::atomic<uint64_t> total_process_ns{0};
+        std::atomic<uint64_t> buffer_allocations{0};
+        // RuntimeOptions::alloc_accounting (StageTelemetry::heap_*)
+        std::atomic<uint64_t> heap_allocations{0};
+        std::atomic<uint64_t> heap_bytes{0};
+        std::atomic<uint64_t> minor_faults{0};
+        std::atomic<uint64_t> batches{0};
+        std::atomic<uint64_t> batched_frames{0};
+        std::array<std::atomic<uint64_t>, kBatchHistogramBins> batch_hist{};
+
+        // Tail distributions (StageTelemetry::*_ms / batch_frames)
+        HdrHistogram process_time;  // ns per process() call that did work
+        HdrHistogram queue_time;    // ns per frame, enqueue → dequeue
+        HdrHistogram batch_size;    // frames per input batch
+        HdrHistogram e2e_latency;   // ns, producer_ts_ns → emitted by this stage
+
+        // Credit-based flow control (StageTelemetry::credit_stall*)
+        std::atomic<uint64_t> credit_stalls{0};
+        std::atomic<uint64_t> credit_stall_ns{0};
+
+        /// Non-blocking mode: frames not yet accepted by a full Block edge,
+        /// per output edge (same order as Node::output_edges).
+        std::vector<std::deque<Frame>> pending;
+
+        /// Guards Node::output_edges and pending while running: attach() /
+        /// detach() change them under it, the stage's own tasks read them.
+        /// Taken inside emit_mutex. Never held across a blocking enqueue.
+        std::mutex outputs_mutex;
+        /// emit() scratch: snapshot of the output edges (emitting task only,
+        /// or under emit_mutex for replicated stages).
+        std::vector<OutputRef> emit_outputs;
+
+        // Replicated stages only: serialize input dispatch and emission
+        std::unique_ptr<Reorder> reorder;
+        std::mutex dispatch_mutex;
+        std::mutex emit_mutex;
+
+        mutable std::mutex placement_mutex;
+        std::string placement;  // effective placement (report_placement)
+    };
+
+    /// One schedulable instance of a stage and its step() scratch state.
+    /// Only the thread currently running the task touches it.
+    struct TaskState {
+        StageId stage = 0;
+        IStage* instance = nullptr;
+        uint64_t iteration = 0;
+        std::vector<Frame> input_frames;  // batch storage reused across steps
+        std::vector<Frame> produced;
+        BatchWriter output;
+        uint64_t credit_stall_since_ns = 0;  // 0 = not stalled
+
+        // detach(): set detached, then wait until in_step is clear
+        std::atomic<bool> detached{false};
+        std::atomic<bool> in_step{false};
+    };
+
+    /// Output credit of a stage: free slots on its most constrained Credit
+    /// edge and that edge's capacity (window 0 = no Credit edge).
+    struct Credit {
+        size_t available = 0;
+        size_t window    = 0;
+    };
+
+    explicit Impl(const RuntimeOptions& opts) : runtime_options(opts) {}
+
+    RuntimeOptions runtime_options;
+
+    std::vector<Node> nodes;
+    std::vector<Edge> edges;
+    std::vector<size_t> outputs;  // OutputId → edge index
+    std::vector<std::unique_ptr<StageState>> states;  // by StageId
+    std::vector<std::unique_ptr<TaskState>> tasks;    // by TaskId
+    std::unique_ptr<IExecutor> executor;  // created in start()
+    size_t max_tasks = 0;  // tasks.size() + max_live_stages, fixed in start()
+
+    // Slots of detached stages, reused by attach() while running
+    std::vector<StageId> free_nodes;
+    std::vector<size_t> free_edges;   // stage edges only (OutputIds stay valid)
+    std::vector<TaskId> free_tasks;   // this run only
+
+    std::atomic<bool> stop{false};
+    std::atomic<bool> is_running{false};
+
+    std::chrono::steady_clock::time_point start_time;
+    std::chrono::steady_clock::time_point stop_time;  // telemetry rates after stop()
+
+    bool add_edge(StageId from, StageId to, const QueueOptions& options);
+
+    /// Create the StageState and TaskStates of stage @p id (start(), attach()).
+    void init_stage(StageId id);
+
+    /// Pre-size a task's input, output and produced batch vectors.
+    static void reserve_batches(TaskState& task, const StageOptions& options);
+
+    /// Stage @p id and everything downstream of it, in breadth-first order.
+    std::vector<StageId> branch(StageId id) const;
+
+    /// step() body; step() brackets it with the detach handshake and, with
+    /// RuntimeOptions::alloc_accounting, the thread's allocation counters.
+    StepResult run_step(TaskId id, bool blocking);
+
+    /// Deliver a stage's produced frames to all of its output edges.
+    /// Single edge: frames are moved. Fan-out: each edge gets a Borrowed
+    /// frame sharing the original's payload (Frame::share()).
+    /// Stamps enqueue_ts_ns, records e2e latency and appends a trace hop.
+    /// Non-blocking mode parks frames for full Block edges in @p state.pending.
+    /// Blocking mode enqueues into a snapshot of the edges taken under
+    /// outputs_mutex, so attach() / detach() never wait behind a full edge.
+    void emit(const Node& node, StageState& state, std::vector<Frame>& frames, bool blocking);
+
+    /// Park a replica's output under @p ticket and emit every batch that is
+    /// now next in dispatch order.
+    void complete_ticket(const Node& node, StageState& state, uint64_t ticket,
+                         std::vector<Frame>& frames, bool blocking);
+
+    /// Retry pending frames; returns true once nothing is pending.
+    bool flush_pending(const Node& node, StageState& state);
+
+    /// Frames were taken from @p edge: wake its producer if it is Blocked.
+    void output_drained(const Edge& edge);
+
+    Credit output_credit(const Node& node, StageState& state) const;
+
+    // ---- IStageRunner ----
+    size_t task_count() const override { return tasks.size(); }
+    size_t task_capacity() const override { return max_tasks; }
+    const StageOptions& task_options(TaskId id) const override {
+        return nodes[tasks[id]->stage].options;
+    }
+    std::string task_name(TaskId id) const override;
+    bool is_source(TaskId id) const override { return !nodes[tasks[id]->stage].input_edge; }
+    bool has_input(TaskId id) const override;
+    StepResult step(TaskId id, bool blocking) override;
+    bool stopping() const override { return stop.load(std::memory_order_relaxed); }
+    void report_placement(TaskId id, const std::string& placement) override;
+};
+
+} // namespace grebe
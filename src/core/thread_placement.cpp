@@ -0,0 +1,257 @@
+#include "grebe/thread_placement.h"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <string>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#ifdef __linux__
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace grebe {
+
+namespace {
+
+// CPU indices an affinity mask can express (cpu_set_t / DWORD_PTR bits)
+#ifdef __linux__
+constexpr int kMaxCpus = CPU_SETSIZE;
+#elif defined(_WIN32)
+constexpr int kMaxCpus = static_cast<int>(sizeof(DWORD_PTR) * 8);
+#else
+constexpr int kMaxCpus = 1024;
+#endif
+
+// NUMA nodes a set_mempolicy(2) node mask can express here
+constexpr unsigned long kMaxNumaNodes = 1024;
+
+#ifdef __linux__
+// set_mempolicy(2) modes (numaif.h is part of libnuma, which we don't require)
+constexpr int kMpolDefault   = 0;
+constexpr int kMpolPreferred = 1;
+constexpr size_t kBitsPerLong = sizeof(unsigned long) * 8;
+
+bool set_preferred_node(int node) {
+    unsigned long mask[kMaxNumaNodes / kBitsPerLong] = {};
+    mask[static_cast<size_t>(node) / kBitsPerLong] |= 1UL << (static_cast<size_t>(node) % kBitsPerLong);
+    return syscall(SYS_set_mempolicy, kMpolPreferred, mask, kMaxNumaNodes + 1) == 0;
+}
+
+int preferred_node() {
+    int mode = kMpolDefault;
+    unsigned long mask[kMaxNumaNodes / kBitsPerLong] = {};
+    if (syscall(SYS_get_mempolicy, &mode, mask, kMaxNumaNodes + 1, nullptr, 0UL) != 0 ||
+        mode != kMpolPreferred) {
+        return -1;
+    }
+    for (size_t i = 0; i < kMaxNumaNodes; ++i) {
+        if (mask[i / kBitsPerLong] & (1UL << (i % kBitsPerLong))) return static_cast<int>(i);
+    }
+    return -1;
+}
+#endif
+
+void read_back(EffectivePlacement& eff) {
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (pthread_getaffinity_np(pthread_self(), sizeof(set), &set) == 0) {
+        for (int c = 0; c < CPU_SETSIZE; ++c) {
+            if (CPU_ISSET(c, &set)) eff.cpus.push_back(c);
+        }
+    }
+    int policy = SCHED_OTHER;
+    sched_param sp{};
+    if (pthread_getschedparam(pthread_self(), &policy, &sp) == 0 && policy == SCHED_FIFO) {
+        eff.fifo_priority = sp.sched_priority;
+    }
+    eff.numa_node = preferred_node();
+#elif defined(_WIN32)
+    if (GetThreadPriority(GetCurrentThread()) == THREAD_PRIORITY_TIME_CRITICAL) {
+        eff.fifo_priority = 1;
+    }
+#endif
+}
+
+std::string cpu_list(const std::vector<int>& cpus) {
+    std::string out;
+    for (size_t i = 0; i < cpus.size();) {
+        size_t j = i;
+        while (j + 1 < cpus.size() && cpus[j + 1] == cpus[j] + 1) ++j;
+        if (!out.empty()) out += ',';
+        out += std::to_string(cpus[i]);
+        if (j > i) out += '-' + std::to_string(cpus[j]);
+        i = j + 1;
+    }
+    return out;
+}
+
+bool parse_int(const std::string& s, int& out) {
+    if (s.empty()) return false;
+    try {
+        size_t pos = 0;
+        out = std::stoi(s, &pos);
+        return pos == s.size();
+    } catch (...) {
+        return false;
+    }
+}
+
+} // namespace
+
+EffectivePlacement apply_thread_placement(const ThreadPlacement& placement,
+                                          const std::string& thread_name) {
+    EffectivePlacement eff;
+
+#ifdef __linux__
+    // Thread names are limited to 15 characters + NUL
+    pthread_setname_np(pthread_self(), thread_name.substr(0, 15).c_str());
+
+    if (!placement.cpus.empty()) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int c : placement.cpus) {
+            if (c >= 0 && c < kMaxCpus) CPU_SET(c, &set);
+        }
+        if (int rc = pthread_setaffinity_np(pthread_self(), sizeof(set), &set); rc != 0) {
+            spdlog::warn("{}: CPU affinity {} failed: {}", thread_name,
+                         cpu_list(placement.cpus), std::strerror(rc));
+            eff.ok = false;
+        }
+    }
+    if (placement.fifo_priority > 0) {
+        sched_param sp{};
+        sp.sched_priority = std::clamp(placement.fifo_priority,
+                                       sched_get_priority_min(SCHED_FIFO),
+                                       sched_get_priority_max(SCHED_FIFO));
+        if (int rc = pthread_setschedparam(pthread_self(), SCHED_FIFO, &sp); rc != 0) {
+            spdlog::warn("{}: SCHED_FIFO priority {} failed: {} (needs CAP_SYS_NICE or rtprio limit)",
+                         thread_name, sp.sched_priority, std::strerror(rc));
+            eff.ok = false;
+        }
+    }
+    if (placement.numa_node >= 0) {
+        // parse_thread_placement() rejects larger nodes; guards the mask
+        if (static_cast<unsigned long>(placement.numa_node) >= kMaxNumaNodes) {
+            spdlog::warn("{}: NUMA node {} is out of range", thread_name, placement.numa_node);
+            eff.ok = false;
+        } else if (!set_preferred_node(placement.numa_node)) {
+            spdlog::warn("{}: NUMA node {} preference failed: {}", thread_name,
+                         placement.numa_node, std::strerror(errno));
+            eff.ok = false;
+        }
+    }
+#elif defined(_WIN32)
+    (void)thread_name;
+    if (!placement.cpus.empty()) {
+        DWORD_PTR mask = 0;
+        for (int c : placement.cpus) {
+            if (c >= 0 && c < kMaxCpus) {
+                mask |= static_cast<DWORD_PTR>(1) << c;
+            }
+        }
+        if (mask == 0 || SetThreadAffinityMask(GetCurrentThread(), mask) == 0) {
+            spdlog::warn("{}: CPU affinity {} failed", thread_name, cpu_list(placement.cpus));
+            eff.ok = false;
+        }
+    }
+    if (placement.fifo_priority > 0 &&
+        !SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL)) {
+        spdlog::warn("{}: real-time priority failed", thread_name);
+        eff.ok = false;
+    }
+    if (placement.numa_node >= 0) {
+        spdlog::warn("{}: NUMA node preference is not supported on this platform", thread_name);
+        eff.ok = false;
+    }
+#else
+    if (!placement.empty()) {
+        spdlog::warn("{}: thread placement is not supported on this platform", thread_name);
+        eff.ok = false;
+    }
+#endif
+
+    read_back(eff);
+    if (!placement.empty()) {
+        spdlog::info("{}: placement {}", thread_name, to_string(eff));
+    }
+    return eff;
+}
+
+bool parse_thread_placement(const std::string& spec, ThreadPlacement& out) {
+    ThreadPlacement p;
+
+    size_t start = 0;
+    bool first = true;
+    while (start <= spec.size()) {
+        size_t end = spec.find(':', start);
+        if (end == std::string::npos) end = spec.size();
+        const std::string field = spec.substr(start, end - start);
+
+        if (first) {
+            // CPU list: "2-3,6" (may be empty)
+            size_t pos = 0;
+            while (pos < field.size()) {
+                size_t comma = field.find(',', pos);
+                if (comma == std::string::npos) comma = field.size();
+                const std::string item = field.substr(pos, comma - pos);
+                const size_t dash = item.find('-');
+                int lo = 0;
+                int hi = 0;
+                if (dash == std::string::npos) {
+                    if (!parse_int(item, lo)) return false;
+                    hi = lo;
+                } else if (!parse_int(item.substr(0, dash), lo) ||
+                           !parse_int(item.substr(dash + 1), hi)) {
+                    return false;
+                }
+                // Checked before expanding: "0-2000000000" is a typo, not a CPU set
+                if (lo < 0 || hi < lo || hi >= kMaxCpus) return false;
+                for (int c = lo; c <= hi; ++c) p.cpus.push_back(c);
+                pos = comma + 1;
+            }
+            first = false;
+        } else if (field.rfind("fifo=", 0) == 0) {
+            if (!parse_int(field.substr(5), p.fifo_priority) ||
+                p.fifo_priority < 0 || p.fifo_priority > 99) {
+                return false;
+            }
+        } else if (field.rfind("numa=", 0) == 0) {
+            if (!parse_int(field.substr(5), p.numa_node) || p.numa_node < 0 ||
+                static_cast<unsigned long>(p.numa_node) >= kMaxNumaNodes) {
+                return false;
+            }
+        } else {
+            return false;
+        }
+        start = end + 1;
+    }
+
+    std::sort(p.cpus.begin(), p.cpus.end());
+    p.cpus.erase(std::unique(p.cpus.begin(), p.cpus.end()), p.cpus.end());
+    out = std::move(p);
+    return true;
+}
+
+std::string to_string(const EffectivePlacement& placement) {
+    std::string out = "cpus=" + (placement.cpus.empty() ? std::string("?") : cpu_list(placement.cpus));
+    out += placement.fifo_priority > 0
+        ? " fifo=" + std::to_string(placement.fifo_priority)
+        : std::string(" other");
+    if (placement.numa_node >= 0) out += " numa=" + std::to_string(placement.numa_node);
+    if (!placement.ok) out += " (partial)";
+    return out;
+}
+
+} // namespace grebe
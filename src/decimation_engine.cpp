@@ -36,6 +36,7 @@ DecimationEngine::~DecimationEngine() {
 
 void DecimationEngine::start(std::vector<RingBuffer<int16_t>*> rings,
                               const DecimationConfig& config) {
+    impl_->thread.set_placement(config.coordinator_placement, config.worker_placement);
     impl_->thread.start(std::move(rings), config.target_points,
                          to_internal(config.algorithm));
     impl_->thread.set_sample_rate(config.sample_rate);
@@ -81,6 +82,7 @@ DecimationMetrics DecimationEngine::metrics() const {
     m.decimation_ratio = impl_->thread.decimation_ratio();
     m.ring_fill_ratio = impl_->thread.ring_fill_ratio();
     m.effective_algorithm = from_internal(impl_->thread.effective_mode());
+    m.placement = impl_->thread.effective_placement();
     return m;
 }
 
@@ -1,4 +1,5 @@
 #include "decimation_thread.h"
+#include "grebe/alloc_tracker.h"
 
 #include <spdlog/spdlog.h>
 #include <algorithm>
@@ -39,11 +40,18 @@ void DecimationThread::start(std::vector<RingBuffer<int16_t>*> rings, uint32_t t
     // Determine worker count: single-thread for 1ch, multi-thread for 2+ch.
     if (num_ch <= 1) {
         num_workers_ = 0;
+    } else if (!worker_placement_.empty()) {
+        num_workers_ = std::min(num_ch, static_cast<uint32_t>(worker_placement_.size()));
     } else {
         uint32_t hw = std::max(1u, std::thread::hardware_concurrency() / 2);
         num_workers_ = std::min({num_ch, hw, 4u});
     }
 
+    {
+        std::lock_guard<std::mutex> lock(placement_mutex_);
+        effective_placement_.assign(1 + num_workers_, std::string());
+    }
+
     // Setup workers if multi-threaded
     if (num_workers_ > 0) {
         workers_.resize(num_workers_);
@@ -124,6 +132,32 @@ void DecimationThread::stop() {
     spdlog::info("DecimationThread stopped");
 }
 
+void DecimationThread::set_placement(const grebe::ThreadPlacement& coordinator,
+                                     std::vector<grebe::ThreadPlacement> workers) {
+    coordinator_placement_ = coordinator;
+    worker_placement_ = std::move(workers);
+}
+
+std::string DecimationThread::effective_placement() const {
+    std::lock_guard<std::mutex> lock(placement_mutex_);
+    std::string out;
+    for (size_t i = 0; i < effective_placement_.size(); i++) {
+        if (effective_placement_[i].empty()) continue;
+        if (!out.empty()) out += ' ';
+        out += (i == 0 ? std::string("coord") : "w" + std::to_string(i - 1));
+        out += '[' + effective_placement_[i] + ']';
+    }
+    return out;
+}
+
+void DecimationThread::apply_placement(const grebe::ThreadPlacement& placement, size_t slot,
+                                       const std::string& name) {
+    grebe::register_alloc_thread(name);
+    auto effective = grebe::to_string(grebe::apply_thread_placement(placement, name));
+    std::lock_guard<std::mutex> lock(placement_mutex_);
+    effective_placement_[slot] = std::move(effective);
+}
+
 void DecimationThread::set_mode(DecimationMode mode) {
     mode_.store(mode, std::memory_order_relaxed);
 }
@@ -185,6 +219,8 @@ const char* DecimationThread::mode_name(DecimationMode m) {
 }
 
 void DecimationThread::thread_func() {
+    apply_placement(coordinator_placement_, 0, "grebe-dec");
+
     if (num_workers_ == 0) {
         thread_func_single();
     } else {
@@ -411,6 +447,11 @@ void DecimationThread::thread_func_multi() {
 }
 
 void DecimationThread::worker_func(uint32_t worker_id) {
+    apply_placement(worker_placement_.empty()
+                        ? grebe::ThreadPlacement{}
+                        : worker_placement_[worker_id % worker_placement_.size()],
+                    1 + worker_id, "grebe-dec-w" + std::to_string(worker_id));
+
     auto& state = workers_[worker_id];
     uint32_t last_generation = 0;
 
@@ -2,12 +2,14 @@
 
 #include "decimator.h"
 #include "ring_buffer.h"
+#include "grebe/thread_placement.h"
 
 #include <atomic>
 #include <condition_variable>
 #include <cstdint>
 #include <memory>
 #include <mutex>
+#include <string>
 #include <thread>
 #include <vector>
 
@@ -23,6 +25,16 @@ public:
     void start(std::vector<RingBuffer<int16_t>*> rings, uint32_t target_points, DecimationMode mode);
     void stop();
 
+    /// Thread placement, applied on the next start(). Worker w uses
+    /// workers[w % size]; a non-empty list replaces the hardware_concurrency()/2
+    /// heuristic so the worker count is min(channels, workers.size()).
+    void set_placement(const grebe::ThreadPlacement& coordinator,
+                       std::vector<grebe::ThreadPlacement> workers = {});
+
+    /// Effective placement per thread, e.g. "coord[cpus=0-1 other] w0[cpus=2 fifo=50]".
+    /// Empty until the threads have started.
+    std::string effective_placement() const;
+
     uint32_t channel_count() const { return channel_count_.load(std::memory_order_relaxed); }
     uint32_t per_channel_vertex_count() const { return per_ch_vtx_.load(std::memory_order_relaxed); }
 
@@ -63,6 +75,8 @@ private:
     void thread_func_single();      // 1ch optimized path (no workers)
     void thread_func_multi();       // multi-ch with worker threads
     void worker_func(uint32_t worker_id);
+    void apply_placement(const grebe::ThreadPlacement& placement, size_t slot,
+                         const std::string& name);
 
     std::vector<RingBuffer<int16_t>*> rings_;
     std::thread thread_;
@@ -85,6 +99,12 @@ private:
     std::vector<uint32_t> front_per_ch_raw_;  // per-channel raw counts
     bool new_data_ = false;
 
+    // Thread placement (requested; effective[0] = coordinator, [1 + w] = worker w)
+    grebe::ThreadPlacement coordinator_placement_;
+    std::vector<grebe::ThreadPlacement> worker_placement_;
+    mutable std::mutex placement_mutex_;
+    std::vector<std::string> effective_placement_;
+
     // Telemetry
     std::atomic<double> decimate_time_ms_{0.0};
     std::atomic<double> decimate_ratio_{1.0};
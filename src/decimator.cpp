@@ -2,6 +2,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstring>
 #include <limits>
 
 #if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
@@ -26,17 +27,65 @@ std::vector<int16_t> Decimator::passthrough(const std::vector<int16_t>& input) {
     return input;
 }
 
-// Scalar MinMax (always available, used for benchmarking)
 std::vector<int16_t> Decimator::minmax_scalar(const std::vector<int16_t>& input, uint32_t target_points) {
-    if (target_points < 2) return {};
-    if (input.size() <= target_points) return input;
+    std::vector<int16_t> output(output_size(input.size(), DecimationMode::MinMax, target_points));
+    minmax_scalar_into(input.data(), input.size(), target_points, output.data());
+    return output;
+}
 
-    uint32_t num_buckets = target_points / 2;
-    std::vector<int16_t> output;
-    output.reserve(num_buckets * 2);
+std::vector<int16_t> Decimator::minmax(const std::vector<int16_t>& input, uint32_t target_points) {
+    std::vector<int16_t> output(output_size(input.size(), DecimationMode::MinMax, target_points));
+    minmax_into(input.data(), input.size(), target_points, output.data());
+    return output;
+}
 
-    size_t n = input.size();
-    const int16_t* data = input.data();
+std::vector<int16_t> Decimator::lttb(const std::vector<int16_t>& input, uint32_t target_points) {
+    std::vector<int16_t> output(output_size(input.size(), DecimationMode::LTTB, target_points));
+    lttb_into(input.data(), input.size(), target_points, output.data());
+    return output;
+}
+
+size_t Decimator::output_size(size_t input_count, DecimationMode mode, uint32_t target_points) {
+    switch (mode) {
+    case DecimationMode::MinMax:
+        if (target_points < 2) return 0;
+        if (input_count <= target_points) return input_count;
+        return static_cast<size_t>(target_points / 2) * 2;
+    case DecimationMode::LTTB:
+        if (target_points < 3) return 0;
+        if (input_count <= target_points) return input_count;
+        return target_points;
+    case DecimationMode::None:
+    default:
+        return input_count;
+    }
+}
+
+size_t Decimator::decimate_into(const int16_t* input, size_t count, DecimationMode mode,
+                                uint32_t target_points, int16_t* output) {
+    switch (mode) {
+    case DecimationMode::MinMax:
+        return minmax_into(input, count, target_points, output);
+    case DecimationMode::LTTB:
+        return lttb_into(input, count, target_points, output);
+    case DecimationMode::None:
+    default:
+        if (count > 0) std::memcpy(output, input, count * sizeof(int16_t));
+        return count;
+    }
+}
+
+// Scalar MinMax (always available, used for benchmarking)
+size_t Decimator::minmax_scalar_into(const int16_t* data, size_t n, uint32_t target_points,
+                                     int16_t* output) {
+    if (target_points < 2) return 0;
+    if (n <= target_points) {
+        if (n > 0) std::memcpy(output, data, n * sizeof(int16_t));
+        return n;
+    }
+
+    uint32_t num_buckets = target_points / 2;
+    size_t out = 0;
 
     for (uint32_t b = 0; b < num_buckets; b++) {
         size_t start = (static_cast<size_t>(b) * n) / num_buckets;
@@ -51,11 +100,11 @@ std::vector<int16_t> Decimator::minmax_scalar(const std::vector<int16_t>& input,
             if (v > hi) hi = v;
         }
 
-        output.push_back(lo);
-        output.push_back(hi);
+        output[out++] = lo;
+        output[out++] = hi;
     }
 
-    return output;
+    return out;
 }
 
 #if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
@@ -80,16 +129,16 @@ static inline int16_t hmax_epi16(__m128i v) {
 }
 
 // SIMD MinMax: process 16 int16 values per iteration (2x unrolled SSE2)
-std::vector<int16_t> Decimator::minmax(const std::vector<int16_t>& input, uint32_t target_points) {
-    if (target_points < 2) return {};
-    if (input.size() <= target_points) return input;
+size_t Decimator::minmax_into(const int16_t* data, size_t n, uint32_t target_points,
+                              int16_t* output) {
+    if (target_points < 2) return 0;
+    if (n <= target_points) {
+        if (n > 0) std::memcpy(output, data, n * sizeof(int16_t));
+        return n;
+    }
 
     uint32_t num_buckets = target_points / 2;
-    std::vector<int16_t> output;
-    output.reserve(num_buckets * 2);
-
-    size_t n = input.size();
-    const int16_t* data = input.data();
+    size_t out = 0;
 
     for (uint32_t b = 0; b < num_buckets; b++) {
         size_t start = (static_cast<size_t>(b) * n) / num_buckets;
@@ -131,34 +180,35 @@ std::vector<int16_t> Decimator::minmax(const std::vector<int16_t>& input, uint32
             if (v > hi) hi = v;
         }
 
-        output.push_back(lo);
-        output.push_back(hi);
+        output[out++] = lo;
+        output[out++] = hi;
     }
 
-    return output;
+    return out;
 }
 
 #else
 
 // Non-SIMD fallback: use scalar implementation
-std::vector<int16_t> Decimator::minmax(const std::vector<int16_t>& input, uint32_t target_points) {
-    return minmax_scalar(input, target_points);
+size_t Decimator::minmax_into(const int16_t* data, size_t n, uint32_t target_points,
+                              int16_t* output) {
+    return minmax_scalar_into(data, n, target_points, output);
 }
 
 #endif // SSE2
 
-std::vector<int16_t> Decimator::lttb(const std::vector<int16_t>& input, uint32_t target_points) {
-    if (target_points < 3) return {};
-    if (input.size() <= target_points) return input;
-
-    size_t n = input.size();
-    const int16_t* data = input.data();
+size_t Decimator::lttb_into(const int16_t* data, size_t n, uint32_t target_points,
+                            int16_t* output) {
+    if (target_points < 3) return 0;
+    if (n <= target_points) {
+        if (n > 0) std::memcpy(output, data, n * sizeof(int16_t));
+        return n;
+    }
 
-    std::vector<int16_t> output;
-    output.reserve(target_points);
+    size_t out = 0;
 
     // Always keep first point
-    output.push_back(data[0]);
+    output[out++] = data[0];
 
     uint32_t num_buckets = target_points - 2;
     double bucket_size = static_cast<double>(n - 2) / static_cast<double>(num_buckets);
@@ -216,13 +266,13 @@ std::vector<int16_t> Decimator::lttb(const std::vector<int16_t>& input, uint32_t
             }
         }
 
-        output.push_back(data[best_idx]);
+        output[out++] = data[best_idx];
         prev_x = static_cast<double>(best_idx);
         prev_y = static_cast<double>(data[best_idx]);
     }
 
     // Always keep last point
-    output.push_back(data[n - 1]);
+    output[out++] = data[n - 1];
 
-    return output;
+    return out;
 }
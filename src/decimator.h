@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <vector>
 
@@ -27,4 +28,16 @@ public:
 
     // LTTB (Largest Triangle Three Buckets)
     static std::vector<int16_t> lttb(const std::vector<int16_t>& input, uint32_t target_points);
+
+    // Allocation-free variants: write into caller-provided storage.
+    // output_size() gives the exact number of samples decimate_into() writes.
+    static size_t output_size(size_t input_count, DecimationMode mode, uint32_t target_points);
+    static size_t decimate_into(const int16_t* input, size_t count, DecimationMode mode,
+                                uint32_t target_points, int16_t* output);
+    static size_t minmax_into(const int16_t* input, size_t count, uint32_t target_points,
+                              int16_t* output);
+    static size_t minmax_scalar_into(const int16_t* input, size_t count, uint32_t target_points,
+                                     int16_t* output);
+    static size_t lttb_into(const int16_t* input, size_t count, uint32_t target_points,
+                            int16_t* output);
 };
@@ -1,5 +1,6 @@
 #include "ingestion_thread.h"
 #include "drop_counter.h"
+#include "grebe/alloc_tracker.h"
 
 #include <spdlog/spdlog.h>
 
@@ -30,6 +31,13 @@ void IngestionThread::stop() {
 }
 
 void IngestionThread::thread_func() {
+    grebe::register_alloc_thread("grebe-ingest");
+    {
+        auto effective = grebe::to_string(grebe::apply_thread_placement(placement_, "grebe-ingest"));
+        std::lock_guard<std::mutex> lock(placement_mutex_);
+        effective_placement_ = std::move(effective);
+    }
+
     grebe::FrameBuffer frame;
     uint64_t gap_count = 0;
 
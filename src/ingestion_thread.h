@@ -1,10 +1,13 @@
 #pragma once
 
 #include "grebe/data_source.h"
+#include "grebe/thread_placement.h"
 #include "ring_buffer.h"
 
 #include <atomic>
 #include <cstdint>
+#include <mutex>
+#include <string>
 #include <thread>
 #include <vector>
 
@@ -26,6 +29,15 @@ public:
                std::vector<DropCounter*> drop_counters);
     void stop();
 
+    /// Thread placement, applied on the next start().
+    void set_placement(const grebe::ThreadPlacement& placement) { placement_ = placement; }
+
+    /// Effective placement of the ingestion thread (empty until started).
+    std::string effective_placement() const {
+        std::lock_guard<std::mutex> lock(placement_mutex_);
+        return effective_placement_;
+    }
+
     bool is_running() const { return running_.load(std::memory_order_relaxed); }
 
     // Telemetry (thread-safe reads from main thread)
@@ -41,6 +53,10 @@ private:
     std::vector<RingBuffer<int16_t>*> rings_;
     std::vector<DropCounter*> drop_counters_;
 
+    grebe::ThreadPlacement placement_;
+    mutable std::mutex placement_mutex_;
+    std::string effective_placement_;
+
     std::thread thread_;
     std::atomic<bool> running_{false};
     std::atomic<bool> stop_requested_{false};
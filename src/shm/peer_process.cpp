@@ -0,0 +1,72 @@
+#include "shm/peer_process.h"
+
+#include <cerrno>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <csignal>
+#include <poll.h>
+#include <sys/types.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+#endif
+
+namespace grebe {
+
+PeerProcess::~PeerProcess() {
+    reset();
+}
+
+void PeerProcess::reset() {
+#ifdef _WIN32
+    if (handle_) CloseHandle(handle_);
+    handle_ = nullptr;
+#else
+    if (pidfd_ >= 0) ::close(pidfd_);
+    pidfd_ = -1;
+#endif
+    pid_ = 0;
+}
+
+void PeerProcess::watch(uint32_t pid) {
+    reset();
+    pid_ = pid;
+    if (pid == 0 || pid == current_pid()) return;
+#ifdef _WIN32
+    handle_ = OpenProcess(SYNCHRONIZE, FALSE, static_cast<DWORD>(pid));
+#elif defined(__linux__) && defined(SYS_pidfd_open)
+    pidfd_ = static_cast<int>(syscall(SYS_pidfd_open, static_cast<pid_t>(pid), 0));
+#endif
+}
+
+bool PeerProcess::alive() const {
+    if (pid_ == 0 || pid_ == current_pid()) return true;
+#ifdef _WIN32
+    // OpenProcess fails for a process that is already gone
+    if (!handle_) return false;
+    return WaitForSingleObject(handle_, 0) == WAIT_TIMEOUT;
+#else
+    if (pidfd_ >= 0) {
+        // A pidfd becomes readable when the process exits
+        struct pollfd p{pidfd_, POLLIN, 0};
+        return ::poll(&p, 1, 0) == 0;
+    }
+    // EPERM: exists but belongs to another user
+    return ::kill(static_cast<pid_t>(pid_), 0) == 0 || errno == EPERM;
+#endif
+}
+
+uint32_t PeerProcess::current_pid() {
+#ifdef _WIN32
+    return static_cast<uint32_t>(GetCurrentProcessId());
+#else
+    return static_cast<uint32_t>(::getpid());
+#endif
+}
+
+} // namespace grebe
@@ -0,0 +1,48 @@
+#pragma once
+
+// PeerProcess — Liveness of the process on the other side of a shared region (Phase 14)
+// Linux pidfd (kill(pid, 0) fallback), Win32 process handle.
+
+#include <cstdint>
+
+namespace grebe {
+
+/// Watches another process by pid and reports whether it is still running.
+///
+/// On Linux a pidfd is opened once in watch(), so a recycled pid is never
+/// mistaken for the original process; where pidfd_open is unavailable
+/// (old kernels, seccomp) it falls back to kill(pid, 0). Windows keeps a
+/// SYNCHRONIZE handle. alive() costs one syscall: callers rate-limit it.
+class PeerProcess {
+public:
+    PeerProcess() = default;
+    ~PeerProcess();
+
+    PeerProcess(const PeerProcess&) = delete;
+    PeerProcess& operator=(const PeerProcess&) = delete;
+
+    /// Start watching @p pid (0 = nobody). Replaces the previous peer.
+    void watch(uint32_t pid);
+
+    /// Pid being watched (0 = nobody).
+    uint32_t pid() const { return pid_; }
+
+    /// False once the watched process has exited. True with nobody watched,
+    /// and for this process itself.
+    bool alive() const;
+
+    /// Pid of the calling process.
+    static uint32_t current_pid();
+
+private:
+    void reset();
+
+    uint32_t pid_ = 0;
+#ifdef _WIN32
+    void* handle_ = nullptr;  // HANDLE
+#else
+    int pidfd_ = -1;
+#endif
+};
+
+} // namespace grebe
@@ -0,0 +1,980 @@
+#include "shm/shm_queue.h"
+#include "core/event_notifier.h"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <thread>
+
+#ifdef __linux__
+#include <climits>
+#include <ctime>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace grebe {
+
+namespace {
+
+constexpr uint32_t kShmQueueMagic   = 0x51534247;  // 'GBSQ' little-endian
+constexpr uint32_t kShmQueueVersion = 3;
+constexpr size_t   kPageSize        = 4096;
+constexpr int      kSpinLimit       = 64;
+constexpr auto     kBlockWaitSlice  = std::chrono::milliseconds(1);
+/// Peer liveness check period; detection takes at most ~3 periods (NFR-06: 1 s)
+constexpr auto     kLivenessInterval = std::chrono::milliseconds(100);
+constexpr uint64_t kLivenessIntervalNs =
+    std::chrono::duration_cast<std::chrono::nanoseconds>(kLivenessInterval).count();
+/// Lane pid while the producer reclaims a dead consumer's references
+constexpr uint32_t kConsumerDetaching = UINT32_MAX;
+/// Slot reference mask: one bit per consumer lane, plus the producer's
+constexpr uint32_t kSlotReserved = 1u << 31;
+
+static_assert(ShmQueue::kMaxConsumers < 31, "lane bits must not reach kSlotReserved");
+static_assert(std::atomic<uint32_t>::is_always_lock_free &&
+              std::atomic<uint64_t>::is_always_lock_free,
+              "ShmQueue needs address-free atomics");
+
+/// Cross-process wait/notify (EventNotifier protocol on a shared futex).
+struct ShmWait {
+    std::atomic<uint32_t> epoch{0};
+    std::atomic<uint32_t> waiters{0};
+};
+
+uint32_t prepare_wait(ShmWait& w) {
+    w.waiters.fetch_add(1, std::memory_order_seq_cst);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    return w.epoch.load(std::memory_order_acquire);
+}
+
+void cancel_wait(ShmWait& w) {
+    w.waiters.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void wait(ShmWait& w, uint32_t token, std::chrono::nanoseconds timeout) {
+    if (timeout.count() > 0 && w.epoch.load(std::memory_order_acquire) == token) {
+#ifdef __linux__
+        struct timespec ts;
+        ts.tv_sec  = static_cast<time_t>(timeout.count() / 1000000000);
+        ts.tv_nsec = static_cast<long>(timeout.count() % 1000000000);
+        // Shared (non-private) futex: the waker lives in another process
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&w.epoch),
+                FUTEX_WAIT, token, &ts, nullptr, 0);
+#else
+        std::this_thread::sleep_for(std::min<std::chrono::nanoseconds>(
+            timeout, std::chrono::microseconds(100)));
+#endif
+    }
+    w.waiters.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void notify_all(ShmWait& w) {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (w.waiters.load(std::memory_order_relaxed) == 0) return;
+    w.epoch.fetch_add(1, std::memory_order_release);
+#ifdef __linux__
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&w.epoch),
+            FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+#endif
+}
+
+constexpr size_t round_up(size_t n, size_t align) {
+    return (n + align - 1) / align * align;
+}
+
+uint32_t round_slot_count(uint32_t n) {
+    uint32_t p = 2;
+    while (p < n) p <<= 1;
+    return p;
+}
+
+bool is_blocking(BackpressurePolicy p) {
+    return p == BackpressurePolicy::Block || p == BackpressurePolicy::Credit;
+}
+
+bool is_attached(uint32_t pid) {
+    return pid != 0 && pid != kConsumerDetaching;
+}
+
+} // namespace
+
+/// Frame metadata as stored in a lane's descriptor ring.
+struct ShmDescriptor {
+    uint64_t sequence;
+    uint64_t producer_ts_ns;
+    uint64_t first_sample_index;
+    double   sample_rate_hz;
+    uint32_t channel_count;
+    uint32_t samples_per_channel;
+    uint32_t flags;
+    uint32_t slot;
+    FrameTrace trace;
+};
+
+struct alignas(64) ShmCell {
+    std::atomic<uint64_t> seq;
+    ShmDescriptor desc;
+};
+
+/// One consumer's share of the region: descriptor ring positions, wait
+/// word, settings and telemetry. Its ring of slot_count cells follows.
+struct ShmLane {
+    alignas(64) std::atomic<uint64_t> enqueue_pos;  // producer
+    std::atomic<uint64_t> enqueued;
+    alignas(64) std::atomic<uint64_t> dequeue_pos;  // consumer, producer evicting
+    std::atomic<uint64_t> heartbeat;
+
+    alignas(64) ShmWait not_empty;  // consumer parked in dequeue_wait()
+    std::atomic<uint32_t> pid;      // 0 = free
+    std::atomic<uint32_t> policy;
+    std::atomic<uint32_t> depth;    // 0 = bounded by the slot pool
+    std::atomic<uint32_t> closed;   // consumer shut its side down
+    std::atomic<uint64_t> dropped;
+
+    /// Attached and still receiving: publish() delivers to this lane.
+    bool active() const {
+        const uint32_t p = pid.load(std::memory_order_acquire);
+        return p != 0 && p != kConsumerDetaching && closed.load(std::memory_order_acquire) == 0;
+    }
+
+    ShmCell* cells() {
+        return reinterpret_cast<ShmCell*>(reinterpret_cast<char*>(this) +
+                                          round_up(sizeof(ShmLane), alignof(ShmCell)));
+    }
+
+    uint64_t size() const {
+        const uint64_t head = dequeue_pos.load(std::memory_order_relaxed);
+        const uint64_t tail = enqueue_pos.load(std::memory_order_relaxed);
+        return tail > head ? tail - head : 0;
+    }
+
+    /// Claim the oldest descriptor (consumer, or producer evicting).
+    bool pop(uint64_t mask, ShmDescriptor& out) {
+        uint64_t pos = dequeue_pos.load(std::memory_order_relaxed);
+        for (;;) {
+            ShmCell& cell = cells()[pos & mask];
+            const uint64_t seq = cell.seq.load(std::memory_order_acquire);
+            const auto diff = static_cast<int64_t>(seq - (pos + 1));
+            if (diff == 0) {
+                if (dequeue_pos.compare_exchange_weak(pos, pos + 1,
+                                                      std::memory_order_relaxed)) {
+                    out = cell.desc;
+                    cell.seq.store(pos + mask + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = dequeue_pos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /// Slot of the oldest queued descriptor, without claiming it (a hint:
+    /// the consumer may take it meanwhile).
+    bool peek_slot(uint64_t mask, uint32_t& slot) {
+        const uint64_t pos = dequeue_pos.load(std::memory_order_relaxed);
+        ShmCell& cell = cells()[pos & mask];
+        if (cell.seq.load(std::memory_order_acquire) != pos + 1) return false;
+        slot = cell.desc.slot;
+        return true;
+    }
+};
+
+/// Shared header at offset 0 of the region. Written once by create() before
+/// `ready` is set; after that only the atomics change.
+struct ShmQueueLayout {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t slot_count;
+    uint32_t policy;           // default for consumers
+    uint32_t max_consumers;
+    uint32_t reserved;
+    uint64_t slot_samples;
+    uint64_t slot_stride;      // bytes between payload slots
+    uint64_t lanes_offset;
+    uint64_t lane_stride;      // bytes between lanes (header + ring)
+    uint64_t refs_offset;
+    uint64_t payload_offset;
+    uint64_t region_bytes;
+
+    alignas(64) std::atomic<uint64_t> producer_heartbeat;
+
+    alignas(64) ShmWait not_full;   // producer parked waiting for a slot
+    std::atomic<uint32_t> shutdown;
+    std::atomic<uint32_t> ready;
+    std::atomic<uint32_t> producer_pid;
+
+    alignas(64) std::atomic<uint64_t> total_published;
+    std::atomic<uint64_t> total_dropped;    // frames that found no slot
+    std::atomic<uint64_t> total_blocked_ns;
+    std::atomic<uint64_t> source_drops;
+    std::atomic<uint64_t> consumer_detaches;
+
+    ShmLane& lane(uint32_t i) {
+        return *reinterpret_cast<ShmLane*>(reinterpret_cast<char*>(this) + lanes_offset +
+                                           i * lane_stride);
+    }
+    /// Per-slot reference mask (bit i = lane i, kSlotReserved = producer).
+    std::atomic<uint32_t>* refs() {
+        return reinterpret_cast<std::atomic<uint32_t>*>(
+            reinterpret_cast<char*>(this) + refs_offset);
+    }
+};
+
+namespace {
+
+size_t lane_stride(uint32_t slots) {
+    return round_up(round_up(sizeof(ShmLane), alignof(ShmCell)) + sizeof(ShmCell) * slots,
+                    alignof(ShmLane));
+}
+
+uint32_t clamp_consumers(uint32_t n) {
+    return std::clamp<uint32_t>(n, 1, ShmQueue::kMaxConsumers);
+}
+
+/// [offset, offset + count * stride) lies within @p size, without overflow.
+bool span_fits(uint64_t offset, uint64_t stride, uint64_t count, uint64_t size) {
+    if (offset > size) return false;
+    return count == 0 || stride <= (size - offset) / count;
+}
+
+/// Geometry and offsets of a mapped region are consistent and inside its
+/// @p size: they come from the producer and are trusted by every access.
+bool layout_valid(const ShmQueueLayout& l, uint64_t size) {
+    const uint32_t slots = l.slot_count;
+    if (slots < 2 || (slots & (slots - 1)) != 0) return false;
+    if (l.max_consumers < 1 || l.max_consumers > ShmQueue::kMaxConsumers) return false;
+    if (l.slot_samples < 1 || l.slot_stride / sizeof(int16_t) < l.slot_samples) return false;
+    if (l.lane_stride < lane_stride(slots)) return false;
+    if (l.lanes_offset < sizeof(ShmQueueLayout) ||
+        l.lanes_offset % alignof(ShmLane) != 0 || l.lane_stride % alignof(ShmLane) != 0 ||
+        l.refs_offset % alignof(std::atomic<uint32_t>) != 0 ||
+        l.payload_offset % alignof(int16_t) != 0 || l.slot_stride % alignof(int16_t) != 0) {
+        return false;
+    }
+    return span_fits(l.lanes_offset, l.lane_stride, l.max_consumers, size) &&
+           span_fits(l.refs_offset, sizeof(std::atomic<uint32_t>), slots, size) &&
+           span_fits(l.payload_offset, l.slot_stride, slots, size);
+}
+
+} // namespace
+
+size_t ShmQueue::region_size(const ShmQueueConfig& config) {
+    const uint32_t slots = round_slot_count(config.slot_count);
+    const size_t stride = round_up(std::max<size_t>(config.slot_samples, 1) * sizeof(int16_t),
+                                   kPageSize);
+    size_t bytes = round_up(sizeof(ShmQueueLayout), kPageSize);
+    bytes += round_up(lane_stride(slots) * clamp_consumers(config.max_consumers), kPageSize);
+    bytes += round_up(sizeof(std::atomic<uint32_t>) * slots, kPageSize);
+    bytes += stride * slots;
+    return bytes;
+}
+
+std::unique_ptr<ShmQueue> ShmQueue::create(const std::string& name,
+                                           const ShmQueueConfig& config) {
+    const size_t bytes = region_size(config);
+    auto region = ShmRegion::create(name, bytes);
+
+    // Fresh region is zero-filled; construct the header and lanes in place
+    auto* base = static_cast<char*>(region->data());
+    auto* l = new (base) ShmQueueLayout{};
+    l->magic         = kShmQueueMagic;
+    l->version       = kShmQueueVersion;
+    l->slot_count    = round_slot_count(config.slot_count);
+    l->policy        = static_cast<uint32_t>(config.policy);
+    l->max_consumers = clamp_consumers(config.max_consumers);
+    l->slot_samples  = std::max<size_t>(config.slot_samples, 1);
+    l->slot_stride   = round_up(l->slot_samples * sizeof(int16_t), kPageSize);
+    l->lanes_offset  = round_up(sizeof(ShmQueueLayout), kPageSize);
+    l->lane_stride   = lane_stride(l->slot_count);
+    l->refs_offset   = l->lanes_offset +
+                       round_up(l->lane_stride * l->max_consumers, kPageSize);
+    l->payload_offset = l->refs_offset +
+                        round_up(sizeof(std::atomic<uint32_t>) * l->slot_count, kPageSize);
+    l->region_bytes = bytes;
+    l->producer_pid.store(PeerProcess::current_pid(), std::memory_order_relaxed);
+    for (uint32_t c = 0; c < l->max_consumers; ++c) {
+        auto* lane = new (&l->lane(c)) ShmLane{};
+        for (uint32_t i = 0; i < l->slot_count; ++i) {
+            auto* cell = new (&lane->cells()[i]) ShmCell{};
+            cell->seq.store(i, std::memory_order_relaxed);
+        }
+    }
+    for (uint32_t i = 0; i < l->slot_count; ++i) {
+        new (&l->refs()[i]) std::atomic<uint32_t>(0);
+    }
+    l->ready.store(1, std::memory_order_release);
+
+    spdlog::info("ShmQueue: created {} ({} slots x {} samples, {} consumer(s), {:.1f} MB)",
+                 region->name().empty() ? "<anonymous>" : region->name(),
+                 l->slot_count, l->slot_samples, l->max_consumers,
+                 static_cast<double>(bytes) / (1024.0 * 1024.0));
+    return std::unique_ptr<ShmQueue>(new ShmQueue(std::move(region), true));
+}
+
+std::unique_ptr<ShmQueue> ShmQueue::open(const std::string& name,
+                                         const ShmConsumerOptions& options) {
+    return open(ShmRegion::open(name), options);
+}
+
+std::unique_ptr<ShmQueue> ShmQueue::open(std::unique_ptr<ShmRegion> region,
+                                         const ShmConsumerOptions& options) {
+    const std::string label = region->name().empty() ? "<anonymous>" : region->name();
+    if (region->size() < sizeof(ShmQueueLayout)) {
+        throw std::runtime_error("ShmQueue: region too small: " + label);
+    }
+    auto* l = static_cast<ShmQueueLayout*>(region->data());
+    if (l->magic != kShmQueueMagic) {
+        throw std::runtime_error("ShmQueue: not a ShmQueue region: " + label);
+    }
+    if (l->version != kShmQueueVersion) {
+        throw std::runtime_error("ShmQueue: unsupported version " +
+                                 std::to_string(l->version) + ": " + label);
+    }
+    if (l->ready.load(std::memory_order_acquire) == 0) {
+        throw std::runtime_error("ShmQueue: region not initialized: " + label);
+    }
+    if (region->size() < l->region_bytes) {
+        throw std::runtime_error("ShmQueue: region truncated: " + label);
+    }
+    if (!layout_valid(*l, region->size())) {
+        throw std::runtime_error("ShmQueue: inconsistent region layout: " + label);
+    }
+    return std::unique_ptr<ShmQueue>(new ShmQueue(std::move(region), false, options));
+}
+
+ShmQueue::ShmQueue(std::unique_ptr<ShmRegion> region, bool producer,
+                   const ShmConsumerOptions& options)
+    : region_(std::move(region))
+    , layout_(static_cast<ShmQueueLayout*>(region_->data()))
+    , producer_(producer) {
+    slot_count_    = layout_->slot_count;
+    mask_          = slot_count_ - 1;
+    slot_samples_  = layout_->slot_samples;
+    max_consumers_ = layout_->max_consumers;
+    policy_        = static_cast<BackpressurePolicy>(layout_->policy);
+    self_pid_      = PeerProcess::current_pid();
+    next_liveness_ns_ = steady_now_ns() + kLivenessIntervalNs;
+
+    if (producer_) {
+        consumers_ = std::make_unique<PeerProcess[]>(max_consumers_);
+        consumer_heartbeats_ = std::make_unique<uint64_t[]>(max_consumers_);
+        return;
+    }
+
+    // Claim a free lane; a crashed consumer keeps its lane until the
+    // producer notices and detaches it
+    bool claimed = false;
+    for (uint32_t i = 0; i < max_consumers_ && !claimed; ++i) {
+        uint32_t expected = 0;
+        claimed = lane(i).pid.compare_exchange_strong(expected, self_pid_,
+                                                      std::memory_order_acq_rel);
+        if (claimed) lane_ = i;
+    }
+    if (!claimed) {
+        throw std::runtime_error("ShmQueue: all " + std::to_string(max_consumers_) +
+                                 " consumer lane(s) in use: " + region_->name());
+    }
+    if (options.policy) policy_ = *options.policy;
+    lane_depth_ = std::min(options.depth, slot_count_);
+    if (lane_depth_ == 0 && policy_ == BackpressurePolicy::DropLatest) {
+        // Nothing evicts a DropLatest lane's frames: bound it to its share
+        // of the pool, so a stalled consumer cannot hold every slot
+        lane_depth_ = std::max<uint32_t>(1, slot_count_ / max_consumers_);
+    }
+    ShmLane& own = lane(lane_);
+    own.policy.store(static_cast<uint32_t>(policy_), std::memory_order_relaxed);
+    own.depth.store(lane_depth_, std::memory_order_relaxed);
+    own.closed.store(0, std::memory_order_relaxed);
+    own.dropped.store(0, std::memory_order_relaxed);
+    own.enqueued.store(0, std::memory_order_relaxed);
+
+    peer_.watch(layout_->producer_pid.load(std::memory_order_relaxed));
+    peer_heartbeat_ = layout_->producer_heartbeat.load(std::memory_order_relaxed);
+
+    slot_refs_ = std::make_unique<SlotRef[]>(slot_count_);
+    for (uint32_t i = 0; i < slot_count_; ++i) {
+        slot_refs_[i].queue = this;
+        slot_refs_[i].slot = i;
+    }
+}
+
+ShmQueue::~ShmQueue() {
+    if (producer_) {
+        // The producer going away ends the stream for the consumers
+        shutdown();
+        return;
+    }
+    // Give back what is still queued for us, then the lane; a frame the
+    // producer pushes meanwhile is drained by the producer itself
+    ShmLane& own = lane(lane_);
+    ShmDescriptor d;
+    while (own.pop(mask_, d)) {
+        if (d.slot >= slot_count_) continue;
+        layout_->refs()[d.slot].fetch_and(~(1u << lane_), std::memory_order_acq_rel);
+    }
+    uint32_t self = self_pid_;
+    own.pid.compare_exchange_strong(self, 0, std::memory_order_acq_rel);
+    notify_all(layout_->not_full);
+}
+
+ShmLane& ShmQueue::lane(uint32_t index) const {
+    return layout_->lane(index);
+}
+
+int16_t* ShmQueue::slot_data(uint32_t slot) const {
+    auto* base = reinterpret_cast<char*>(layout_) + layout_->payload_offset;
+    return reinterpret_cast<int16_t*>(base + static_cast<size_t>(slot) * layout_->slot_stride);
+}
+
+// ---- Liveness ----
+
+void ShmQueue::beat() {
+    auto& hb = producer_ ? layout_->producer_heartbeat : lane(lane_).heartbeat;
+    hb.fetch_add(1, std::memory_order_relaxed);
+}
+
+void ShmQueue::heartbeat() {
+    beat();
+}
+
+void ShmQueue::poll_peer() {
+    const uint64_t now = steady_now_ns();
+    if (now < next_liveness_ns_) return;
+    next_liveness_ns_ = now + kLivenessIntervalNs;
+    if (producer_) {
+        check_consumers();
+    } else {
+        check_producer();
+    }
+}
+
+void ShmQueue::check_consumers() {
+    for (uint32_t i = 0; i < max_consumers_; ++i) {
+        ShmLane& l = lane(i);
+        const uint32_t pid = l.pid.load(std::memory_order_acquire);
+        if (pid == 0) {
+            // Free lane with leftovers: pushed while its consumer closed
+            if (l.size() > 0) drain_lane(i);
+            continue;
+        }
+        if (pid == kConsumerDetaching) continue;
+
+        PeerProcess& peer = consumers_[i];
+        const uint64_t hb = l.heartbeat.load(std::memory_order_relaxed);
+        if (pid != peer.pid()) {
+            // New consumer on this lane: start watching it
+            peer.watch(pid);
+            consumer_heartbeats_[i] = hb;
+            continue;
+        }
+        // A moving heartbeat proves liveness without a syscall
+        if (hb != consumer_heartbeats_[i]) {
+            consumer_heartbeats_[i] = hb;
+            continue;
+        }
+        if (!peer.alive()) detach_consumer(i, pid);
+    }
+}
+
+void ShmQueue::detach_consumer(uint32_t index, uint32_t pid) {
+    ShmLane& l = lane(index);
+    uint32_t expected = pid;
+    if (!l.pid.compare_exchange_strong(expected, kConsumerDetaching,
+                                       std::memory_order_acq_rel)) {
+        return;
+    }
+
+    // A consumer killed inside pop() claimed position head-1 without
+    // releasing its cell; the producer would wait on that cell forever
+    const uint64_t head = l.dequeue_pos.load(std::memory_order_acquire);
+    if (head > 0) {
+        ShmCell& cell = l.cells()[(head - 1) & mask_];
+        if (cell.seq.load(std::memory_order_acquire) == head) {
+            cell.seq.store(head - 1 + slot_count_, std::memory_order_release);
+        }
+    }
+
+    // Drop its queued frames, then its references on the slots it borrowed
+    drain_lane(index);
+    const uint32_t bit = 1u << index;
+    uint32_t reclaimed = 0;
+    for (uint32_t s = 0; s < slot_count_; ++s) {
+        if (layout_->refs()[s].fetch_and(~bit, std::memory_order_acq_rel) & bit) ++reclaimed;
+    }
+
+    // It may have died parked in dequeue_wait(): forget it, or every
+    // publish would keep paying for a futex wake
+    l.not_empty.waiters.store(0, std::memory_order_relaxed);
+    layout_->consumer_detaches.fetch_add(1, std::memory_order_relaxed);
+    l.pid.store(0, std::memory_order_release);
+    consumers_[index].watch(0);
+
+    spdlog::warn("ShmQueue: consumer {} (pid {}) exited without closing; detached, "
+                 "{} borrowed slot(s) reclaimed", index, pid, reclaimed);
+}
+
+void ShmQueue::check_producer() {
+    const uint64_t hb = layout_->producer_heartbeat.load(std::memory_order_relaxed);
+    if (hb != peer_heartbeat_) {
+        peer_heartbeat_ = hb;
+        return;
+    }
+    if (is_shutdown() || peer_.alive()) return;
+
+    spdlog::warn("ShmQueue: producer (pid {}) exited; end of stream", peer_.pid());
+    layout_->not_full.waiters.store(0, std::memory_order_relaxed);
+    layout_->shutdown.store(1, std::memory_order_release);
+}
+
+// ---- Producer ----
+
+bool ShmQueue::try_reserve_free(uint32_t& slot) {
+    auto* refs = layout_->refs();
+    for (uint32_t n = 0; n < slot_count_; ++n) {
+        const uint32_t s = (next_slot_ + n) & static_cast<uint32_t>(mask_);
+        // Only the producer adds references to a free slot: no CAS needed
+        if (refs[s].load(std::memory_order_acquire) == 0) {
+            refs[s].store(kSlotReserved, std::memory_order_relaxed);
+            next_slot_ = s + 1;
+            slot = s;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ShmQueue::has_free_slot() const {
+    auto* refs = layout_->refs();
+    for (uint32_t s = 0; s < slot_count_; ++s) {
+        if (refs[s].load(std::memory_order_acquire) == 0) return true;
+    }
+    return false;
+}
+
+bool ShmQueue::blocking_consumer_full() const {
+    for (uint32_t i = 0; i < max_consumers_; ++i) {
+        ShmLane& l = lane(i);
+        if (!l.active()) continue;
+        const uint32_t depth = l.depth.load(std::memory_order_relaxed);
+        if (depth > 0 && l.size() >= depth &&
+            is_blocking(static_cast<BackpressurePolicy>(l.policy.load(std::memory_order_relaxed)))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ShmQueue::blocking_consumer_attached() const {
+    for (uint32_t i = 0; i < max_consumers_; ++i) {
+        ShmLane& l = lane(i);
+        if (l.active() &&
+            is_blocking(static_cast<BackpressurePolicy>(l.policy.load(std::memory_order_relaxed)))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ShmQueue::evict_oldest(uint32_t index) {
+    ShmDescriptor d;
+    if (!lane(index).pop(mask_, d)) return false;
+    if (d.slot < slot_count_) {
+        layout_->refs()[d.slot].fetch_and(~(1u << index), std::memory_order_acq_rel);
+    }
+    lane(index).dropped.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+void ShmQueue::drain_lane(uint32_t index) {
+    ShmDescriptor d;
+    while (lane(index).pop(mask_, d)) {
+        if (d.slot >= slot_count_) continue;
+        layout_->refs()[d.slot].fetch_and(~(1u << index), std::memory_order_acq_rel);
+    }
+}
+
+bool ShmQueue::make_room() {
+    // Out of slots: DropOldest consumers give up their oldest queued frame.
+    // Prefer one that is the last holder of that slot (frees it at once);
+    // with nobody blocking to wait for, take from the longest lane anyway
+    const bool can_wait = blocking_consumer_attached();
+    int best = -1;
+    uint64_t best_size = 0;
+    bool best_frees = false;
+    for (uint32_t i = 0; i < max_consumers_; ++i) {
+        ShmLane& l = lane(i);
+        const bool gone = l.pid.load(std::memory_order_acquire) == 0 ||
+                          l.closed.load(std::memory_order_acquire) != 0;
+        if (gone && l.size() > 0) {
+            drain_lane(i);  // leftovers of a consumer that closed
+            return true;
+        }
+        if (!l.active() ||
+            static_cast<BackpressurePolicy>(l.policy.load(std::memory_order_relaxed)) !=
+                BackpressurePolicy::DropOldest) {
+            continue;
+        }
+        uint32_t slot = 0;
+        if (!l.peek_slot(mask_, slot) || slot >= slot_count_) continue;
+        const bool frees = (layout_->refs()[slot].load(std::memory_order_relaxed) &
+                            ~(1u << i)) == 0;
+        const uint64_t size = l.size();
+        if ((frees && !best_frees) || (frees == best_frees && size > best_size)) {
+            best = static_cast<int>(i);
+            best_size = size;
+            best_frees = frees;
+        }
+    }
+    if (best < 0 || (!best_frees && can_wait)) return false;
+    evict_oldest(static_cast<uint32_t>(best));
+    return true;
+}
+
+ShmSlot ShmQueue::reserve(size_t samples) {
+    assert(producer_ && "reserve() on the consumer side");
+    if (samples > slot_samples_) {
+        layout_->total_dropped.fetch_add(1, std::memory_order_relaxed);
+        spdlog::warn("ShmQueue: frame of {} samples exceeds slot size {}, dropped",
+                     samples, slot_samples_);
+        return {};
+    }
+    if (layout_->shutdown.load(std::memory_order_acquire)) return {};
+    poll_peer();
+
+    uint32_t slot = 0;
+    bool reserved = false;
+    uint64_t t0 = 0;
+    int spin = 0;
+    for (;;) {
+        if (!blocking_consumer_full()) {
+            if ((reserved = try_reserve_free(slot))) break;
+            if (make_room()) continue;
+            if (!blocking_consumer_attached()) {
+                // Only lossy consumers, all slots borrowed or held back by
+                // DropLatest queues: this frame is lost for everyone
+                layout_->total_dropped.fetch_add(1, std::memory_order_relaxed);
+                if (t0) {
+                    layout_->total_blocked_ns.fetch_add(steady_now_ns() - t0,
+                                                        std::memory_order_relaxed);
+                }
+                return {};
+            }
+        }
+
+        // A blocking consumer holds us back: spin briefly, then park
+        if (t0 == 0) t0 = steady_now_ns();
+        if (spin < kSpinLimit) {
+            ++spin;
+            cpu_relax();
+            continue;
+        }
+        const uint32_t token = prepare_wait(layout_->not_full);
+        if (layout_->shutdown.load(std::memory_order_acquire)) {
+            cancel_wait(layout_->not_full);
+            break;
+        }
+        if (!blocking_consumer_full() && has_free_slot()) {
+            cancel_wait(layout_->not_full);
+            continue;
+        }
+        wait(layout_->not_full, token, kBlockWaitSlice);
+        beat();
+        poll_peer();
+    }
+    if (t0) {
+        layout_->total_blocked_ns.fetch_add(steady_now_ns() - t0, std::memory_order_relaxed);
+    }
+    if (!reserved) return {};
+
+    ShmSlot s;
+    s.data = slot_data(slot);
+    s.capacity = slot_samples_;
+    s.index = slot;
+    return s;
+}
+
+void ShmQueue::push(uint32_t index, uint32_t pid, const ShmDescriptor& desc) {
+    // Single producer: the cell at enqueue_pos is free once its previous
+    // occupant was popped (a lane never holds more than slot_count frames)
+    ShmLane& l = lane(index);
+    const uint64_t pos = l.enqueue_pos.load(std::memory_order_relaxed);
+    ShmCell& cell = l.cells()[pos & mask_];
+    for (uint32_t spin = 1; cell.seq.load(std::memory_order_acquire) != pos; ++spin) {
+        cpu_relax();
+        // A consumer that died inside pop() leaves the cell claimed until
+        // it is detached; that also empties the lane
+        if ((spin & 1023) == 0) {
+            poll_peer();
+            if (l.pid.load(std::memory_order_acquire) != pid) return;
+        }
+    }
+    cell.desc = desc;
+    cell.seq.store(pos + 1, std::memory_order_release);
+    l.enqueue_pos.store(pos + 1, std::memory_order_relaxed);
+    l.enqueued.fetch_add(1, std::memory_order_relaxed);
+    notify_all(l.not_empty);
+}
+
+bool ShmQueue::publish(const ShmSlot& slot, const Frame& meta) {
+    assert(producer_ && slot && "publish() needs a reserved slot");
+    const size_t count = static_cast<size_t>(meta.channel_count) * meta.samples_per_channel;
+    if (count > slot.capacity) {
+        cancel(slot);
+        layout_->total_dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    ShmDescriptor d;
+    d.sequence            = meta.sequence;
+    d.producer_ts_ns      = meta.producer_ts_ns;
+    d.first_sample_index  = meta.first_sample_index;
+    d.sample_rate_hz      = meta.sample_rate_hz;
+    d.channel_count       = meta.channel_count;
+    d.samples_per_channel = meta.samples_per_channel;
+    d.flags               = meta.flags;
+    d.slot                = slot.index;
+    d.trace               = meta.trace;
+
+    // Pick the consumers this frame goes to, applying per-consumer depth
+    uint32_t targets = 0;
+    uint32_t pids[kMaxConsumers];
+    for (uint32_t i = 0; i < max_consumers_; ++i) {
+        ShmLane& l = lane(i);
+        pids[i] = l.pid.load(std::memory_order_acquire);
+        if (!l.active()) continue;
+        const uint32_t depth = l.depth.load(std::memory_order_relaxed);
+        if (depth > 0 && l.size() >= depth) {
+            const auto policy = static_cast<BackpressurePolicy>(
+                l.policy.load(std::memory_order_relaxed));
+            if (policy == BackpressurePolicy::DropLatest) {
+                l.dropped.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+            if (policy == BackpressurePolicy::DropOldest) evict_oldest(i);
+            // Block / Credit: reserve() waited for room
+        }
+        targets |= 1u << i;
+    }
+
+    // References first: a consumer may release its frame before the
+    // producer has pushed the last descriptor
+    layout_->refs()[slot.index].store(targets, std::memory_order_release);
+    for (uint32_t i = 0; i < max_consumers_; ++i) {
+        if (targets & (1u << i)) push(i, pids[i], d);
+    }
+    layout_->producer_heartbeat.fetch_add(1, std::memory_order_relaxed);
+    layout_->total_published.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+void ShmQueue::cancel(const ShmSlot& slot) {
+    layout_->refs()[slot.index].store(0, std::memory_order_release);
+}
+
+bool ShmQueue::enqueue(Frame&& item) {
+    ShmSlot slot = reserve(item.data_count());
+    if (!slot) return false;
+    std::memcpy(slot.data, item.data(), item.data_count() * sizeof(int16_t));
+    return publish(slot, item);
+}
+
+// ---- Consumer ----
+
+void ShmQueue::SlotRef::on_release() noexcept {
+    queue->release_slot(slot);
+}
+
+void ShmQueue::release_slot(uint32_t slot) {
+    const uint32_t bit = 1u << lane_;
+    lane(lane_).heartbeat.fetch_add(1, std::memory_order_relaxed);
+    // Only the last holder's release makes the slot free for the producer
+    if (layout_->refs()[slot].fetch_and(~bit, std::memory_order_acq_rel) == bit) {
+        notify_all(layout_->not_full);
+    }
+}
+
+std::optional<Frame> ShmQueue::try_pop() {
+    ShmLane& own = lane(lane_);
+    ShmDescriptor d;
+    if (!own.pop(mask_, d)) return std::nullopt;
+    own.heartbeat.fetch_add(1, std::memory_order_relaxed);
+    // A blocking producer may be waiting for this lane to drop below its depth
+    if (lane_depth_ > 0 && is_blocking(policy_)) notify_all(layout_->not_full);
+
+    const size_t count = static_cast<size_t>(d.channel_count) * d.samples_per_channel;
+    if (d.slot >= slot_count_ || count > slot_samples_) {
+        // Descriptors come from the producer's side of the region
+        spdlog::error("ShmQueue: corrupt descriptor (slot {}, {} samples), skipped",
+                      d.slot, count);
+        return std::nullopt;
+    }
+    Frame f = Frame::make_borrowed(slot_data(d.slot), count, &slot_refs_[d.slot]);
+    f.sequence            = d.sequence;
+    f.producer_ts_ns      = d.producer_ts_ns;
+    f.channel_count       = d.channel_count;
+    f.samples_per_channel = d.samples_per_channel;
+    f.sample_rate_hz      = d.sample_rate_hz;
+    f.first_sample_index  = d.first_sample_index;
+    f.flags               = d.flags;
+    f.trace               = d.trace;
+    return f;
+}
+
+std::optional<Frame> ShmQueue::dequeue() {
+    assert(!producer_ && "dequeue() on the producer side");
+    if (auto f = try_pop()) return f;
+    poll_peer();
+    return std::nullopt;
+}
+
+std::optional<Frame> ShmQueue::dequeue_wait(std::chrono::nanoseconds timeout) {
+    assert(!producer_ && "dequeue_wait() on the producer side");
+    if (auto f = try_pop()) return f;
+
+    ShmLane& own = lane(lane_);
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    for (;;) {
+        const uint32_t token = prepare_wait(own.not_empty);
+        if (auto f = try_pop()) {
+            cancel_wait(own.not_empty);
+            return f;
+        }
+        const auto remaining = deadline - std::chrono::steady_clock::now();
+        if (is_shutdown() || remaining.count() <= 0) {
+            cancel_wait(own.not_empty);
+            return std::nullopt;
+        }
+        // Wake up at least every liveness interval to notice a dead producer
+        wait(own.not_empty, token,
+             std::min<std::chrono::nanoseconds>(
+                 std::chrono::duration_cast<std::chrono::nanoseconds>(remaining),
+                 kLivenessInterval));
+        beat();
+        poll_peer();
+    }
+}
+
+size_t ShmQueue::dequeue_bulk(std::vector<Frame>& out, size_t max_items) {
+    assert(!producer_ && "dequeue_bulk() on the producer side");
+    size_t n = 0;
+    while (n < max_items) {
+        auto f = try_pop();
+        if (!f) break;
+        out.push_back(std::move(*f));
+        ++n;
+    }
+    if (n == 0) poll_peer();
+    return n;
+}
+
+// ---- State / telemetry ----
+
+size_t ShmQueue::capacity() const {
+    return slot_count_;
+}
+
+size_t ShmQueue::size() const {
+    if (!producer_) return static_cast<size_t>(lane(lane_).size());
+    uint64_t longest = 0;
+    for (uint32_t i = 0; i < max_consumers_; ++i) {
+        longest = std::max(longest, lane(i).size());
+    }
+    return static_cast<size_t>(longest);
+}
+
+double ShmQueue::fill_ratio() const {
+    return static_cast<double>(size()) / static_cast<double>(capacity());
+}
+
+bool ShmQueue::empty() const { return size() == 0; }
+bool ShmQueue::full() const { return size() >= capacity(); }
+
+uint32_t ShmQueue::slots_in_use() const {
+    uint32_t n = 0;
+    for (uint32_t i = 0; i < slot_count_; ++i) {
+        if (layout_->refs()[i].load(std::memory_order_relaxed) != 0) ++n;
+    }
+    return n;
+}
+
+uint32_t ShmQueue::slots_borrowed() const {
+    if (!slot_refs_) return 0;
+    uint32_t n = 0;
+    for (uint32_t i = 0; i < slot_count_; ++i) {
+        if (slot_refs_[i].use_count() > 0) ++n;
+    }
+    return n;
+}
+
+uint64_t ShmQueue::total_enqueued() const {
+    if (!producer_) return lane(lane_).enqueued.load(std::memory_order_relaxed);
+    return layout_->total_published.load(std::memory_order_relaxed);
+}
+
+uint64_t ShmQueue::total_dropped() const {
+    uint64_t n = layout_->total_dropped.load(std::memory_order_relaxed);
+    if (!producer_) return n + lane(lane_).dropped.load(std::memory_order_relaxed);
+    for (uint32_t i = 0; i < max_consumers_; ++i) {
+        n += lane(i).dropped.load(std::memory_order_relaxed);
+    }
+    return n;
+}
+
+uint64_t ShmQueue::total_blocked_ns() const {
+    return layout_->total_blocked_ns.load(std::memory_order_relaxed);
+}
+
+bool ShmQueue::consumer_attached() const {
+    return consumers_attached() > 0;
+}
+
+uint32_t ShmQueue::consumers_attached() const {
+    uint32_t n = 0;
+    for (uint32_t i = 0; i < max_consumers_; ++i) {
+        if (is_attached(lane(i).pid.load(std::memory_order_acquire))) ++n;
+    }
+    return n;
+}
+
+uint64_t ShmQueue::consumer_detaches() const {
+    return layout_->consumer_detaches.load(std::memory_order_relaxed);
+}
+
+void ShmQueue::set_source_drops(uint64_t total) {
+    layout_->source_drops.store(total, std::memory_order_relaxed);
+}
+
+uint64_t ShmQueue::source_drops() const {
+    return layout_->source_drops.load(std::memory_order_relaxed);
+}
+
+bool ShmQueue::is_shutdown() const {
+    if (layout_->shutdown.load(std::memory_order_acquire) != 0) return true;
+    return !producer_ && lane(lane_).closed.load(std::memory_order_acquire) != 0;
+}
+
+void ShmQueue::shutdown() {
+    if (!producer_) {
+        // Only this consumer stops; the producer stops delivering to it
+        // and no longer waits for it
+        lane(lane_).closed.store(1, std::memory_order_release);
+        notify_all(lane(lane_).not_empty);
+        notify_all(layout_->not_full);
+        return;
+    }
+    layout_->shutdown.store(1, std::memory_order_release);
+    for (uint32_t i = 0; i < max_consumers_; ++i) {
+        notify_all(lane(i).not_empty);
+    }
+    notify_all(layout_->not_full);
+}
+
+} // namespace grebe
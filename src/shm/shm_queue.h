@@ -0,0 +1,260 @@
+#pragma once
+
+// ShmQueue — IQueue<Frame> over a shared memory region (Phase 14, RDD §5.3)
+// Fixed payload slot pool + one descriptor ring per consumer (fan-out, Phase 15);
+// Borrowed frames on the reader side.
+
+#include "grebe/queue.h"
+#include "grebe/frame.h"
+#include "shm/peer_process.h"
+#include "shm/shm_region.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+
+namespace grebe {
+
+struct ShmQueueLayout;
+struct ShmLane;
+struct ShmDescriptor;
+
+/// Geometry of a shared-memory queue, fixed when the region is created.
+struct ShmQueueConfig {
+    /// Payload slots, and descriptor ring capacity per consumer (rounded up
+    /// to a power of two).
+    uint32_t slot_count = 64;
+    /// Largest frame a slot holds, in int16_t samples (all channels).
+    size_t   slot_samples = 8 * 65536;
+    /// Policy of consumers that do not choose their own.
+    BackpressurePolicy policy = BackpressurePolicy::DropOldest;
+    /// Consumers that may be attached at once (fan-out), 1..kMaxConsumers.
+    uint32_t max_consumers = 1;
+};
+
+/// Per-consumer delivery settings, chosen when a consumer attaches.
+struct ShmConsumerOptions {
+    /// Backpressure policy for this consumer (unset = the queue's default).
+    std::optional<BackpressurePolicy> policy;
+    /// Frames queued for this consumer before its policy applies
+    /// (0 = bounded only by the shared slot pool; for DropLatest,
+    /// slot_count / max_consumers).
+    uint32_t depth = 0;
+};
+
+/// A payload slot reserved by the producer, filled in place and then
+/// published (ShmQueue::publish) or returned (ShmQueue::cancel).
+struct ShmSlot {
+    int16_t* data = nullptr;
+    size_t   capacity = 0;  ///< samples
+    uint32_t index = 0;
+
+    explicit operator bool() const { return data != nullptr; }
+};
+
+/// Single-producer queue of frames to one or more consumer processes.
+///
+/// The region holds a header, a pool of fixed-size payload slots and one
+/// lane per possible consumer: a ring of frame descriptors (Vyukov sequence
+/// cells, as in LockFreeQueue) with its own positions, policy and
+/// telemetry. Nothing is allocated after construction, on either side.
+///
+/// Producer process (create()): enqueue() copies the frame into a free slot
+/// and publishes it. Writers that can produce samples in place use
+/// reserve() / publish() instead and never copy. publish() writes the
+/// payload once whatever the number of consumers (FR-11): each attached
+/// consumer gets a descriptor referencing the same slot. Frames published
+/// while no consumer is attached are discarded.
+///
+/// Each slot carries a reference mask with one bit per consumer holding it
+/// (queued or borrowed); the slot is recycled once every bit is cleared.
+///
+/// Consumer process (open()): takes a free lane with its own policy and
+/// depth. dequeue() returns Borrowed frames that point into the slot; the
+/// consumer's reference goes once the last frame referencing it (including
+/// share() copies) is destroyed, from any thread. Policies per consumer:
+///   - DropLatest: at its depth, new frames skip this consumer. Its depth
+///     defaults to an even share of the slot pool, so a stalled consumer
+///     keeps at most that many slots queued.
+///   - DropOldest: at its depth, or when the pool runs out of slots, its
+///     oldest queued frame is dropped.
+///   - Block / Credit: the producer waits while this consumer is at its
+///     depth, or while no slot is free.
+/// A lossy consumer never stalls the producer, unless it keeps every slot
+/// borrowed; with no blocking consumer a frame that finds no slot is
+/// dropped.
+///
+/// Waiting uses a futex in the shared header on Linux (polling elsewhere);
+/// the hot path issues a wake syscall only while the other side is parked.
+///
+/// Crash detection (NFR-06): each side records its pid in the region and
+/// bumps a heartbeat counter as it makes progress or waits. At most every
+/// 100 ms — from reserve() on the producer, from the dequeue calls while
+/// the lane is empty on a consumer — a side compares the peer's heartbeat
+/// with the last one it saw, and only if it has not moved asks the OS
+/// whether the peer still runs (PeerProcess). A dead consumer is detached
+/// by the producer: its lane is drained and its references on borrowed
+/// slots dropped, so the others keep running. A dead producer shuts the
+/// queue down, so consumers drain what was queued and see end of stream.
+class ShmQueue final : public IQueue<Frame> {
+public:
+    /// Upper bound for ShmQueueConfig::max_consumers.
+    static constexpr uint32_t kMaxConsumers = 16;
+
+    /// Producer side: create the region @p name (empty = anonymous memfd)
+    /// sized for @p config. Throws std::runtime_error on failure.
+    static std::unique_ptr<ShmQueue> create(const std::string& name,
+                                            const ShmQueueConfig& config = {});
+
+    /// Consumer side: map a queue created by another process and attach as
+    /// one of its consumers. Throws std::runtime_error if it does not exist,
+    /// is not a ShmQueue (or its layout does not fit the mapping), or
+    /// already has max_consumers consumers.
+    static std::unique_ptr<ShmQueue> open(const std::string& name,
+                                          const ShmConsumerOptions& options = {});
+
+    /// Consumer side: use an already mapped queue region, e.g. an anonymous
+    /// one received through a session handshake (ShmRegion::adopt).
+    static std::unique_ptr<ShmQueue> open(std::unique_ptr<ShmRegion> region,
+                                          const ShmConsumerOptions& options = {});
+
+    /// Bytes of shared memory a queue with @p config occupies.
+    static size_t region_size(const ShmQueueConfig& config);
+
+    ~ShmQueue() override;
+
+    // ---- Producer: zero-copy write ----
+
+    /// Reserve a free slot for @p samples samples, applying the consumers'
+    /// policies when none is free. Empty result: dropped (counted), frame
+    /// too large for a slot, or shutdown.
+    ShmSlot reserve(size_t samples);
+
+    /// Publish @p slot carrying @p meta's metadata and @p meta.channel_count
+    /// x samples_per_channel samples (meta's own data is not read) to every
+    /// attached consumer.
+    bool publish(const ShmSlot& slot, const Frame& meta);
+
+    /// Return a reserved slot without publishing it.
+    void cancel(const ShmSlot& slot);
+
+    // ---- IQueue<Frame> ----
+    // Consumer side: this consumer's lane. Producer side: size() is the
+    // longest lane, total_enqueued() counts published frames, and
+    // total_dropped() adds every consumer's drops to the producer's own.
+    bool enqueue(Frame&& item) override;
+    std::optional<Frame> dequeue() override;
+    std::optional<Frame> dequeue_wait(std::chrono::nanoseconds timeout) override;
+    size_t dequeue_bulk(std::vector<Frame>& out, size_t max_items) override;
+
+    size_t   capacity()   const override;
+    size_t   size()       const override;
+    double   fill_ratio() const override;
+    bool     empty()      const override;
+    bool     full()       const override;
+
+    uint64_t total_enqueued()   const override;
+    uint64_t total_dropped()    const override;
+    uint64_t total_blocked_ns() const override;
+
+    /// Producer side: end the stream for every consumer. Consumer side:
+    /// stop receiving; the producer skips this consumer from then on.
+    void shutdown() override;
+    /// The producer shut down, or this consumer did.
+    bool is_shutdown() const;
+
+    /// Mark this side alive while it has nothing to send or receive (e.g.
+    /// from a command polling loop). Thread-safe; no syscall.
+    void heartbeat();
+
+    /// At least one consumer has the queue open.
+    bool consumer_attached() const;
+    /// Consumers that have the queue open.
+    uint32_t consumers_attached() const;
+    /// Consumers detached by the producer after they exited without closing.
+    uint64_t consumer_detaches() const;
+
+    /// Drops upstream of the queue reported by the producer (e.g. its own
+    /// source ring overruns), for the consumer's telemetry.
+    void set_source_drops(uint64_t total);
+    uint64_t source_drops() const;
+
+    // ---- Introspection ----
+    const ShmRegion& region() const { return *region_; }
+    uint32_t slot_count() const { return slot_count_; }
+    size_t   slot_samples() const { return slot_samples_; }
+    uint32_t max_consumers() const { return max_consumers_; }
+    /// Consumer side: this consumer's policy; producer side: the default.
+    BackpressurePolicy policy() const { return policy_; }
+    /// Slots not free (reserved, queued or still borrowed by a consumer).
+    uint32_t slots_in_use() const;
+    /// Consumer: slots still referenced by frames this side handed out. The
+    /// queue must not be destroyed before this drops to zero.
+    uint32_t slots_borrowed() const;
+
+private:
+    /// Consumer-side reference on one payload slot; drops this consumer's
+    /// reference when the last Borrowed frame using it goes away.
+    class SlotRef final : public FramePayload {
+    public:
+        ShmQueue* queue = nullptr;
+        uint32_t  slot = 0;
+    protected:
+        void on_release() noexcept override;
+    };
+
+    ShmQueue(std::unique_ptr<ShmRegion> region, bool producer,
+             const ShmConsumerOptions& options = {});
+
+    ShmLane& lane(uint32_t index) const;
+
+    // Liveness
+    void beat();
+    void poll_peer();
+    void check_consumers();
+    void check_producer();
+    void detach_consumer(uint32_t index, uint32_t pid);
+
+    // Producer
+    bool try_reserve_free(uint32_t& slot);
+    bool has_free_slot() const;
+    bool blocking_consumer_full() const;
+    bool blocking_consumer_attached() const;
+    bool make_room();
+    bool evict_oldest(uint32_t index);
+    void drain_lane(uint32_t index);
+    void push(uint32_t index, uint32_t pid, const ShmDescriptor& desc);
+
+    // Consumer
+    void release_slot(uint32_t slot);
+    std::optional<Frame> try_pop();
+
+    int16_t* slot_data(uint32_t slot) const;
+
+    std::unique_ptr<ShmRegion> region_;
+    ShmQueueLayout* layout_ = nullptr;  // header at the start of the region
+    const bool producer_;
+
+    uint32_t slot_count_ = 0;
+    uint64_t mask_ = 0;
+    size_t   slot_samples_ = 0;
+    uint32_t max_consumers_ = 0;
+    BackpressurePolicy policy_ = BackpressurePolicy::DropOldest;
+
+    uint32_t next_slot_ = 0;                 // producer: free-slot scan cursor
+    std::unique_ptr<SlotRef[]> slot_refs_;   // consumer: one payload per slot
+    uint32_t lane_ = 0;                      // consumer: own lane
+    uint32_t lane_depth_ = 0;                // consumer: own depth
+
+    // Liveness of the other side(s)
+    uint32_t self_pid_ = 0;
+    PeerProcess peer_;                                  // consumer: the producer
+    uint64_t    peer_heartbeat_ = 0;
+    std::unique_ptr<PeerProcess[]> consumers_;          // producer: one per lane
+    std::unique_ptr<uint64_t[]>    consumer_heartbeats_;
+    uint64_t    next_liveness_ns_ = 0;
+};
+
+} // namespace grebe
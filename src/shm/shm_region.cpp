@@ -0,0 +1,191 @@
+#include "shm/shm_region.h"
+
+#include <spdlog/spdlog.h>
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace grebe {
+
+namespace {
+
+/// POSIX shm names are "/name"; Win32 mapping names take no slash.
+std::string os_name(const std::string& name) {
+#ifdef _WIN32
+    return (!name.empty() && name.front() == '/') ? name.substr(1) : name;
+#else
+    return (!name.empty() && name.front() != '/') ? "/" + name : name;
+#endif
+}
+
+std::string last_error() {
+#ifdef _WIN32
+    return "error " + std::to_string(GetLastError());
+#else
+    return std::strerror(errno);
+#endif
+}
+
+} // namespace
+
+std::unique_ptr<ShmRegion> ShmRegion::create(const std::string& name, size_t size) {
+    if (size == 0) {
+        throw std::runtime_error("ShmRegion: size must be non-zero");
+    }
+    std::unique_ptr<ShmRegion> r(new ShmRegion);
+    r->name_ = os_name(name);
+    r->size_ = size;
+
+#ifdef _WIN32
+    if (r->name_.empty()) {
+        throw std::runtime_error("ShmRegion: anonymous regions are not supported on Windows");
+    }
+    const auto size64 = static_cast<unsigned long long>(size);
+    r->mapping_handle_ = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+                                            static_cast<DWORD>(size64 >> 32),
+                                            static_cast<DWORD>(size64 & 0xFFFFFFFFull),
+                                            r->name_.c_str());
+    if (!r->mapping_handle_) {
+        throw std::runtime_error("ShmRegion: CreateFileMapping failed (" + last_error() +
+                                 "): " + r->name_);
+    }
+    if (GetLastError() == ERROR_ALREADY_EXISTS) {
+        // Win32 mappings cannot be replaced while open elsewhere
+        throw std::runtime_error("ShmRegion: mapping already exists: " + r->name_);
+    }
+    r->owner_ = true;
+#else
+    if (r->name_.empty()) {
+#ifdef __linux__
+        r->fd_ = memfd_create("grebe-shm", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+#endif
+        if (r->fd_ < 0) {
+            throw std::runtime_error("ShmRegion: memfd_create failed: " + last_error());
+        }
+    } else {
+        // Replace a stale object left behind by a crashed producer
+        shm_unlink(r->name_.c_str());
+        r->fd_ = shm_open(r->name_.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (r->fd_ < 0) {
+            throw std::runtime_error("ShmRegion: shm_open failed (" + last_error() +
+                                     "): " + r->name_);
+        }
+        r->owner_ = true;
+    }
+    if (ftruncate(r->fd_, static_cast<off_t>(size)) != 0) {
+        throw std::runtime_error("ShmRegion: ftruncate failed (" + last_error() + ")");
+    }
+#ifdef __linux__
+    // Size is final: whoever receives the fd may rely on it
+    if (r->name_.empty() &&
+        fcntl(r->fd_, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL) != 0) {
+        throw std::runtime_error("ShmRegion: sealing memfd failed: " + last_error());
+    }
+#endif
+#endif
+
+    r->map("create");
+    spdlog::debug("ShmRegion: created {} ({} bytes)",
+                  r->name_.empty() ? "<anonymous>" : r->name_, size);
+    return r;
+}
+
+std::unique_ptr<ShmRegion> ShmRegion::open(const std::string& name) {
+    std::unique_ptr<ShmRegion> r(new ShmRegion);
+    r->name_ = os_name(name);
+    if (r->name_.empty()) {
+        throw std::runtime_error("ShmRegion: open requires a name");
+    }
+
+#ifdef _WIN32
+    r->mapping_handle_ = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, r->name_.c_str());
+    if (!r->mapping_handle_) {
+        throw std::runtime_error("ShmRegion: OpenFileMapping failed (" + last_error() +
+                                 "): " + r->name_);
+    }
+#else
+    r->fd_ = shm_open(r->name_.c_str(), O_RDWR, 0);
+    if (r->fd_ < 0) {
+        throw std::runtime_error("ShmRegion: shm_open failed (" + last_error() +
+                                 "): " + r->name_);
+    }
+    struct stat st{};
+    if (fstat(r->fd_, &st) != 0 || st.st_size <= 0) {
+        throw std::runtime_error("ShmRegion: empty or unreadable object: " + r->name_);
+    }
+    r->size_ = static_cast<size_t>(st.st_size);
+#endif
+
+    r->map("open");
+    return r;
+}
+
+#ifndef _WIN32
+std::unique_ptr<ShmRegion> ShmRegion::adopt(int fd) {
+    if (fd < 0) {
+        throw std::runtime_error("ShmRegion: adopt needs a valid fd");
+    }
+    std::unique_ptr<ShmRegion> r(new ShmRegion);
+    r->fd_ = fd;
+#ifdef __linux__
+    const int seals = fcntl(fd, F_GET_SEALS);
+    if (seals < 0 || !(seals & F_SEAL_SHRINK)) {
+        throw std::runtime_error("ShmRegion: received region is not sealed against shrinking");
+    }
+#endif
+    struct stat st{};
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        throw std::runtime_error("ShmRegion: received region is empty or unreadable");
+    }
+    r->size_ = static_cast<size_t>(st.st_size);
+    r->map("adopt");
+    return r;
+}
+#endif
+
+void ShmRegion::map(const char* what) {
+#ifdef _WIN32
+    data_ = MapViewOfFile(mapping_handle_, FILE_MAP_ALL_ACCESS, 0, 0, size_);
+    if (!data_) {
+        throw std::runtime_error(std::string("ShmRegion: MapViewOfFile failed on ") + what +
+                                 " (" + last_error() + "): " + name_);
+    }
+    if (size_ == 0) {
+        MEMORY_BASIC_INFORMATION info{};
+        VirtualQuery(data_, &info, sizeof(info));
+        size_ = info.RegionSize;
+    }
+#else
+    void* p = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (p == MAP_FAILED) {
+        throw std::runtime_error(std::string("ShmRegion: mmap failed on ") + what +
+                                 " (" + last_error() + "): " + name_);
+    }
+    data_ = p;
+#endif
+}
+
+ShmRegion::~ShmRegion() {
+#ifdef _WIN32
+    if (data_) UnmapViewOfFile(data_);
+    if (mapping_handle_) CloseHandle(mapping_handle_);
+#else
+    if (data_) munmap(data_, size_);
+    if (fd_ >= 0) ::close(fd_);
+    if (owner_ && !name_.empty()) shm_unlink(name_.c_str());
+#endif
+}
+
+} // namespace grebe
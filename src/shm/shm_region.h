@@ -0,0 +1,74 @@
+#pragma once
+
+// ShmRegion — Fixed-size shared memory mapping (Phase 14)
+// POSIX shm_open / Linux memfd_create, Win32 CreateFileMapping.
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace grebe {
+
+/// A shared memory object mapped read/write into this process.
+///
+/// The creator fixes the size once (NFR-08: nothing grows at runtime) and
+/// unlinks a named object again on destruction; other processes open() the
+/// existing object and map it at its full size. The mapping stays valid
+/// until this ShmRegion is destroyed, even after the name is unlinked.
+/// Anonymous regions leave nothing behind when their processes exit; they
+/// are sealed against resizing so a peer that receives the descriptor
+/// (adopt()) cannot be hit by SIGBUS from a shrunk mapping.
+/// Failures throw std::runtime_error.
+class ShmRegion {
+public:
+    /// Create a zero-filled region of @p size bytes. Any existing object
+    /// named @p name is replaced. An empty @p name creates an anonymous
+    /// region (Linux memfd, sealed against shrink/grow), reachable from other
+    /// processes only via fd().
+    static std::unique_ptr<ShmRegion> create(const std::string& name, size_t size);
+
+    /// Map the existing region @p name created by another process.
+    static std::unique_ptr<ShmRegion> open(const std::string& name);
+
+#ifndef _WIN32
+    /// Map an anonymous region received from its creator (e.g. over a Unix
+    /// socket) and take ownership of @p fd. On Linux the memfd must carry
+    /// the shrink seal.
+    static std::unique_ptr<ShmRegion> adopt(int fd);
+#endif
+
+    ~ShmRegion();
+
+    ShmRegion(const ShmRegion&) = delete;
+    ShmRegion& operator=(const ShmRegion&) = delete;
+
+    void*  data() const { return data_; }
+    size_t size() const { return size_; }
+    /// Object name as passed to the OS (POSIX: leading '/'); empty if anonymous.
+    const std::string& name() const { return name_; }
+    /// True for the creating side, which unlinks the name on destruction.
+    bool is_owner() const { return owner_; }
+
+#ifndef _WIN32
+    /// File descriptor of the shared memory object.
+    int fd() const { return fd_; }
+#endif
+
+private:
+    ShmRegion() = default;
+
+    /// Map fd_ / mapping_handle_ (size_ bytes, or the whole object if 0).
+    void map(const char* what);
+
+    std::string name_;
+    bool owner_ = false;
+    void* data_ = nullptr;
+    size_t size_ = 0;
+#ifdef _WIN32
+    void* mapping_handle_ = nullptr;  // HANDLE
+#else
+    int fd_ = -1;
+#endif
+};
+
+} // namespace grebe
@@ -0,0 +1,382 @@
+#include "shm/shm_session.h"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace grebe {
+
+#ifndef _WIN32
+
+namespace {
+
+constexpr uint32_t kSessionMagic   = 0x53534247;  // 'GBSS' little-endian
+constexpr uint32_t kSessionVersion = 1;
+/// A connected peer has this long to complete its half of the handshake
+constexpr int      kHandshakeTimeoutMs = 2000;
+
+#ifdef MSG_NOSIGNAL
+constexpr int kSendFlags = MSG_NOSIGNAL;  // a vanished peer must not raise SIGPIPE
+#else
+constexpr int kSendFlags = 0;
+#endif
+
+enum SessionStatus : uint32_t {
+    kSessionOk       = 0,
+    kSessionBusy     = 1,  ///< current session has no free consumer lane
+    kSessionMismatch = 2,  ///< proposed channel count differs
+    kSessionFailed   = 3,  ///< producer could not create the queue
+};
+
+struct SessionHello {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t channels;
+    uint32_t slot_count;
+    uint64_t slot_samples;
+};
+
+struct SessionReply {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t status;
+    uint32_t channels;
+    uint32_t slot_count;
+    uint32_t reserved;
+    uint64_t slot_samples;
+    uint64_t region_bytes;
+};
+
+struct FdGuard {
+    int fd;
+    ~FdGuard() { if (fd >= 0) ::close(fd); }
+};
+
+const char* status_text(uint32_t status) {
+    switch (status) {
+    case kSessionBusy:     return "busy (all consumer lanes in use)";
+    case kSessionMismatch: return "geometry mismatch";
+    case kSessionFailed:   return "producer failed to create the queue";
+    default:               return "unknown status";
+    }
+}
+
+void set_cloexec(int fd) {
+    fcntl(fd, F_SETFD, fcntl(fd, F_GETFD) | FD_CLOEXEC);
+}
+
+/// The other end of @p fd runs as our user. An abstract socket has no file
+/// permissions: without this, any local user could take a session (and a
+/// writable region), or squat on the name and hand out a crafted one.
+bool peer_is_same_user(int fd) {
+#ifdef SO_PEERCRED
+    struct ucred cred{};
+    socklen_t len = sizeof(cred);
+    if (::getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &cred, &len) != 0) return false;
+    return cred.uid == ::getuid();
+#else
+    uid_t uid = 0;
+    gid_t gid = 0;
+    if (::getpeereid(fd, &uid, &gid) != 0) return false;
+    return uid == ::getuid();
+#endif
+}
+
+/// '@name' = Linux abstract namespace (no file); anything else is a path.
+socklen_t make_address(const std::string& path, sockaddr_un& addr) {
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(addr.sun_path)) {
+        throw std::runtime_error("ShmSession: invalid socket path: " + path);
+    }
+    if (path.front() == '@') {
+#ifdef __linux__
+        std::memcpy(addr.sun_path + 1, path.data() + 1, path.size() - 1);
+        return static_cast<socklen_t>(offsetof(sockaddr_un, sun_path) + path.size());
+#else
+        throw std::runtime_error("ShmSession: abstract socket names need Linux: " + path);
+#endif
+    }
+    std::memcpy(addr.sun_path, path.data(), path.size());
+    return static_cast<socklen_t>(offsetof(sockaddr_un, sun_path) + path.size() + 1);
+}
+
+bool wait_readable(int fd, int timeout_ms) {
+    struct pollfd p{fd, POLLIN, 0};
+    return ::poll(&p, 1, timeout_ms) > 0;
+}
+
+/// Read exactly @p len bytes; the first read may carry an SCM_RIGHTS fd.
+bool recv_message(int fd, void* buf, size_t len, int* received_fd) {
+    auto* p = static_cast<char*>(buf);
+    size_t got = 0;
+    while (got < len) {
+        if (!wait_readable(fd, kHandshakeTimeoutMs)) return false;
+
+        struct iovec iov{p + got, len - got};
+        alignas(struct cmsghdr) char control[CMSG_SPACE(sizeof(int))];
+        struct msghdr msg{};
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        if (received_fd) {
+            msg.msg_control = control;
+            msg.msg_controllen = sizeof(control);
+        }
+#ifdef MSG_CMSG_CLOEXEC
+        const ssize_t n = ::recvmsg(fd, &msg, MSG_CMSG_CLOEXEC);
+#else
+        const ssize_t n = ::recvmsg(fd, &msg, 0);
+#endif
+        if (n <= 0) return false;
+
+        if (received_fd) {
+            for (cmsghdr* c = CMSG_FIRSTHDR(&msg); c; c = CMSG_NXTHDR(&msg, c)) {
+                if (c->cmsg_level == SOL_SOCKET && c->cmsg_type == SCM_RIGHTS) {
+                    std::memcpy(received_fd, CMSG_DATA(c), sizeof(int));
+                    set_cloexec(*received_fd);
+                }
+            }
+        }
+        got += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+/// Send @p len bytes, attaching @p fd (SCM_RIGHTS) unless it is -1.
+bool send_message(int sock, const void* buf, size_t len, int fd) {
+    struct iovec iov{const_cast<void*>(buf), len};
+    alignas(struct cmsghdr) char control[CMSG_SPACE(sizeof(int))];
+    struct msghdr msg{};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    if (fd >= 0) {
+        std::memset(control, 0, sizeof(control));
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+        cmsghdr* c = CMSG_FIRSTHDR(&msg);
+        c->cmsg_level = SOL_SOCKET;
+        c->cmsg_type = SCM_RIGHTS;
+        c->cmsg_len = CMSG_LEN(sizeof(int));
+        std::memcpy(CMSG_DATA(c), &fd, sizeof(int));
+    }
+    // Small message on a stream socket: sent whole or not at all in practice
+    return ::sendmsg(sock, &msg, kSendFlags) == static_cast<ssize_t>(len);
+}
+
+SessionReply make_reply(uint32_t status, uint32_t channels) {
+    SessionReply r{};
+    r.magic = kSessionMagic;
+    r.version = kSessionVersion;
+    r.status = status;
+    r.channels = channels;
+    return r;
+}
+
+} // namespace
+
+// ---- Producer ----
+
+ShmSessionServer::ShmSessionServer(const std::string& path, const ShmSessionLimits& limits)
+    : path_(path), limits_(limits) {
+    sockaddr_un addr;
+    const socklen_t addr_len = make_address(path_, addr);
+
+    listen_fd_ = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listen_fd_ < 0) {
+        throw std::runtime_error(std::string("ShmSessionServer: socket failed: ") +
+                                 std::strerror(errno));
+    }
+    set_cloexec(listen_fd_);
+    // Replace a socket file left behind by a crashed producer
+    if (path_.front() != '@') ::unlink(path_.c_str());
+    if (::bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), addr_len) != 0 ||
+        ::listen(listen_fd_, 4) != 0) {
+        const std::string err = std::strerror(errno);
+        ::close(listen_fd_);
+        listen_fd_ = -1;
+        throw std::runtime_error("ShmSessionServer: cannot listen on " + path_ + ": " + err);
+    }
+    spdlog::info("ShmSessionServer: listening on {}", path_);
+}
+
+ShmSessionServer::~ShmSessionServer() {
+    if (listen_fd_ >= 0) ::close(listen_fd_);
+    if (!path_.empty() && path_.front() != '@') ::unlink(path_.c_str());
+}
+
+std::unique_ptr<ShmQueue> ShmSessionServer::accept(std::chrono::milliseconds timeout,
+                                                   const ShmQueue* current) {
+    if (!wait_readable(listen_fd_, static_cast<int>(timeout.count()))) return nullptr;
+    FdGuard conn{::accept(listen_fd_, nullptr, nullptr)};
+    if (conn.fd < 0) return nullptr;
+    set_cloexec(conn.fd);
+    if (!peer_is_same_user(conn.fd)) {
+        spdlog::warn("ShmSessionServer: refused connection from another user");
+        return nullptr;
+    }
+
+    SessionHello hello{};
+    if (!recv_message(conn.fd, &hello, sizeof(hello), nullptr) ||
+        hello.magic != kSessionMagic || hello.version != kSessionVersion) {
+        spdlog::warn("ShmSessionServer: bad or incomplete session request, ignored");
+        return nullptr;
+    }
+
+    if (hello.channels != 0 && hello.channels != limits_.channels) {
+        spdlog::warn("ShmSessionServer: refused session ({} channels requested, sending {})",
+                     hello.channels, limits_.channels);
+        const SessionReply r = make_reply(kSessionMismatch, limits_.channels);
+        send_message(conn.fd, &r, sizeof(r), -1);
+        return nullptr;
+    }
+    if (current && current->consumers_attached() > 0 && !current->is_shutdown()) {
+        // Session in progress: join it while it has a free consumer lane
+        // (fan-out; the geometry is already fixed)
+        if (current->consumers_attached() >= current->max_consumers()) {
+            spdlog::info("ShmSessionServer: refused session ({} consumer(s) attached)",
+                         current->consumers_attached());
+            const SessionReply r = make_reply(kSessionBusy, limits_.channels);
+            send_message(conn.fd, &r, sizeof(r), -1);
+            return nullptr;
+        }
+        SessionReply r = make_reply(kSessionOk, limits_.channels);
+        r.slot_count   = current->slot_count();
+        r.slot_samples = current->slot_samples();
+        r.region_bytes = current->region().size();
+        if (send_message(conn.fd, &r, sizeof(r), current->region().fd())) {
+            spdlog::info("ShmSessionServer: consumer joined the current session");
+        }
+        return nullptr;
+    }
+
+    // Negotiate: the consumer's proposal within the producer's limits
+    ShmQueueConfig config = limits_.defaults;
+    if (hello.slot_count != 0) config.slot_count = hello.slot_count;
+    config.slot_count = std::clamp(config.slot_count, limits_.min_slot_count,
+                                   limits_.max_slot_count);
+    if (hello.slot_samples != 0) config.slot_samples = static_cast<size_t>(hello.slot_samples);
+    config.slot_samples = std::clamp(config.slot_samples, limits_.min_slot_samples,
+                                     std::max(limits_.min_slot_samples, limits_.max_slot_samples));
+
+    std::unique_ptr<ShmQueue> queue;
+    try {
+        queue = ShmQueue::create("", config);
+    } catch (const std::exception& e) {
+        spdlog::error("ShmSessionServer: {}", e.what());
+        const SessionReply r = make_reply(kSessionFailed, limits_.channels);
+        send_message(conn.fd, &r, sizeof(r), -1);
+        return nullptr;
+    }
+
+    SessionReply r = make_reply(kSessionOk, limits_.channels);
+    r.slot_count   = queue->slot_count();
+    r.slot_samples = queue->slot_samples();
+    r.region_bytes = queue->region().size();
+    if (!send_message(conn.fd, &r, sizeof(r), queue->region().fd())) {
+        spdlog::warn("ShmSessionServer: consumer went away during the handshake");
+        return nullptr;
+    }
+    spdlog::info("ShmSessionServer: session granted ({} ch, {} slots x {} samples)",
+                 r.channels, r.slot_count, r.slot_samples);
+    return queue;
+}
+
+// ---- Consumer ----
+
+std::unique_ptr<ShmQueue> shm_session_connect(const std::string& path,
+                                              const ShmSessionGeometry& request,
+                                              ShmSessionGeometry* granted,
+                                              const ShmConsumerOptions& options) {
+    sockaddr_un addr;
+    const socklen_t addr_len = make_address(path, addr);
+
+    FdGuard sock{::socket(AF_UNIX, SOCK_STREAM, 0)};
+    if (sock.fd < 0) {
+        throw std::runtime_error(std::string("ShmSession: socket failed: ") +
+                                 std::strerror(errno));
+    }
+    set_cloexec(sock.fd);
+    if (::connect(sock.fd, reinterpret_cast<sockaddr*>(&addr), addr_len) != 0) {
+        throw std::runtime_error("ShmSession: connect to " + path + " failed: " +
+                                 std::strerror(errno));
+    }
+    if (!peer_is_same_user(sock.fd)) {
+        throw std::runtime_error("ShmSession: " + path + " is served by another user");
+    }
+
+    SessionHello hello{};
+    hello.magic        = kSessionMagic;
+    hello.version      = kSessionVersion;
+    hello.channels     = request.channels;
+    hello.slot_count   = request.slot_count;
+    hello.slot_samples = request.slot_samples;
+    if (!send_message(sock.fd, &hello, sizeof(hello), -1)) {
+        throw std::runtime_error("ShmSession: sending request to " + path + " failed");
+    }
+
+    SessionReply reply{};
+    int region_fd = -1;
+    const bool ok = recv_message(sock.fd, &reply, sizeof(reply), &region_fd);
+    FdGuard region_guard{region_fd};
+    if (!ok || reply.magic != kSessionMagic || reply.version != kSessionVersion) {
+        throw std::runtime_error("ShmSession: no valid reply from " + path);
+    }
+    if (reply.status != kSessionOk) {
+        std::string reason = status_text(reply.status);
+        if (reply.status == kSessionMismatch) {
+            reason += ": producer sends " + std::to_string(reply.channels) + " channels, " +
+                      std::to_string(request.channels) + " requested";
+        }
+        throw std::runtime_error("ShmSession: " + path + " refused session: " + reason);
+    }
+    if (region_fd < 0) {
+        throw std::runtime_error("ShmSession: reply from " + path + " carried no region");
+    }
+
+    region_guard.fd = -1;  // owned by the region from here on
+    auto queue = ShmQueue::open(ShmRegion::adopt(region_fd), options);
+    if (granted) {
+        granted->channels     = reply.channels;
+        granted->slot_count   = queue->slot_count();
+        granted->slot_samples = queue->slot_samples();
+    }
+    return queue;
+}
+
+#else  // _WIN32
+
+ShmSessionServer::ShmSessionServer(const std::string& path, const ShmSessionLimits& limits)
+    : path_(path), limits_(limits) {
+    throw std::runtime_error("ShmSessionServer: fd passing is not supported on Windows "
+                             "(use a named queue)");
+}
+
+ShmSessionServer::~ShmSessionServer() = default;
+
+std::unique_ptr<ShmQueue> ShmSessionServer::accept(std::chrono::milliseconds,
+                                                   const ShmQueue*) {
+    return nullptr;
+}
+
+std::unique_ptr<ShmQueue> shm_session_connect(const std::string& path,
+                                              const ShmSessionGeometry&,
+                                              ShmSessionGeometry*,
+                                              const ShmConsumerOptions&) {
+    throw std::runtime_error("ShmSession: fd passing is not supported on Windows: " + path);
+}
+
+#endif
+
+} // namespace grebe
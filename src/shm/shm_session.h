@@ -0,0 +1,83 @@
+#pragma once
+
+// ShmSession — Shared-memory session setup over a Unix domain socket (Phase 14)
+// memfd handed over with SCM_RIGHTS; geometry negotiated per session.
+
+#include "shm/shm_queue.h"
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace grebe {
+
+/// Queue geometry as proposed by a consumer and granted by the producer.
+/// Zero fields in a proposal mean "producer's choice".
+struct ShmSessionGeometry {
+    uint32_t channels = 0;
+    uint32_t slot_count = 0;
+    uint64_t slot_samples = 0;  ///< per slot, all channels
+};
+
+/// What a producer is willing to grant.
+struct ShmSessionLimits {
+    uint32_t channels = 1;            ///< fixed: other proposals are refused
+    ShmQueueConfig defaults;          ///< geometry, policy, max_consumers
+    uint32_t min_slot_count = 2;
+    uint32_t max_slot_count = 256;
+    size_t   min_slot_samples = 1;    ///< largest frame the producer sends
+    size_t   max_slot_samples = 8 * 262144;
+};
+
+/// Producer end: listens on a Unix domain socket and hands accepted
+/// consumers an anonymous, sealed ShmQueue: a new one when no session is in
+/// progress, otherwise the current one while it has a free consumer lane
+/// (ShmQueueConfig::max_consumers, fan-out).
+///
+/// A session is set up in one exchange: the consumer sends its proposed
+/// geometry, the producer clamps it to its limits, creates the queue and
+/// replies with the granted geometry and the memfd (SCM_RIGHTS). The
+/// connection is closed afterwards; liveness is tracked in the queue itself.
+/// Nothing is left in the file system: the memfd disappears with its last
+/// mapping, and a socket path starting with '@' uses the Linux abstract
+/// namespace (otherwise the path is unlinked on destruction).
+/// Both ends accept only a peer running as the same user (SO_PEERCRED):
+/// an abstract socket has no file permissions of its own.
+///
+/// POSIX only; the constructor throws std::runtime_error on Windows.
+class ShmSessionServer {
+public:
+    ShmSessionServer(const std::string& path, const ShmSessionLimits& limits);
+    ~ShmSessionServer();
+
+    ShmSessionServer(const ShmSessionServer&) = delete;
+    ShmSessionServer& operator=(const ShmSessionServer&) = delete;
+
+    /// Serve one consumer if one connects within @p timeout (0 = just poll).
+    /// Returns a new session's queue (producer side), or nullptr when no one
+    /// connected, the handshake failed, or the consumer joined @p current
+    /// (the session in progress; turned away when all its lanes are taken).
+    std::unique_ptr<ShmQueue> accept(std::chrono::milliseconds timeout,
+                                     const ShmQueue* current = nullptr);
+
+    const std::string& path() const { return path_; }
+
+private:
+    std::string path_;
+    ShmSessionLimits limits_;
+    int listen_fd_ = -1;
+};
+
+/// Consumer end: connect to the producer listening on @p path, propose
+/// @p request and map the queue it returns, attaching with @p options.
+/// @p granted (optional) receives the geometry in effect. Throws
+/// std::runtime_error when nobody listens, the producer runs as another user
+/// or refuses the session, or the received region is invalid (layout outside
+/// the mapping) or has no free consumer lane.
+std::unique_ptr<ShmQueue> shm_session_connect(const std::string& path,
+                                              const ShmSessionGeometry& request,
+                                              ShmSessionGeometry* granted = nullptr,
+                                              const ShmConsumerOptions& options = {});
+
+} // namespace grebe
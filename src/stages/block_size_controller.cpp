@@ -0,0 +1,95 @@
+#include "stages/block_size_controller.h"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <utility>
+
+namespace grebe {
+
+BlockSizeController::BlockSizeController(std::string owner, Request request)
+    : owner_(std::move(owner))
+    , request_(std::move(request)) {}
+
+void BlockSizeController::update(uint32_t block, double sample_rate_hz,
+                                 const ExecContext& ctx) {
+    if (unsupported_) return;
+
+    // A new sample rate may come with a new default block: drop the request
+    // and learn the default again once blocks of the old size have drained
+    if (sample_rate_hz != base_rate_) {
+        base_rate_ = sample_rate_hz;
+        if (base_block_ != 0) {
+            if (requested() != 0) request_(0);
+            restart(ctx.credit_window);
+        }
+    }
+
+    if (settle_frames_ > 0) {
+        // Let the previous change reach the queue before judging it
+        --settle_frames_;
+        return;
+    }
+    if (base_block_ == 0) base_block_ = block;
+    if (base_block_ == 0) return;
+
+    // Settled blocks of neither the requested nor the default size: the
+    // producer was reconnected or restarted and forgot the request, or its
+    // default changed. Start over from the size it sends now.
+    const uint32_t requested_now = requested();
+    const uint32_t expected = requested_now ? requested_now : base_block_;
+    if (block != expected && block == previous_block_) {
+        // Still draining blocks sent before the last change (transport
+        // buffers can hold more than settle_frames_)
+        return;
+    }
+    if (block != expected) {
+        spdlog::debug("{}: source block size now {} (expected {}), restarting flow control",
+                      owner_, block, expected);
+        restart(0);
+        base_block_ = block;
+        if (base_block_ == 0) return;
+    }
+
+    const uint32_t current = std::max(requested(), base_block_);
+    if (quiet_reads_ == 0) quiet_reads_ = ctx.credit_window;
+    full_credit_reads_ = (ctx.credits >= ctx.credit_window) ? full_credit_reads_ + 1 : 0;
+
+    uint32_t next = current;
+    if (static_cast<uint64_t>(ctx.credits) * 4 <= ctx.credit_window) {
+        next = std::min(current * 2, base_block_ * kMaxBlockScale);
+        if (next != current && last_step_down_) {
+            // The smaller size did not keep up: wait longer before retrying
+            quiet_reads_ = std::min(quiet_reads_ * 2, ctx.credit_window * 64);
+        }
+    } else if (full_credit_reads_ >= quiet_reads_ && current > base_block_) {
+        next = std::max(current / 2, base_block_);
+    }
+    if (next == current) return;
+
+    if (!request_(next)) {
+        spdlog::info("{}: source does not support block size requests, "
+                     "flow control limited to credit stalls", owner_);
+        unsupported_ = true;
+        return;
+    }
+    spdlog::debug("{}: credit {}/{}, block size {} -> {}",
+                  owner_, ctx.credits, ctx.credit_window, current, next);
+    requested_block_.store(next, std::memory_order_relaxed);
+    previous_block_ = current;
+    last_step_down_ = next < current;
+    full_credit_reads_ = 0;
+    settle_frames_ = ctx.credit_window;
+}
+
+void BlockSizeController::restart(uint32_t settle_frames) {
+    requested_block_.store(0, std::memory_order_relaxed);
+    base_block_ = 0;
+    previous_block_ = 0;
+    settle_frames_ = settle_frames;
+    full_credit_reads_ = 0;
+    quiet_reads_ = 0;
+    last_step_down_ = false;
+}
+
+} // namespace grebe
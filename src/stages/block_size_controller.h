@@ -0,0 +1,65 @@
+#pragma once
+
+// BlockSizeController — Credit-driven source block size adaptation
+// Shared by DataSourceAdapter (IDataSource) and AsyncTransportRxStage
+// (grebe-sg command channel).
+
+#include "grebe/batch.h"
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+namespace grebe {
+
+/// When credit on the source's Credit edge falls to a quarter of the
+/// window, ask the producer for blocks twice as large (same samples in
+/// fewer frames, so each credit covers more data); once the downstream
+/// queue has stayed drained for a while, step back towards the default
+/// size. A step down that had to be undone doubles that quiet period, so
+/// the size settles instead of oscillating.
+///
+/// The producer's default block is learned from the blocks it sends, and
+/// learned again after a sample rate change or when settled blocks match
+/// neither the requested nor the default size (reconnected or restarted
+/// producer that forgot the request).
+class BlockSizeController {
+public:
+    /// Asks the producer for blocks of n samples per channel (0 = its
+    /// default); false if it cannot change its block size.
+    using Request = std::function<bool(uint32_t)>;
+
+    /// @p owner names the stage in log messages.
+    BlockSizeController(std::string owner, Request request);
+
+    /// Feed one received block (call per frame on a Credit edge, from the
+    /// stage's executor thread).
+    void update(uint32_t block, double sample_rate_hz, const ExecContext& ctx);
+
+    /// Block size last requested (0 = none, the producer's default).
+    uint32_t requested() const { return requested_block_.load(std::memory_order_relaxed); }
+
+    /// Largest block requested, as a multiple of the producer's default.
+    static constexpr uint32_t kMaxBlockScale = 16;
+
+private:
+    /// Forget the learned default and any request; the default is re-read
+    /// after @p settle_frames.
+    void restart(uint32_t settle_frames);
+
+    std::string owner_;
+    Request request_;
+
+    uint32_t base_block_ = 0;       // producer default (0 = learn from the next block)
+    double   base_rate_ = 0.0;      // sample rate base_block_ was learned at
+    uint32_t previous_block_ = 0;   // size before the last request (still in flight)
+    uint32_t settle_frames_ = 0;    // frames to read before the next change
+    uint32_t full_credit_reads_ = 0;  // consecutive reads with all credit free
+    uint32_t quiet_reads_ = 0;      // full_credit_reads_ needed to step down
+    bool last_step_down_ = false;
+    bool unsupported_ = false;
+    std::atomic<uint32_t> requested_block_{0};
+};
+
+} // namespace grebe
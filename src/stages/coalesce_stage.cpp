@@ -0,0 +1,119 @@
+#include "stages/coalesce_stage.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+namespace grebe {
+
+CoalesceStage::CoalesceStage(const CoalesceOptions& options)
+    : options_(options) {
+    options_.target_samples_per_channel = std::max<uint32_t>(1, options_.target_samples_per_channel);
+}
+
+StageResult CoalesceStage::process(BatchView& in, BatchWriter& out,
+                                   ExecContext& /*ctx*/) {
+    if (in.empty()) return StageResult::NoData;
+
+    const uint64_t now_ns = steady_now_ns();
+    const uint32_t target = options_.target_samples_per_channel;
+
+    for (size_t i = 0; i < in.size(); ++i) {
+        const Frame& f = in[i];
+        const uint32_t spc = f.samples_per_channel;
+        if (f.channel_count == 0 || spc == 0) continue;
+        if (f.data_count() < static_cast<size_t>(f.channel_count) * spc) continue;
+
+        if (acc_samples_ > 0 && (!contiguous(f) || acc_samples_ + spc > target)) {
+            flush(out);
+        }
+        if (spc >= target) {
+            out.push(in.take(i));  // already a full block: forward as is
+            continue;
+        }
+        if (acc_samples_ == 0) begin(f, now_ns);
+        append(f);
+        if (acc_samples_ == target) flush(out);
+    }
+
+    // Time budget: don't hold a partial block back longer than max_delay
+    const auto max_delay_ns = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(options_.max_delay).count());
+    if (acc_samples_ > 0 && max_delay_ns > 0 && now_ns - acc_started_ns_ >= max_delay_ns) {
+        flush(out);
+    }
+
+    return StageResult::Ok;
+}
+
+bool CoalesceStage::contiguous(const Frame& f) const {
+    return !(f.flags & kFrameDiscontinuity) &&
+           f.channel_count == acc_channels_ &&
+           f.sample_rate_hz == sample_rate_hz_ &&
+           f.first_sample_index == first_sample_index_ + acc_samples_;
+}
+
+void CoalesceStage::begin(const Frame& f, uint64_t now_ns) {
+    const size_t needed = static_cast<size_t>(f.channel_count) * options_.target_samples_per_channel;
+    if (acc_.size() != needed) {
+        FramePool::global().recycle(std::move(acc_));
+        acc_ = FramePool::global().acquire(needed);
+    }
+    acc_channels_       = f.channel_count;
+    acc_started_ns_     = now_ns;
+    sequence_           = f.sequence;
+    producer_ts_ns_     = f.producer_ts_ns;
+    sample_rate_hz_     = f.sample_rate_hz;
+    first_sample_index_ = f.first_sample_index;
+    flags_              = 0;
+    trace_              = f.trace;
+}
+
+void CoalesceStage::append(const Frame& f) {
+    const size_t stride = options_.target_samples_per_channel;
+    const uint32_t spc = f.samples_per_channel;
+    for (uint32_t ch = 0; ch < acc_channels_; ++ch) {
+        std::memcpy(acc_.data() + ch * stride + acc_samples_,
+                    f.data() + static_cast<size_t>(ch) * spc,
+                    spc * sizeof(int16_t));
+    }
+    acc_samples_ += spc;
+    flags_ |= f.flags;
+}
+
+void CoalesceStage::flush(BatchWriter& out) {
+    const size_t stride = options_.target_samples_per_channel;
+    const size_t n = acc_samples_;
+
+    // Partial block: close the gaps between channels
+    if (n < stride) {
+        for (uint32_t ch = 1; ch < acc_channels_; ++ch) {
+            std::memmove(acc_.data() + ch * n, acc_.data() + ch * stride, n * sizeof(int16_t));
+        }
+    }
+    acc_.resize(acc_channels_ * n);
+
+    // Hand the filled buffer to a pooled frame and keep the pooled buffer
+    // for the next block (no copy; no allocation once warm)
+    Frame frame = Frame::make_pooled(acc_channels_, static_cast<uint32_t>(n));
+    frame.swap_storage(acc_);
+    const size_t needed = acc_channels_ * stride;
+    if (acc_.capacity() < needed) {
+        FramePool::global().recycle(std::move(acc_));
+        acc_ = FramePool::global().acquire(needed);
+    } else {
+        acc_.resize(needed);
+    }
+
+    frame.sequence           = sequence_;
+    frame.producer_ts_ns     = producer_ts_ns_;
+    frame.sample_rate_hz     = sample_rate_hz_;
+    frame.first_sample_index = first_sample_index_;
+    frame.flags              = flags_;
+    frame.trace              = trace_;
+    out.push(std::move(frame));
+
+    acc_samples_ = 0;
+}
+
+} // namespace grebe
@@ -0,0 +1,71 @@
+#pragma once
+
+// CoalesceStage — Merges small contiguous frames into larger blocks
+// Decouples downstream block size from source block size / transport MTU.
+
+#include "grebe/stage.h"
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+namespace grebe {
+
+struct CoalesceOptions {
+    /// Emit once this many samples per channel have been merged. Input
+    /// frames at least this large are forwarded unmerged and uncopied.
+    uint32_t target_samples_per_channel = 16384;
+    /// Emit a partial block once its first frame arrived this long ago
+    /// (0 = size budget only). Checked whenever input arrives; a stalled
+    /// stream leaves at most one partial block pending.
+    std::chrono::microseconds max_delay{2000};
+};
+
+/// ProcessingStage that concatenates consecutive frames into blocks of
+/// CoalesceOptions::target_samples_per_channel samples per channel.
+///
+/// Frames are merged only while they are contiguous: same channel count and
+/// sample rate, and first_sample_index continuing where the previous frame
+/// ended, and not flagged kFrameDiscontinuity. A gap (dropped datagram,
+/// source restart) emits the pending block first, so no output block spans
+/// a discontinuity.
+///
+/// A merged frame carries the first input frame's sequence, producer_ts_ns,
+/// first_sample_index and trace (so e2e latency includes the time spent
+/// waiting here) and the OR of all input flags. Merged frames are pooled
+/// and handed over without an extra copy; input frames already of the
+/// target size are moved through as they are (BatchView::take()).
+class CoalesceStage final : public IStage {
+public:
+    explicit CoalesceStage(const CoalesceOptions& options = {});
+
+    StageResult process(BatchView& in, BatchWriter& out,
+                        ExecContext& ctx) override;
+
+    std::string name() const override { return "CoalesceStage"; }
+
+private:
+    bool contiguous(const Frame& f) const;
+    void begin(const Frame& f, uint64_t now_ns);
+    void append(const Frame& f);
+    void flush(BatchWriter& out);
+
+    CoalesceOptions options_;
+
+    // Pending block: channel-major with a stride of target samples per
+    // channel, so appending never moves earlier data
+    std::vector<int16_t> acc_;
+    uint32_t acc_channels_ = 0;
+    uint32_t acc_samples_ = 0;  // per channel; 0 = nothing pending
+    uint64_t acc_started_ns_ = 0;
+
+    // Metadata of the pending block
+    uint64_t sequence_ = 0;
+    uint64_t producer_ts_ns_ = 0;
+    double   sample_rate_hz_ = 0.0;
+    uint64_t first_sample_index_ = 0;
+    uint32_t flags_ = 0;
+    FrameTrace trace_;
+};
+
+} // namespace grebe
@@ -3,15 +3,31 @@
 namespace grebe {
 
 DataSourceAdapter::DataSourceAdapter(IDataSource& source)
-    : source_(source) {}
+    : source_(source)
+    , block_size_("DataSourceAdapter",
+                  [&source](uint32_t n) { return source.request_block_size(n); }) {}
 
-StageResult DataSourceAdapter::process(const BatchView& /*in*/, BatchWriter& out,
-                                       ExecContext& /*ctx*/) {
+StageResult DataSourceAdapter::process(BatchView& /*in*/, BatchWriter& out,
+                                       ExecContext& ctx) {
     auto result = source_.read_frame(fb_);
 
     switch (result) {
     case ReadResult::Ok: {
-        Frame frame = Frame::from_frame_buffer(fb_);
+        if (ctx.credit_window > 0) {
+            block_size_.update(fb_.samples_per_channel, source_.info().sample_rate_hz, ctx);
+        }
+
+        // Hand the filled buffer to a pooled frame and keep the pooled buffer
+        // for the next read_frame() (no copy; no allocation once warm)
+        Frame frame = Frame::make_pooled(fb_.channel_count, fb_.samples_per_channel);
+        frame.swap_storage(fb_.data);
+        frame.sequence       = fb_.sequence;
+        frame.producer_ts_ns = fb_.producer_ts_ns;
+        frame.first_sample_index = fb_.first_sample_index;
+        frame.flags          = fb_.flags;
+        if (fb_.receive_ts_ns != 0 && !(fb_.flags & kFrameVirtualClock)) {
+            frame.trace.mark(TracePoint::Receive, fb_.producer_ts_ns, fb_.receive_ts_ns);
+        }
         // Propagate sample_rate from source info
         frame.sample_rate_hz = source_.info().sample_rate_hz;
         out.push(std::move(frame));
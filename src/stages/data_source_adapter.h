@@ -2,9 +2,13 @@
 
 // DataSourceAdapter — IDataSource → IStage adapter (Phase 12)
 // Wraps any IDataSource (SyntheticSource, TransportSource, etc.) as a SourceStage.
+// On a Credit output edge, adapts the source block size to downstream credit.
 
 #include "grebe/stage.h"
 #include "grebe/data_source.h"
+#include "stages/block_size_controller.h"
+
+#include <cstdint>
 
 namespace grebe {
 
@@ -12,14 +16,19 @@ class DataSourceAdapter final : public IStage {
 public:
     explicit DataSourceAdapter(IDataSource& source);
 
-    StageResult process(const BatchView& in, BatchWriter& out,
+    StageResult process(BatchView& in, BatchWriter& out,
                         ExecContext& ctx) override;
 
     std::string name() const override { return "DataSourceAdapter"; }
 
+    /// Block size last requested from the source by flow control
+    /// (0 = none, the source's own default is in effect).
+    uint32_t requested_block_size() const { return block_size_.requested(); }
+
 private:
     IDataSource& source_;
-    FrameBuffer fb_;  // reusable buffer to avoid per-call allocation
+    FrameBuffer fb_;  // reusable buffer; storage is swapped with pooled frames
+    BlockSizeController block_size_;  // Credit edge: source block size
 };
 
 } // namespace grebe
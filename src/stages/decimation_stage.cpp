@@ -1,19 +1,28 @@
 #include "stages/decimation_stage.h"
 
-#include <cstring>
+#include <utility>
 
 namespace grebe {
 
 DecimationStage::DecimationStage(DecimationMode mode, uint32_t target_points)
-    : mode_(mode)
-    , target_points_(target_points) {}
+    : params_(std::make_shared<Params>()) {
+    params_->mode.store(mode, std::memory_order_relaxed);
+    params_->target_points.store(target_points, std::memory_order_relaxed);
+}
+
+DecimationStage::DecimationStage(std::shared_ptr<Params> params)
+    : params_(std::move(params)) {}
 
-StageResult DecimationStage::process(const BatchView& in, BatchWriter& out,
-                                      ExecContext& /*ctx*/) {
+std::unique_ptr<IStage> DecimationStage::clone() const {
+    return std::unique_ptr<IStage>(new DecimationStage(params_));
+}
+
+StageResult DecimationStage::process(BatchView& in, BatchWriter& out,
+                                     ExecContext& /*ctx*/) {
     if (in.empty()) return StageResult::NoData;
 
     const auto cur_mode = effective_mode();
-    const auto cur_target = target_points_.load(std::memory_order_relaxed);
+    const auto cur_target = params_->target_points.load(std::memory_order_relaxed);
 
     for (size_t i = 0; i < in.size(); ++i) {
         const Frame& src = in[i];
@@ -21,33 +30,25 @@ StageResult DecimationStage::process(const BatchView& in, BatchWriter& out,
         const uint32_t spc = src.samples_per_channel;
 
         if (ch_count == 0 || spc == 0) continue;
+        if (src.data_count() < static_cast<size_t>(ch_count) * spc) continue;
 
-        // Decimate each channel independently, then concatenate
-        std::vector<std::vector<int16_t>> ch_results(ch_count);
-        uint32_t decimated_spc = 0;
+        // Decimate each channel straight from the source frame into a pooled
+        // output frame (channel-major, no intermediate buffers)
+        const auto decimated_spc = static_cast<uint32_t>(
+            Decimator::output_size(spc, cur_mode, cur_target));
+        Frame dst = Frame::make_pooled(ch_count, decimated_spc);
 
         for (uint32_t ch = 0; ch < ch_count; ++ch) {
-            // Extract single-channel data
-            std::vector<int16_t> ch_data(spc);
-            std::memcpy(ch_data.data(),
-                        src.data() + static_cast<size_t>(ch) * spc,
-                        spc * sizeof(int16_t));
-
-            ch_results[ch] = Decimator::decimate(ch_data, cur_mode, cur_target);
-
-            if (ch == 0) {
-                decimated_spc = static_cast<uint32_t>(ch_results[ch].size());
-            }
+            Decimator::decimate_into(src.data() + static_cast<size_t>(ch) * spc, spc,
+                                     cur_mode, cur_target,
+                                     dst.mutable_data() + static_cast<size_t>(ch) * decimated_spc);
         }
 
-        // Build output frame with concatenated decimated channels
-        Frame dst = Frame::make_owned(ch_count, decimated_spc);
-
         // Copy metadata (adjust sample_rate_hz to preserve time span)
-        // Use stored sample_rate_ as fallback when frame's rate is 0
+        // Use the stored sample rate as fallback when frame's rate is 0
         const double input_rate = (src.sample_rate_hz > 0.0)
             ? src.sample_rate_hz
-            : sample_rate_.load(std::memory_order_relaxed);
+            : params_->sample_rate.load(std::memory_order_relaxed);
         dst.sequence            = src.sequence;
         dst.producer_ts_ns      = src.producer_ts_ns;
         dst.sample_rate_hz      = (spc > 0 && input_rate > 0.0)
@@ -55,13 +56,7 @@ StageResult DecimationStage::process(const BatchView& in, BatchWriter& out,
             : input_rate;
         dst.first_sample_index  = src.first_sample_index;
         dst.flags               = src.flags;
-
-        // Concatenate channel data
-        for (uint32_t ch = 0; ch < ch_count; ++ch) {
-            std::memcpy(dst.mutable_data() + static_cast<size_t>(ch) * decimated_spc,
-                        ch_results[ch].data(),
-                        ch_results[ch].size() * sizeof(int16_t));
-        }
+        dst.trace               = src.trace;
 
         out.push(std::move(dst));
     }
@@ -70,33 +65,33 @@ StageResult DecimationStage::process(const BatchView& in, BatchWriter& out,
 }
 
 void DecimationStage::set_mode(DecimationMode mode) {
-    mode_.store(mode, std::memory_order_relaxed);
+    params_->mode.store(mode, std::memory_order_relaxed);
 }
 
 void DecimationStage::set_target_points(uint32_t n) {
-    target_points_.store(n, std::memory_order_relaxed);
+    params_->target_points.store(n, std::memory_order_relaxed);
 }
 
 DecimationMode DecimationStage::mode() const {
-    return mode_.load(std::memory_order_relaxed);
+    return params_->mode.load(std::memory_order_relaxed);
 }
 
 uint32_t DecimationStage::target_points() const {
-    return target_points_.load(std::memory_order_relaxed);
+    return params_->target_points.load(std::memory_order_relaxed);
 }
 
 void DecimationStage::set_sample_rate(double rate) {
-    sample_rate_.store(rate, std::memory_order_relaxed);
+    params_->sample_rate.store(rate, std::memory_order_relaxed);
 }
 
 double DecimationStage::sample_rate() const {
-    return sample_rate_.load(std::memory_order_relaxed);
+    return params_->sample_rate.load(std::memory_order_relaxed);
 }
 
 DecimationMode DecimationStage::effective_mode() const {
-    auto m = mode_.load(std::memory_order_relaxed);
+    auto m = params_->mode.load(std::memory_order_relaxed);
     if (m == DecimationMode::LTTB &&
-        sample_rate_.load(std::memory_order_relaxed) >= kLttbHighRateThreshold) {
+        params_->sample_rate.load(std::memory_order_relaxed) >= kLttbHighRateThreshold) {
         return DecimationMode::MinMax;
     }
     return m;
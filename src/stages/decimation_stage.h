@@ -7,6 +7,7 @@
 #include "decimator.h"
 
 #include <atomic>
+#include <memory>
 
 namespace grebe {
 
@@ -14,11 +15,15 @@ class DecimationStage final : public IStage {
 public:
     DecimationStage(DecimationMode mode, uint32_t target_points);
 
-    StageResult process(const BatchView& in, BatchWriter& out,
+    StageResult process(BatchView& in, BatchWriter& out,
                         ExecContext& ctx) override;
 
     std::string name() const override { return "DecimationStage"; }
 
+    /// Replica sharing this stage's parameters: set_mode() etc. on any
+    /// instance applies to all of them.
+    std::unique_ptr<IStage> clone() const override;
+
     void set_mode(DecimationMode mode);
     void set_target_points(uint32_t n);
     void set_sample_rate(double rate);
@@ -31,9 +36,16 @@ public:
 private:
     static constexpr double kLttbHighRateThreshold = 100e6;  // 100 MSPS
 
-    std::atomic<DecimationMode> mode_;
-    std::atomic<uint32_t> target_points_;
-    std::atomic<double> sample_rate_{0.0};
+    /// Runtime-controlled parameters, shared between replicas.
+    struct Params {
+        std::atomic<DecimationMode> mode;
+        std::atomic<uint32_t> target_points;
+        std::atomic<double> sample_rate{0.0};
+    };
+
+    explicit DecimationStage(std::shared_ptr<Params> params);
+
+    std::shared_ptr<Params> params_;
 };
 
 } // namespace grebe
@@ -11,26 +11,31 @@ namespace grebe {
 VisualizationStage::VisualizationStage(uint32_t display_target_points)
     : display_target_points_(display_target_points) {}
 
-StageResult VisualizationStage::process(const BatchView& in, BatchWriter& out,
-                                         ExecContext& /*ctx*/) {
+StageResult VisualizationStage::process(BatchView& in, BatchWriter& out,
+                                        ExecContext& /*ctx*/) {
     // 1. Accumulate input frames (may be empty — still produce output below)
+    const Frame* newest = nullptr;
     for (size_t i = 0; i < in.size(); ++i) {
         const Frame& frame = in[i];
         const uint32_t ch_count = frame.channel_count;
         const uint32_t spc = frame.samples_per_channel;
 
         if (ch_count == 0 || spc == 0) continue;
-
-        if (frame.sample_rate_hz > 0.0) {
-            // Clear history when sample rate changes (different time density)
-            if (last_sample_rate_hz_ > 0.0
-                && frame.sample_rate_hz != last_sample_rate_hz_) {
-                for (auto& hist : channel_history_) {
-                    hist.clear();
-                }
-                ch0_frame_ends_.clear();
-                ch0_total_appended_ = 0;
+        newest = &frame;
+
+        // Clear history when sample rate changes (different time density)
+        // or the stream has a gap (the window must not join across it)
+        const bool rate_changed = frame.sample_rate_hz > 0.0
+            && last_sample_rate_hz_ > 0.0
+            && frame.sample_rate_hz != last_sample_rate_hz_;
+        if (rate_changed || (frame.flags & kFrameDiscontinuity)) {
+            for (auto& hist : channel_history_) {
+                hist.clear();
             }
+            ch0_frame_ends_.clear();
+            ch0_total_appended_ = 0;
+        }
+        if (frame.sample_rate_hz > 0.0) {
             last_sample_rate_hz_ = frame.sample_rate_hz;
         }
 
@@ -47,8 +52,7 @@ StageResult VisualizationStage::process(const BatchView& in, BatchWriter& out,
         for (uint32_t ch = 0; ch < ch_count; ++ch) {
             const int16_t* ch_data = frame.data()
                 + static_cast<size_t>(ch) * spc;
-            channel_history_[ch].insert(
-                channel_history_[ch].end(), ch_data, ch_data + spc);
+            channel_history_[ch].append(ch_data, spc);
         }
 
         // Track frame boundary for ch0
@@ -79,9 +83,7 @@ StageResult VisualizationStage::process(const BatchView& in, BatchWriter& out,
     const size_t max_history = window_samples * 2;
     for (auto& hist : channel_history_) {
         if (hist.size() > max_history) {
-            hist.erase(hist.begin(),
-                       hist.begin()
-                           + static_cast<ptrdiff_t>(hist.size() - max_history));
+            hist.trim_front(hist.size() - max_history);
         }
     }
 
@@ -114,43 +116,53 @@ StageResult VisualizationStage::process(const BatchView& in, BatchWriter& out,
         static_cast<double>(min_available)
             / static_cast<double>(window_samples));
 
-    // 3. Window + decimate per channel
+    // 3. Window + decimate per channel, straight into a pooled output frame
+    //    (always MinMax for visual fidelity)
     const size_t take = std::min(min_available, window_samples);
+    const bool decimate = take > display_target_points_;
+    const auto decimated_spc = static_cast<uint32_t>(decimate
+        ? Decimator::output_size(take, DecimationMode::MinMax, display_target_points_)
+        : take);
 
-    std::vector<std::vector<int16_t>> ch_decimated(last_channel_count_);
-    uint32_t decimated_spc = 0;
-    std::vector<int16_t> ch0_windowed;  // saved for debug dump
-
-    for (uint32_t ch = 0; ch < last_channel_count_; ++ch) {
-        auto& hist = channel_history_[ch];
-        const size_t start = hist.size() - take;
+    if (decimated_spc == 0) {
+        return StageResult::NoData;
+    }
 
-        // Copy windowed data from deque to contiguous vector
-        std::vector<int16_t> windowed(take);
-        auto it = hist.begin() + static_cast<ptrdiff_t>(start);
-        std::copy(it, hist.end(), windowed.begin());
+    // 4. Build output frame
+    Frame dst = Frame::make_pooled(last_channel_count_, decimated_spc);
+    dst.sample_rate_hz = last_sample_rate_hz_;
 
-        // Save ch0 windowed data for potential debug dump
-        if (ch == 0 && debug_dump_requested_.load(std::memory_order_relaxed)) {
-            ch0_windowed = windowed;
+    // Carry the newest input frame's identity so the display latency can be
+    // measured; a redraw without new input keeps producer_ts_ns = 0
+    if (newest) {
+        dst.sequence       = newest->sequence;
+        dst.producer_ts_ns = newest->producer_ts_ns;
+        dst.flags          = newest->flags & kFrameVirtualClock;
+        dst.trace          = newest->trace;
+        if (!(dst.flags & kFrameVirtualClock)) {
+            dst.trace.mark(TracePoint::Visualize, dst.producer_ts_ns, steady_now_ns());
         }
+    }
 
-        // Decimate to display target (always MinMax for visual fidelity)
-        if (windowed.size() > display_target_points_) {
-            ch_decimated[ch] = Decimator::decimate(
-                windowed, DecimationMode::MinMax, display_target_points_);
-        } else {
-            ch_decimated[ch] = std::move(windowed);
-        }
+    for (uint32_t ch = 0; ch < last_channel_count_; ++ch) {
+        const auto& hist = channel_history_[ch];
+        const int16_t* windowed = hist.data() + (hist.size() - take);
+        int16_t* dst_ch = dst.mutable_data() + static_cast<size_t>(ch) * decimated_spc;
 
-        if (ch == 0) {
-            decimated_spc = static_cast<uint32_t>(ch_decimated[ch].size());
+        if (decimate) {
+            Decimator::minmax_into(windowed, take, display_target_points_, dst_ch);
+        } else {
+            std::memcpy(dst_ch, windowed, take * sizeof(int16_t));
         }
     }
 
     // Debug dump (one-shot, ch0 only)
-    if (debug_dump_requested_.exchange(false, std::memory_order_relaxed)
-        && !ch0_windowed.empty()) {
+    if (debug_dump_requested_.exchange(false, std::memory_order_relaxed)) {
+        const auto& hist0 = channel_history_[0];
+        const int16_t* win0 = hist0.data() + (hist0.size() - take);
+        std::vector<int16_t> ch0_windowed(win0, win0 + take);
+        std::vector<int16_t> ch0_decimated(dst.data(), dst.data() + decimated_spc);
+
         // Compute boundary offsets within windowed region
         const size_t win_abs_start = ch0_total_appended_ - take;
         std::vector<size_t> boundary_offsets;
@@ -159,22 +171,7 @@ StageResult VisualizationStage::process(const BatchView& in, BatchWriter& out,
                 boundary_offsets.push_back(b - win_abs_start);
             }
         }
-        dump_debug_csv(ch0_windowed, ch_decimated[0], boundary_offsets);
-    }
-
-    if (decimated_spc == 0) {
-        return StageResult::NoData;
-    }
-
-    // 4. Build output frame
-    Frame dst = Frame::make_owned(last_channel_count_, decimated_spc);
-    dst.sample_rate_hz = last_sample_rate_hz_;
-
-    for (uint32_t ch = 0; ch < last_channel_count_; ++ch) {
-        std::memcpy(dst.mutable_data()
-                        + static_cast<size_t>(ch) * decimated_spc,
-                    ch_decimated[ch].data(),
-                    ch_decimated[ch].size() * sizeof(int16_t));
+        dump_debug_csv(ch0_windowed, ch0_decimated, boundary_offsets);
     }
 
     out.push(std::move(dst));
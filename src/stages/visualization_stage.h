@@ -7,7 +7,9 @@
 #include "grebe/stage.h"
 #include "decimator.h"
 
+#include <algorithm>
 #include <atomic>
+#include <cstddef>
 #include <deque>
 #include <string>
 #include <vector>
@@ -18,7 +20,7 @@ class VisualizationStage final : public IStage {
 public:
     explicit VisualizationStage(uint32_t display_target_points = 3840);
 
-    StageResult process(const BatchView& in, BatchWriter& out,
+    StageResult process(BatchView& in, BatchWriter& out,
                         ExecContext& ctx) override;
 
     std::string name() const override { return "VisualizationStage"; }
@@ -41,11 +43,36 @@ private:
                         const std::vector<int16_t>& decimated,
                         const std::vector<size_t>& boundary_offsets);
 
+    /// Per-channel sample history: contiguous buffer with a moving head.
+    /// Trimming advances the head; storage is compacted in place, so the
+    /// capacity is reused and steady-state appends do not allocate.
+    struct SampleHistory {
+        std::vector<int16_t> buf;
+        size_t head = 0;
+
+        size_t size() const { return buf.size() - head; }
+        bool empty() const { return size() == 0; }
+        const int16_t* data() const { return buf.data() + head; }
+        void clear() { buf.clear(); head = 0; }
+        void append(const int16_t* p, size_t n) {
+            if (head > 0 && buf.size() + n > buf.capacity()) compact();
+            buf.insert(buf.end(), p, p + n);
+        }
+        void trim_front(size_t n) {
+            head += std::min(n, size());
+            if (head >= buf.size() / 2) compact();
+        }
+        void compact() {
+            buf.erase(buf.begin(), buf.begin() + static_cast<ptrdiff_t>(head));
+            head = 0;
+        }
+    };
+
     uint32_t display_target_points_;
     std::atomic<double> visible_time_span_s_{0.010};  // 10ms default
 
     // Per-channel sample history (accumulates pipeline-decimated data)
-    std::vector<std::deque<int16_t>> channel_history_;
+    std::vector<SampleHistory> channel_history_;
     double last_sample_rate_hz_ = 0.0;
     uint32_t last_channel_count_ = 0;
     double last_coverage_ = 0.0;
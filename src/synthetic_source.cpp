@@ -1,5 +1,6 @@
 #include "synthetic_source.h"
 #include "waveform_utils.h"
+#include "grebe/frame.h"
 
 #ifdef _MSC_VER
 #define _USE_MATH_DEFINES
@@ -44,6 +45,10 @@ void SyntheticSource::start() {
     sequence_ = 0;
     total_samples_ = 0;
     phase_acc_ = 0.0;
+    virtual_epoch_ns_ = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            Clock::now().time_since_epoch()).count());
+    virtual_elapsed_s_ = 0.0;
     started_.store(true, std::memory_order_release);
 }
 
@@ -83,6 +88,17 @@ void SyntheticSource::set_paused(bool paused) {
     paused_.store(paused, std::memory_order_relaxed);
 }
 
+bool SyntheticSource::request_block_size(uint32_t samples_per_channel) {
+    constexpr uint32_t kMaxBlock = 1u << 20;
+    block_size_request_.store(std::min(samples_per_channel, kMaxBlock), std::memory_order_relaxed);
+    return true;
+}
+
+bool SyntheticSource::set_virtual_clock(bool enabled) {
+    virtual_clock_.store(enabled, std::memory_order_relaxed);
+    return true;
+}
+
 const int16_t* SyntheticSource::period_buffer_ptr(uint32_t ch) const {
     if (ch < channel_states_.size()) return channel_states_[ch].period_buf.data();
     return nullptr;
@@ -176,6 +192,9 @@ grebe::ReadResult SyntheticSource::read_frame(grebe::FrameBuffer& frame) {
     constexpr size_t BATCH_SIZE_LOW = 4096;
     constexpr size_t BATCH_SIZE_HIGH = 65536;
     size_t batch_size = high_rate ? BATCH_SIZE_HIGH : BATCH_SIZE_LOW;
+    if (const uint32_t requested = block_size_request_.load(std::memory_order_relaxed)) {
+        batch_size = requested;
+    }
 
     double frequency = target_frequency_.load(std::memory_order_relaxed);
     if (frequency < 1.0) frequency = 1.0;
@@ -208,6 +227,7 @@ grebe::ReadResult SyntheticSource::read_frame(grebe::FrameBuffer& frame) {
 
     // Prepare frame
     frame.sequence = sequence_++;
+    frame.first_sample_index = total_samples_;
     frame.channel_count = num_channels_;
     frame.samples_per_channel = static_cast<uint32_t>(batch_size);
     frame.data.resize(num_channels_ * batch_size);
@@ -285,10 +305,18 @@ grebe::ReadResult SyntheticSource::read_frame(grebe::FrameBuffer& frame) {
 
     total_samples_ += batch_size;
 
-    // Timestamp
-    frame.producer_ts_ns = static_cast<uint64_t>(
-        std::chrono::duration_cast<std::chrono::nanoseconds>(
-            Clock::now().time_since_epoch()).count());
+    // Timestamp: wall clock, or the block's position on the simulated timeline
+    const bool virtual_clock = virtual_clock_.load(std::memory_order_relaxed);
+    if (virtual_clock) {
+        frame.producer_ts_ns = virtual_epoch_ns_ + static_cast<uint64_t>(virtual_elapsed_s_ * 1e9);
+        frame.flags = grebe::kFrameVirtualClock;
+        virtual_elapsed_s_ += static_cast<double>(batch_size) / sample_rate;
+    } else {
+        frame.flags = 0;
+        frame.producer_ts_ns = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                Clock::now().time_since_epoch()).count());
+    }
 
     // Rate measurement (update every 100ms)
     rate_sample_count_ += batch_size;
@@ -300,6 +328,12 @@ grebe::ReadResult SyntheticSource::read_frame(grebe::FrameBuffer& frame) {
         rate_sample_count_ = 0;
     }
 
+    // Virtual clock: no pacing, the reader's credit sets the rate
+    if (virtual_clock) {
+        next_wake_ = now;
+        return grebe::ReadResult::Ok;
+    }
+
     // Pacing: target the requested rate
     double batch_duration = static_cast<double>(batch_size) / sample_rate;
     next_wake_ += std::chrono::duration_cast<Clock::duration>(
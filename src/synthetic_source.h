@@ -35,8 +35,11 @@ public:
     void set_channel_waveform(uint32_t ch, WaveformType type);
     WaveformType get_channel_waveform(uint32_t ch) const;
     void set_paused(bool paused);
+    bool request_block_size(uint32_t samples_per_channel) override;
+    bool set_virtual_clock(bool enabled) override;
 
     bool is_paused() const { return paused_.load(std::memory_order_relaxed); }
+    bool is_virtual_clock() const { return virtual_clock_.load(std::memory_order_relaxed); }
     double target_sample_rate() const { return target_sample_rate_.load(std::memory_order_relaxed); }
     double actual_sample_rate() const { return actual_rate_.load(std::memory_order_relaxed); }
 
@@ -69,7 +72,9 @@ private:
     std::atomic<WaveformType> waveform_type_;
     std::array<std::atomic<WaveformType>, MAX_CHANNELS> channel_waveforms_;
     std::atomic<bool> paused_{false};
+    std::atomic<uint32_t> block_size_request_{0};  // 0 = rate-based default
     std::atomic<bool> started_{false};
+    std::atomic<bool> virtual_clock_{false};  // unpaced, simulated timestamps
 
     // Rate measurement
     std::atomic<double> actual_rate_{0.0};
@@ -81,6 +86,8 @@ private:
     uint64_t rate_sample_count_ = 0;
     uint64_t sequence_ = 0;
     uint64_t total_samples_ = 0;
+    uint64_t virtual_epoch_ns_ = 0;  // simulated time origin (steady clock at start())
+    double virtual_elapsed_s_ = 0.0; // simulated time of the next block
     double phase_acc_ = 0.0;
     std::mt19937 rng_{42};
     std::uniform_int_distribution<int> noise_dist_{-32768, 32767};
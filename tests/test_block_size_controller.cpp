@@ -0,0 +1,82 @@
+// BlockSizeController: a sample rate change must return the producer to its
+// configured block size, and growth must still be relative to that size.
+
+#include "stages/block_size_controller.h"
+#include "ipc/contracts.h"
+
+#include <cstdint>
+#include <cstdio>
+
+namespace {
+
+int failures = 0;
+
+#define CHECK_EQ(actual, expected)                                            \
+    do {                                                                      \
+        const auto a_ = (actual);                                             \
+        const auto e_ = (expected);                                           \
+        if (a_ != e_) {                                                       \
+            std::fprintf(stderr, "%s:%d: %s == %llu, expected %llu\n",        \
+                         __FILE__, __LINE__, #actual,                         \
+                         static_cast<unsigned long long>(a_),                 \
+                         static_cast<unsigned long long>(e_));                \
+            ++failures;                                                       \
+        }                                                                     \
+    } while (0)
+
+constexpr uint32_t kDefaultBlock = 16384;
+constexpr uint32_t kMaxBlock = 1u << 20;
+
+/// grebe-sg answering SET_BLOCK_SIZE (0 restores its configured default).
+struct Producer {
+    uint32_t block = kDefaultBlock;
+    bool request(uint32_t n) {
+        block = block_size_for_request(n, kDefaultBlock, kMaxBlock);
+        return true;
+    }
+};
+
+/// Feed @p frames blocks of the producer's current size with @p credits free.
+void feed(grebe::BlockSizeController& ctl, const Producer& producer, double rate,
+          uint32_t credits, int frames) {
+    grebe::ExecContext ctx;
+    ctx.credit_window = 16;
+    ctx.credits = credits;
+    for (int i = 0; i < frames; ++i) ctl.update(producer.block, rate, ctx);
+}
+
+void rate_change_keeps_default_block() {
+    Producer producer;
+    grebe::BlockSizeController ctl("test", [&producer](uint32_t n) {
+        return producer.request(n);
+    });
+    const uint32_t max_block = kDefaultBlock * grebe::BlockSizeController::kMaxBlockScale;
+
+    // Starved: grows to the largest multiple of the default
+    feed(ctl, producer, 1e6, 0, 2000);
+    CHECK_EQ(producer.block, max_block);
+
+    // Rate change: the request is dropped and the default comes back
+    feed(ctl, producer, 10e6, 16, 1);
+    CHECK_EQ(producer.block, kDefaultBlock);
+    CHECK_EQ(ctl.requested(), 0u);
+
+    // Growth is still relative to the original default, not a smaller one
+    feed(ctl, producer, 10e6, 0, 2000);
+    CHECK_EQ(producer.block, max_block);
+
+    // Drained: steps back down to the default and no further
+    feed(ctl, producer, 10e6, 16, 200000);
+    CHECK_EQ(producer.block, kDefaultBlock);
+}
+
+} // namespace
+
+int main() {
+    rate_change_keeps_default_block();
+    if (failures) {
+        std::fprintf(stderr, "%d check(s) failed\n", failures);
+        return 1;
+    }
+    return 0;
+}
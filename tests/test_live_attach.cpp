@@ -0,0 +1,119 @@
+// StageGraph::attach() / detach() in a tight loop while running: detach()
+// must return under every executor, including when a WorkStealing worker is
+// inside the detached stage's step() as the branch is removed, and
+// attach() / detach() must not wait behind a full Block sibling edge.
+
+#include "grebe/runtime.h"
+#include "grebe/stage.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+
+namespace {
+
+constexpr int kCycles = 3000;
+constexpr auto kTimeout = std::chrono::seconds(30);
+
+class Source : public grebe::IStage {
+public:
+    grebe::StageResult process(grebe::BatchView&, grebe::BatchWriter& out,
+                               grebe::ExecContext&) override {
+        auto f = grebe::Frame::make_owned(1, 64);
+        f.sequence = seq_++;
+        out.push(std::move(f));
+        std::this_thread::sleep_for(std::chrono::microseconds(20));
+        return grebe::StageResult::Ok;
+    }
+    std::string name() const override { return "Source"; }
+
+private:
+    uint64_t seq_ = 0;
+};
+
+class Pass : public grebe::IStage {
+public:
+    grebe::StageResult process(grebe::BatchView& in, grebe::BatchWriter& out,
+                               grebe::ExecContext&) override {
+        for (const auto& f : in) out.push(f.to_owned());
+        return grebe::StageResult::Ok;
+    }
+    std::string name() const override { return "Pass"; }
+};
+
+class Sink : public grebe::IStage {
+public:
+    grebe::StageResult process(grebe::BatchView&, grebe::BatchWriter&,
+                               grebe::ExecContext&) override {
+        return grebe::StageResult::Ok;
+    }
+    std::string name() const override { return "Sink"; }
+};
+
+/// @p stalled_output: the upstream also feeds a Block output that is never
+/// polled, so it sits blocked on that full edge while branches come and go.
+bool run_cycles(grebe::ExecutorKind kind, const char* label, bool stalled_output) {
+    grebe::RuntimeOptions ro;
+    ro.executor = kind;
+    ro.worker_threads = 4;
+    grebe::StageGraph g(ro);
+
+    grebe::StageOptions opts;
+    opts.policy = grebe::BackpressurePolicy::DropOldest;
+    opts.idle_policy = grebe::IdlePolicy::Park;
+    const auto src = g.add_stage(std::make_unique<Source>(), opts);
+    const auto pass = g.add_stage(std::make_unique<Pass>(), opts);
+    const auto sink = g.add_stage(std::make_unique<Sink>(), opts);
+    g.connect(src, pass);
+    g.connect(pass, sink);
+    if (stalled_output) g.add_output(pass, {4, grebe::BackpressurePolicy::Block});
+    g.start();
+
+    // A hang is the failure mode: report it instead of blocking ctest
+    std::atomic<int> done{0};
+    std::thread watchdog([&] {
+        const auto end = std::chrono::steady_clock::now() + kTimeout;
+        while (!done.load() && std::chrono::steady_clock::now() < end) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        if (!done.load()) {
+            std::fprintf(stderr, "%s: attach() / detach() hung\n", label);
+            std::_Exit(1);
+        }
+    });
+
+    bool ok = true;
+    for (int i = 0; i < kCycles && ok; ++i) {
+        const auto id = g.attach(pass, std::make_unique<Sink>(), opts);
+        if (id == grebe::kInvalidStageId) {
+            std::fprintf(stderr, "%s: attach() failed at cycle %d\n", label, i);
+            ok = false;
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+        ok = g.detach(id);
+    }
+    done.store(1);
+    watchdog.join();
+    g.stop();
+    return ok;
+}
+
+} // namespace
+
+int main() {
+    int failures = 0;
+    if (!run_cycles(grebe::ExecutorKind::ThreadPerStage, "ThreadPerStage", false)) ++failures;
+    if (!run_cycles(grebe::ExecutorKind::WorkStealing, "WorkStealing", false)) ++failures;
+    if (!run_cycles(grebe::ExecutorKind::ThreadPerStage, "ThreadPerStage/Block", true)) ++failures;
+    if (!run_cycles(grebe::ExecutorKind::WorkStealing, "WorkStealing/Block", true)) ++failures;
+
+    if (failures) {
+        std::fprintf(stderr, "%d check(s) failed\n", failures);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,52 @@
+// parse_thread_placement: CPU lists, and CPU indices / NUMA nodes outside
+// the affinity / node mask rejected before a range is expanded.
+
+#include "grebe/thread_placement.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace {
+
+int failures = 0;
+
+void expect_parse(const std::string& spec, bool ok, const std::vector<int>& cpus = {}) {
+    grebe::ThreadPlacement p;
+    const bool parsed = grebe::parse_thread_placement(spec, p);
+    if (parsed != ok) {
+        std::fprintf(stderr, "\"%s\": parse returned %d, expected %d\n",
+                     spec.c_str(), parsed, ok);
+        ++failures;
+        return;
+    }
+    if (ok && p.cpus != cpus) {
+        std::fprintf(stderr, "\"%s\": %zu CPU(s) parsed, expected %zu\n",
+                     spec.c_str(), p.cpus.size(), cpus.size());
+        ++failures;
+    }
+}
+
+} // namespace
+
+int main() {
+    expect_parse("2-3,6", true, {2, 3, 6});
+    expect_parse("6,2-3,3", true, {2, 3, 6});
+    expect_parse(":fifo=50", true);
+
+    // Out of range: rejected without allocating the range
+    expect_parse("0-2000000000", false);
+    expect_parse("2000000000", false);
+    expect_parse("0-100000:fifo=10", false);
+    expect_parse("-1", false);
+    expect_parse("3-2", false);
+    expect_parse(":numa=1023", true);
+    expect_parse(":numa=1024", false);
+    expect_parse("2:numa=2000000000", false);
+
+    if (failures) {
+        std::fprintf(stderr, "%d check(s) failed\n", failures);
+        return 1;
+    }
+    return 0;
+}